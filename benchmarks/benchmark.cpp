@@ -0,0 +1,251 @@
+// benchmarks/benchmark.cpp
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+#include "vm.h"
+
+#ifndef VM_SAMPLES_DIR
+#define VM_SAMPLES_DIR "."
+#endif
+
+// Бенчмарк интерпретатора на программах .suffering.
+//
+// Использование: vm_benchmark [число прогонов] [файлы...]
+// Без файлов прогоняются все примеры из корня репозитория. Для каждой программы
+// выводится лучшее время прогона (разбор + компиляция + исполнение); вывод print подавляется.
+// Сборка с VM_PROFILE_OPCODES=1 (цель vm_benchmark_profile) дополнительно считает
+// число выполненных инструкций, что даёт время на одну инструкцию, и печатает самые
+// частые пары подряд выполненных инструкций стекового байткода по всем программам.
+// Пиковый объём кучи за прогон считается через подмену глобальных operator new/delete,
+// число полных и малых сборок мусора и самые долгие паузы берутся из vm::gcStats().
+// Колонки bytecode и folded - число инструкций байткода программы и сколько из них
+// убрала свёртка констант (компиляция без исполнения, с CompilerOptions и без).
+// Каждая программа прогоняется на стековом байткоде без JIT, с трассами горячих циклов
+// (TraceJit.h), с базовым JIT (Jit.h) и с JIT на трафаретах (CopyPatchJit.h) вместе с трассами
+// и на регистровом коде (колонка backend), что даёт сравнение числа инструкций и времени
+// на одних и тех же программах. В сборке с подсчётом инструкций JIT выключен, поэтому строки
+// stack, trace, jit и stencil в ней совпадают.
+
+namespace {
+    // Заголовок перед каждым блоком хранит его размер, чтобы учитывать освобождения.
+    // Размер читается и пишется через memcpy: в начале блока нет объекта size_t.
+    constexpr size_t ALLOCATION_HEADER = alignof(std::max_align_t);
+
+    size_t currentHeapBytes = 0;
+    size_t peakHeapBytes = 0;
+
+    void *allocateCounted(size_t size) {
+        auto *block = static_cast<unsigned char *>(std::malloc(size + ALLOCATION_HEADER));
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
+        std::memcpy(block, &size, sizeof(size));
+        currentHeapBytes += size;
+        peakHeapBytes = std::max(peakHeapBytes, currentHeapBytes);
+        return block + ALLOCATION_HEADER;
+    }
+
+    void freeCounted(void *pointer) noexcept {
+        if (pointer == nullptr) {
+            return;
+        }
+        unsigned char *block = static_cast<unsigned char *>(pointer) - ALLOCATION_HEADER;
+        size_t size;
+        std::memcpy(&size, block, sizeof(size));
+        currentHeapBytes -= size;
+        std::free(block);
+    }
+}
+
+// Обычная и sized-формы operator delete заменяются вместе, чтобы обе освобождали блок с заголовком
+void *operator new(size_t size) {
+    return allocateCounted(size);
+}
+
+void operator delete(void *pointer) noexcept {
+    freeCounted(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    freeCounted(pointer);
+}
+
+namespace {
+    struct NullBuffer : std::streambuf {
+        int overflow(int c) override { return c; }
+    };
+
+    std::string readFile(const std::string &path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open the file: " + path);
+        }
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    std::string baseName(const std::string &path) {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+
+    size_t bytecodeInstructions(const std::string &code, CompilerOptions options) {
+        Heap heap;
+        Heap::Scope heapScope(heap);
+        Heap::TenuredScope tenured(heap);
+        auto global = std::make_shared<Global>();
+        global->setGlobalVariables();
+        syntax::parser parser;
+        if (options.backend == Backend::REGISTER) {
+            registerGenerator generator(global, options);
+            generator.compile(*parser.parse(code), parser.arena);
+            return generator.compileStats().instructions;
+        }
+        bytecodeGenerator generator(global, options);
+        generator.compile(*parser.parse(code), parser.arena);
+        return generator.compileStats().instructions;
+    }
+
+    const char *backendName(const CompilerOptions &options) {
+        if (options.backend == Backend::REGISTER) {
+            return "register";
+        }
+        if (options.jit) {
+            return options.jitCompiler == JitCompiler::STENCILS ? "stencil" : "jit";
+        }
+        return options.traces ? "trace" : "stack";
+    }
+
+    // Стековый байткод в интерпретаторе, с трассами, с JIT на шаблонах и на трафаретах, регистровый код
+    std::vector<CompilerOptions> configurations() {
+        CompilerOptions interpreter;
+        CompilerOptions traces;
+        traces.traces = true;
+        CompilerOptions jit;
+        jit.jit = true;
+        jit.traces = true;
+        CompilerOptions stencils = jit;
+        stencils.jitCompiler = JitCompiler::STENCILS;
+        CompilerOptions registers;
+        registers.backend = Backend::REGISTER;
+        return {interpreter, traces, jit, stencils, registers};
+    }
+
+    const char *dispatchName() {
+        return VM_USE_COMPUTED_GOTO ? "computed goto" : "handler table";
+    }
+}
+
+int main(int argc, char **argv) {
+    int runs = argc > 1 ? std::max(1, std::stoi(argv[1])) : 1;
+
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; ++i) {
+        files.emplace_back(argv[i]);
+    }
+    if (files.empty()) {
+        for (const char *name: {
+                 "factorial.suffering", "optimizationsTest.suffering", "eratosfen.suffering",
+                 "QuickSorting.suffering", "bubbleSorting.suffering"
+             }) {
+            files.push_back(std::string(VM_SAMPLES_DIR) + "/" + name);
+        }
+    }
+
+    std::printf("dispatch: %s\n", dispatchName());
+    std::printf("%-30s %-8s %6s %12s %12s %6s %14s %10s %14s %10s %8s %16s %10s\n", "program", "backend", "runs",
+                "best ms", "peak KB", "GCs", "max pause ms", "minor GCs", "max minor ms", "bytecode", "folded",
+                "instructions", "ns/instr");
+
+    NullBuffer nullBuffer;
+    std::vector<uint64_t> pairCounts(0x10000);
+    for (const auto &path: files) {
+        std::string code = readFile(path);
+
+        for (const CompilerOptions &options: configurations()) {
+            CompilerOptions unfolded = options;
+            unfolded.foldConstants = false;
+            size_t bytecode = bytecodeInstructions(code, options);
+            size_t folded = bytecodeInstructions(code, unfolded) - bytecode;
+
+            double bestMs = std::numeric_limits<double>::max();
+            uint64_t instructions = 0;
+            size_t peakBytes = 0;
+            GcStats gcStats;
+
+            for (int run = 0; run < runs; ++run) {
+                size_t heapBefore = currentHeapBytes;
+                peakHeapBytes = currentHeapBytes;
+
+                vm machine(vm::DEFAULT_STACK_SIZE, options);
+
+                std::streambuf *previous = std::cout.rdbuf(&nullBuffer);
+                auto start = std::chrono::steady_clock::now();
+                machine.exec(code);
+                auto end = std::chrono::steady_clock::now();
+                std::cout.rdbuf(previous);
+
+                peakBytes = std::max(peakBytes, peakHeapBytes - heapBefore);
+                gcStats = machine.gcStats();
+
+                bestMs = std::min(bestMs, std::chrono::duration<double, std::milli>(end - start).count());
+#if VM_PROFILE_OPCODES
+                instructions = 0;
+                for (uint64_t count: machine.opcodeCounts) {
+                    instructions += count;
+                }
+                for (uint64_t count: machine.registerOpcodeCounts) {
+                    instructions += count;
+                }
+                if (run == 0) {
+                    for (size_t pair = 0; pair < pairCounts.size(); ++pair) {
+                        pairCounts[pair] += machine.opcodePairCounts[pair];
+                    }
+                }
+#endif
+            }
+
+            if (instructions != 0) {
+                std::printf("%-30s %-8s %6d %12.3f %12zu %6zu %14.3f %10zu %14.3f %10zu %8zu %16llu %10.2f\n",
+                            baseName(path).c_str(), backendName(options), runs, bestMs, peakBytes / 1024,
+                            gcStats.collections, gcStats.maxPauseMs, gcStats.minorCollections,
+                            gcStats.maxMinorPauseMs, bytecode, folded, static_cast<unsigned long long>(instructions),
+                            bestMs * 1e6 / instructions);
+            } else {
+                std::printf("%-30s %-8s %6d %12.3f %12zu %6zu %14.3f %10zu %14.3f %10zu %8zu %16s %10s\n",
+                            baseName(path).c_str(), backendName(options), runs, bestMs, peakBytes / 1024,
+                            gcStats.collections, gcStats.maxPauseMs, gcStats.minorCollections,
+                            gcStats.maxMinorPauseMs, bytecode, folded, "-", "-");
+            }
+        }
+    }
+
+    uint64_t totalPairs = 0;
+    std::vector<size_t> pairs;
+    for (size_t pair = 0; pair < pairCounts.size(); ++pair) {
+        totalPairs += pairCounts[pair];
+        if (pairCounts[pair] != 0) {
+            pairs.push_back(pair);
+        }
+    }
+    if (totalPairs != 0) {
+        std::sort(pairs.begin(), pairs.end(), [&](size_t a, size_t b) { return pairCounts[a] > pairCounts[b]; });
+        pairs.resize(std::min<size_t>(pairs.size(), 20));
+
+        std::printf("\nmost frequent instruction pairs\n");
+        for (size_t pair: pairs) {
+            std::printf("%-20s %-20s %16llu %7.2f%%\n", opcodeToString(pair >> 8).c_str(),
+                        opcodeToString(pair & 0xFF).c_str(), static_cast<unsigned long long>(pairCounts[pair]),
+                        100.0 * pairCounts[pair] / totalPairs);
+        }
+    }
+    return 0;
+}
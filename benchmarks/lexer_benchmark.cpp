@@ -0,0 +1,137 @@
+// benchmarks/lexer_benchmark.cpp
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "parser.h"
+
+#ifndef VM_SAMPLES_DIR
+#define VM_SAMPLES_DIR "."
+#endif
+
+// Пропускная способность лексера (syntax::Tokenizer) и LR-парсера (syntax::parser) в МБ/с
+// и пиковый объём кучи при разборе (вместе с построенным AST).
+//
+// Использование: vm_lexer_benchmark [число прогонов] [размеры входа в КБ...]
+// Вход собирается повторением примеров из корня репозитория до нужного размера,
+// поэтому в нём есть все виды лексем: ключевые слова, числа, строки, комментарии.
+
+namespace {
+    // Заголовок перед каждым блоком хранит его размер, чтобы учитывать освобождения.
+    constexpr size_t ALLOCATION_HEADER = alignof(std::max_align_t);
+
+    size_t currentHeapBytes = 0;
+    size_t peakHeapBytes = 0;
+}
+
+void *operator new(size_t size) {
+    void *block = std::malloc(size + ALLOCATION_HEADER);
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t *>(block) = size;
+    currentHeapBytes += size;
+    peakHeapBytes = std::max(peakHeapBytes, currentHeapBytes);
+    return static_cast<char *>(block) + ALLOCATION_HEADER;
+}
+
+void operator delete(void *pointer) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    void *block = static_cast<char *>(pointer) - ALLOCATION_HEADER;
+    currentHeapBytes -= *static_cast<size_t *>(block);
+    std::free(block);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+namespace {
+    std::string readFile(const std::string &path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open the file: " + path);
+        }
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    std::string buildInput(size_t bytes) {
+        std::string corpus;
+        for (const char *name: {
+                 "factorial.suffering", "optimizationsTest.suffering", "eratosfen.suffering",
+                 "QuickSorting.suffering", "bubbleSorting.suffering"
+             }) {
+            corpus += readFile(std::string(VM_SAMPLES_DIR) + "/" + name);
+            corpus += "\n/* block\n   comment */ // line comment\n";
+        }
+
+        std::string input;
+        while (input.size() < bytes) {
+            input += corpus;
+        }
+        return input;
+    }
+
+    size_t countTokens(syntax::Tokenizer &tokenizer, const std::string &input) {
+        tokenizer.initString(input);
+        size_t tokens = 0;
+        while (tokenizer.getNextToken().type != syntax::TokenType::__EOF) {
+            ++tokens;
+        }
+        return tokens;
+    }
+}
+
+int main(int argc, char **argv) {
+    int runs = argc > 1 ? std::max(1, std::stoi(argv[1])) : 3;
+
+    std::vector<size_t> sizesKb;
+    for (int i = 2; i < argc; ++i) {
+        sizesKb.push_back(std::stoul(argv[i]));
+    }
+    if (sizesKb.empty()) {
+        sizesKb = {16, 256, 4096};
+    }
+
+    std::printf("%10s %6s %10s %12s %10s %12s %10s %14s\n", "input KB", "runs", "tokens", "lex ms", "lex MB/s",
+                "parse ms", "parse MB/s", "parse peak KB");
+
+    for (size_t sizeKb: sizesKb) {
+        std::string input = buildInput(sizeKb * 1024);
+
+        syntax::Tokenizer tokenizer;
+        syntax::parser parser;
+        size_t tokens = 0;
+        double lexMs = std::numeric_limits<double>::max();
+        double parseMs = std::numeric_limits<double>::max();
+        size_t parsePeakBytes = 0;
+
+        for (int run = 0; run < runs; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            tokens = countTokens(tokenizer, input);
+            auto end = std::chrono::steady_clock::now();
+            lexMs = std::min(lexMs, std::chrono::duration<double, std::milli>(end - start).count());
+
+            size_t heapBefore = currentHeapBytes;
+            peakHeapBytes = currentHeapBytes;
+            start = std::chrono::steady_clock::now();
+            parser.parse(input);
+            end = std::chrono::steady_clock::now();
+            parser.releaseAst();
+            parseMs = std::min(parseMs, std::chrono::duration<double, std::milli>(end - start).count());
+            parsePeakBytes = std::max(parsePeakBytes, peakHeapBytes - heapBefore);
+        }
+
+        double megabytes = input.size() / (1024.0 * 1024.0);
+        std::printf("%10zu %6d %10zu %12.3f %10.3f %12.3f %10.3f %14zu\n", input.size() / 1024, runs, tokens, lexMs,
+                    megabytes / (lexMs / 1000.0), parseMs, megabytes / (parseMs / 1000.0), parsePeakBytes / 1024);
+    }
+    return 0;
+}
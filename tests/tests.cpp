@@ -1376,3 +1376,1205 @@ primes;
     ASSERT_TRUE(IS_ARRAY(result));
 
 }
+
+TEST_F(VmTest, NumberArraysStayPackedUntilOtherValueIsStored) {
+    auto packed = _vm->exec(R"(
+        var big = 1;
+        var i = 0;
+        while (i < 62) {
+            big = big * 2;
+            i = i + 1;
+        }
+        var numbers = [3, 1, 2];
+        numbers[3] = big;
+        numbers[0] = numbers[3] - 1;
+        numbers;
+    )");
+
+    ASSERT_TRUE(IS_ARRAY(packed));
+    ArrayObject *array = AS_ARRAY(packed);
+    EXPECT_EQ(array->kind, ArrayObject::Kind::INT64);
+    ASSERT_EQ(array->size(), 4u);
+    EXPECT_EQ(array->numbers[0], (int64_t(1) << 62) - 1);
+    EXPECT_EQ(array->numbers[3], int64_t(1) << 62);
+
+    auto mixed = _vm->exec(R"(
+        var big = 1;
+        var i = 0;
+        while (i < 62) {
+            big = big * 2;
+            i = i + 1;
+        }
+        var values = [1, big];
+        values[2] = "three";
+        values[1] + values[0];
+    )");
+
+    ASSERT_TRUE(IS_NUMBER(mixed));
+    EXPECT_EQ(AS_NUMBER(mixed), (int64_t(1) << 62) + 1);
+
+    auto holes = _vm->exec(R"(
+        var values = [];
+        values[2] = 7;
+        values;
+    )");
+
+    ASSERT_TRUE(IS_ARRAY(holes));
+    EXPECT_EQ(AS_ARRAY(holes)->kind, ArrayObject::Kind::GENERIC);
+    ASSERT_EQ(AS_ARRAY(holes)->size(), 3u);
+    EXPECT_TRUE(IS_NIL(AS_ARRAY(holes)->elements[0]));
+    EXPECT_EQ(AS_NUMBER(AS_ARRAY(holes)->elements[2]), 7);
+}
+
+TEST_F(VmTest, ArrayLiteralsOfAnySize) {
+    auto mixed = _vm->exec(R"(
+        var x = 5;
+        var values = [x + 1, "two", [3, 4], x];
+        values;
+    )");
+
+    ASSERT_TRUE(IS_ARRAY(mixed));
+    ArrayObject *array = AS_ARRAY(mixed);
+    EXPECT_EQ(array->kind, ArrayObject::Kind::GENERIC);
+    ASSERT_EQ(array->size(), 4u);
+    EXPECT_EQ(AS_NUMBER(array->elements[0]), 6);
+    EXPECT_EQ(AS_CPP_STRING(array->elements[1]), "two");
+    ASSERT_TRUE(IS_ARRAY(array->elements[2]));
+    EXPECT_EQ(AS_ARRAY(array->elements[2])->kind, ArrayObject::Kind::INT64);
+    EXPECT_EQ(AS_ARRAY(array->elements[2])->numbers[1], 4);
+    EXPECT_EQ(AS_NUMBER(array->elements[3]), 5);
+
+    // More elements than fit in the one-byte operand of ARRAY_LITERAL
+    std::string literal = "[";
+    for (int i = 0; i < 300; ++i) {
+        literal += (i == 0 ? "" : ", ") + std::to_string(i);
+    }
+    literal += "]";
+    auto large = _vm->exec("var values = " + literal + R"(;
+        var sum = 0;
+        var i = 0;
+        while (i < 300) {
+            sum = sum + values[i];
+            i = i + 1;
+        }
+        values[300] = sum;
+        values;
+    )");
+
+    ASSERT_TRUE(IS_ARRAY(large));
+    ASSERT_EQ(AS_ARRAY(large)->size(), 301u);
+    EXPECT_EQ(AS_ARRAY(large)->numbers[299], 299);
+    EXPECT_EQ(AS_ARRAY(large)->numbers[300], 299 * 300 / 2);
+}
+
+TEST_F(VmTest, NumbersBeyondSmallIntegerRange) {
+    auto result = _vm->exec(R"(
+        var x = 1;
+        var i = 0;
+        while (i < 62) {
+            x = x * 2;
+            i = i + 1;
+        }
+        x;
+    )");
+
+    ASSERT_TRUE(IS_NUMBER(result));
+    EXPECT_FALSE(IS_OBJECT(result)) << "Boxed numbers must still be reported as numbers.";
+    EXPECT_EQ(AS_NUMBER(result), int64_t(1) << 62);
+
+    auto back = _vm->exec(R"(
+        var x = 1;
+        var i = 0;
+        while (i < 62) {
+            x = x * 2;
+            i = i + 1;
+        }
+        x - 1;
+    )");
+
+    ASSERT_TRUE(IS_NUMBER(back));
+    EXPECT_EQ(AS_NUMBER(back), (int64_t(1) << 62) - 1);
+}
+
+TEST_F(VmTest, InvalidOperationStringSubtraction) {
+    EXPECT_THROW({
+                 _vm->exec(R"(
+            ("Hello" - 5);
+        )");
+                 }, std::exception);
+}
+
+TEST(VmStackTest, StatementsKeepOperandStackBalanced) {
+    vm machine(64);
+    auto result = machine.exec(R"(
+        func identity(x) {
+            return x;
+        }
+        var i = 0;
+        while (i < 1000) {
+            identity(i);
+            if (i < 0) {
+                1;
+            }
+            var flag = (i > 10) && (i < 20);
+            i = i + 1;
+        }
+        i;
+    )");
+
+    ASSERT_TRUE(IS_NUMBER(result));
+    EXPECT_EQ(AS_NUMBER(result), 1000);
+}
+
+TEST(VmStackTest, StackOverflowIsReportedAsError) {
+    vm machine(64);
+    EXPECT_THROW({
+                 machine.exec(R"(
+            func sum(n) {
+                if (n == 0) {
+                    return 0;
+                }
+                return n + sum(n - 1);
+            }
+            sum(1000);
+        )");
+                 }, std::runtime_error);
+
+    // The machine stays usable after the error
+    auto result = machine.exec("(2 + 3);");
+    ASSERT_TRUE(IS_NUMBER(result));
+    EXPECT_EQ(AS_NUMBER(result), 5);
+}
+
+TEST(VmStackTest, CallerLocalsSurviveRecursiveCalls) {
+    vm machine(256);
+    auto result = machine.exec(R"(
+        func fib(n) {
+            if (n < 2) {
+                return n;
+            }
+            var a = fib(n - 1);
+            var b = fib(n - 2);
+            return a + b;
+        }
+        func pad(x, y) {
+            var z = 7;
+            return x + z;
+        }
+        var before = 100;
+        var f = fib(15);
+        var after = 1;
+        before + f + after + pad(2);
+    )");
+
+    ASSERT_TRUE(IS_NUMBER(result));
+    EXPECT_EQ(AS_NUMBER(result), 100 + 610 + 1 + 9);
+}
+
+TEST(VmStackTest, CallSitesCacheTheirTarget) {
+    vm machine;
+    auto result = machine.exec(R"(
+        func fib(n) {
+            if (n < 2) {
+                return n;
+            }
+            return fib(n - 1) + fib(n - 2);
+        }
+        var s = 0;
+        for (var i = 0; i < 10; i = i + 1) {
+            s = s + fib(10) + random(1);
+        }
+        s;
+    )");
+    EXPECT_EQ(AS_NUMBER(result), 550);
+    // One miss per call site: two in fib, fib and random in the loop
+    EXPECT_EQ(machine.callCacheMisses, 4u);
+}
+
+TEST(VmStackTest, RedefinedFunctionsInvalidateCallSites) {
+    vm machine;
+    machine.exec("func f(x) { return x; } func g() { var s = 0; for (var i = 0; i < 5; i = i + 1) { s = s + f(1); } return s; }");
+    EXPECT_EQ(AS_NUMBER(machine.exec("g();")), 5);
+
+    // The call site in g now reaches the new f and checks its arity again
+    machine.exec("func f(x) { return x * 10; }");
+    EXPECT_EQ(AS_NUMBER(machine.exec("g();")), 50);
+    machine.exec("func f() { return 1; }");
+    EXPECT_THROW(machine.exec("g();"), std::runtime_error);
+    machine.exec("f = 3;");
+    EXPECT_THROW(machine.exec("g();"), std::runtime_error);
+}
+
+TEST(VmStackTest, WritesToOtherGlobalsKeepCallSites) {
+    vm machine;
+    auto result = machine.exec(R"(
+        func f() { return 1; }
+        func h() { return 2; }
+        var s = 0;
+        for (var i = 0; i < 10; i = i + 1) {
+            h = h;
+            s = s + f();
+        }
+        s;
+    )");
+    EXPECT_EQ(AS_NUMBER(result), 10);
+    // Only the slot of f guards its call site
+    EXPECT_EQ(machine.callCacheMisses, 1u);
+}
+
+// Builtins are native function objects stored in globals
+TEST_F(VmTest, NativeFunctionCall) {
+    auto result = _vm->exec(R"(
+        var total = 0;
+        var i = 0;
+        while (i < 100) {
+            var r = random(10);
+            if (r >= 0 - 10 && r <= 10) {
+                total = total + 1;
+            }
+            i = i + 1;
+        }
+        total;
+    )");
+
+    ASSERT_TRUE(IS_NUMBER(result));
+    EXPECT_EQ(AS_NUMBER(result), 100);
+}
+
+TEST_F(VmTest, NativeFunctionArityIsChecked) {
+    EXPECT_THROW(_vm->exec("random(1, 2);"), std::runtime_error);
+    EXPECT_THROW(_vm->exec("random();"), std::runtime_error);
+}
+
+// More than 256 globals switch to the 16-bit global opcodes; globals persist between exec calls
+TEST_F(VmTest, ManyGlobalFunctions) {
+    for (int batch = 0; batch < 3; ++batch) {
+        std::string program;
+        for (int i = batch * 200; i < (batch + 1) * 200; ++i) {
+            program += "func f" + std::to_string(i) + "(x) { return x + " + std::to_string(i) + "; }\n";
+        }
+        _vm->exec(program);
+    }
+
+    auto result = _vm->exec("f599(1) + f300(f0(2)) + f10(0);");
+
+    ASSERT_TRUE(IS_NUMBER(result));
+    EXPECT_EQ(AS_NUMBER(result), 600 + 302 + 10);
+}
+
+// More than 256 constants in one code object switch to OP_CONST_LONG
+TEST_F(VmTest, ManyConstants) {
+    std::string program = "var t = [";
+    for (int i = 0; i < 1000; ++i) {
+        program += std::to_string(i * 7 + 3) + ", \"s" + std::to_string(i) + "\", ";
+    }
+    program += "true];\n t[1998] + t[600];";
+
+    auto result = _vm->exec(program);
+
+    ASSERT_TRUE(IS_NUMBER(result));
+    EXPECT_EQ(AS_NUMBER(result), (999 * 7 + 3) + (300 * 7 + 3));
+}
+
+// Keywords are whole words: identifiers that start with a keyword are plain symbols
+TEST_F(VmTest, IdentifiersStartingWithKeywords) {
+    auto result = _vm->exec(R"(
+        var format = 3;
+        var iffy = 4;
+        var returned = 5; /* block
+        comment */ var variable = 6; // line comment
+        func funcs(elsewhere) { return elsewhere + 1; }
+        funcs(iffy) + format + returned + variable;
+    )");
+
+    ASSERT_TRUE(IS_NUMBER(result));
+    EXPECT_EQ(AS_NUMBER(result), 5 + 3 + 5 + 6);
+}
+
+TEST_F(VmTest, LargeProgramAstSpansSeveralArenaBlocks) {
+    // Thousands of statements, a long array literal and many parameters: the AST
+    // spans several arena blocks and its node lists grow several times
+    std::string program = "func sum(a, b, c, d, e, f, g, h) { return a + b + c + d + e + f + g + h; }\n"
+                          "var total = 0;\n";
+    for (int i = 0; i < 3000; ++i) {
+        program += "total = total + 1;\n";
+    }
+    program += "var items = [";
+    for (int i = 0; i < 100; ++i) {
+        program += (i == 0 ? "" : ", ") + std::to_string(i);
+    }
+    program += "];\n";
+    program += "total + items[99] + sum(1, 2, 3, 4, 5, 6, 7, 8);\n";
+
+    auto result = _vm->exec(program);
+
+    ASSERT_TRUE(IS_NUMBER(result));
+    EXPECT_EQ(AS_NUMBER(result), 3000 + 99 + 36);
+
+    // String constants must not point into the released AST memory
+    auto str = _vm->exec(R"(var s = "arena"; s;)");
+    ASSERT_TRUE(IS_STRING(str));
+    EXPECT_EQ(AS_CPP_STRING(str), "arena");
+}
+
+TEST_F(VmTest, GarbageCollectorFreesTemporaryStrings) {
+    _vm->heap.setNurserySize(16 * 1024);
+
+    auto result = _vm->exec(R"(
+        var s = "";
+        var tail = "def";
+        for (var i = 0; i < 20000; i = i + 1) {
+            s = "abc" + tail;
+        }
+        s;
+    )");
+
+    ASSERT_TRUE(IS_STRING(result));
+    EXPECT_EQ(AS_CPP_STRING(result), "abcdef");
+
+    // Temporaries die young: minor collections free them without a full collection
+    const GcStats &stats = _vm->gcStats();
+    EXPECT_GT(stats.minorCollections, 0u);
+    EXPECT_EQ(stats.collections, 0u);
+    EXPECT_GT(stats.objectsFreed, 19000u);
+    EXPECT_GT(stats.bytesFreed, 0u);
+    // Only the result and a few survivors were promoted
+    EXPECT_LT(stats.bytesPromoted, 16u * 1024);
+    EXPECT_LT(stats.heapBytes, 64u * 1024);
+    EXPECT_GE(stats.maxMinorPauseMs, stats.lastMinorPauseMs);
+}
+
+TEST_F(VmTest, YoungObjectsStoredInOldArraysSurviveMinorCollections) {
+    _vm->heap.setNurserySize(4 * 1024);
+
+    // The array is promoted by the first minor collections and then keeps receiving
+    // fresh young strings: the write barrier must keep them alive
+    auto result = _vm->exec(R"(
+        var items = [];
+        var last = "";
+        var y = "y";
+        for (var i = 0; i < 2000; i = i + 1) {
+            last = "x" + y;
+            items[i - (i / 10) * 10] = last + "!";
+        }
+        items[0] + items[9];
+    )");
+
+    ASSERT_TRUE(IS_STRING(result));
+    EXPECT_EQ(AS_CPP_STRING(result), "xy!xy!");
+    EXPECT_GT(_vm->gcStats().minorCollections, 10u);
+    EXPECT_FALSE(_vm->heap.isYoung(result));
+}
+
+TEST_F(VmTest, GarbageCollectorKeepsReachableObjects) {
+    _vm->exec(R"(
+        var unused = [1, 2, 3];
+        func makeGreeting(name) { return "Hello, " + name; }
+    )");
+    _vm->exec(R"(
+        func fill(n) {
+            var items = [];
+            var mark = "!";
+            for (var i = 0; i < n; i = i + 1) {
+                items[i] = "item" + mark;
+            }
+            return items;
+        }
+        var dropped = fill(100);
+    )");
+
+    // Top-level variables die with their program; functions and their constants
+    // stay reachable through globals
+    _vm->collectGarbage();
+    _vm->collectGarbage();
+    EXPECT_GT(_vm->gcStats().objectsFreed, 100u);
+
+    auto result = _vm->exec(R"(
+        var items = fill(1000);
+        makeGreeting("GC") + items[999];
+    )");
+
+    ASSERT_TRUE(IS_STRING(result));
+    EXPECT_EQ(AS_CPP_STRING(result), "Hello, GCitem!");
+    EXPECT_EQ(_vm->gcStats().collections, 2u);
+
+    // The result of exec stays valid until the next exec
+    _vm->collectGarbage();
+    EXPECT_EQ(AS_CPP_STRING(result), "Hello, GCitem!");
+}
+
+TEST_F(VmTest, GarbageCollectionDuringRecursion) {
+    _vm->heap.setThreshold(1024);
+    _vm->heap.setNurserySize(1024);
+
+    auto result = _vm->exec(R"(
+        func build(depth) {
+            if (depth == 0) {
+                return ["leaf"];
+            }
+            var empty = "";
+            var label = "level" + empty;
+            var inner = build(depth - 1);
+            var outer = [label, inner];
+            return outer;
+        }
+        func depthOf(node, d) {
+            if (node[0] == "leaf") {
+                return d;
+            }
+            return depthOf(node[1], d + 1);
+        }
+        depthOf(build(50), 0);
+    )");
+
+    EXPECT_GT(_vm->gcStats().collections, 0u);
+    ASSERT_TRUE(IS_NUMBER(result));
+    EXPECT_EQ(AS_NUMBER(result), 50);
+}
+
+TEST_F(VmTest, IncrementalCollectionKeepsReachableArrays) {
+    // No automatic old-generation collection while the arrays are built
+    _vm->heap.setThreshold(1u << 30);
+    auto result = _vm->exec(R"(
+        func fill(n) {
+            var items = [];
+            var i = 0;
+            var empty = "";
+            while (i < n) {
+                items[i] = "s" + empty;
+                i = i + 1;
+            }
+            return items;
+        }
+        var keep = [];
+        var drop = [];
+        var k = 0;
+        while (k < 40) {
+            keep[k] = fill(2000);
+            drop[k] = fill(2000);
+            k = k + 1;
+        }
+        [keep, drop];
+    )");
+    ASSERT_TRUE(IS_ARRAY(result));
+
+    // The result of exec is old; dropping its second half leaves 40 * 2001 + 1 unreachable objects
+    EvaluationValue keep = AS_ARRAY(result)->elements[0];
+    AS_ARRAY(result)->elements[1] = NIL();
+
+    // Slices bounded by the number of scanned objects make the cycle deterministic
+    _vm->heap.setIncremental(true);
+    _vm->heap.setMaxSliceWork(1024);
+    GcStats before = _vm->gcStats();
+    do {
+        _vm->heap.beginPause();
+        _vm->collectIncrementally();
+        _vm->heap.endPause();
+    } while (_vm->heap.phase() != Heap::Phase::IDLE);
+
+    const GcStats &stats = _vm->gcStats();
+    EXPECT_EQ(stats.collections, before.collections + 1);
+    EXPECT_EQ(stats.objectsFreed - before.objectsFreed, 40u * 2001 + 1);
+    // Every cycle takes several pauses: start, marking slices and sweeping slices
+    EXPECT_GT(stats.pauses - before.pauses, 2u);
+    // A minor collection inside an old-generation pause is recorded once
+    EXPECT_GE(_vm->gcPauseHistogram().total(), stats.pauses);
+    EXPECT_LE(_vm->gcPauseHistogram().total(), stats.pauses + stats.minorCollections);
+
+    ASSERT_EQ(AS_ARRAY(keep)->elements.size(), 40u);
+    for (const EvaluationValue &items: AS_ARRAY(keep)->elements) {
+        ASSERT_EQ(AS_ARRAY(items)->elements.size(), 2000u);
+        for (const EvaluationValue &item: AS_ARRAY(items)->elements) {
+            ASSERT_EQ(AS_CPP_STRING(item), "s");
+        }
+    }
+}
+
+// Slices run between instructions after every SLICE_ALLOCATION bytes, while the program
+// keeps writing into arrays that are being marked
+TEST_F(VmTest, IncrementalCollectionRunsWithTheProgram) {
+    _vm->heap.setThreshold(64 * 1024);
+    _vm->heap.setIncremental(true);
+    _vm->heap.setMaxSliceWork(1024);
+
+    auto result = _vm->exec(R"(
+        func fill(n) {
+            var items = [];
+            var i = 0;
+            var empty = "";
+            while (i < n) {
+                items[i] = "s" + empty;
+                i = i + 1;
+            }
+            return items;
+        }
+        var keep = [];
+        var k = 0;
+        while (k < 40) {
+            keep[k] = fill(2000);
+            var garbage = fill(2000);
+            k = k + 1;
+        }
+        var total = 0;
+        k = 0;
+        while (k < 40) {
+            var items = keep[k];
+            var i = 0;
+            while (i < 2000) {
+                if (items[i] == "s") {
+                    total = total + 1;
+                }
+                i = i + 1;
+            }
+            k = k + 1;
+        }
+        total;
+    )");
+
+    ASSERT_TRUE(IS_NUMBER(result));
+    EXPECT_EQ(AS_NUMBER(result), 80000);
+    const GcStats &stats = _vm->gcStats();
+    EXPECT_GT(stats.collections, 0u);
+    EXPECT_GT(stats.pauses, stats.collections * 2);
+}
+
+// Every compiler configuration runs the same programs to the same result or error as the
+// reference configuration without optimizations and native code. Tests of each optimization
+// and tier below check only what is specific to it.
+namespace {
+    bool containsOpcode(const CodeObject *co, uint8_t opcode) {
+        for (size_t offset = 0; offset < co->code.size(); offset += instructionLength(co->code[offset])) {
+            if (co->code[offset] == opcode) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string resultOrError(vm &machine, const std::string &program) {
+        try {
+            return evaluationValueToConstantString(machine.exec(program));
+        } catch (const std::exception &error) {
+            return std::string("error: ") + error.what();
+        }
+    }
+
+    // Sorts the array literal a of n elements in place, then evaluates result
+    std::string bubbleSort(const std::string &array, int n, const std::string &result) {
+        return "var a = " + array + "; var n = " + std::to_string(n) + "; var i = 0;"
+               "while (i < n) { var j = 0; while (j < n - i - 1) {"
+               "  if (a[j] > a[j + 1]) { var t = a[j]; a[j] = a[j + 1]; a[j + 1] = t; } j = j + 1; }"
+               "  i = i + 1; } " + result + ";";
+    }
+
+    CompilerOptions withoutJit() {
+        CompilerOptions options;
+        options.jit = false;
+        options.traces = false;
+        return options;
+    }
+
+    CompilerOptions unoptimized() {
+        CompilerOptions options = withoutJit();
+        options.foldConstants = false;
+        options.peephole = false;
+        options.superinstructions = false;
+        return options;
+    }
+
+    // The reference configuration with one optimization turned on
+    CompilerOptions only(bool CompilerOptions::*optimization) {
+        CompilerOptions options = unoptimized();
+        options.*optimization = true;
+        return options;
+    }
+
+    CompilerOptions registerBackend() {
+        CompilerOptions options;
+        options.backend = Backend::REGISTER;
+        return options;
+    }
+
+    // Baseline JIT only
+    CompilerOptions jitAfter(uint32_t threshold) {
+        CompilerOptions options = withoutJit();
+        options.jit = true;
+        options.jitThreshold = threshold;
+        options.osrThreshold = threshold;
+        return options;
+    }
+
+    // Traces only, so that loops run either in traces or in the interpreter
+    CompilerOptions tracesAfter(uint32_t threshold) {
+        CompilerOptions options = withoutJit();
+        options.traces = true;
+        options.traceThreshold = threshold;
+        return options;
+    }
+
+    CompilerOptions stencilsAfter(uint32_t threshold) {
+        CompilerOptions options = jitAfter(threshold);
+        options.jitCompiler = JitCompiler::STENCILS;
+        return options;
+    }
+
+    CompilerOptions withTracesAfter(CompilerOptions options, uint32_t threshold) {
+        options.traces = true;
+        options.traceThreshold = threshold;
+        return options;
+    }
+
+    std::vector<std::string> differentialPrograms() {
+        std::string bigLiteral = "var big = [";
+        for (int i = 0; i < 300; ++i) {
+            bigLiteral += std::to_string(i) + (i + 1 < 300 ? ", " : "];");
+        }
+        bigLiteral += " big[0] + big[299];";
+
+        return {
+            // Constant expressions
+            "(2 + 3 * 4 - 10 / 2);",
+            "\"con\" + \"cat\" + \"enation\";",
+            "!true;",
+            "!0;",
+            "(3 < 4) && (\"b\" > \"a\");",
+            "0 && 5;",
+            "\"\" || 7;",
+            "true || 7;",
+            "if (true) { 1; } else { 2; }",
+            "if (false) { 1; } else { 2; }",
+            // Only the boolean false skips the then-branch
+            "if (0) { \"then\"; } else { \"else\"; }",
+            "if (false) { 1; }",
+            "var x = 6; (x * 2) * 1 + 0;",
+            "var x = 6; x * 1;",
+            "var x = 6; var y = x * x - 1; y / 5;",
+            "var n = 0; while (false) { n = n + 1; } n;",
+            "if (false) { func g() { return 1; } } 3;",
+            // Overflowing constants are left to the runtime
+            "(4611686018427387903 * 4611686018427387903);",
+
+            // Control flow and logical operators
+            "var x = 0; if (!x) { 1; } else { 2; }",
+            "var x = \"\"; var n = 0; while (!x) { n = n + 1; if (n == 3) { x = \"done\"; } } n;",
+            "var i = 0; var s = 0; while (i < 5) { i = i + 1; s = s + i; } s;",
+            "var a = true; var b = false; if (a) { if (b) { 1; } else { 2; } } else { 3; }",
+            "var t = 1; t; 2; t;",
+            "var y = 1; (y && 0) || !y;",
+            "var a = 0; var b = a || \"default\"; b;",
+            // The assigned variable is read again after the left operand is stored
+            "var x = 5; x = 0 && x; x;",
+            "var x = 5; x = x || 7; x;",
+            "var c = 0; for (var k = 0; k < 10; k = k + 1) { if (!(k < 5)) { c = c + k; } } c;",
+            "var s = 0; for (var i = 0; true; i = i + 1) { if (i == 4) { return s; } s = s + i; }",
+            "var n = 2; var m = 3; var r = 0; if (n < m) { r = n; } else { r = m; } r + m;",
+
+            // Hot loops: small integers, overflow into heap numbers, strings and type changes
+            "var s = 0; for (var i = 0; i < 100; i = i + 1) { s = s + i * 2 - 1; } s;",
+            "var s = 0; var i = 0; while (i < 100) { if (i - (i / 3) * 3 == 0) { s = s + i; } else { s = s - 1; } i = i + 1; } s;",
+            "var s = \"\"; for (var i = 0; i < 20; i = i + 1) { s = s + \"ab\"; } s;",
+            "var c = 0; for (var i = 0; i < 10; i = i + 1) { if (\"a\" < \"b\") { c = c + 1; } } c;",
+            "var c = 0; for (var i = 0; i < 50; i = i + 1) { var t = i >= 25; if (t) { c = c + 1; } } c;",
+            "var p = 1; for (var i = 0; i < 40; i = i + 1) { p = p * 3 - p * 2; p = p + 2 * 3; } p;",
+            "var x = 0; var c = 0; while (!x) { c = c + 1; if (c == 5) { x = c; } } c;",
+            "var x = 1; for (var i = 0; i < 62; i = i + 1) { x = x + x; } x;",
+            "var x = 3; for (var i = 0; i < 61; i = i + 1) { x = x * 2; } x;",
+            "var x = 1073741824 * 1073741824 * 4 - 1000; x = x + 1000; x - 1;",
+            "var x = 1073741824 * 1073741824 * 4 - 3; for (var i = 0; i < 6; i = i + 1) { x = x + 1; } x;",
+            "var y = 2 - 1073741824 * 1073741824 * 4; for (var i = 0; i < 6; i = i + 1) { y = y - 1; } y;",
+            "var v = 0; for (var i = 0; i < 30; i = i + 1) { if (i == 20) { v = \"s\"; } v = v + 1; } v;",
+            "var a = 1; var b = 2; for (var i = 0; i < 5; i = i + 1) { a = a && b; b = b || a; } [a, b];",
+            // Nested loops: an inner loop gets a trace, the outer one unrolls it
+            "var s = 0; for (var i = 0; i < 30; i = i + 1) { for (var j = 0; j < i; j = j + 1) { s = s + j; } } s;",
+
+            // Arrays of numbers, heap numbers in them and generic arrays
+            bubbleSort("[5, 3, 1, 4]", 4, "a"),
+            bubbleSort("[5, 3, 1, 4, 2, 9, 7, 8, 6, 0]", 10, "a"),
+            "var a = [1073741824 * 1073741824 * 4, 1]; var s = 0; for (var i = 0; i < 2; i = i + 1) { s = a[i]; } a[0] - s;",
+            "var a = [0, 0]; for (var i = 0; i < 4; i = i + 1) { a[i] = i * 1073741824 * 1073741824 * 2; } a;",
+            "var g = [\"x\", 1, true]; var s = \"\"; for (var i = 0; i < 3; i = i + 1) { g[i] = i; s = g; } s;",
+            "var a = [0, 0, 0]; for (var i = 0; i < 20; i = i + 1) { if (i == 15) { a[1] = \"x\"; } a[0] = a[0] + i; } a;",
+            "var a = [1, 2]; var s = 0; for (var i = 0; i < 20; i = i + 1) { if (i == 12) { a = \"no\"; } s = a[0]; } s;",
+            "var s = [\"a\", 1, true]; s[0] = s[0] + \"b\"; s[3] = 4; s;",
+            "var e = []; e[2] = 1; e;",
+            "var e = []; for (var i = 0; i < 10; i = i + 2) { e[i] = i; } e;",
+            bigLiteral,
+
+            // Calls and returns, also between compiled and interpreted frames
+            "func fib(n) { if (n < 2) { return n; } return fib(n - 1) + fib(n - 2); } fib(15);",
+            "func f(x) { if (x > 0) { return 1; } return 2; } f(0 - 1) * 10 + f(1);",
+            "func g(n) { var i = 0; while (i < n) { if (i == 3) { return i; } i = i + 1; } return 0 - 1; } g(10) + g(2);",
+            "func f() { var i = 0; while (true) { i = i + 1; if (i == 5) { return i; } } } f();",
+            "func h() { var i = 0; while (true) { i = i + 1; if (i == 5) { return i; } } } h() + h();",
+            "func f(k) { var total = 0; while (k > 0) { total = total + k; k = k - 1; } return total; } f(10);",
+            "func g(a, b) { return b; } g(1);",
+            "func k(n) { var arr = [n, n + 1]; return arr; } var r = k(3); r[1];",
+            "func k(n) { var arr = [n, n + 1]; return arr; } var r = 0; for (var i = 0; i < 5; i = i + 1) { r = k(i); } r;",
+            "func nothing() { var z = 1; } nothing();",
+            "func sum(a, b, c) { return a + b + c; } sum(sum(1, 2, 3), sum(4, 5, 6), 7);",
+            "func sum(a, b, c) { return a + b + c; } var t = 0; for (var i = 0; i < 5; i = i + 1) { t = sum(t, i, 1); } t;",
+            "func inc(x) { return x + 1; } var s = 0; for (var i = 0; i < 100; i = i + 1) { s = inc(s); } s;",
+            "func sumTo(n) { var s = 0; var i = 0; while (i < n) { s = s + i; i = i + 1; } return s; }"
+            "var t = 0; for (var k = 0; k < 20; k = k + 1) { t = t + sumTo(k * 10); } t;",
+            // Native functions
+            "var m = 0; random(m) + 1;",
+            "var m = 0; for (var i = 0; i < 5; i = i + 1) { m = m + random(0); } m;",
+            "random(\"x\");",
+            "random(1, 2);",
+
+            // Errors are reported the same way, also in the middle of a hot loop
+            "var t = \"a\"; t = t - 1;",
+            "var b = [1]; var i = 3; b[i];",
+            "var c = true; c = c + 1;",
+            "(5 / 0);",
+            "var x = 1; if (x < \"a\") { 1; }",
+            "func one(a) { return a; } one(1, 2);",
+            "var n = 5; n[0];",
+            "undefinedFunction(1);",
+            "var b = [1, 2, 3]; var s = 0; for (var i = 0; i < 10; i = i + 1) { s = s + b[i]; } s;",
+            "var s = 0; for (var i = 0; i < 10; i = i + 1) { s = s + i; if (i == 7) { s = s + \"x\"; } } s;",
+        };
+    }
+}
+
+struct Configuration {
+    const char *name;
+    CompilerOptions options;
+
+    // Whether the configuration can run in this build; nullptr if always
+    bool (*available)();
+
+    // Number of code objects compiled to machine code; nullptr if the configuration has none
+    size_t (*compiledCount)(const vm &machine);
+};
+
+static void PrintTo(const Configuration &configuration, std::ostream *os) {
+    *os << configuration.name;
+}
+
+static size_t jitCompiled(const vm &machine) {
+    return machine.jitCache.compiledCount();
+}
+
+static size_t stencilsCompiled(const vm &machine) {
+    return machine.stencilJit.compiledCount();
+}
+
+class DifferentialTest : public ::testing::TestWithParam<Configuration> {
+};
+
+TEST_P(DifferentialTest, ProgramsGiveTheSameResultsAsWithoutOptimizations) {
+    const Configuration &configuration = GetParam();
+    if (configuration.available != nullptr && !configuration.available()) {
+        GTEST_SKIP() << "No machine code for " << configuration.name << " in this build";
+    }
+
+    size_t compiledPrograms = 0;
+    for (const std::string &program: differentialPrograms()) {
+        vm reference(vm::DEFAULT_STACK_SIZE, unoptimized());
+        vm machine(vm::DEFAULT_STACK_SIZE, configuration.options);
+        EXPECT_EQ(resultOrError(machine, program), resultOrError(reference, program)) << program;
+        if (configuration.compiledCount != nullptr && configuration.compiledCount(machine) > 0) {
+            compiledPrograms++;
+        }
+    }
+    // The programs with loops and calls really ran in machine code
+    if (configuration.compiledCount != nullptr) {
+        EXPECT_GT(compiledPrograms, 0u);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Configurations, DifferentialTest,
+    ::testing::Values(
+        Configuration{"Default", CompilerOptions{}, nullptr, nullptr},
+        Configuration{"ConstantFolding", only(&CompilerOptions::foldConstants), nullptr, nullptr},
+        Configuration{"Peephole", only(&CompilerOptions::peephole), nullptr, nullptr},
+        Configuration{"Superinstructions", only(&CompilerOptions::superinstructions), nullptr, nullptr},
+        Configuration{"RegisterBackend", registerBackend(), nullptr, nullptr},
+        Configuration{"Jit", jitAfter(1), JitCache::available, jitCompiled},
+        Configuration{"TracesAfter1", tracesAfter(1), JitCache::available, nullptr},
+        Configuration{"TracesAfter7", tracesAfter(7), JitCache::available, nullptr},
+        Configuration{"JitWithTraces", withTracesAfter(jitAfter(1), 3), JitCache::available, jitCompiled},
+        Configuration{"Stencils", stencilsAfter(1), StencilJit::available, stencilsCompiled},
+        Configuration{"StencilsWithTraces", withTracesAfter(stencilsAfter(1), 3), StencilJit::available,
+                      stencilsCompiled}),
+    [](const ::testing::TestParamInfo<Configuration> &info) { return std::string(info.param.name); });
+
+TEST(ConstantFoldingTest, ConstantExpressionsCompileToOneLoad) {
+    vm folded;
+    vm unfolded(vm::DEFAULT_STACK_SIZE, CompilerOptions{false});
+    const char *program = "(2 + 3 * 4);";
+
+    EXPECT_EQ(AS_NUMBER(folded.exec(program)), 14);
+    EXPECT_EQ(AS_NUMBER(unfolded.exec(program)), 14);
+
+    // CONST, HALT instead of CONST, CONST, CONST, MUL, ADD, HALT
+    EXPECT_EQ(folded._bytecodeGenerator->compileStats().instructions, 2u);
+    EXPECT_EQ(folded._bytecodeGenerator->compileStats().foldedExpressions, 2u);
+    EXPECT_EQ(unfolded._bytecodeGenerator->compileStats().instructions, 6u);
+    EXPECT_EQ(unfolded._bytecodeGenerator->compileStats().foldedExpressions, 0u);
+}
+
+TEST(ConstantFoldingTest, RuntimeErrorsAreNotFolded) {
+    vm machine;
+    EXPECT_THROW(machine.exec("(5 / 0);"), std::exception);
+    EXPECT_THROW(machine.exec("\"a\" + 1;"), std::exception);
+    EXPECT_THROW(machine.exec("(\"a\" < 1);"), std::exception);
+}
+
+TEST(PeepholeTest, UnreachableCodeAfterReturnIsRemoved) {
+    vm machine;
+    EXPECT_EQ(AS_NUMBER(machine.exec("func test() { var a = 8; return a; var d = a + 6; } test();")), 8);
+    // The dead declaration and the implicit NIL; RETURN at the end of the function
+    EXPECT_GE(machine._bytecodeGenerator->compileStats().peepholeRemoved, 5u);
+}
+
+TEST(PeepholeTest, NegatedConditionBecomesJumpIfTrue) {
+    vm machine;
+    EXPECT_EQ(AS_NUMBER(machine.exec("var x = 0; if (!x) { 1; } else { 2; }")), 1);
+    EXPECT_TRUE(containsOpcode(machine.co, OP_JUMP_IF_TRUE));
+    EXPECT_FALSE(containsOpcode(machine.co, OP_LOGICAL_NOT));
+
+    EXPECT_TRUE(AS_BOOL(machine.exec("var x = 0; (!x);"))) << "a value-producing NOT is kept";
+    EXPECT_TRUE(containsOpcode(machine.co, OP_LOGICAL_NOT));
+}
+
+TEST(SuperinstructionTest, HotLoopSequencesAreFused) {
+    const char *program = "var a = [5, 3, 1]; var j = 0; var s = 0;"
+                          "while (j < 2) { if (a[j] > a[j + 1]) { s = s + 1; } j = j + 1; } s;";
+    vm machine;
+    EXPECT_EQ(AS_NUMBER(machine.exec(program)), 2);
+
+    EXPECT_TRUE(containsOpcode(machine.co, OP_ARRAY_GET_LOCAL_LOCAL));
+    EXPECT_TRUE(containsOpcode(machine.co, OP_GET_LOCAL_LOCAL));
+    EXPECT_TRUE(containsOpcode(machine.co, OP_ADD_CONST));
+    EXPECT_TRUE(containsOpcode(machine.co, OP_INC_LOCAL));
+    EXPECT_FALSE(containsOpcode(machine.co, OP_ADD));
+    EXPECT_EQ(machine._bytecodeGenerator->compileStats().superinstructions, 5u);
+
+    CompilerOptions options;
+    options.superinstructions = false;
+    vm unfused(vm::DEFAULT_STACK_SIZE, options);
+    EXPECT_EQ(AS_NUMBER(unfused.exec(program)), 2);
+    EXPECT_FALSE(containsOpcode(unfused.co, OP_INC_LOCAL));
+    EXPECT_EQ(unfused._bytecodeGenerator->compileStats().superinstructions, 0u);
+}
+
+TEST(SuperinstructionTest, FusionRunsWithoutOtherPeepholeRules) {
+    CompilerOptions options;
+    options.peephole = false;
+    vm machine(vm::DEFAULT_STACK_SIZE, options);
+    EXPECT_EQ(AS_NUMBER(machine.exec("var i = 0; var s = 0; while (i < 5) { i = i + 1; s = s + i; } s;")), 15);
+
+    EXPECT_TRUE(containsOpcode(machine.co, OP_INC_LOCAL));
+    EXPECT_GT(machine._bytecodeGenerator->compileStats().superinstructions, 0u);
+    EXPECT_EQ(machine._bytecodeGenerator->compileStats().peepholeRemoved, 0u);
+}
+
+TEST(CompareJumpTest, FusedBranchesMatchComparisonValues) {
+    // Every operator on small, negative, heap-allocated and string operands, once as a branch
+    // condition (fused compare-and-jump) and once as a stored value
+    const char *operators[] = {"<", ">", "==", ">=", "<=", "!="};
+    const char *operands[][2] = {
+        {"1", "2"}, {"2", "1"}, {"3", "3"}, {"0 - 5", "4"}, {"0 - 5", "0 - 7"},
+        // 2^62 does not fit a small integer and is allocated in the heap
+        {"1073741824 * 1073741824 * 4", "1073741824 * 1073741824 * 4 - 1"},
+        {"1073741824 * 1073741824 * 4 - 1", "1073741824 * 1073741824 * 4"},
+        {"\"abc\"", "\"abd\""}, {"\"b\"", "\"b\""},
+    };
+
+    for (const char *op: operators) {
+        for (const auto &pair: operands) {
+            std::string left = pair[0];
+            std::string right = pair[1];
+            std::string branch = "var l = " + left + "; var r = " + right +
+                                 "; if (l " + op + " r) { 1; } else { 0; }";
+            std::string value = "var l = " + left + "; var r = " + right + "; var c = (l " + op +
+                                " r); if (c) { 1; } else { 0; }";
+            vm machine;
+            EXPECT_EQ(AS_NUMBER(machine.exec(branch)), AS_NUMBER(machine.exec(value))) << branch;
+        }
+    }
+}
+
+TEST(CompareJumpTest, LoopConditionsUseFusedJumps) {
+    vm machine;
+    EXPECT_EQ(AS_NUMBER(machine.exec("var s = 0; var i = 0; while (i < 10) { if (i != 3) { s = s + i; } i = i + 1; } s;")),
+              42);
+    EXPECT_TRUE(containsOpcode(machine.co, OP_JUMP_IF_NOT_LT));
+    EXPECT_TRUE(containsOpcode(machine.co, OP_JUMP_IF_NOT_NE));
+    EXPECT_FALSE(containsOpcode(machine.co, OP_COMPARE));
+    EXPECT_FALSE(containsOpcode(machine.co, OP_JUMP_IF_FALSE));
+
+    EXPECT_THROW(machine.exec("var x = 1; if (x < \"a\") { 1; }"), std::runtime_error);
+}
+
+TEST(RegisterBackendTest, ThreeAddressCodeNeedsFewerInstructions) {
+    std::string program = bubbleSort("[5, 3, 1, 4, 2]", 5, "a[0] * 10000 + a[1] * 1000 + a[2] * 100 + a[3] * 10 + a[4]");
+
+    vm stackMachine;
+    vm registerMachine(vm::DEFAULT_STACK_SIZE, registerBackend());
+    EXPECT_EQ(AS_NUMBER(stackMachine.exec(program)), 12345);
+    EXPECT_EQ(AS_NUMBER(registerMachine.exec(program)), 12345);
+
+    EXPECT_TRUE(registerMachine.co->registerBased);
+    EXPECT_FALSE(stackMachine.co->registerBased);
+    EXPECT_LT(registerMachine._registerGenerator->compileStats().instructions,
+              stackMachine._bytecodeGenerator->compileStats().instructions);
+}
+
+TEST(RegisterBackendTest, RegistersAreGarbageCollectionRoots) {
+    vm machine(vm::DEFAULT_STACK_SIZE, registerBackend());
+    machine.heap.setNurserySize(1024);
+
+    // Strings and arrays live only in registers of nested frames while minor collections move them
+    auto result = machine.exec(R"(
+        func wrap(s, depth) {
+            if (depth == 0) {
+                return [s + "!"];
+            }
+            var inner = wrap(s + "x", depth - 1);
+            return [inner[0], depth];
+        }
+        var kept = [];
+        for (var i = 0; i < 2000; i = i + 1) {
+            var w = wrap("a", 5);
+            kept[i - (i / 10) * 10] = w[0];
+        }
+        kept[3] + kept[9];
+    )");
+
+    ASSERT_TRUE(IS_STRING(result));
+    EXPECT_EQ(AS_CPP_STRING(result), "axxxxx!axxxxx!");
+    EXPECT_GT(machine.gcStats().minorCollections, 0u);
+}
+
+TEST(RegisterBackendTest, StackOverflowIsReportedAsError) {
+    vm machine(64, registerBackend());
+    EXPECT_THROW(machine.exec("func sum(n) { if (n == 0) { return 0; } return n + sum(n - 1); } sum(1000);"),
+                 std::runtime_error);
+
+    // The machine stays usable after the error
+    EXPECT_EQ(AS_NUMBER(machine.exec("func sum(n) { if (n == 0) { return 0; } return n + sum(n - 1); } sum(5);")),
+              15);
+}
+
+TEST(RegisterBackendTest, NarrowCalleeOfWideCallerChecksItsScratchSpace) {
+    // g needs 240 registers for the arguments of k; h, called from g afterwards, has few registers
+    // but pushes 100 values for its array literal above the top of g's frame
+    std::string params;
+    std::string args;
+    for (int i = 0; i < 240; ++i) {
+        params += (i > 0 ? ", p" : "p") + std::to_string(i);
+        args += (i > 0 ? ", " : "") + std::to_string(i);
+    }
+    std::string elements;
+    for (int i = 0; i < 100; ++i) {
+        elements += (i > 0 ? ", " : "") + std::to_string(i);
+    }
+    std::string program = "func k(" + params + ") { return 1; }"
+                          "func h() { return [" + elements + "]; }"
+                          "func g() { var t = k(" + args + "); return h(); } g();";
+
+    vm machine(300, registerBackend());
+    try {
+        machine.exec(program);
+        FAIL() << "Expected a stack overflow";
+    } catch (const std::runtime_error &error) {
+        EXPECT_STREQ(error.what(), "Stack overflow.");
+    }
+
+    vm roomy(vm::DEFAULT_STACK_SIZE, registerBackend());
+    EXPECT_EQ(AS_NUMBER(roomy.exec(program + " var r = g(); r[99];")), 99);
+}
+
+TEST(JitTest, HotCodeIsCompiledAtThreshold) {
+    if (!JitCache::available()) {
+        GTEST_SKIP() << "No JIT on this platform";
+    }
+    const char *program =
+        "func inc(x) { return x + 1; } var s = 0; for (var i = 0; i < LIMIT; i = i + 1) { s = inc(s); } s;";
+    auto withLimit = [&](int limit) {
+        std::string source = program;
+        source.replace(source.find("LIMIT"), 5, std::to_string(limit));
+        return source;
+    };
+
+    // Neither the function nor the loop of main reaches 50 calls or back edges
+    vm cold(vm::DEFAULT_STACK_SIZE, jitAfter(50));
+    EXPECT_EQ(AS_NUMBER(cold.exec(withLimit(10))), 10);
+    EXPECT_EQ(cold.jitCache.compiledCount(), 0u);
+    EXPECT_EQ(cold.co->native, nullptr);
+
+    vm hot(vm::DEFAULT_STACK_SIZE, jitAfter(50));
+    EXPECT_EQ(AS_NUMBER(hot.exec(withLimit(1000))), 1000);
+    EXPECT_EQ(hot.jitCache.compiledCount(), 2u);
+    EXPECT_NE(hot.co->native, nullptr);
+    EXPECT_GT(hot.jitCache.size(), 0u);
+
+    vm disabled(vm::DEFAULT_STACK_SIZE, withoutJit());
+    EXPECT_EQ(AS_NUMBER(disabled.exec(withLimit(1000))), 1000);
+    EXPECT_EQ(disabled.jitCache.compiledCount(), 0u);
+}
+
+TEST(JitTest, CallsAndBackEdgesPromoteCodeSeparately) {
+    if (!JitCache::available()) {
+        GTEST_SKIP() << "No JIT on this platform";
+    }
+    const char *program =
+        "func inc(x) { return x + 1; } var s = 0; for (var i = 0; i < 200; i = i + 1) { s = inc(s); } s;";
+
+    // The function is compiled on its 50th call, the loop of main never gets hot enough
+    CompilerOptions calls = jitAfter(50);
+    calls.osrThreshold = 1000;
+    vm onCall(vm::DEFAULT_STACK_SIZE, calls);
+    EXPECT_EQ(AS_NUMBER(onCall.exec(program)), 200);
+    EXPECT_EQ(onCall.tieringStats.promotedOnCall, 1u);
+    EXPECT_EQ(onCall.tieringStats.promotedInLoop, 0u);
+    EXPECT_EQ(tierOf(onCall.co), Tier::INTERPRETER);
+    EXPECT_EQ(onCall.co->backEdges, 200u);
+
+    // main runs once: its loop moves to compiled code at the 50th back edge
+    CompilerOptions loops = jitAfter(1000);
+    loops.osrThreshold = 50;
+    vm inLoop(vm::DEFAULT_STACK_SIZE, loops);
+    EXPECT_EQ(AS_NUMBER(inLoop.exec(program)), 200);
+    EXPECT_EQ(inLoop.tieringStats.promotedOnCall, 0u);
+    EXPECT_EQ(inLoop.tieringStats.promotedInLoop, 1u);
+    EXPECT_EQ(tierOf(inLoop.co), Tier::NATIVE);
+    EXPECT_EQ(inLoop.co->backEdges, 50u);
+    EXPECT_EQ(inLoop.co->invocations, 0u);
+}
+
+TEST(JitTest, CompiledCodeSeesGlobalsDefinedLater) {
+    if (!JitCache::available()) {
+        GTEST_SKIP() << "No JIT on this platform";
+    }
+    vm machine(vm::DEFAULT_STACK_SIZE, jitAfter(1));
+    machine.exec("func step() { return 10; }"
+                 "func addSteps(x) { var s = 0; for (var i = 0; i < x; i = i + 1) { s = s + step(); } return s; }");
+    EXPECT_EQ(AS_NUMBER(machine.exec("addSteps(3);")), 30);
+
+    // Many new functions move the global slots; compiled code reads the current buffer
+    std::string program;
+    for (int i = 0; i < 300; ++i) {
+        program += "func g" + std::to_string(i) + "() { return " + std::to_string(i) + "; }";
+    }
+    program += "func step() { return 7; } addSteps(4);";
+    EXPECT_EQ(AS_NUMBER(machine.exec(program)), 28);
+}
+
+TEST(JitTest, CompiledLoopsSurviveGarbageCollection) {
+    vm machine(vm::DEFAULT_STACK_SIZE, jitAfter(1));
+    machine.heap.setNurserySize(1024);
+
+    // Strings and arrays are created by the interpreter between compiled instructions
+    auto result = machine.exec(R"(
+        func wrap(s, depth) {
+            if (depth == 0) {
+                return [s + "!"];
+            }
+            var inner = wrap(s + "x", depth - 1);
+            return [inner[0], depth];
+        }
+        var kept = [];
+        for (var i = 0; i < 2000; i = i + 1) {
+            var w = wrap("a", 5);
+            kept[i - (i / 10) * 10] = w[0];
+        }
+        kept[3] + kept[9];
+    )");
+
+    ASSERT_TRUE(IS_STRING(result));
+    EXPECT_EQ(AS_CPP_STRING(result), "axxxxx!axxxxx!");
+    EXPECT_GT(machine.gcStats().minorCollections, 0u);
+}
+
+TEST(TraceTest, HotLoopsAreRecordedAndOptimized) {
+    if (!JitCache::available()) {
+        GTEST_SKIP() << "No JIT on this platform";
+    }
+    vm machine(vm::DEFAULT_STACK_SIZE, tracesAfter(10));
+    auto result = machine.exec(
+        "var a = [1, 2, 3, 4, 5, 6, 7, 8]; var s = 0; var k = 0;"
+        "for (var i = 0; i < 1000; i = i + 1) { s = s + a[k] * 2; a[k] = a[k] + 1; k = k + 1; if (k == 8) { k = 0; } } s;");
+    EXPECT_EQ(AS_NUMBER(result), 2 * (36 * 125 + 8 * (124 * 125 / 2)));
+    EXPECT_EQ(machine.traceCache.traceCount(), 1u);
+
+    // Repeated loads of i, k and a are forwarded, their type checks removed
+    const TraceStats &stats = machine.traceCache.stats();
+    EXPECT_GT(stats.loadsForwarded, 0u);
+    EXPECT_GT(stats.guardsRemoved, 0u);
+    EXPECT_LT(stats.optimized, stats.recorded);
+
+    // A loop that never gets hot is not recorded
+    vm cold(vm::DEFAULT_STACK_SIZE, tracesAfter(10));
+    EXPECT_EQ(AS_NUMBER(cold.exec("var s = 0; for (var i = 0; i < 5; i = i + 1) { s = s + i; } s;")), 10);
+    EXPECT_EQ(cold.traceCache.traceCount(), 0u);
+}
+
+TEST(TraceTest, ConstantsAreFolded) {
+    if (!JitCache::available()) {
+        GTEST_SKIP() << "No JIT on this platform";
+    }
+    // two is forwarded from the store, so two * 3 is known inside the trace
+    vm machine(vm::DEFAULT_STACK_SIZE, tracesAfter(1));
+    EXPECT_EQ(AS_NUMBER(machine.exec("var s = 0; var two = 2; for (var i = 0; i < 100; i = i + 1) { two = 2; s = s + two * 3; } s;")), 600);
+    EXPECT_GT(machine.traceCache.stats().constantsFolded, 0u);
+}
+
+TEST(TraceTest, SideExitsResumeInTheInterpreter) {
+    if (!JitCache::available()) {
+        GTEST_SKIP() << "No JIT on this platform";
+    }
+    // The trace records the else branch; later iterations take the other branch through a side exit
+    vm machine(vm::DEFAULT_STACK_SIZE, tracesAfter(1));
+    auto result = machine.exec(
+        "var small = 0; var big = 0; for (var i = 0; i < 200; i = i + 1) { if (i > 100) { big = big + 1; } else { small = small + 1; } } small * 1000 + big;");
+    EXPECT_EQ(AS_NUMBER(result), 101099);
+
+    // Errors are raised by the interpreter after the side exit, with the loop state intact
+    vm failing(vm::DEFAULT_STACK_SIZE, tracesAfter(1));
+    EXPECT_THROW(failing.exec("var a = [1, 2, 3]; var s = 0; for (var i = 0; i < 10; i = i + 1) { s = s + a[i]; }"),
+                 std::runtime_error);
+    EXPECT_EQ(AS_NUMBER(failing.exec("var a = [1, 2, 3]; var s = 0; for (var i = 0; i < 3; i = i + 1) { s = s + a[i]; } s;")), 6);
+}
+
+TEST(TraceTest, TracesThatKeepExitingAreRetiredInFavourOfCompiledCode) {
+    if (!JitCache::available()) {
+        GTEST_SKIP() << "No JIT on this platform";
+    }
+    // The branch flips on every iteration, so the trace leaves through a side exit each time
+    const char *program =
+        "var odd = 0; var flag = false;"
+        "for (var i = 0; i < 2000; i = i + 1) { if (flag) { odd = odd + 1; flag = false; } else { flag = true; } } odd;";
+
+    vm machine(vm::DEFAULT_STACK_SIZE, withTracesAfter(jitAfter(1), 1));
+    EXPECT_EQ(AS_NUMBER(machine.exec(program)), 1000);
+    EXPECT_EQ(machine.traceCache.traceCount(), 1u);
+    EXPECT_EQ(machine.traceCache.retiredCount(), 1u);
+
+    // Without compiled code to fall back on, the trace stays
+    vm traced(vm::DEFAULT_STACK_SIZE, tracesAfter(1));
+    EXPECT_EQ(AS_NUMBER(traced.exec(program)), 1000);
+    EXPECT_EQ(traced.traceCache.retiredCount(), 0u);
+}
+
+TEST(StencilJitTest, CompiledCodeSeesGlobalsDefinedLater) {
+    if (!StencilJit::available()) {
+        GTEST_SKIP() << "No stencils in this build";
+    }
+    vm machine(vm::DEFAULT_STACK_SIZE, stencilsAfter(1));
+    machine.exec("func step() { return 10; }"
+                 "func addSteps(x) { var s = 0; for (var i = 0; i < x; i = i + 1) { s = s + step(); } return s; }");
+    EXPECT_EQ(AS_NUMBER(machine.exec("addSteps(3);")), 30);
+
+    std::string program;
+    for (int i = 0; i < 300; ++i) {
+        program += "func g" + std::to_string(i) + "() { return " + std::to_string(i) + "; }";
+    }
+    program += "func step() { return 7; } addSteps(4);";
+    EXPECT_EQ(AS_NUMBER(machine.exec(program)), 28);
+    EXPECT_GT(machine.stencilJit.size(), 0u);
+}
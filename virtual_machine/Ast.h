@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Память под AST: узлы выделяются сдвигом указателя в крупных блоках и освобождаются
+// все сразу вызовом reset() после компиляции. Деструкторы узлов не вызываются,
+// поэтому в арене размещаются только тривиально разрушаемые типы.
+class AstArena {
+public:
+    // Блоки растут вдвое от первого до максимального размера, чтобы маленькая
+    // программа не занимала лишнего, а большая не делала много выделений.
+    static constexpr size_t FIRST_BLOCK_SIZE = 4 * 1024;
+    static constexpr size_t MAX_BLOCK_SIZE = 64 * 1024;
+
+    AstArena() = default;
+
+    AstArena(const AstArena &) = delete;
+
+    AstArena &operator=(const AstArena &) = delete;
+
+    void *allocate(size_t size, size_t alignment) {
+        size_t padding = (alignment - reinterpret_cast<uintptr_t>(cursor_) % alignment) % alignment;
+        if (cursor_ == nullptr || size + padding > static_cast<size_t>(limit_ - cursor_)) {
+            newBlock(size + alignment);
+            padding = (alignment - reinterpret_cast<uintptr_t>(cursor_) % alignment) % alignment;
+        }
+        void *result = cursor_ + padding;
+        cursor_ += padding + size;
+        return result;
+    }
+
+    template<typename T, typename... Args>
+    T *make(Args &&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "Узлы AST не должны требовать деструктора");
+        return new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    T *allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "Узлы AST не должны требовать деструктора");
+        return static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Копия строки в арене: AST не зависит от времени жизни исходного текста
+    std::string_view copyString(std::string_view str) {
+        if (str.empty()) {
+            return {};
+        }
+        char *data = allocateArray<char>(str.size());
+        std::memcpy(data, str.data(), str.size());
+        return {data, str.size()};
+    }
+
+    // Освобождает все узлы разом
+    void reset() {
+        blocks_.clear();
+        cursor_ = nullptr;
+        limit_ = nullptr;
+        bytesAllocated_ = 0;
+    }
+
+    // Объём памяти, занятой блоками арены
+    size_t bytesAllocated() const {
+        return bytesAllocated_;
+    }
+
+private:
+    void newBlock(size_t minimumSize) {
+        size_t size = blocks_.empty() ? FIRST_BLOCK_SIZE : std::min(MAX_BLOCK_SIZE, lastBlockSize_ * 2);
+        lastBlockSize_ = size;
+        size = std::max(size, minimumSize);
+        blocks_.emplace_back(new char[size]);
+        cursor_ = blocks_.back().get();
+        limit_ = cursor_ + size;
+        bytesAllocated_ += size;
+    }
+
+    std::vector<std::unique_ptr<char[]> > blocks_;
+    char *cursor_ = nullptr;
+    char *limit_ = nullptr;
+    size_t lastBlockSize_ = 0;
+    size_t bytesAllocated_ = 0;
+};
+
+// Список в арене (инструкции блока, аргументы, параметры). При росте ёмкость удваивается,
+// старый буфер остаётся в арене до reset().
+template<typename T>
+struct ArenaList {
+    T *items;
+    uint32_t count;
+    uint32_t capacity;
+
+    void push_back(AstArena &arena, T item) {
+        if (count == capacity) {
+            uint32_t newCapacity = capacity == 0 ? 4 : capacity * 2;
+            T *newItems = arena.allocateArray<T>(newCapacity);
+            if (count != 0) {
+                std::memcpy(newItems, items, sizeof(T) * count);
+            }
+            items = newItems;
+            capacity = newCapacity;
+        }
+        items[count++] = item;
+    }
+
+    size_t size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+    T *begin() const { return items; }
+
+    T *end() const { return items + count; }
+
+    T &operator[](size_t index) const { return items[index]; }
+
+    T &back() const { return items[count - 1]; }
+};
+
+enum class ExpType : uint8_t {
+    NUMBER,
+    STRING,
+    SYMBOL,
+    BINARY_EXP,
+    UNARY_EXP,
+    IF_EXP,
+    WHILE_EXP,
+    FOR_EXP,
+    VAR_DECLARATION,
+    BLOCK,
+    ASSIGNMENT,
+    FUNCTION_DECLARATION,
+    FUNCTION_CALL,
+    PARAM_LIST,
+    ARG_LIST,
+    RETURN_STATEMENT,
+    ARRAY_LITERAL,
+    ARRAY_ACCESS,
+};
+
+struct Exp;
+
+using ExpList = ArenaList<Exp *>;
+using NameList = ArenaList<std::string_view>;
+
+// Данные узла для каждого вида выражения. Отсутствующие части (else, инициализация for,
+// значение return) - nullptr.
+
+struct BinaryNode {
+    std::string_view op;
+    Exp *left;
+    Exp *right;
+};
+
+struct UnaryNode {
+    std::string_view op;
+    Exp *operand;
+};
+
+struct IfNode {
+    Exp *condition;
+    Exp *thenBranch;
+    Exp *elseBranch;
+};
+
+struct WhileNode {
+    Exp *condition;
+    Exp *body;
+};
+
+struct ForNode {
+    Exp *init;
+    Exp *condition;
+    Exp *update;
+    Exp *body;
+};
+
+// Объявление переменной: var name = value
+struct VariableNode {
+    std::string_view name;
+    Exp *value;
+};
+
+// Присваивание name = value или name[index] = value (тогда index не nullptr)
+struct AssignmentNode {
+    std::string_view name;
+    Exp *index;
+    Exp *value;
+};
+
+struct FunctionNode {
+    std::string_view name;
+    NameList params;
+    Exp *body;
+};
+
+struct CallNode {
+    std::string_view name;
+    ExpList arguments;
+};
+
+struct ArrayAccessNode {
+    std::string_view name;
+    Exp *index;
+};
+
+// Узел AST: тег вида и данные этого вида в объединении. Узлы живут в AstArena,
+// строки ссылаются на её же память.
+struct Exp {
+    ExpType type;
+
+    union {
+        int64_t number;                 // NUMBER
+        std::string_view string;        // STRING, SYMBOL
+        BinaryNode binary;              // BINARY_EXP
+        UnaryNode unary;                // UNARY_EXP
+        IfNode ifExp;                   // IF_EXP
+        WhileNode whileExp;             // WHILE_EXP
+        ForNode forExp;                 // FOR_EXP
+        VariableNode variable;          // VAR_DECLARATION
+        AssignmentNode assignment;      // ASSIGNMENT
+        ExpList list;                   // BLOCK, ARG_LIST, ARRAY_LITERAL
+        NameList params;                // PARAM_LIST
+        FunctionNode function;          // FUNCTION_DECLARATION
+        CallNode call;                  // FUNCTION_CALL
+        Exp *returnValue;               // RETURN_STATEMENT
+        ArrayAccessNode arrayAccess;    // ARRAY_ACCESS
+    };
+
+    explicit Exp(int64_t number) : type(ExpType::NUMBER), number(number) {}
+
+    // STRING или SYMBOL
+    Exp(ExpType type, std::string_view string) : type(type), string(string) {}
+
+    explicit Exp(BinaryNode binary) : type(ExpType::BINARY_EXP), binary(binary) {}
+
+    explicit Exp(UnaryNode unary) : type(ExpType::UNARY_EXP), unary(unary) {}
+
+    explicit Exp(IfNode ifExp) : type(ExpType::IF_EXP), ifExp(ifExp) {}
+
+    explicit Exp(WhileNode whileExp) : type(ExpType::WHILE_EXP), whileExp(whileExp) {}
+
+    explicit Exp(ForNode forExp) : type(ExpType::FOR_EXP), forExp(forExp) {}
+
+    explicit Exp(VariableNode variable) : type(ExpType::VAR_DECLARATION), variable(variable) {}
+
+    explicit Exp(AssignmentNode assignment) : type(ExpType::ASSIGNMENT), assignment(assignment) {}
+
+    // BLOCK, ARG_LIST или ARRAY_LITERAL
+    Exp(ExpType type, ExpList list) : type(type), list(list) {}
+
+    explicit Exp(NameList params) : type(ExpType::PARAM_LIST), params(params) {}
+
+    explicit Exp(FunctionNode function) : type(ExpType::FUNCTION_DECLARATION), function(function) {}
+
+    explicit Exp(CallNode call) : type(ExpType::FUNCTION_CALL), call(call) {}
+
+    explicit Exp(Exp *returnValue) : type(ExpType::RETURN_STATEMENT), returnValue(returnValue) {}
+
+    explicit Exp(ArrayAccessNode arrayAccess) : type(ExpType::ARRAY_ACCESS), arrayAccess(arrayAccess) {}
+};
+
+// Оставляет ли выражение (инструкция) значение на стеке операндов.
+// Каждая инструкция языка оставляет либо ровно одно значение, либо ни одного,
+// поэтому глубина стека в любой точке байткода известна при компиляции.
+inline bool producesValue(const Exp &exp) {
+    switch (exp.type) {
+        case ExpType::VAR_DECLARATION:
+        case ExpType::ASSIGNMENT:
+        case ExpType::WHILE_EXP:
+        case ExpType::FOR_EXP:
+        case ExpType::FUNCTION_DECLARATION:
+        case ExpType::RETURN_STATEMENT:
+            return false;
+        case ExpType::BLOCK:
+            return !exp.list.empty() && producesValue(*exp.list.back());
+        case ExpType::IF_EXP:
+            return producesValue(*exp.ifExp.thenBranch) ||
+                   (exp.ifExp.elseBranch != nullptr && producesValue(*exp.ifExp.elseBranch));
+        default:
+            return true;
+    }
+}
+
+static_assert(std::is_trivially_destructible_v<Exp>, "Exp размещается в AstArena");
+static_assert(sizeof(Exp) <= 48, "Узел AST должен оставаться компактным");
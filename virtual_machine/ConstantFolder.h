@@ -0,0 +1,350 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include "Ast.h"
+
+// Свёртка констант и алгебраические упрощения в AST перед генерацией байткода.
+//
+// Вычисления повторяют семантику инструкций vm, поэтому результат программы не меняется:
+// выражение, которое при исполнении бросило бы исключение (деление на ноль, сложение
+// строки с числом, сравнение разных типов) или переполнило бы int64, не сворачивается.
+// Узлы заменяются на месте, новые строки копируются в арену AST.
+//
+// Условие if/while считается ложным, только если это константа false: так работает
+// JUMP_IF_FALSE. Недостижимая ветка удаляется, если в ней нет объявлений, видимых
+// снаружи (функций и переменных вне блока).
+class ConstantFolder {
+public:
+    explicit ConstantFolder(AstArena &arena) : arena(arena) {
+    }
+
+    void fold(Exp &exp) {
+        switch (exp.type) {
+            case ExpType::NUMBER:
+            case ExpType::STRING:
+            case ExpType::SYMBOL:
+            case ExpType::PARAM_LIST:
+                break;
+            case ExpType::UNARY_EXP:
+                fold(*exp.unary.operand);
+                foldUnary(exp);
+                break;
+            case ExpType::BINARY_EXP:
+                fold(*exp.binary.left);
+                fold(*exp.binary.right);
+                foldBinary(exp);
+                break;
+            case ExpType::IF_EXP:
+                fold(*exp.ifExp.condition);
+                fold(*exp.ifExp.thenBranch);
+                if (exp.ifExp.elseBranch != nullptr) {
+                    fold(*exp.ifExp.elseBranch);
+                }
+                foldIf(exp);
+                break;
+            case ExpType::WHILE_EXP:
+                fold(*exp.whileExp.condition);
+                fold(*exp.whileExp.body);
+                foldWhile(exp);
+                break;
+            case ExpType::FOR_EXP:
+                for (Exp *part: {exp.forExp.init, exp.forExp.condition, exp.forExp.update, exp.forExp.body}) {
+                    if (part != nullptr) {
+                        fold(*part);
+                    }
+                }
+                foldFor(exp);
+                break;
+            case ExpType::VAR_DECLARATION:
+                fold(*exp.variable.value);
+                break;
+            case ExpType::ASSIGNMENT:
+                if (exp.assignment.index != nullptr) {
+                    fold(*exp.assignment.index);
+                }
+                fold(*exp.assignment.value);
+                break;
+            case ExpType::BLOCK:
+            case ExpType::ARG_LIST:
+            case ExpType::ARRAY_LITERAL:
+                for (Exp *item: exp.list) {
+                    fold(*item);
+                }
+                break;
+            case ExpType::FUNCTION_DECLARATION:
+                fold(*exp.function.body);
+                break;
+            case ExpType::FUNCTION_CALL:
+                for (Exp *argument: exp.call.arguments) {
+                    fold(*argument);
+                }
+                break;
+            case ExpType::RETURN_STATEMENT:
+                if (exp.returnValue != nullptr) {
+                    fold(*exp.returnValue);
+                }
+                break;
+            case ExpType::ARRAY_ACCESS:
+                fold(*exp.arrayAccess.index);
+                break;
+        }
+    }
+
+    // Число свёрнутых или упрощённых выражений
+    size_t foldedCount() const {
+        return folded;
+    }
+
+private:
+    static bool isBoolean(const Exp &exp) {
+        return exp.type == ExpType::SYMBOL && (exp.string == "true" || exp.string == "false");
+    }
+
+    static bool isConstant(const Exp &exp) {
+        return exp.type == ExpType::NUMBER || exp.type == ExpType::STRING || isBoolean(exp);
+    }
+
+    // Истинность константы, как в vm::isTruth
+    static bool isTruthy(const Exp &exp) {
+        switch (exp.type) {
+            case ExpType::NUMBER:
+                return exp.number != 0;
+            case ExpType::STRING:
+                return !exp.string.empty();
+            default:
+                return exp.string == "true";
+        }
+    }
+
+    static bool isFalse(const Exp &exp) {
+        return isBoolean(exp) && exp.string == "false";
+    }
+
+    // Выражение, значение которого всегда число: SUB, MUL и DIV над другими типами
+    // бросают исключение, ADD чисел даёт число
+    static bool isNumeric(const Exp &exp) {
+        if (exp.type == ExpType::NUMBER) {
+            return true;
+        }
+        if (exp.type != ExpType::BINARY_EXP) {
+            return false;
+        }
+        std::string_view op = exp.binary.op;
+        if (op == "-" || op == "*" || op == "/") {
+            return true;
+        }
+        return op == "+" && isNumeric(*exp.binary.left) && isNumeric(*exp.binary.right);
+    }
+
+    static bool isNumber(const Exp &exp, int64_t value) {
+        return exp.type == ExpType::NUMBER && exp.number == value;
+    }
+
+    // Можно ли удалить недостижимый код: функции объявляются при компиляции, а переменная
+    // вне блока видна следующим инструкциям
+    static bool isRemovable(const Exp *exp) {
+        if (exp == nullptr) {
+            return true;
+        }
+        return exp->type != ExpType::VAR_DECLARATION && !declaresFunction(*exp);
+    }
+
+    static bool declaresFunction(const Exp &exp) {
+        switch (exp.type) {
+            case ExpType::FUNCTION_DECLARATION:
+                return true;
+            case ExpType::UNARY_EXP:
+                return declaresFunction(*exp.unary.operand);
+            case ExpType::BINARY_EXP:
+                return declaresFunction(*exp.binary.left) || declaresFunction(*exp.binary.right);
+            case ExpType::IF_EXP:
+                return declaresFunction(*exp.ifExp.condition) || declaresFunction(*exp.ifExp.thenBranch) ||
+                       (exp.ifExp.elseBranch != nullptr && declaresFunction(*exp.ifExp.elseBranch));
+            case ExpType::WHILE_EXP:
+                return declaresFunction(*exp.whileExp.body);
+            case ExpType::FOR_EXP:
+                for (Exp *part: {exp.forExp.init, exp.forExp.condition, exp.forExp.update, exp.forExp.body}) {
+                    if (part != nullptr && declaresFunction(*part)) {
+                        return true;
+                    }
+                }
+                return false;
+            case ExpType::BLOCK:
+                for (Exp *item: exp.list) {
+                    if (declaresFunction(*item)) {
+                        return true;
+                    }
+                }
+                return false;
+            default:
+                return false;
+        }
+    }
+
+    static Exp booleanExp(bool value) {
+        return Exp(ExpType::SYMBOL, value ? std::string_view("true") : std::string_view("false"));
+    }
+
+    static Exp emptyBlock() {
+        return Exp(ExpType::BLOCK, ExpList{});
+    }
+
+    void replace(Exp &exp, const Exp &replacement) {
+        exp = replacement;
+        folded++;
+    }
+
+    void foldUnary(Exp &exp) {
+        if (exp.unary.op == "!" && isConstant(*exp.unary.operand)) {
+            replace(exp, booleanExp(!isTruthy(*exp.unary.operand)));
+        }
+    }
+
+    void foldBinary(Exp &exp) {
+        const BinaryNode &binary = exp.binary;
+        const Exp &left = *binary.left;
+        const Exp &right = *binary.right;
+        std::string_view op = binary.op;
+
+        // Короткое замыкание: результат - одно из значений операндов
+        if (op == "&&" || op == "||") {
+            if (isConstant(left)) {
+                bool keepLeft = (op == "&&") != isTruthy(left);
+                replace(exp, keepLeft ? left : right);
+            }
+            return;
+        }
+
+        if (left.type == ExpType::NUMBER && right.type == ExpType::NUMBER) {
+            foldNumbers(exp, op, left.number, right.number);
+            return;
+        }
+
+        if (left.type == ExpType::STRING && right.type == ExpType::STRING) {
+            if (op == "+") {
+                std::string joined = std::string(left.string) + std::string(right.string);
+                replace(exp, Exp(ExpType::STRING, arena.copyString(joined)));
+            } else if (int result = compare(op, left.string, right.string); result != -1) {
+                replace(exp, booleanExp(result));
+            }
+            return;
+        }
+
+        // Нейтральные элементы: x + 0, 0 + x, x - 0, x * 1, 1 * x, x / 1
+        if ((op == "+" && isNumber(right, 0) && isNumeric(left)) ||
+            (op == "-" && isNumber(right, 0) && isNumeric(left)) ||
+            (op == "*" && isNumber(right, 1) && isNumeric(left)) ||
+            (op == "/" && isNumber(right, 1) && isNumeric(left))) {
+            replace(exp, left);
+        } else if ((op == "+" && isNumber(left, 0) && isNumeric(right)) ||
+                   (op == "*" && isNumber(left, 1) && isNumeric(right))) {
+            replace(exp, right);
+        }
+    }
+
+    void foldNumbers(Exp &exp, std::string_view op, int64_t left, int64_t right) {
+        if (op == "+") {
+            if (!addOverflows(left, right)) {
+                replace(exp, Exp(left + right));
+            }
+        } else if (op == "-") {
+            if (!subtractOverflows(left, right)) {
+                replace(exp, Exp(left - right));
+            }
+        } else if (op == "*") {
+            if (!multiplyOverflows(left, right)) {
+                replace(exp, Exp(left * right));
+            }
+        } else if (op == "/") {
+            if (right != 0 && !(left == MIN && right == -1)) {
+                replace(exp, Exp(left / right));
+            }
+        } else if (int result = compare(op, left, right); result != -1) {
+            replace(exp, booleanExp(result));
+        }
+    }
+
+    static constexpr int64_t MIN = std::numeric_limits<int64_t>::min();
+    static constexpr int64_t MAX = std::numeric_limits<int64_t>::max();
+
+    static bool addOverflows(int64_t left, int64_t right) {
+        return right > 0 ? left > MAX - right : left < MIN - right;
+    }
+
+    static bool subtractOverflows(int64_t left, int64_t right) {
+        return right < 0 ? left > MAX + right : left < MIN + right;
+    }
+
+    static bool multiplyOverflows(int64_t left, int64_t right) {
+        if (left == 0 || right == 0) {
+            return false;
+        }
+        if (left > 0) {
+            return right > 0 ? left > MAX / right : right < MIN / left;
+        }
+        return right > 0 ? left < MIN / right : right < MAX / left;
+    }
+
+    // Результат сравнения (0 или 1) или -1, если op не оператор сравнения
+    template<typename T>
+    static int compare(std::string_view op, const T &left, const T &right) {
+        if (op == "<") return left < right;
+        if (op == ">") return left > right;
+        if (op == "==") return left == right;
+        if (op == ">=") return left >= right;
+        if (op == "<=") return left <= right;
+        if (op == "!=") return left != right;
+        return -1;
+    }
+
+    // if с константным условием заменяется выбранной веткой, если у неё тот же эффект на стек
+    void foldIf(Exp &exp) {
+        const IfNode &ifExp = exp.ifExp;
+        if (!isConstant(*ifExp.condition)) {
+            return;
+        }
+        bool takeElse = isFalse(*ifExp.condition);
+        Exp *taken = takeElse ? ifExp.elseBranch : ifExp.thenBranch;
+        Exp *dropped = takeElse ? ifExp.thenBranch : ifExp.elseBranch;
+
+        bool resultValue = producesValue(exp);
+        bool takenValue = taken != nullptr && producesValue(*taken);
+        if (resultValue != takenValue || !isRemovable(dropped)) {
+            return;
+        }
+        replace(exp, taken != nullptr ? *taken : emptyBlock());
+    }
+
+    // while (false) исчезает, while с истинной константой становится for без условия
+    void foldWhile(Exp &exp) {
+        const WhileNode &whileExp = exp.whileExp;
+        if (!isConstant(*whileExp.condition)) {
+            return;
+        }
+        if (!isFalse(*whileExp.condition)) {
+            replace(exp, Exp(ForNode{nullptr, nullptr, nullptr, whileExp.body}));
+        } else if (isRemovable(whileExp.body)) {
+            replace(exp, emptyBlock());
+        }
+    }
+
+    void foldFor(Exp &exp) {
+        ForNode &forExp = exp.forExp;
+        if (forExp.condition == nullptr || !isConstant(*forExp.condition)) {
+            return;
+        }
+        if (!isFalse(*forExp.condition)) {
+            forExp.condition = nullptr;
+            folded++;
+        } else if (forExp.init == nullptr && isRemovable(forExp.body) && isRemovable(forExp.update)) {
+            replace(exp, emptyBlock());
+        }
+    }
+
+    AstArena &arena;
+
+    size_t folded = 0;
+};
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "EvaluationValue.h"
+#include "Global.h"
+#include "Jit.h"
+#include "OpCode.h"
+#include "Stencil.h"
+
+// JIT-компилятор копированием и заплатками (copy-and-patch).
+//
+// Машинный код инструкций не собирается по байтам, как в Jit.h, а берётся готовым: при сборке
+// цель vm_stencils компилирует быстрые пути инструкций (stencils/stencils.cpp) обычным
+// компилятором C++, а extractStencils извлекает из объектного файла код каждой функции и
+// положение дыр (Stencils.h). Компиляция объекта кода - выбор трафарета для каждой инструкции,
+// копирование трафаретов подряд и запись в дыры операндов, адресов продолжения и адреса выхода.
+// Переход на следующую инструкцию в конце трафарета отбрасывается, если она лежит сразу за ним.
+//
+// Результат - тот же NativeCode, что у базового JIT: точка входа у каждой инструкции и выход
+// в интерпретатор на инструкциях без быстрого пути, поэтому vm исполняет его так же.
+// Без сгенерированных трафаретов (VM_HAVE_STENCILS=0) компилятор недоступен.
+#ifndef VM_HAVE_STENCILS
+#define VM_HAVE_STENCILS 0
+#endif
+
+#if VM_HAVE_STENCILS
+#include "Stencils.h"
+#endif
+
+class StencilJit {
+public:
+    explicit StencilJit(std::shared_ptr<Global> global) : global(std::move(global)) {
+    }
+
+    // Трафареты сгенерированы при сборке для платформы, на которой поддерживается машинный код
+    static bool available() {
+        return VM_JIT_AVAILABLE && VM_HAVE_STENCILS;
+    }
+
+    // Компилирует объект стекового кода; nullptr, если исполняемую память получить не удалось.
+    // С traceSlot обратный переход выходит в интерпретатор, если у цикла уже есть трасса.
+    const NativeCode *compile(CodeObject *codeObject, const JitCache::TraceSlot &traceSlot = nullptr) {
+#if VM_HAVE_STENCILS
+        const std::vector<uint8_t> &code = codeObject->code;
+
+        std::vector<Instruction> instructions;
+        for (size_t offset = 0; offset < code.size(); offset += instructionLength(code[offset])) {
+            instructions.push_back(select(codeObject, offset, traceSlot));
+        }
+
+        // Трафареты подряд за точкой входа; переход на следующую инструкцию в конце не нужен
+        std::vector<uint32_t> offsets(code.size());
+        size_t size = stencils::ENTER.size;
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            offsets[instructions[i].offset] = static_cast<uint32_t>(size);
+            instructions[i].length = i + 1 < instructions.size() ? instructions[i].stencil->tailJump
+                                                                  : instructions[i].stencil->size;
+            size += instructions[i].length;
+        }
+
+        std::unique_ptr<ExecutableMemory> memory = ExecutableMemory::allocate(size);
+        if (memory == nullptr) {
+            return nullptr;
+        }
+        uint8_t *base = memory->data();
+        std::memcpy(base, stencils::ENTER.code, stencils::ENTER.size);
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            const Instruction &instruction = instructions[i];
+            uint8_t *copy = base + offsets[instruction.offset];
+            std::memcpy(copy, instruction.stencil->code, instruction.length);
+
+            uint64_t holes[6] = {
+                reinterpret_cast<uint64_t>(i + 1 < instructions.size() ? base + offsets[instructions[i + 1].offset]
+                                                                       : nullptr),
+                reinterpret_cast<uint64_t>(instruction.target != SIZE_MAX ? base + offsets[instruction.target]
+                                                                          : nullptr),
+                reinterpret_cast<uint64_t>(&code[instruction.offset]),
+                instruction.operands[0],
+                instruction.operands[1],
+                instruction.operands[2],
+            };
+            for (size_t p = 0; p < instruction.stencil->patchCount; ++p) {
+                const StencilPatch &patch = instruction.stencil->patches[p];
+                if (patch.offset >= instruction.length) {
+                    continue;
+                }
+                uint64_t value = holes[static_cast<size_t>(patch.hole)] + static_cast<uint64_t>(patch.addend);
+                std::memcpy(copy + patch.offset, &value, sizeof(value));
+            }
+        }
+        if (!memory->seal()) {
+            return nullptr;
+        }
+
+        codeBytes += memory->size();
+        compiled.push_back(std::make_unique<NativeCode>(std::move(memory), code.data(), std::move(offsets)));
+        return compiled.back().get();
+#else
+        return nullptr;
+#endif
+    }
+
+    // Число скомпилированных объектов кода
+    size_t compiledCount() const {
+        return compiled.size();
+    }
+
+    // Объём исполняемой памяти в байтах
+    size_t size() const {
+        return codeBytes;
+    }
+
+private:
+    struct Instruction {
+        size_t offset;
+        const Stencil *stencil;
+        uint64_t operands[3] = {0, 0, 0};
+
+        // Смещение цели перехода в байткоде или SIZE_MAX
+        size_t target = SIZE_MAX;
+
+        // Копируемая часть трафарета
+        size_t length = 0;
+    };
+
+#if VM_HAVE_STENCILS
+    // Трафарет и операнды инструкции байткода offset
+    Instruction select(CodeObject *codeObject, size_t offset, const JitCache::TraceSlot &traceSlot) const {
+        const uint8_t *operands = &codeObject->code[offset + 1];
+        auto jumpAddress = [&]() {
+            return static_cast<size_t>((operands[0] << 8) | operands[1]);
+        };
+        // Слово константы, если это малое целое
+        auto smallConstant = [&](uint8_t index, uint64_t &bits) {
+            EvaluationValue constant = codeObject->constants[index];
+            bits = constant.bits;
+            return constant.isSmallNumber();
+        };
+        static const Stencil *const compares[] = {
+            &stencils::COMPARE_LT, &stencils::COMPARE_GT, &stencils::COMPARE_EQ,
+            &stencils::COMPARE_GE, &stencils::COMPARE_LE, &stencils::COMPARE_NE,
+        };
+        static const Stencil *const jumpsIfNot[] = {
+            &stencils::JUMP_IF_NOT_LT, &stencils::JUMP_IF_NOT_GT, &stencils::JUMP_IF_NOT_EQ,
+            &stencils::JUMP_IF_NOT_GE, &stencils::JUMP_IF_NOT_LE, &stencils::JUMP_IF_NOT_NE,
+        };
+
+        Instruction instruction{offset, &stencils::EXIT};
+        uint8_t opcode = codeObject->code[offset];
+        switch (opcode) {
+            case OP_CONST:
+                instruction.stencil = &stencils::CONST;
+                instruction.operands[0] = codeObject->constants[operands[0]].bits;
+                break;
+            case OP_CONST_LONG:
+                instruction.stencil = &stencils::CONST;
+                instruction.operands[0] = codeObject->constants[(operands[0] << 8) | operands[1]].bits;
+                break;
+            case OP_NIL:
+                instruction.stencil = &stencils::CONST;
+                instruction.operands[0] = NIL().bits;
+                break;
+            case OP_GET_LOCAL:
+                instruction.stencil = &stencils::GET_LOCAL;
+                instruction.operands[0] = operands[0];
+                break;
+            case OP_GET_LOCAL_LOCAL:
+                instruction.stencil = &stencils::GET_LOCAL_LOCAL;
+                instruction.operands[0] = operands[0];
+                instruction.operands[1] = operands[1];
+                break;
+            case OP_SET_LOCAL:
+                instruction.stencil = &stencils::SET_LOCAL;
+                instruction.operands[0] = operands[0];
+                break;
+            case OP_DUP:
+                instruction.stencil = &stencils::DUP;
+                break;
+            case OP_POP:
+                instruction.stencil = &stencils::POP;
+                break;
+            case OP_GET_GLOBAL:
+            case OP_GET_GLOBAL_LONG:
+                instruction.stencil = &stencils::GET_GLOBAL;
+                instruction.operands[0] = reinterpret_cast<uint64_t>(&global->globals);
+                instruction.operands[1] = opcode == OP_GET_GLOBAL ? operands[0] : (operands[0] << 8) | operands[1];
+                break;
+            case OP_JUMP:
+                instruction.target = jumpAddress();
+                instruction.stencil = &stencils::JUMP;
+                if (traceSlot && instruction.target < offset) {
+                    instruction.stencil = &stencils::LOOP_JUMP;
+                    instruction.operands[0] = reinterpret_cast<uint64_t>(traceSlot(instruction.target));
+                }
+                break;
+            case OP_JUMP_IF_FALSE:
+                instruction.stencil = &stencils::JUMP_IF_FALSE;
+                instruction.target = jumpAddress();
+                break;
+            case OP_JUMP_IF_TRUE:
+                instruction.stencil = &stencils::JUMP_IF_TRUE;
+                instruction.target = jumpAddress();
+                break;
+            case OP_JUMP_IF_NOT_LT:
+            case OP_JUMP_IF_NOT_GT:
+            case OP_JUMP_IF_NOT_EQ:
+            case OP_JUMP_IF_NOT_GE:
+            case OP_JUMP_IF_NOT_LE:
+            case OP_JUMP_IF_NOT_NE:
+                instruction.stencil = jumpsIfNot[opcode - OP_JUMP_IF_NOT_LT];
+                instruction.target = jumpAddress();
+                break;
+            case OP_ADD:
+                instruction.stencil = &stencils::ADD;
+                break;
+            case OP_SUB:
+                instruction.stencil = &stencils::SUB;
+                break;
+            case OP_MUL:
+                instruction.stencil = &stencils::MUL;
+                break;
+            case OP_ADD_CONST:
+            case OP_SUB_CONST:
+                if (smallConstant(operands[0], instruction.operands[0])) {
+                    instruction.stencil = opcode == OP_ADD_CONST ? &stencils::ADD_CONST : &stencils::SUB_CONST;
+                }
+                break;
+            case OP_INC_LOCAL:
+                if (smallConstant(operands[1], instruction.operands[1])) {
+                    instruction.stencil = &stencils::INC_LOCAL;
+                    instruction.operands[0] = operands[0];
+                }
+                break;
+            case OP_COMPARE:
+                if (operands[0] < 6) {
+                    instruction.stencil = compares[operands[0]];
+                }
+                break;
+            case OP_ARRAY_GET:
+                instruction.stencil = &stencils::ARRAY_GET;
+                break;
+            case OP_ARRAY_GET_LOCAL_LOCAL:
+                instruction.stencil = &stencils::ARRAY_GET_LOCAL_LOCAL;
+                instruction.operands[0] = operands[0];
+                instruction.operands[1] = operands[1];
+                break;
+            case OP_ARRAY_SET:
+                instruction.stencil = &stencils::ARRAY_SET;
+                break;
+            default:
+                // Вызовы, создание объектов, запись глобальных переменных с барьером
+                // выполняет интерпретатор
+                break;
+        }
+        return instruction;
+    }
+#endif
+
+    std::shared_ptr<Global> global;
+
+    std::vector<std::unique_ptr<NativeCode>> compiled;
+
+    size_t codeBytes = 0;
+};
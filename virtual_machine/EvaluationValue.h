@@ -1,7 +1,16 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
-#include <variant>
+#include <vector>
 
 enum class EvaluationValueType {
     NUMBER,
@@ -10,10 +19,12 @@ enum class EvaluationValueType {
     NIL,
 };
 
-enum class ObjectType {
+enum class ObjectType : uint8_t {
     STRING,
     CODE,
     ARRAY,
+    NUMBER,
+    NATIVE,
 };
 
 struct Object {
@@ -22,35 +33,124 @@ struct Object {
     }
 
     ObjectType type;
+
+    // Служебные поля сборщика мусора (см. Heap): метка текущей сборки, признак переноса
+    // из молодого поколения, признак записи в запомненное множество и список объектов
+    // старого поколения (у перенесённого молодого объекта - адрес его копии)
+    bool marked = false;
+    bool forwarded = false;
+    bool remembered = false;
+    Object *next = nullptr;
 };
 
+// Значение занимает одно 64-битное слово (tagged pointer):
+//   ...xxxx1 - целое число (63 бита, хранится со сдвигом на 1);
+//   ...00010 - логическое значение (бит 3 - само значение);
+//   ...00110 - nil;
+//   ...xx000 - указатель на объект (объекты выровнены минимум на 8 байт).
+// Числа, не помещающиеся в 63 бита, хранятся в куче как NumberObject.
 struct EvaluationValue {
-    EvaluationValueType type;
+    static constexpr uint64_t INT_TAG = 0x1;
+    static constexpr uint64_t TAG_MASK = 0x7;
+    static constexpr uint64_t BOOLEAN_TAG = 0x2;
+    static constexpr uint64_t NIL_TAG = 0x6;
+    static constexpr uint64_t FALSE_BITS = BOOLEAN_TAG;
+    static constexpr uint64_t TRUE_BITS = BOOLEAN_TAG | 0x8;
 
+    static constexpr int64_t SMALL_NUMBER_MIN = -(int64_t(1) << 62);
+    static constexpr int64_t SMALL_NUMBER_MAX = (int64_t(1) << 62) - 1;
 
-    std::variant<bool, int64_t, Object *, std::nullptr_t> value;
+    uint64_t bits = NIL_TAG;
 
-    [[nodiscard]] bool boolean() const {
-        return std::get<bool>(value);
+    [[nodiscard]] bool isSmallNumber() const {
+        return (bits & INT_TAG) != 0;
     }
 
-    [[nodiscard]] int64_t number() const {
-        return std::get<int64_t>(value);
+    [[nodiscard]] bool isHeapReference() const {
+        return (bits & TAG_MASK) == 0;
     }
 
+    [[nodiscard]] EvaluationValueType type() const;
+
+    [[nodiscard]] bool boolean() const {
+        return bits == TRUE_BITS;
+    }
+
+    [[nodiscard]] int64_t number() const;
+
     [[nodiscard]] Object *object() const {
-        return std::get<Object *>(value);
+        return reinterpret_cast<Object *>(bits);
+    }
+
+    bool operator==(const EvaluationValue &other) const {
+        return bits == other.bits;
+    }
+
+    bool operator!=(const EvaluationValue &other) const {
+        return bits != other.bits;
     }
 };
 
+static_assert(sizeof(EvaluationValue) == 8, "EvaluationValue должен занимать одно машинное слово");
+
+struct NumberObject : Object {
+    explicit NumberObject(int64_t number) : Object(ObjectType::NUMBER), number(number) {
+    }
+
+    int64_t number;
+};
+
+inline int64_t EvaluationValue::number() const {
+    if (isSmallNumber()) {
+        return static_cast<int64_t>(bits) >> 1;
+    }
+    return static_cast<NumberObject *>(object())->number;
+}
+
+inline EvaluationValueType EvaluationValue::type() const {
+    if (isSmallNumber()) {
+        return EvaluationValueType::NUMBER;
+    }
+    switch (bits & TAG_MASK) {
+        case BOOLEAN_TAG:
+            return EvaluationValueType::BOOLEAN;
+        case NIL_TAG:
+            return EvaluationValueType::NIL;
+        default:
+            if (object() != nullptr && object()->type == ObjectType::NUMBER) {
+                return EvaluationValueType::NUMBER;
+            }
+            return EvaluationValueType::OBJECT;
+    }
+}
+
 struct StringObject : Object {
-    explicit StringObject(const std::string &str) : Object(ObjectType::STRING) {
-        this->string = str;
+    explicit StringObject(std::string str) : Object(ObjectType::STRING), string(std::move(str)) {
     }
 
     std::string string;
 };
 
+class NativeCode;
+class LoopTable;
+
+// Мономорфный кэш места вызова (OP_CALL): функция, которую вызвали здесь в последний раз,
+// уже проверена - это объект кода или встроенная функция, и число аргументов ей подходит.
+// Место вызова всегда загружает функцию из одного глобального слота; кэш действителен, пока
+// не менялась версия этого слота (GlobalVar::version): тогда функция всё ещё в слоте, жива,
+// и совпадение слова - та же функция. Записи в другие слоты кэш не сбрасывают.
+struct CallCache {
+    uint64_t callee = 0;
+
+    // 0 - пустой кэш, версии слотов начинаются с 1
+    uint64_t version = 0;
+
+    // Глобальный слот вызываемой функции
+    uint32_t slot = 0;
+
+    bool native = false;
+};
+
 struct CodeObject : public Object {
     explicit CodeObject(std::string name) : Object(ObjectType::CODE), name(std::move(name)) {
     }
@@ -66,64 +166,882 @@ struct CodeObject : public Object {
 
 
     std::unordered_map<int, std::string> localNames;
+
+
+    // Число параметров функции; аргументы занимают первые слоты локальных переменных
+    size_t arity = 0;
+
+
+    // Число слотов локальных переменных (включая параметры), вычисляется при компиляции
+    size_t localCount = 0;
+
+
+    // Максимальная глубина стека операндов, вычисляется при компиляции
+    size_t maxStackDepth = 0;
+
+
+    // Код в регистровом наборе инструкций (RegisterOpCode.h); localCount - число регистров
+    bool registerBased = false;
+
+
+    // Число вызовов и обратных переходов; на их порогах vm переводит стековый код
+    // на машинный (Tiering.h)
+    uint32_t invocations = 0;
+    uint32_t backEdges = 0;
+
+
+    // Машинный код (Jit.h), память которого принадлежит JitCache виртуальной машины
+    const NativeCode *native = nullptr;
+
+    // Счётчики и трассы заголовков циклов (TraceJit.h), память принадлежит TraceCache
+    LoopTable *loops = nullptr;
+
+    // Кэши мест вызова по номеру из операнда OP_CALL; заводятся при компиляции, по одному на вызов
+    std::vector<CallCache> callCaches;
+};
+
+struct Global;
+
+// Встроенная функция получает аргументы прямо со стека операндов, без копирования
+typedef EvaluationValue (*NativeFunction)(Global &global, const EvaluationValue *args, size_t argCount);
+
+struct NativeObject : Object {
+    NativeObject(std::string name, NativeFunction function, int arity)
+        : Object(ObjectType::NATIVE), name(std::move(name)), function(function), arity(arity) {
+    }
+
+    std::string name;
+
+    NativeFunction function;
+
+    // Число аргументов; -1 - произвольное число (например, print)
+    int arity;
 };
 
+// Пока в массиве только числа, они хранятся без тегов в numbers (вид INT64): сборщику
+// не нужно просматривать элементы, запись не требует барьера, а большим числам не нужен
+// NumberObject. Первая запись другого значения или запись с пропуском индексов переводит
+// массив в общий вид GENERIC, где элементы - значения в elements.
 struct ArrayObject : Object {
+    enum class Kind : uint8_t {
+        INT64,
+        GENERIC,
+    };
+
     ArrayObject() : Object(ObjectType::ARRAY) {
     }
 
+    size_t size() const {
+        return kind == Kind::INT64 ? numbers.size() : elements.size();
+    }
+
+    Kind kind = Kind::INT64;
+
+    std::vector<int64_t> numbers;
+
     std::vector<EvaluationValue> elements;
 };
 
+// Гистограмма пауз сборщика: в корзине 0 паузы короче 1 мкс, в корзине i - от 2^(i-1)
+// до 2^i мкс, в последней - все более долгие
+struct PauseHistogram {
+    static constexpr size_t BUCKETS = 24;
 
-inline EvaluationValue ALLOC_ARRAY() {
+    std::array<size_t, BUCKETS> counts{};
+    double maxMicros = 0;
+
+    void record(double micros) {
+        size_t bucket = 0;
+        while (bucket + 1 < BUCKETS && micros >= upperBoundMicros(bucket)) {
+            bucket++;
+        }
+        counts[bucket]++;
+        maxMicros = std::max(maxMicros, micros);
+    }
+
+    static double upperBoundMicros(size_t bucket) {
+        return static_cast<double>(uint64_t(1) << bucket);
+    }
+
+    size_t total() const {
+        size_t total = 0;
+        for (size_t count: counts) {
+            total += count;
+        }
+        return total;
+    }
+
+    // Верхняя граница корзины, в которую попадает доля fraction самых коротких пауз
+    double percentileMicros(double fraction) const {
+        size_t target = static_cast<size_t>(fraction * total());
+        size_t seen = 0;
+        for (size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+            seen += counts[bucket];
+            if (seen > target) {
+                return bucket + 1 < BUCKETS ? upperBoundMicros(bucket) : maxMicros;
+            }
+        }
+        return 0;
+    }
+};
+
+// Статистика сборщика мусора
+struct GcStats {
+    // Завершённые циклы сборки старого поколения (mark-and-sweep всей кучи)
+    size_t collections = 0;
+
+    // Малые сборки: выжившие объекты молодого поколения переносятся в старое
+    size_t minorCollections = 0;
+    size_t bytesPromoted = 0;
+
+    // Всего выделено и освобождено за время жизни кучи
+    size_t bytesAllocated = 0;
+    size_t bytesFreed = 0;
+    size_t objectsFreed = 0;
+
+    // Объекты старого поколения сейчас: пережившие последнюю сборку и созданные после неё
+    size_t heapObjects = 0;
+    size_t heapBytes = 0;
+
+    // Паузы с работой по старому поколению в миллисекундах: полная сборка целиком
+    // или одна порция инкрементальной
+    size_t pauses = 0;
+    double totalPauseMs = 0;
+    double lastPauseMs = 0;
+    double maxPauseMs = 0;
+
+    // Паузы малых сборок в миллисекундах
+    double totalMinorPauseMs = 0;
+    double lastMinorPauseMs = 0;
+    double maxMinorPauseMs = 0;
+
+    // Все остановки программы сборщиком; вложенная малая сборка входит в объемлющую паузу
+    PauseHistogram pauseHistogram;
+};
+
+// Куча объектов одной vm из двух поколений.
+//
+// Молодое поколение (nursery) - непрерывный буфер, строки, массивы и большие числа
+// выделяются в нём сдвигом указателя. Малая сборка переносит достижимые молодые
+// объекты в старое поколение (конструктором перемещения) и освобождает буфер целиком.
+// Корни малой сборки - корни vm и запомненное множество: старые объекты, в которые
+// барьер записи (writeBarrier) сохранил ссылку на молодой объект.
+//
+// Старое поколение - объекты в отдельных блоках, связанные в список через Object::next;
+// сборка - точный mark-and-sweep, корни перечисляет владелец кучи (vm) после startMarking().
+// Объекты кода и встроенные функции, а также всё, что создано внутри TenuredScope,
+// сразу попадают в старое поколение.
+//
+// В инкрементальном режиме (setIncremental) разметка и очистка старого поколения идут
+// порциями между инструкциями программы, каждая порция - не дольше setMaxPauseMicros()
+// или, если задан setMaxSliceWork(), не больше заданного числа просмотренных объектов.
+// Разметка трёхцветная: белые объекты не отмечены, серые отмечены и лежат в grayStack_,
+// чёрные отмечены и просмотрены. Барьер записи красит сохраняемый старый объект в серый,
+// поэтому чёрный объект не ссылается на белый; созданные во время разметки объекты
+// сразу отмечены (объекты со ссылками - серые). Корни, которые меняются без барьера
+// (стек, глобальные переменные), vm просматривает ещё раз в конце разметки.
+//
+// ALLOC_* и NUMBER создают объекты в активной куче потока (Heap::Scope);
+// объекты, созданные вне vm, сборщиком не управляются.
+//
+// Метка "живой" - совпадение Object::marked с markBit_, который меняется в начале
+// каждой полной сборки, поэтому снимать метки с выживших объектов не нужно.
+class Heap {
+public:
+    // Полная сборка запускается, когда объём старого поколения достигает порога; после
+    // сборки порог - объём выживших объектов, умноженный на GROWTH_FACTOR, но не меньше минимального
+    static constexpr size_t DEFAULT_THRESHOLD = 1024 * 1024;
+    static constexpr size_t GROWTH_FACTOR = 2;
+
+    static constexpr size_t DEFAULT_NURSERY_SIZE = 256 * 1024;
+
+    // Малая сборка запрашивается, когда в молодом поколении остаётся меньше NURSERY_RESERVE байт.
+    // Между безопасными точками создаётся не больше нескольких объектов, а если буфер всё же
+    // кончится, объект создаётся сразу в старом поколении.
+    static constexpr size_t NURSERY_RESERVE = 1024;
+
+    // Инкрементальная сборка: порция работы после каждых SLICE_ALLOCATION выделенных байт,
+    // время проверяется раз в SLICE_CHECK_INTERVAL просмотренных объектов или элементов массивов
+    static constexpr size_t DEFAULT_MAX_PAUSE_MICROS = 1000;
+    static constexpr size_t SLICE_ALLOCATION = 64 * 1024;
+    static constexpr size_t SLICE_CHECK_INTERVAL = 256;
+
+    enum class Phase : uint8_t {
+        IDLE,
+        MARKING,
+        SWEEPING,
+    };
+
+    Heap() {
+        setNurserySize(DEFAULT_NURSERY_SIZE);
+    }
+
+    Heap(const Heap &) = delete;
+
+    Heap &operator=(const Heap &) = delete;
+
+    ~Heap() {
+        destroyNursery();
+        freeList(objects_);
+        freeList(sweepAllocated_);
+    }
+
+    static Heap *&active() {
+        thread_local Heap *heap = nullptr;
+        return heap;
+    }
+
+    // Делает кучу активной на время жизни объекта
+    class Scope {
+    public:
+        explicit Scope(Heap &heap) : previous_(active()) {
+            active() = &heap;
+        }
+
+        ~Scope() {
+            active() = previous_;
+        }
+
+        Scope(const Scope &) = delete;
+
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        Heap *previous_;
+    };
+
+    // Объекты, созданные на время жизни TenuredScope, сразу попадают в старое поколение.
+    // Так создаются константы при компиляции: у объектов кода нет барьера записи.
+    class TenuredScope {
+    public:
+        explicit TenuredScope(Heap &heap) : heap_(heap), previous_(heap.tenured_) {
+            heap.tenured_ = true;
+        }
+
+        ~TenuredScope() {
+            heap_.tenured_ = previous_;
+        }
+
+        TenuredScope(const TenuredScope &) = delete;
+
+        TenuredScope &operator=(const TenuredScope &) = delete;
+
+    private:
+        Heap &heap_;
+        bool previous_;
+    };
+
+    template<typename T, typename... Args>
+    T *allocate(Args &&... args) {
+        if constexpr (isMovable<T>()) {
+            constexpr size_t size = youngSize(sizeof(T));
+            if (!tenured_ && size <= static_cast<size_t>(nurseryEnd_ - nurseryCursor_)) {
+                T *object = new(nurseryCursor_) T(std::forward<Args>(args)...);
+                nurseryCursor_ += size;
+                stats_.bytesAllocated += size;
+                return object;
+            }
+        }
+        T *object = new T(std::forward<Args>(args)...);
+        link(object);
+        account(objectSize(object));
+        return object;
+    }
+
+    // Учёт памяти, выделенной уже существующим объектом старого поколения (например, при росте массива)
+    void account(size_t bytes) {
+        stats_.bytesAllocated += bytes;
+        stats_.heapBytes += bytes;
+    }
+
+    bool isYoung(const Object *object) const {
+        return static_cast<size_t>(reinterpret_cast<const char *>(object) - nursery_.get()) < nurserySize_;
+    }
+
+    bool isYoung(const EvaluationValue &value) const {
+        return value.isHeapReference() && isYoung(value.object());
+    }
+
+    // Барьер записи: ссылка value сохранена в объект owner. Молодой объект делает owner
+    // корнем малой сборки, старый во время разметки становится серым.
+    void writeBarrier(Object *owner, const EvaluationValue &value) {
+        if (!value.isHeapReference() || isYoung(owner)) {
+            return;
+        }
+        if (isYoung(value.object())) {
+            if (!owner->remembered) {
+                owner->remembered = true;
+                remembered_.push_back(owner);
+            }
+        } else if (phase_ == Phase::MARKING) {
+            markValue(value);
+        }
+    }
+
+    // Пора начать сборку старого поколения или, если цикл уже идёт, выполнить следующую порцию
+    bool needsCollection() const {
+        if (phase_ == Phase::IDLE) {
+            return stats_.heapBytes >= nextCollection_;
+        }
+        return stats_.bytesAllocated >= nextSlice_;
+    }
+
+    // Программа выделяет память быстрее, чем идёт инкрементальная сборка: цикл пора
+    // завершить за одну паузу
+    bool exceedsLimit() const {
+        return phase_ != Phase::IDLE && stats_.heapBytes >= nextCollection_ * GROWTH_FACTOR;
+    }
+
+    bool needsYoungCollection() const {
+        return static_cast<size_t>(nurseryEnd_ - nurseryCursor_) < NURSERY_RESERVE;
+    }
+
+    // Минимальный порог запуска полной сборки в байтах
+    void setThreshold(size_t bytes) {
+        threshold_ = bytes;
+        nextCollection_ = std::max(threshold_, stats_.heapBytes);
+    }
+
+    // Размер молодого поколения; менять можно только пока в нём нет объектов
+    void setNurserySize(size_t bytes) {
+        if (nurseryCursor_ != nursery_.get()) {
+            throw std::runtime_error("Размер молодого поколения меняется только до создания объектов.");
+        }
+        nurserySize_ = std::max(bytes, 2 * NURSERY_RESERVE);
+        nursery_.reset(new char[nurserySize_]);
+        nurseryCursor_ = nursery_.get();
+        nurseryEnd_ = nurseryCursor_ + nurserySize_;
+    }
+
+    size_t nurseryUsed() const {
+        return nurseryCursor_ - nursery_.get();
+    }
+
+    void setIncremental(bool incremental) {
+        incremental_ = incremental;
+    }
+
+    bool incremental() const {
+        return incremental_;
+    }
+
+    // Целевая длительность одной паузы инкрементальной сборки. Конец разметки (повторный
+    // просмотр корней) и малые сборки этим значением не ограничены.
+    void setMaxPauseMicros(size_t micros) {
+        maxPause_ = std::chrono::microseconds(micros);
+    }
+
+    size_t maxPauseMicros() const {
+        return static_cast<size_t>(maxPause_.count());
+    }
+
+    // Порция ограничивается числом просмотренных объектов и элементов массивов вместо
+    // времени (с точностью до SLICE_CHECK_INTERVAL): ход сборки не зависит от скорости
+    // машины. 0 - ограничение по времени (setMaxPauseMicros).
+    void setMaxSliceWork(size_t work) {
+        maxSliceWork_ = work;
+    }
+
+    Phase phase() const {
+        return phase_;
+    }
+
+    const GcStats &stats() const {
+        return stats_;
+    }
+
+    // --- Паузы ---
+
+    // Остановка программы сборщиком; вложенные паузы входят во внешнюю
+    void beginPause() {
+        if (pauseDepth_++ == 0) {
+            pauseStart_ = std::chrono::steady_clock::now();
+            oldGenerationWork_ = false;
+        }
+    }
+
+    void endPause() {
+        if (--pauseDepth_ != 0) {
+            return;
+        }
+        auto duration = std::chrono::steady_clock::now() - pauseStart_;
+        stats_.pauseHistogram.record(std::chrono::duration<double, std::micro>(duration).count());
+        if (oldGenerationWork_) {
+            double pauseMs = std::chrono::duration<double, std::milli>(duration).count();
+            stats_.pauses++;
+            stats_.lastPauseMs = pauseMs;
+            stats_.totalPauseMs += pauseMs;
+            stats_.maxPauseMs = std::max(stats_.maxPauseMs, pauseMs);
+        }
+    }
+
+    // --- Малая сборка ---
+
+    void beginYoungCollection() {
+        beginPause();
+        minorStart_ = std::chrono::steady_clock::now();
+    }
+
+    // Обновляет ссылку из корня: молодой объект переносится в старое поколение
+    void evacuate(EvaluationValue &slot) {
+        if (isYoung(slot)) {
+            slot.bits = reinterpret_cast<uint64_t>(promote(slot.object()));
+        }
+    }
+
+    // Обходит запомненные объекты и перенесённые объекты, затем освобождает молодое поколение
+    void finishYoungCollection() {
+        for (Object *object: remembered_) {
+            object->remembered = false;
+            scanYoungReferences(object);
+        }
+        remembered_.clear();
+
+        while (!promotedStack_.empty()) {
+            Object *object = promotedStack_.back();
+            promotedStack_.pop_back();
+            scanYoungReferences(object);
+        }
+
+        destroyNursery();
+        nurseryCursor_ = nursery_.get();
+
+        double pauseMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - minorStart_).count();
+        stats_.minorCollections++;
+        stats_.lastMinorPauseMs = pauseMs;
+        stats_.totalMinorPauseMs += pauseMs;
+        stats_.maxMinorPauseMs = std::max(stats_.maxMinorPauseMs, pauseMs);
+        endPause();
+    }
+
+    // --- Сборка старого поколения (вызывается внутри паузы) ---
+
+    // Начинает разметку: все старые объекты становятся белыми. Корни отмечает vm.
+    void startMarking() {
+        oldGenerationWork_ = true;
+        markBit_ = !markBit_;
+        phase_ = Phase::MARKING;
+        scheduleSlice();
+    }
+
+    // Молодые объекты не размечаются: живые попадут в старое поколение при малой сборке
+    // и станут серыми там
+    void markValue(const EvaluationValue &value) {
+        if (value.isHeapReference() && value.object() != nullptr && !isYoung(value.object())) {
+            markObject(value.object());
+        }
+    }
+
+    void markObject(Object *object) {
+        if (object->marked == markBit_) {
+            return;
+        }
+        object->marked = markBit_;
+        grayStack_.push_back({object, 0});
+    }
+
+    bool isMarked(const Object *object) const {
+        return object->marked == markBit_;
+    }
+
+    // Порция разметки до конца паузы; true, если серых объектов не осталось
+    bool markSlice() {
+        sliceWork_ = 0;
+        bool done = processGray(true);
+        scheduleSlice();
+        return done;
+    }
+
+    // Обход ссылок из отмеченных объектов, пока не останется необработанных
+    void traceReferences() {
+        processGray(false);
+    }
+
+    // Разметка закончена: начинается очистка
+    void startSweeping() {
+        oldGenerationWork_ = true;
+        phase_ = Phase::SWEEPING;
+        sweepLink_ = &objects_;
+        sweptObjects_ = 0;
+        sweptBytes_ = 0;
+        heapObjectsAtSweep_ = stats_.heapObjects;
+        heapBytesAtSweep_ = stats_.heapBytes;
+        scheduleSlice();
+    }
+
+    // Порция очистки до конца паузы; true, если цикл сборки завершён
+    bool sweepSlice() {
+        sliceWork_ = 0;
+        bool done = sweep(true);
+        scheduleSlice();
+        return done;
+    }
+
+    void sweepAll() {
+        sweep(false);
+    }
+
+    // Приблизительный размер объекта вместе с его буферами
+    static size_t objectSize(const Object *object) {
+        switch (object->type) {
+            case ObjectType::STRING:
+                return sizeof(StringObject) + static_cast<const StringObject *>(object)->string.capacity();
+            case ObjectType::ARRAY: {
+                auto *array = static_cast<const ArrayObject *>(object);
+                return sizeof(ArrayObject) + array->numbers.capacity() * sizeof(int64_t) +
+                       array->elements.capacity() * sizeof(EvaluationValue);
+            }
+            case ObjectType::CODE: {
+                auto *code = static_cast<const CodeObject *>(object);
+                return sizeof(CodeObject) + code->code.capacity() +
+                       code->constants.capacity() * sizeof(EvaluationValue);
+            }
+            case ObjectType::NUMBER:
+                return sizeof(NumberObject);
+            case ObjectType::NATIVE:
+                return sizeof(NativeObject);
+        }
+        return sizeof(Object);
+    }
+
+private:
+    // В молодом поколении живут только объекты, которые можно переместить: на строки,
+    // массивы и числа ссылаются лишь значения, а на объекты кода - ещё и фреймы
+    template<typename T>
+    static constexpr bool isMovable() {
+        return std::is_same_v<T, StringObject> || std::is_same_v<T, ArrayObject> ||
+               std::is_same_v<T, NumberObject>;
+    }
+
+    // Размер объекта в молодом поколении с выравниванием под указатель-значение
+    static constexpr size_t youngSize(size_t size) {
+        return (size + 7) & ~size_t(7);
+    }
+
+    static size_t youngSize(ObjectType type) {
+        switch (type) {
+            case ObjectType::STRING:
+                return youngSize(sizeof(StringObject));
+            case ObjectType::ARRAY:
+                return youngSize(sizeof(ArrayObject));
+            default:
+                return youngSize(sizeof(NumberObject));
+        }
+    }
+
+    // Новый объект старого поколения сразу отмечен. Во время разметки объект со ссылками
+    // ещё и серый: его ссылки просматриваются, во время очистки он ждёт её конца в
+    // отдельном списке.
+    void link(Object *object) {
+        object->marked = markBit_;
+        if (phase_ == Phase::SWEEPING) {
+            object->next = sweepAllocated_;
+            sweepAllocated_ = object;
+        } else {
+            object->next = objects_;
+            objects_ = object;
+            if (phase_ == Phase::MARKING && (object->type == ObjectType::ARRAY || object->type == ObjectType::CODE)) {
+                grayStack_.push_back({object, 0});
+            }
+        }
+        stats_.heapObjects++;
+    }
+
+    void scheduleSlice() {
+        nextSlice_ = stats_.bytesAllocated + SLICE_ALLOCATION;
+    }
+
+    // Вызывается раз в SLICE_CHECK_INTERVAL единиц работы
+    bool pauseExpired() {
+        if (maxSliceWork_ != 0) {
+            sliceWork_ += SLICE_CHECK_INTERVAL;
+            return sliceWork_ >= maxSliceWork_;
+        }
+        return std::chrono::steady_clock::now() - pauseStart_ >= maxPause_;
+    }
+
+    // Просматривает серые объекты; bounded - остановиться, когда кончится время паузы.
+    // Большой массив просматривается частями, остаток возвращается в grayStack_.
+    bool processGray(bool bounded) {
+        oldGenerationWork_ = true;
+        size_t work = 0;
+        while (!grayStack_.empty()) {
+            if (bounded && work >= SLICE_CHECK_INTERVAL) {
+                if (pauseExpired()) {
+                    return false;
+                }
+                work = 0;
+            }
+            GrayObject gray = grayStack_.back();
+            grayStack_.pop_back();
+            work++;
+            switch (gray.object->type) {
+                case ObjectType::ARRAY: {
+                    const auto &elements = static_cast<ArrayObject *>(gray.object)->elements;
+                    size_t end = elements.size();
+                    if (bounded && end > gray.next + SLICE_CHECK_INTERVAL) {
+                        end = gray.next + SLICE_CHECK_INTERVAL;
+                        grayStack_.push_back({gray.object, end});
+                    }
+                    for (size_t i = gray.next; i < end; ++i) {
+                        markValue(elements[i]);
+                    }
+                    work += end - std::min(end, gray.next);
+                    break;
+                }
+                case ObjectType::CODE:
+                    for (const EvaluationValue &constant: static_cast<CodeObject *>(gray.object)->constants) {
+                        markValue(constant);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        return true;
+    }
+
+    // Освобождает неотмеченные объекты; в конце цикла созданные за время очистки объекты
+    // присоединяются к списку и обновляется статистика
+    bool sweep(bool bounded) {
+        oldGenerationWork_ = true;
+        size_t work = 0;
+        while (*sweepLink_ != nullptr) {
+            if (bounded && ++work % SLICE_CHECK_INTERVAL == 0 && pauseExpired()) {
+                return false;
+            }
+            Object *object = *sweepLink_;
+            size_t size = objectSize(object);
+            if (object->marked == markBit_) {
+                sweptObjects_++;
+                sweptBytes_ += size;
+                sweepLink_ = &object->next;
+            } else {
+                *sweepLink_ = object->next;
+                stats_.objectsFreed++;
+                stats_.bytesFreed += size;
+                freeObject(object);
+            }
+        }
+
+        *sweepLink_ = sweepAllocated_;
+        sweepAllocated_ = nullptr;
+        phase_ = Phase::IDLE;
+
+        stats_.heapObjects = sweptObjects_ + (stats_.heapObjects - heapObjectsAtSweep_);
+        stats_.heapBytes = sweptBytes_ + (stats_.heapBytes - heapBytesAtSweep_);
+        nextCollection_ = std::max(threshold_, stats_.heapBytes * GROWTH_FACTOR);
+        stats_.collections++;
+        return true;
+    }
+
+    static void freeList(Object *object) {
+        while (object != nullptr) {
+            Object *next = object->next;
+            freeObject(object);
+            object = next;
+        }
+    }
+
+    // Переносит молодой объект в старое поколение; повторный вызов вернёт уже перенесённую копию
+    Object *promote(Object *object) {
+        if (object->forwarded) {
+            return object->next;
+        }
+
+        Object *copy;
+        switch (object->type) {
+            case ObjectType::STRING:
+                copy = new StringObject(std::move(*static_cast<StringObject *>(object)));
+                break;
+            case ObjectType::ARRAY:
+                copy = new ArrayObject(std::move(*static_cast<ArrayObject *>(object)));
+                promotedStack_.push_back(copy);
+                break;
+            default:
+                copy = new NumberObject(*static_cast<NumberObject *>(object));
+                break;
+        }
+        copy->forwarded = false;
+        copy->remembered = false;
+        link(copy);
+
+        size_t size = objectSize(copy);
+        stats_.heapBytes += size;
+        stats_.bytesPromoted += size;
+
+        // Адрес копии хранится на месте ссылки на следующий объект
+        object->forwarded = true;
+        object->next = copy;
+        return copy;
+    }
+
+    void scanYoungReferences(Object *object) {
+        if (object->type == ObjectType::ARRAY) {
+            for (EvaluationValue &element: static_cast<ArrayObject *>(object)->elements) {
+                evacuate(element);
+            }
+        }
+    }
+
+    // Вызывает деструкторы всех объектов молодого поколения (у перенесённых остались пустые оболочки)
+    void destroyNursery() {
+        char *cursor = nursery_.get();
+        while (cursor < nurseryCursor_) {
+            auto *object = reinterpret_cast<Object *>(cursor);
+            size_t size = youngSize(object->type);
+            if (!object->forwarded) {
+                stats_.objectsFreed++;
+                stats_.bytesFreed += size;
+            }
+            freeYoungObject(object);
+            cursor += size;
+        }
+    }
+
+    static void freeYoungObject(Object *object) {
+        switch (object->type) {
+            case ObjectType::STRING:
+                static_cast<StringObject *>(object)->~StringObject();
+                break;
+            case ObjectType::ARRAY:
+                static_cast<ArrayObject *>(object)->~ArrayObject();
+                break;
+            default:
+                static_cast<NumberObject *>(object)->~NumberObject();
+                break;
+        }
+    }
+
+    // У Object нет виртуального деструктора, поэтому удаление - по типу
+    static void freeObject(Object *object) {
+        switch (object->type) {
+            case ObjectType::STRING:
+                delete static_cast<StringObject *>(object);
+                break;
+            case ObjectType::CODE:
+                delete static_cast<CodeObject *>(object);
+                break;
+            case ObjectType::ARRAY:
+                delete static_cast<ArrayObject *>(object);
+                break;
+            case ObjectType::NUMBER:
+                delete static_cast<NumberObject *>(object);
+                break;
+            case ObjectType::NATIVE:
+                delete static_cast<NativeObject *>(object);
+                break;
+        }
+    }
+
+    // Молодое поколение
+    std::unique_ptr<char[]> nursery_;
+    size_t nurserySize_ = 0;
+    char *nurseryCursor_ = nullptr;
+    char *nurseryEnd_ = nullptr;
+    bool tenured_ = false;
+
+    // Старые объекты со ссылками на молодые и перенесённые массивы, которые ещё не просмотрены
+    std::vector<Object *> remembered_;
+    std::vector<Object *> promotedStack_;
+
+    // Серый объект; у массива next - первый ещё не просмотренный элемент
+    struct GrayObject {
+        Object *object;
+        size_t next;
+    };
+
+    // Старое поколение
+    Object *objects_ = nullptr;
+    std::vector<GrayObject> grayStack_;
+    bool markBit_ = false;
+    Phase phase_ = Phase::IDLE;
+
+    // Очистка: ссылка на следующий непроверенный объект, выжившие объекты и объекты,
+    // созданные за время очистки
+    Object **sweepLink_ = nullptr;
+    Object *sweepAllocated_ = nullptr;
+    size_t sweptObjects_ = 0;
+    size_t sweptBytes_ = 0;
+    size_t heapObjectsAtSweep_ = 0;
+    size_t heapBytesAtSweep_ = 0;
+
+    size_t threshold_ = DEFAULT_THRESHOLD;
+    size_t nextCollection_ = DEFAULT_THRESHOLD;
+
+    bool incremental_ = false;
+    std::chrono::steady_clock::duration maxPause_ = std::chrono::microseconds(DEFAULT_MAX_PAUSE_MICROS);
+    size_t maxSliceWork_ = 0;
+    size_t sliceWork_ = 0;
+    size_t nextSlice_ = 0;
+
+    GcStats stats_;
+    size_t pauseDepth_ = 0;
+    bool oldGenerationWork_ = false;
+    std::chrono::steady_clock::time_point pauseStart_;
+    std::chrono::steady_clock::time_point minorStart_;
+};
+
+// Создаёт объект в активной куче, если она есть
+template<typename T, typename... Args>
+inline T *NEW_OBJECT(Args &&... args) {
+    if (Heap *heap = Heap::active()) {
+        return heap->allocate<T>(std::forward<Args>(args)...);
+    }
+    return new T(std::forward<Args>(args)...);
+}
+
+
+inline EvaluationValue OBJECT(Object *object) {
     EvaluationValue val;
-    val.type = EvaluationValueType::OBJECT;
-    val.value = static_cast<Object *>(new ArrayObject());
+    val.bits = reinterpret_cast<uint64_t>(object);
     return val;
 }
 
+inline EvaluationValue ALLOC_ARRAY() {
+    return OBJECT(NEW_OBJECT<ArrayObject>());
+}
+
 
 inline ArrayObject *AS_ARRAY(const EvaluationValue &value) {
     return static_cast<ArrayObject *>(value.object());
 }
 
 inline EvaluationValue NUMBER(int64_t value) {
+    if (value < EvaluationValue::SMALL_NUMBER_MIN || value > EvaluationValue::SMALL_NUMBER_MAX) {
+        return OBJECT(NEW_OBJECT<NumberObject>(value));
+    }
     EvaluationValue val;
-    val.type = EvaluationValueType::NUMBER;
-    val.value = value;
+    val.bits = (static_cast<uint64_t>(value) << 1) | EvaluationValue::INT_TAG;
     return val;
 }
 
 inline EvaluationValue BOOLEAN(bool value) {
     EvaluationValue val;
-    val.type = EvaluationValueType::BOOLEAN;
-    val.value = value;
+    val.bits = value ? EvaluationValue::TRUE_BITS : EvaluationValue::FALSE_BITS;
     return val;
 }
 
 inline EvaluationValue NIL() {
     EvaluationValue val;
-    val.type = EvaluationValueType::NIL;
-    val.value = nullptr;
+    val.bits = EvaluationValue::NIL_TAG;
     return val;
 }
 
 inline EvaluationValue ALLOC_STRING(std::string value) {
-    EvaluationValue val;
-    val.type = EvaluationValueType::OBJECT;
-    val.value = static_cast<Object *>(new StringObject(value));
-    return val;
+    return OBJECT(NEW_OBJECT<StringObject>(std::move(value)));
 }
 
 inline EvaluationValue ALLOC_CODE(std::string value) {
-    EvaluationValue val;
-    val.type = EvaluationValueType::OBJECT;
-    val.value = static_cast<Object *>(new CodeObject(value));
-    return val;
+    return OBJECT(NEW_OBJECT<CodeObject>(value));
 }
 
-inline double AS_NUMBER(const EvaluationValue &value) {
+inline EvaluationValue ALLOC_NATIVE(std::string name, NativeFunction function, int arity) {
+    return OBJECT(NEW_OBJECT<NativeObject>(std::move(name), function, arity));
+}
+
+inline int64_t AS_NUMBER(const EvaluationValue &value) {
     return value.number();
 }
 
@@ -143,24 +1061,28 @@ inline CodeObject *AS_CODE(const EvaluationValue &evaValue) {
     return static_cast<CodeObject *>(evaValue.object());
 }
 
+inline NativeObject *AS_NATIVE(const EvaluationValue &evaValue) {
+    return static_cast<NativeObject *>(evaValue.object());
+}
+
 inline bool IS_NIL(const EvaluationValue &value) {
-    return value.type == EvaluationValueType::NIL;
+    return value.bits == EvaluationValue::NIL_TAG;
+}
+
+inline bool IS_OBJECT_TYPE(const EvaluationValue &value, const ObjectType &objectType) {
+    return value.isHeapReference() and value.object() != nullptr and value.object()->type == objectType;
 }
 
 inline bool IS_NUMBER(const EvaluationValue &value) {
-    return value.type == EvaluationValueType::NUMBER;
+    return value.isSmallNumber() or IS_OBJECT_TYPE(value, ObjectType::NUMBER);
 }
 
 inline bool IS_BOOL(const EvaluationValue &value) {
-    return value.type == EvaluationValueType::BOOLEAN;
+    return (value.bits & ~uint64_t(0x8)) == EvaluationValue::BOOLEAN_TAG;
 }
 
 inline bool IS_OBJECT(const EvaluationValue &value) {
-    return value.type == EvaluationValueType::OBJECT;
-}
-
-inline bool IS_OBJECT_TYPE(const EvaluationValue &value, const ObjectType &objectType) {
-    return IS_OBJECT(value) and value.object()->type == objectType;
+    return value.isHeapReference() and !IS_OBJECT_TYPE(value, ObjectType::NUMBER);
 }
 
 
@@ -176,9 +1098,13 @@ inline bool IS_CODE(const EvaluationValue &value) {
     return IS_OBJECT_TYPE(value, ObjectType::CODE);
 }
 
+inline bool IS_NATIVE(const EvaluationValue &value) {
+    return IS_OBJECT_TYPE(value, ObjectType::NATIVE);
+}
+
 inline std::string evaluationValueToConstantString(const EvaluationValue &evaluationValue) {
     std::stringstream ss;
-    switch (evaluationValue.type) {
+    switch (evaluationValue.type()) {
         case EvaluationValueType::NUMBER:
             ss << evaluationValue.number();
             break;
@@ -202,9 +1128,13 @@ inline std::string evaluationValueToConstantString(const EvaluationValue &evalua
                 case ObjectType::ARRAY: {
                     ArrayObject *arrObj = static_cast<ArrayObject *>(evaluationValue.object());
                     ss << "[";
-                    for (size_t i = 0; i < arrObj->elements.size(); ++i) {
-                        ss << evaluationValueToConstantString(arrObj->elements[i]);
-                        if (i < arrObj->elements.size() - 1) {
+                    for (size_t i = 0; i < arrObj->size(); ++i) {
+                        if (arrObj->kind == ArrayObject::Kind::INT64) {
+                            ss << arrObj->numbers[i];
+                        } else {
+                            ss << evaluationValueToConstantString(arrObj->elements[i]);
+                        }
+                        if (i < arrObj->size() - 1) {
                             ss << ", ";
                         }
                     }
@@ -216,6 +1146,11 @@ inline std::string evaluationValueToConstantString(const EvaluationValue &evalua
                     ss << "<Объект кода " << codeObj->name << ">";
                     break;
                 }
+                case ObjectType::NATIVE: {
+                    NativeObject *nativeObj = static_cast<NativeObject *>(evaluationValue.object());
+                    ss << "<Встроенная функция " << nativeObj->name << ">";
+                    break;
+                }
                 default:
                     ss << " неизвестный тип объекта, по-хорошему,вас здесь не должно быть ";
                     break;
@@ -224,7 +1159,7 @@ inline std::string evaluationValueToConstantString(const EvaluationValue &evalua
         default:
             throw std::runtime_error(
                 " неизвестный тип вычисляемого значения, по-хорошему,вас здесь не должно быть " + std::to_string(
-                    static_cast<int>(evaluationValue.type)));
+                    static_cast<int>(evaluationValue.type())));
     }
     return ss.str();
 }
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include "EvaluationValue.h"
+
+// Быстрые пути арифметики, сравнений и массивов чисел: малые целые (int63 с тегом в младшем
+// бите) и массивы Kind::INT64. Функция возвращает false, если операнды не подходят или
+// результат не помещается в малое целое; тогда работу выполняет общий путь обработчика.
+//
+// Одни и те же функции вызывают обработчики стековых инструкций и цикл регистрового кода (vm.h)
+// и трафареты JIT-компилятора (stencils/stencils.cpp), поэтому смысл быстрого пути задан
+// в одном месте. Функции не обращаются к куче и не бросают исключений: трафарет - это код
+// без вызовов и без данных, кроме дыр.
+
+inline bool smallNumbers(EvaluationValue left, EvaluationValue right) {
+    return (left.bits & right.bits & EvaluationValue::INT_TAG) != 0;
+}
+
+// (2a + 1) + (2b + 1) - 1 = 2(a + b) + 1
+inline bool addSmall(EvaluationValue left, EvaluationValue right, EvaluationValue &result) {
+    int64_t sum;
+    if (!smallNumbers(left, right) ||
+        __builtin_add_overflow(static_cast<int64_t>(left.bits), static_cast<int64_t>(right.bits - 1), &sum)) {
+        return false;
+    }
+    result.bits = static_cast<uint64_t>(sum);
+    return true;
+}
+
+// (2a + 1) - (2b + 1) = 2(a - b)
+inline bool subSmall(EvaluationValue left, EvaluationValue right, EvaluationValue &result) {
+    int64_t difference;
+    if (!smallNumbers(left, right) ||
+        __builtin_sub_overflow(static_cast<int64_t>(left.bits), static_cast<int64_t>(right.bits), &difference)) {
+        return false;
+    }
+    result.bits = static_cast<uint64_t>(difference) | EvaluationValue::INT_TAG;
+    return true;
+}
+
+// 2a * b + 1
+inline bool mulSmall(EvaluationValue left, EvaluationValue right, EvaluationValue &result) {
+    int64_t product;
+    if (!smallNumbers(left, right) ||
+        __builtin_mul_overflow(static_cast<int64_t>(left.bits - 1), static_cast<int64_t>(right.bits) >> 1,
+                               &product)) {
+        return false;
+    }
+    result.bits = static_cast<uint64_t>(product) | EvaluationValue::INT_TAG;
+    return true;
+}
+
+// Сравнение малых целых; код - операнд OP_COMPARE (bytecodeGenerator::compareOperator).
+// Слова малых целых упорядочены так же, как числа, поэтому распаковка не нужна.
+inline bool compareSmall(uint8_t compareOp, EvaluationValue left, EvaluationValue right) {
+    auto l = static_cast<int64_t>(left.bits);
+    auto r = static_cast<int64_t>(right.bits);
+    switch (compareOp) {
+        case 0: return l < r;
+        case 1: return l > r;
+        case 2: return l == r;
+        case 3: return l >= r;
+        case 4: return l <= r;
+        default: return l != r;
+    }
+}
+
+// Массив чисел, если arrayVal - массив Kind::INT64 и indexVal - индекс в его границах
+inline ArrayObject *numberArray(EvaluationValue arrayVal, EvaluationValue indexVal) {
+    if (!arrayVal.isHeapReference() || arrayVal.bits == 0 || !indexVal.isSmallNumber()) {
+        return nullptr;
+    }
+    Object *object = arrayVal.object();
+    if (object->type != ObjectType::ARRAY) {
+        return nullptr;
+    }
+    auto *array = static_cast<ArrayObject *>(object);
+    if (array->kind != ArrayObject::Kind::INT64 ||
+        static_cast<uint64_t>(static_cast<int64_t>(indexVal.bits) >> 1) >= array->numbers.size()) {
+        return nullptr;
+    }
+    return array;
+}
+
+// Элемент массива чисел как малое целое
+inline bool getNumberElement(EvaluationValue arrayVal, EvaluationValue indexVal, EvaluationValue &result) {
+    const ArrayObject *array = numberArray(arrayVal, indexVal);
+    if (array == nullptr) {
+        return false;
+    }
+    int64_t number = array->numbers[static_cast<int64_t>(indexVal.bits) >> 1];
+    int64_t doubled;
+    if (__builtin_add_overflow(number, number, &doubled)) {
+        return false;
+    }
+    result.bits = static_cast<uint64_t>(doubled) | EvaluationValue::INT_TAG;
+    return true;
+}
+
+// Запись малого целого в массив чисел
+inline bool setNumberElement(EvaluationValue arrayVal, EvaluationValue indexVal, EvaluationValue value) {
+    ArrayObject *array = numberArray(arrayVal, indexVal);
+    if (array == nullptr || !value.isSmallNumber()) {
+        return false;
+    }
+    array->numbers[static_cast<int64_t>(indexVal.bits) >> 1] = static_cast<int64_t>(value.bits) >> 1;
+    return true;
+}
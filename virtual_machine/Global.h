@@ -1,70 +1,63 @@
 #pragma once
 
-#include <unordered_map>
-#include <functional>
+#include <iostream>
 #include <random>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "EvaluationValue.h"
 
 struct GlobalVar {
     std::string name;
     EvaluationValue value;
+
+    // Слот уже в списке корней малой сборки (см. vm::setGlobal)
+    bool remembered = false;
+
+    // Растёт при каждой записи; по ней кэши мест вызова (CallCache) узнают, что функция сменилась
+    uint64_t version = 1;
 };
 
 
 struct Global {
     std::vector<GlobalVar> globals;
 
-    std::mt19937 rng;
+    // Индекс имя -> номер слота в globals; слоты только добавляются, поэтому индекс не устаревает
+    std::unordered_map<std::string, size_t> globalIndex;
 
-    // Таблица встроенных функций: имя функции -> указатель на функцию
-    std::unordered_map<std::string, std::function<EvaluationValue(const std::vector<EvaluationValue> &)> >
-    builtinFunctions;
+    std::mt19937 rng;
 
-    // Метод для регистрации встроенной функции
-    void registerBuiltin(const std::string &name,
-                         const std::function<EvaluationValue(const std::vector<EvaluationValue> &)> &func) {
-        builtinFunctions[name] = func;
+    // Метод для регистрации встроенной функции: глобальная переменная со значением NativeObject
+    void defineNative(const std::string &name, NativeFunction function, int arity) {
+        set(define(name), ALLOC_NATIVE(name, function, arity));
     }
 
-    // Метод для определения глобальной переменной
-    void define(const std::string &name) {
-        if (getGlobalIndex(name) != -1) {
-            return; // Уже определена
+    // Метод для определения глобальной переменной; возвращает её индекс
+    int define(const std::string &name) {
+        auto [it, inserted] = globalIndex.emplace(name, globals.size());
+        if (inserted) {
+            globals.push_back({name, NIL()});
         }
-        globals.push_back({name, NIL()});
+        return static_cast<int>(it->second);
     }
 
     // Метод для получения индекса глобальной переменной
-    int getGlobalIndex(const std::string &name) {
-        for (int i = 0; i < globals.size(); ++i) {
-            if (globals[i].name == name) {
-                return i;
-            }
-        }
-        return -1;
+    int getGlobalIndex(const std::string &name) const {
+        auto it = globalIndex.find(name);
+        return it == globalIndex.end() ? -1 : static_cast<int>(it->second);
     }
 
     // Метод для проверки существования глобальной переменной
     bool exists(const std::string &name) const {
-        for (const auto &var: globals) {
-            if (var.name == name) {
-                return true;
-            }
-        }
-        return false;
+        return globalIndex.count(name) != 0;
     }
 
     void setGlobalVariables() {
 
-        registerBuiltin("random", [this](const std::vector<EvaluationValue> &args) -> EvaluationValue {
-            initializeRNG();
+        defineNative("random", [](Global &global, const EvaluationValue *args, size_t /*argCount*/) -> EvaluationValue {
+            global.initializeRNG();
 
 
-            if (args.size() != 1) {
-                throw std::runtime_error("Функция random ожидает 1 аргумент: max.");
-            }
             if (!IS_NUMBER(args[0])) {
                 throw std::runtime_error("Функция random принимает только числовой аргумент.");
             }
@@ -77,19 +70,19 @@ struct Global {
 
 
             std::uniform_real_distribution dist(minVal, maxVal);
-            int randomValue = dist(rng);
+            int randomValue = dist(global.rng);
             return NUMBER(randomValue);
-        });
+        }, 1);
 
 
 
-        registerBuiltin("print", [](const std::vector<EvaluationValue>& args) -> EvaluationValue {
-            for (const auto& arg : args) {
-                std::cout << evaluationValueToConstantString(arg) << " ";
+        defineNative("print", [](Global &/*global*/, const EvaluationValue *args, size_t argCount) -> EvaluationValue {
+            for (size_t i = 0; i < argCount; ++i) {
+                std::cout << evaluationValueToConstantString(args[i]) << " ";
             }
             std::cout << std::endl;
             return NIL();
-        });
+        }, -1);
 
 
     }
@@ -103,21 +96,18 @@ struct Global {
         return globals[index];
     }
 
+    // Доступ к слоту без проверки границ: индексы в байткоде проверены при компиляции
+    EvaluationValue &slot(size_t index) {
+        return globals[index].value;
+    }
+
     // Метод для установки значения глобальной переменной
     void set(size_t index, const EvaluationValue &value) {
         if (index >= globals.size()) {
             throw std::runtime_error("Глобальное значение " + std::to_string(index) + " не существует");
         }
         globals[index].value = value;
-    }
-
-    // Метод для вызова встроенной функции
-    EvaluationValue callBuiltin(const std::string &name, const std::vector<EvaluationValue> &args) {
-        auto it = builtinFunctions.find(name);
-        if (it != builtinFunctions.end()) {
-            return it->second(args);
-        }
-        throw std::runtime_error("Встроенная функция не найдена: " + name);
+        globals[index].version++;
     }
 
     void initializeRNG() {
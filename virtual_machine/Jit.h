@@ -0,0 +1,856 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "EvaluationValue.h"
+#include "Global.h"
+#include "OpCode.h"
+
+// Базовый JIT-компилятор стекового байткода в машинный код x86-64 (только Linux).
+//
+// Каждая инструкция переводится по своему шаблону, без анализа соседних инструкций.
+// Шаблоны работают с тем же стеком операндов, что и интерпретатор: вершина стека
+// во время исполнения машинного кода живёт в r14, локальные переменные фрейма - в r15.
+// Шаблон выполняет только быстрый путь (малые целые, логические значения, массивы чисел)
+// и не создаёт объектов в куче, поэтому внутри машинного кода не бывает ни сборки мусора,
+// ни исключений. Всё остальное - выход в интерпретатор: машинный код сохраняет sp
+// и возвращает адрес инструкции, vm выполняет её обработчиком и продолжает машинный код
+// со следующей инструкции. Так же выходят CALL, RETURN и HALT, которые меняют стек вызовов.
+//
+// Точка входа есть у каждой инструкции, поэтому машинный код можно начать с любого места
+// (в том числе с заголовка цикла, в котором объект кода стал горячим) и вернуться в него
+// после выхода. Код пишется в страницы, доступные для записи, и перед исполнением
+// переключается в режим только чтения и исполнения (W^X).
+#if defined(__x86_64__) && defined(__linux__)
+#define VM_JIT_AVAILABLE 1
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#define VM_JIT_AVAILABLE 0
+#endif
+
+// Кодирование нужных шаблонам инструкций x86-64
+class X86Emitter {
+public:
+    enum Register : uint8_t {
+        RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6, RDI = 7,
+        R8 = 8, R9 = 9, R10 = 10, R11 = 11, R12 = 12, R13 = 13, R14 = 14, R15 = 15,
+    };
+
+    // Коды условий для jcc и setcc
+    enum Condition : uint8_t {
+        OVERFLOW = 0x0, ABOVE_OR_EQUAL = 0x3, EQUAL = 0x4, NOT_EQUAL = 0x5,
+        LESS = 0xC, GREATER_OR_EQUAL = 0xD, LESS_OR_EQUAL = 0xE, GREATER = 0xF,
+    };
+
+    // Противоположное условие отличается младшим битом
+    static Condition inverse(Condition condition) {
+        return static_cast<Condition>(condition ^ 1);
+    }
+
+    size_t size() const {
+        return code.size();
+    }
+
+    const std::vector<uint8_t> &bytes() const {
+        return code;
+    }
+
+    // mov dst, [base + disp]
+    void load(Register dst, Register base, int32_t disp) {
+        rex(true, dst, base);
+        byte(0x8B);
+        memory(dst, base, disp);
+    }
+
+    // mov dst, [base + index * 8]
+    void loadIndexed(Register dst, Register base, Register index) {
+        rex(true, dst, base, index);
+        byte(0x8B);
+        memoryIndexed(dst, base, index);
+    }
+
+    // mov [base + disp], src
+    void store(Register base, int32_t disp, Register src) {
+        rex(true, src, base);
+        byte(0x89);
+        memory(src, base, disp);
+    }
+
+    // mov [base + index * 8], src
+    void storeIndexed(Register base, Register index, Register src) {
+        rex(true, src, base, index);
+        byte(0x89);
+        memoryIndexed(src, base, index);
+    }
+
+    // mov qword [base + disp], imm32 (со знаковым расширением)
+    void storeImmediate(Register base, int32_t disp, int32_t value) {
+        rex(true, RAX, base);
+        byte(0xC7);
+        memory(RAX, base, disp);
+        int32(value);
+    }
+
+    // mov dst, imm64
+    void moveImmediate(Register dst, uint64_t value) {
+        rex(true, RAX, dst);
+        byte(0xB8 + (dst & 7));
+        for (int i = 0; i < 8; ++i) {
+            byte(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void move(Register dst, Register src) {
+        arithmetic(0x89, dst, src);
+    }
+
+    void add(Register dst, Register src) {
+        arithmetic(0x01, dst, src);
+    }
+
+    void subtract(Register dst, Register src) {
+        arithmetic(0x29, dst, src);
+    }
+
+    void bitAnd(Register dst, Register src) {
+        arithmetic(0x21, dst, src);
+    }
+
+    void compare(Register left, Register right) {
+        arithmetic(0x39, left, right);
+    }
+
+    void test(Register left, Register right) {
+        arithmetic(0x85, left, right);
+    }
+
+    // imul dst, src
+    void multiply(Register dst, Register src) {
+        rex(true, dst, src);
+        byte(0x0F);
+        byte(0xAF);
+        registers(dst, src);
+    }
+
+    void addImmediate(Register dst, int32_t value) {
+        arithmeticImmediate(0, dst, value);
+    }
+
+    void orImmediate(Register dst, int32_t value) {
+        arithmeticImmediate(1, dst, value);
+    }
+
+    void subtractImmediate(Register dst, int32_t value) {
+        arithmeticImmediate(5, dst, value);
+    }
+
+    void compareImmediate(Register dst, int32_t value) {
+        arithmeticImmediate(7, dst, value);
+    }
+
+    // sub dst, [base + disp]
+    void subtractMemory(Register dst, Register base, int32_t disp) {
+        rex(true, dst, base);
+        byte(0x2B);
+        memory(dst, base, disp);
+    }
+
+    // test dst, imm32
+    void testImmediate(Register dst, int32_t value) {
+        rex(true, RAX, dst);
+        byte(0xF7);
+        registers(0, dst);
+        int32(value);
+    }
+
+    // cmp byte [base + disp], imm8
+    void compareByte(Register base, int32_t disp, uint8_t value) {
+        rex(false, RAX, base);
+        byte(0x80);
+        memory(7, base, disp);
+        byte(value);
+    }
+
+    void shiftLeft(Register dst, uint8_t count) {
+        rex(true, RAX, dst);
+        byte(0xC1);
+        registers(4, dst);
+        byte(count);
+    }
+
+    // Арифметический сдвиг вправо (со знаком)
+    void shiftRight(Register dst, uint8_t count) {
+        rex(true, RAX, dst);
+        byte(0xC1);
+        registers(7, dst);
+        byte(count);
+    }
+
+    // setcc по младшему байту регистра RAX..RBX и movzx в весь регистр
+    void setIf(Condition condition, Register dst) {
+        byte(0x0F);
+        byte(0x90 + condition);
+        registers(0, dst);
+        rex(true, dst, dst);
+        byte(0x0F);
+        byte(0xB6);
+        registers(dst, dst);
+    }
+
+    // Условный и безусловный переходы с 32-битным смещением; возвращают позицию
+    // смещения для patch
+    size_t jumpIf(Condition condition) {
+        byte(0x0F);
+        byte(0x80 + condition);
+        int32(0);
+        return code.size() - 4;
+    }
+
+    size_t jump() {
+        byte(0xE9);
+        int32(0);
+        return code.size() - 4;
+    }
+
+    void jumpRegister(Register target) {
+        rex(false, RAX, target);
+        byte(0xFF);
+        registers(4, target);
+    }
+
+    // Направляет переход с позиции at на смещение target в коде
+    void patch(size_t at, size_t target) {
+        int32_t relative = static_cast<int32_t>(target) - static_cast<int32_t>(at + 4);
+        std::memcpy(&code[at], &relative, sizeof(relative));
+    }
+
+    void push(Register reg) {
+        rex(false, RAX, reg);
+        byte(0x50 + (reg & 7));
+    }
+
+    void pop(Register reg) {
+        rex(false, RAX, reg);
+        byte(0x58 + (reg & 7));
+    }
+
+    void ret() {
+        byte(0xC3);
+    }
+
+private:
+    void byte(uint8_t value) {
+        code.push_back(value);
+    }
+
+    void int32(int32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            byte(static_cast<uint8_t>(static_cast<uint32_t>(value) >> (8 * i)));
+        }
+    }
+
+    // Префикс REX нужен для 64-битного операнда и для регистров r8-r15
+    void rex(bool wide, int reg, int base, int index = 0) {
+        uint8_t prefix = 0x40 | (wide << 3) | ((reg & 8) >> 1) | ((index & 8) >> 2) | ((base & 8) >> 3);
+        if (prefix != 0x40) {
+            byte(prefix);
+        }
+    }
+
+    void registers(int reg, int rm) {
+        byte(0xC0 | ((reg & 7) << 3) | (rm & 7));
+    }
+
+    // ModRM (и SIB для rsp/r12) для адреса [base + disp]
+    void memory(int reg, int base, int32_t disp) {
+        uint8_t mod = disp == 0 && (base & 7) != RBP ? 0 : (disp >= -128 && disp <= 127 ? 1 : 2);
+        byte((mod << 6) | ((reg & 7) << 3) | (base & 7));
+        if ((base & 7) == RSP) {
+            byte(0x24);
+        }
+        if (mod == 1) {
+            byte(static_cast<uint8_t>(disp));
+        } else if (mod == 2) {
+            int32(disp);
+        }
+    }
+
+    // [base + index * 8]; base не может быть rbp или r13
+    void memoryIndexed(int reg, int base, int index) {
+        byte(((reg & 7) << 3) | RSP);
+        byte((3 << 6) | ((index & 7) << 3) | (base & 7));
+    }
+
+    // op r/m64, reg: dst - r/m, src - reg
+    void arithmetic(uint8_t opcode, Register dst, Register src) {
+        rex(true, src, dst);
+        byte(opcode);
+        registers(src, dst);
+    }
+
+    void arithmeticImmediate(int extension, Register dst, int32_t value) {
+        rex(true, RAX, dst);
+        if (value >= -128 && value <= 127) {
+            byte(0x83);
+            registers(extension, dst);
+            byte(static_cast<uint8_t>(value));
+        } else {
+            byte(0x81);
+            registers(extension, dst);
+            int32(value);
+        }
+    }
+
+    std::vector<uint8_t> code;
+};
+
+// Исполняемая память: код копируется в страницы, доступные для записи, которые затем
+// переключаются в режим только чтения и исполнения (W^X)
+class ExecutableMemory {
+public:
+    // nullptr, если память получить не удалось или JIT на платформе недоступен
+    static std::unique_ptr<ExecutableMemory> create(const std::vector<uint8_t> &code) {
+        std::unique_ptr<ExecutableMemory> memory = allocate(code.size());
+        if (memory == nullptr) {
+            return nullptr;
+        }
+        std::memcpy(memory->data(), code.data(), code.size());
+        return memory->seal() ? std::move(memory) : nullptr;
+    }
+
+    // Страницы под size байт, пока доступные для записи: код, которому нужен собственный
+    // адрес (CopyPatchJit.h), пишется прямо в них, после чего вызывается seal
+    static std::unique_ptr<ExecutableMemory> allocate(size_t size) {
+#if VM_JIT_AVAILABLE
+        size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t mappedSize = std::max<size_t>((size + pageSize - 1) / pageSize, 1) * pageSize;
+        void *memory = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            return nullptr;
+        }
+        return std::unique_ptr<ExecutableMemory>(new ExecutableMemory(static_cast<uint8_t *>(memory), mappedSize));
+#else
+        return nullptr;
+#endif
+    }
+
+    // Переключает страницы в режим только чтения и исполнения
+    bool seal() {
+#if VM_JIT_AVAILABLE
+        return mprotect(memory, mappedSize, PROT_READ | PROT_EXEC) == 0;
+#else
+        return false;
+#endif
+    }
+
+    ExecutableMemory(const ExecutableMemory &) = delete;
+    ExecutableMemory &operator=(const ExecutableMemory &) = delete;
+
+    ~ExecutableMemory() {
+#if VM_JIT_AVAILABLE
+        munmap(memory, mappedSize);
+#endif
+    }
+
+    uint8_t *data() const {
+        return memory;
+    }
+
+    size_t size() const {
+        return mappedSize;
+    }
+
+private:
+    ExecutableMemory(uint8_t *memory, size_t mappedSize) : memory(memory), mappedSize(mappedSize) {
+    }
+
+    uint8_t *memory;
+    size_t mappedSize;
+};
+
+// Раскладка объектов, которые машинный код читает напрямую, и общие для JIT-компиляторов
+// шаблоны доступа к ним. Шаблоны читают начало и конец буфера std::vector прямо из объекта;
+// если раскладка библиотеки другая, такие инструкции всегда выполняет интерпретатор.
+class JitLayout {
+public:
+    using Register = X86Emitter::Register;
+
+    JitLayout() {
+        ArrayObject array;
+        arrayTypeOffset = fieldOffset(&array, &array.type);
+        arrayKindOffset = fieldOffset(&array, &array.kind);
+        arrayNumbersOffset = fieldOffset(&array, &array.numbers);
+
+        GlobalVar globalVar;
+        globalValueOffset = fieldOffset(&globalVar, &globalVar.value);
+
+        std::vector<int64_t> numbers(3);
+        std::vector<GlobalVar> globals(3);
+        vectorsKnown = hasPointerLayout(numbers) && hasPointerLayout(globals) &&
+                       static_cast<void *>(&array) == static_cast<Object *>(&array);
+    }
+
+    bool vectorLayoutKnown() const {
+        return vectorsKnown;
+    }
+
+    // dst = значение глобальной переменной index. Слоты только добавляются, но буфер globals
+    // может переехать, поэтому адрес буфера перечитывается при каждом обращении.
+    void emitLoadGlobal(X86Emitter &emitter, Register dst, const Global &global, size_t index) const {
+        emitter.moveImmediate(dst, reinterpret_cast<uint64_t>(&global.globals));
+        emitter.load(dst, dst, 0);
+        emitter.load(dst, dst, static_cast<int32_t>(index * sizeof(GlobalVar)) + globalValueOffset);
+    }
+
+    // Выход, если rax - не массив чисел
+    template<typename ExitIf>
+    void emitNumberArrayGuard(X86Emitter &emitter, ExitIf &exitIf) const {
+        emitter.testImmediate(X86Emitter::RAX, EvaluationValue::TAG_MASK);
+        exitIf(X86Emitter::NOT_EQUAL);
+        emitter.test(X86Emitter::RAX, X86Emitter::RAX);
+        exitIf(X86Emitter::EQUAL);
+        emitter.compareByte(X86Emitter::RAX, arrayTypeOffset, static_cast<uint8_t>(ObjectType::ARRAY));
+        exitIf(X86Emitter::NOT_EQUAL);
+        emitter.compareByte(X86Emitter::RAX, arrayKindOffset, static_cast<uint8_t>(ArrayObject::Kind::INT64));
+        exitIf(X86Emitter::NOT_EQUAL);
+    }
+
+    // rax - массив чисел, rcx - малое целое. Выход, если индекс вне границ; иначе rcx -
+    // индекс, rdx - начало буфера чисел. Отрицательный индекс при сравнении без знака
+    // тоже вне границ.
+    template<typename ExitIf>
+    void emitBoundsCheck(X86Emitter &emitter, ExitIf &exitIf) const {
+        emitter.shiftRight(X86Emitter::RCX, 1);
+        emitter.load(X86Emitter::RDX, X86Emitter::RAX, arrayNumbersOffset + static_cast<int32_t>(sizeof(void *)));
+        emitter.subtractMemory(X86Emitter::RDX, X86Emitter::RAX, arrayNumbersOffset);
+        emitter.shiftRight(X86Emitter::RDX, 3);
+        emitter.compare(X86Emitter::RCX, X86Emitter::RDX);
+        exitIf(X86Emitter::ABOVE_OR_EQUAL);
+        emitter.load(X86Emitter::RDX, X86Emitter::RAX, arrayNumbersOffset);
+    }
+
+private:
+    template<typename Owner, typename Field>
+    static int32_t fieldOffset(const Owner *owner, const Field *field) {
+        return static_cast<int32_t>(reinterpret_cast<const char *>(field) - reinterpret_cast<const char *>(owner));
+    }
+
+    // Первые два слова std::vector - начало и конец буфера
+    template<typename T>
+    static bool hasPointerLayout(const std::vector<T> &vector) {
+        const T *words[2];
+        if (sizeof(vector) < sizeof(words)) {
+            return false;
+        }
+        std::memcpy(words, &vector, sizeof(words));
+        return words[0] == vector.data() && words[1] == vector.data() + vector.size();
+    }
+
+    int32_t arrayTypeOffset = 0;
+    int32_t arrayKindOffset = 0;
+    int32_t arrayNumbersOffset = 0;
+    int32_t globalValueOffset = 0;
+    bool vectorsKnown = false;
+};
+
+// Машинный код одного объекта кода в собственных исполняемых страницах
+class NativeCode {
+public:
+    // Точка входа: адрес ячейки vm::sp, локальные переменные фрейма и адрес машинного кода
+    // инструкции, с которой начинается исполнение. Возвращает адрес инструкции байткода,
+    // которую должен выполнить интерпретатор.
+    typedef uint8_t *(*Entry)(EvaluationValue **sp, EvaluationValue *locals, const void *start);
+
+    NativeCode(std::unique_ptr<ExecutableMemory> memory, const uint8_t *bytecode, std::vector<uint32_t> offsets)
+        : memory(std::move(memory)), bytecode(bytecode), offsets(std::move(offsets)) {
+    }
+
+    // Исполняет машинный код с инструкции ip до первого выхода в интерпретатор
+    uint8_t *run(EvaluationValue **sp, EvaluationValue *locals, const uint8_t *ip) const {
+        Entry entry = reinterpret_cast<Entry>(memory->data());
+        return entry(sp, locals, memory->data() + offsets[ip - bytecode]);
+    }
+
+    size_t size() const {
+        return memory->size();
+    }
+
+private:
+    std::unique_ptr<ExecutableMemory> memory;
+
+    // Байткод, по которому построен код, и смещение машинного кода каждой его инструкции
+    const uint8_t *bytecode;
+    std::vector<uint32_t> offsets;
+};
+
+// Кэш машинного кода виртуальной машины: компилирует горячие объекты кода и владеет
+// их исполняемой памятью. Объект кода ссылается на свой машинный код (CodeObject::native),
+// поэтому поиска по кэшу при вызове нет. Память освобождается вместе с vm.
+class JitCache {
+public:
+    explicit JitCache(std::shared_ptr<Global> global) : global(std::move(global)) {
+    }
+
+    // Машинный код для платформы сборки поддерживается
+    static bool available() {
+        return VM_JIT_AVAILABLE;
+    }
+
+    // Адрес ячейки, в которой появляется трасса заголовка цикла (TraceJit.h) по его смещению
+    using TraceSlot = std::function<const void *(size_t header)>;
+
+    // Компилирует объект стекового кода; nullptr, если исполняемую память получить не удалось.
+    // С traceSlot обратный переход выходит в интерпретатор, если у цикла уже есть трасса.
+    const NativeCode *compile(CodeObject *codeObject, const TraceSlot &traceSlot = nullptr) {
+        X86Emitter emitter;
+        std::vector<uint32_t> offsets(codeObject->code.size());
+        emitTemplates(codeObject, traceSlot, emitter, offsets);
+
+        std::unique_ptr<ExecutableMemory> memory = ExecutableMemory::create(emitter.bytes());
+        if (memory == nullptr) {
+            return nullptr;
+        }
+        codeBytes += memory->size();
+        compiled.push_back(std::make_unique<NativeCode>(std::move(memory), codeObject->code.data(), std::move(offsets)));
+        return compiled.back().get();
+    }
+
+    // Число скомпилированных объектов кода
+    size_t compiledCount() const {
+        return compiled.size();
+    }
+
+    // Объём исполняемой памяти в байтах
+    size_t size() const {
+        return codeBytes;
+    }
+
+private:
+    using Register = X86Emitter::Register;
+    using Condition = X86Emitter::Condition;
+
+    // Вершина стека операндов, локальные переменные фрейма и адрес ячейки vm::sp
+    static constexpr Register SP = X86Emitter::R14;
+    static constexpr Register LOCALS = X86Emitter::R15;
+    static constexpr Register SP_SLOT = X86Emitter::R12;
+
+    static constexpr Register RAX = X86Emitter::RAX;
+    static constexpr Register RCX = X86Emitter::RCX;
+    static constexpr Register RDX = X86Emitter::RDX;
+    static constexpr Register RSI = X86Emitter::RSI;
+    static constexpr Register RDI = X86Emitter::RDI;
+
+    static constexpr int32_t SLOT = sizeof(EvaluationValue);
+
+    // Код сравнения OP_COMPARE -> условие x86 для слов малых целых со знаком
+    static Condition compareCondition(uint8_t compareOp) {
+        static const Condition conditions[] = {
+            X86Emitter::LESS, X86Emitter::GREATER, X86Emitter::EQUAL,
+            X86Emitter::GREATER_OR_EQUAL, X86Emitter::LESS_OR_EQUAL, X86Emitter::NOT_EQUAL,
+        };
+        return conditions[compareOp];
+    }
+
+    void emitTemplates(CodeObject *codeObject, const TraceSlot &traceSlot, X86Emitter &emitter,
+                       std::vector<uint32_t> &offsets) {
+        const std::vector<uint8_t> &code = codeObject->code;
+
+        // Пролог: сохранение используемых callee-saved регистров и переход к инструкции
+        emitter.push(SP_SLOT);
+        emitter.push(SP);
+        emitter.push(LOCALS);
+        emitter.move(SP_SLOT, RDI);
+        emitter.load(SP, SP_SLOT, 0);
+        emitter.move(LOCALS, RSI);
+        emitter.jumpRegister(RDX);
+
+        // Эпилог: адрес инструкции для интерпретатора уже в rax
+        size_t exitOffset = emitter.size();
+        emitter.store(SP_SLOT, 0, SP);
+        emitter.pop(LOCALS);
+        emitter.pop(SP);
+        emitter.pop(SP_SLOT);
+        emitter.ret();
+
+        // Переходы по байткоду и выходы с медленных путей: позиция смещения и адрес байткода
+        std::vector<std::pair<size_t, size_t>> jumps;
+        std::vector<std::pair<size_t, size_t>> slowPaths;
+
+        auto exitTo = [&](size_t offset) {
+            emitter.moveImmediate(RAX, reinterpret_cast<uint64_t>(&code[offset]));
+            emitter.patch(emitter.jump(), exitOffset);
+        };
+
+        for (size_t offset = 0; offset < code.size(); offset += instructionLength(code[offset])) {
+            offsets[offset] = static_cast<uint32_t>(emitter.size());
+            const uint8_t *operands = &code[offset + 1];
+
+            auto exitIf = [&](Condition condition) {
+                slowPaths.emplace_back(emitter.jumpIf(condition), offset);
+            };
+            auto jumpAddress = [&]() {
+                return static_cast<size_t>((operands[0] << 8) | operands[1]);
+            };
+            auto pushRax = [&]() {
+                emitter.store(SP, 0, RAX);
+                emitter.addImmediate(SP, SLOT);
+            };
+            auto pushConstant = [&](EvaluationValue value) {
+                if (static_cast<int64_t>(value.bits) == static_cast<int32_t>(value.bits)) {
+                    emitter.storeImmediate(SP, 0, static_cast<int32_t>(value.bits));
+                } else {
+                    emitter.moveImmediate(RAX, value.bits);
+                    emitter.store(SP, 0, RAX);
+                }
+                emitter.addImmediate(SP, SLOT);
+            };
+            // Оба слова rax и rcx - малые целые
+            auto exitUnlessSmallNumbers = [&]() {
+                emitter.move(RDX, RAX);
+                emitter.bitAnd(RDX, RCX);
+                emitter.testImmediate(RDX, EvaluationValue::INT_TAG);
+                exitIf(X86Emitter::EQUAL);
+            };
+
+            uint8_t opcode = code[offset];
+            switch (opcode) {
+                case OP_CONST:
+                    pushConstant(codeObject->constants[operands[0]]);
+                    break;
+                case OP_CONST_LONG:
+                    pushConstant(codeObject->constants[(operands[0] << 8) | operands[1]]);
+                    break;
+                case OP_NIL:
+                    pushConstant(NIL());
+                    break;
+                case OP_GET_LOCAL:
+                    emitter.load(RAX, LOCALS, operands[0] * SLOT);
+                    pushRax();
+                    break;
+                case OP_GET_LOCAL_LOCAL:
+                    emitter.load(RAX, LOCALS, operands[0] * SLOT);
+                    emitter.store(SP, 0, RAX);
+                    emitter.load(RAX, LOCALS, operands[1] * SLOT);
+                    emitter.store(SP, SLOT, RAX);
+                    emitter.addImmediate(SP, 2 * SLOT);
+                    break;
+                case OP_SET_LOCAL:
+                    emitter.load(RAX, SP, -SLOT);
+                    emitter.store(LOCALS, operands[0] * SLOT, RAX);
+                    emitter.subtractImmediate(SP, SLOT);
+                    break;
+                case OP_DUP:
+                    emitter.load(RAX, SP, -SLOT);
+                    pushRax();
+                    break;
+                case OP_POP:
+                    emitter.subtractImmediate(SP, SLOT);
+                    break;
+                case OP_GET_GLOBAL:
+                case OP_GET_GLOBAL_LONG: {
+                    if (!layout.vectorLayoutKnown()) {
+                        exitTo(offset);
+                        break;
+                    }
+                    size_t index = opcode == OP_GET_GLOBAL ? operands[0] : (operands[0] << 8) | operands[1];
+                    layout.emitLoadGlobal(emitter, RAX, *global, index);
+                    pushRax();
+                    break;
+                }
+                case OP_JUMP:
+                    if (traceSlot && jumpAddress() < offset) {
+                        emitter.moveImmediate(RAX, reinterpret_cast<uint64_t>(traceSlot(jumpAddress())));
+                        emitter.load(RAX, RAX, 0);
+                        emitter.test(RAX, RAX);
+                        exitIf(X86Emitter::NOT_EQUAL);
+                    }
+                    jumps.emplace_back(emitter.jump(), jumpAddress());
+                    break;
+                case OP_JUMP_IF_FALSE:
+                    emitter.load(RAX, SP, -SLOT);
+                    emitter.subtractImmediate(SP, SLOT);
+                    emitter.compareImmediate(RAX, EvaluationValue::FALSE_BITS);
+                    jumps.emplace_back(emitter.jumpIf(X86Emitter::EQUAL), jumpAddress());
+                    break;
+                case OP_JUMP_IF_TRUE: {
+                    // Быстрый путь только для логических значений
+                    emitter.load(RAX, SP, -SLOT);
+                    emitter.compareImmediate(RAX, EvaluationValue::FALSE_BITS);
+                    size_t isFalse = emitter.jumpIf(X86Emitter::EQUAL);
+                    emitter.compareImmediate(RAX, EvaluationValue::TRUE_BITS);
+                    exitIf(X86Emitter::NOT_EQUAL);
+                    emitter.subtractImmediate(SP, SLOT);
+                    jumps.emplace_back(emitter.jump(), jumpAddress());
+                    emitter.patch(isFalse, emitter.size());
+                    emitter.subtractImmediate(SP, SLOT);
+                    break;
+                }
+                case OP_ADD:
+                case OP_SUB:
+                    emitter.load(RAX, SP, -2 * SLOT);
+                    emitter.load(RCX, SP, -SLOT);
+                    exitUnlessSmallNumbers();
+                    emitter.move(RDX, RAX);
+                    if (opcode == OP_ADD) {
+                        // (2a + 1) + (2b + 1) - 1 = 2(a + b) + 1
+                        emitter.subtractImmediate(RDX, 1);
+                        emitter.add(RDX, RCX);
+                        exitIf(X86Emitter::OVERFLOW);
+                    } else {
+                        // (2a + 1) - (2b + 1) = 2(a - b)
+                        emitter.subtract(RDX, RCX);
+                        exitIf(X86Emitter::OVERFLOW);
+                        emitter.orImmediate(RDX, EvaluationValue::INT_TAG);
+                    }
+                    emitter.store(SP, -2 * SLOT, RDX);
+                    emitter.subtractImmediate(SP, SLOT);
+                    break;
+                case OP_ADD_CONST:
+                case OP_SUB_CONST:
+                case OP_INC_LOCAL: {
+                    EvaluationValue constant = codeObject->constants[operands[opcode == OP_INC_LOCAL ? 1 : 0]];
+                    if (!constant.isSmallNumber()) {
+                        exitTo(offset);
+                        break;
+                    }
+                    int32_t slot = opcode == OP_INC_LOCAL ? operands[0] * SLOT : 0;
+                    if (opcode == OP_INC_LOCAL) {
+                        emitter.load(RAX, LOCALS, slot);
+                    } else {
+                        emitter.load(RAX, SP, -SLOT);
+                    }
+                    emitter.testImmediate(RAX, EvaluationValue::INT_TAG);
+                    exitIf(X86Emitter::EQUAL);
+                    // Слово константы без тега - удвоенное число
+                    emitter.moveImmediate(RCX, constant.bits - EvaluationValue::INT_TAG);
+                    emitter.move(RDX, RAX);
+                    if (opcode == OP_SUB_CONST) {
+                        emitter.subtract(RDX, RCX);
+                    } else {
+                        emitter.add(RDX, RCX);
+                    }
+                    exitIf(X86Emitter::OVERFLOW);
+                    if (opcode == OP_INC_LOCAL) {
+                        emitter.store(LOCALS, slot, RDX);
+                    } else {
+                        emitter.store(SP, -SLOT, RDX);
+                    }
+                    break;
+                }
+                case OP_COMPARE:
+                    emitter.load(RAX, SP, -2 * SLOT);
+                    emitter.load(RCX, SP, -SLOT);
+                    exitUnlessSmallNumbers();
+                    // Слова малых целых упорядочены так же, как числа
+                    emitter.compare(RAX, RCX);
+                    emitter.setIf(compareCondition(operands[0]), RDX);
+                    emitter.shiftLeft(RDX, 3);
+                    emitter.orImmediate(RDX, EvaluationValue::FALSE_BITS);
+                    emitter.store(SP, -2 * SLOT, RDX);
+                    emitter.subtractImmediate(SP, SLOT);
+                    break;
+                case OP_JUMP_IF_NOT_LT:
+                case OP_JUMP_IF_NOT_GT:
+                case OP_JUMP_IF_NOT_EQ:
+                case OP_JUMP_IF_NOT_GE:
+                case OP_JUMP_IF_NOT_LE:
+                case OP_JUMP_IF_NOT_NE:
+                    emitter.load(RAX, SP, -2 * SLOT);
+                    emitter.load(RCX, SP, -SLOT);
+                    exitUnlessSmallNumbers();
+                    emitter.subtractImmediate(SP, 2 * SLOT);
+                    emitter.compare(RAX, RCX);
+                    jumps.emplace_back(
+                        emitter.jumpIf(X86Emitter::inverse(compareCondition(opcode - OP_JUMP_IF_NOT_LT))),
+                        jumpAddress());
+                    break;
+                case OP_ARRAY_GET:
+                case OP_ARRAY_GET_LOCAL_LOCAL:
+                    if (!layout.vectorLayoutKnown()) {
+                        exitTo(offset);
+                        break;
+                    }
+                    if (opcode == OP_ARRAY_GET) {
+                        emitter.load(RAX, SP, -2 * SLOT);
+                        emitter.load(RCX, SP, -SLOT);
+                    } else {
+                        emitter.load(RAX, LOCALS, operands[0] * SLOT);
+                        emitter.load(RCX, LOCALS, operands[1] * SLOT);
+                    }
+                    emitNumberArrayAccess(emitter, exitIf);
+                    // Элемент - малое целое, если удвоение не переполняется
+                    emitter.loadIndexed(RAX, RDX, RCX);
+                    emitter.add(RAX, RAX);
+                    exitIf(X86Emitter::OVERFLOW);
+                    emitter.orImmediate(RAX, EvaluationValue::INT_TAG);
+                    if (opcode == OP_ARRAY_GET) {
+                        emitter.store(SP, -2 * SLOT, RAX);
+                        emitter.subtractImmediate(SP, SLOT);
+                    } else {
+                        pushRax();
+                    }
+                    break;
+                case OP_ARRAY_SET:
+                    if (!layout.vectorLayoutKnown()) {
+                        exitTo(offset);
+                        break;
+                    }
+                    emitter.load(RSI, SP, -SLOT);
+                    emitter.testImmediate(RSI, EvaluationValue::INT_TAG);
+                    exitIf(X86Emitter::EQUAL);
+                    emitter.load(RAX, SP, -3 * SLOT);
+                    emitter.load(RCX, SP, -2 * SLOT);
+                    emitNumberArrayAccess(emitter, exitIf);
+                    emitter.shiftRight(RSI, 1);
+                    emitter.storeIndexed(RDX, RCX, RSI);
+                    emitter.subtractImmediate(SP, 3 * SLOT);
+                    break;
+                default:
+                    // Остальные инструкции (вызовы, создание объектов, запись глобальных
+                    // переменных с барьером) всегда выполняет интерпретатор
+                    exitTo(offset);
+                    break;
+            }
+        }
+
+        for (const auto &[at, address]: jumps) {
+            emitter.patch(at, offsets[address]);
+        }
+
+        // Медленные пути одной инструкции ведут к общей заглушке выхода
+        size_t stubFor = SIZE_MAX;
+        size_t stubOffset = 0;
+        for (const auto &[at, offset]: slowPaths) {
+            if (offset != stubFor) {
+                stubFor = offset;
+                stubOffset = emitter.size();
+                exitTo(offset);
+            }
+            emitter.patch(at, stubOffset);
+        }
+    }
+
+    // Проверки для доступа к массиву чисел: rax - массив, rcx - индекс. После них rcx -
+    // индекс в границах массива, rdx - начало буфера чисел.
+    template<typename ExitIf>
+    void emitNumberArrayAccess(X86Emitter &emitter, ExitIf &exitIf) const {
+        emitter.testImmediate(RCX, EvaluationValue::INT_TAG);
+        exitIf(X86Emitter::EQUAL);
+        layout.emitNumberArrayGuard(emitter, exitIf);
+        layout.emitBoundsCheck(emitter, exitIf);
+    }
+
+    std::shared_ptr<Global> global;
+
+    JitLayout layout;
+
+    std::vector<std::unique_ptr<NativeCode>> compiled;
+
+    size_t codeBytes = 0;
+};
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstdint>
+#include <stdexcept>
+#include <string>
 
 
 constexpr auto OP_HALT = 0x00;
@@ -30,13 +32,53 @@ constexpr auto OP_DUP= 0X10;
 
 constexpr auto OP_NIL = 0x11;
 
+// Операнды: число аргументов и 16-битный номер места вызова (CodeObject::callCaches)
 constexpr auto OP_CALL   = 0x12;
 constexpr auto OP_RETURN = 0x13;
 
+// Пустой массив; 16-битный операнд - ёмкость, выделяемая заранее
 constexpr auto OP_ARRAY = 0x14;
 constexpr auto OP_ARRAY_GET = 0x15;
 constexpr auto OP_ARRAY_SET = 0x16;
 
+constexpr auto OP_POP = 0x17;
+
+// Доступ к глобальным переменным с 16-битным индексом (когда глобальных больше 256)
+constexpr auto OP_GET_GLOBAL_LONG = 0x18;
+constexpr auto OP_SET_GLOBAL_LONG = 0x19;
+
+// Загрузка константы с 16-битным индексом (когда констант больше 256)
+constexpr auto OP_CONST_LONG = 0x1A;
+
+// Массив из n значений с вершины стека (n - байт операнда), первое значение - самое глубокое
+constexpr auto OP_ARRAY_LITERAL = 0x1B;
+
+// Переход, если снятое со стека значение истинно (ставится оптимизатором вместо LOGICAL_NOT; JUMP_IF_FALSE)
+constexpr auto OP_JUMP_IF_TRUE = 0x1C;
+
+// Суперинструкции: частые последовательности, которые оптимизатор байткода сливает в одну
+// инструкцию (см. PeepholeOptimizer). Выбраны по профилю пар инструкций на примерах.
+
+// GET_LOCAL a; GET_LOCAL b - операнды: два слота
+constexpr auto OP_GET_LOCAL_LOCAL = 0x1D;
+// CONST k; ADD и CONST k; SUB - операнд: индекс константы
+constexpr auto OP_ADD_CONST = 0x1E;
+constexpr auto OP_SUB_CONST = 0x1F;
+// GET_LOCAL x; CONST k; ADD; SET_LOCAL x - операнды: слот и индекс константы
+constexpr auto OP_INC_LOCAL = 0x20;
+// GET_LOCAL a; GET_LOCAL i; ARRAY_GET - операнды: слот массива и слот индекса
+constexpr auto OP_ARRAY_GET_LOCAL_LOCAL = 0x21;
+
+// Сравнение, слитое с условным переходом: снимает два значения и переходит по 16-битному
+// адресу, если сравнение ложно. Порядок совпадает с кодами операнда OP_COMPARE:
+// OP_JUMP_IF_NOT_LT + код сравнения.
+constexpr auto OP_JUMP_IF_NOT_LT = 0x22;
+constexpr auto OP_JUMP_IF_NOT_GT = 0x23;
+constexpr auto OP_JUMP_IF_NOT_EQ = 0x24;
+constexpr auto OP_JUMP_IF_NOT_GE = 0x25;
+constexpr auto OP_JUMP_IF_NOT_LE = 0x26;
+constexpr auto OP_JUMP_IF_NOT_NE = 0x27;
+
 
 inline std::string opcodeToString(uint8_t opcode) {
     switch (opcode) {
@@ -63,7 +105,147 @@ inline std::string opcodeToString(uint8_t opcode) {
         case OP_ARRAY: return "ARRAY";
         case OP_ARRAY_GET: return "ARRAY_GET";
         case OP_ARRAY_SET: return "ARRAY_SET";
+        case OP_POP: return "POP";
+        case OP_GET_GLOBAL_LONG: return "GET_GLOBAL_LONG";
+        case OP_SET_GLOBAL_LONG: return "SET_GLOBAL_LONG";
+        case OP_CONST_LONG: return "CONST_LONG";
+        case OP_ARRAY_LITERAL: return "ARRAY_LITERAL";
+        case OP_JUMP_IF_TRUE: return "JUMP_IF_TRUE";
+        case OP_GET_LOCAL_LOCAL: return "GET_LOCAL_LOCAL";
+        case OP_ADD_CONST: return "ADD_CONST";
+        case OP_SUB_CONST: return "SUB_CONST";
+        case OP_INC_LOCAL: return "INC_LOCAL";
+        case OP_ARRAY_GET_LOCAL_LOCAL: return "ARRAY_GET_LOCAL_LOCAL";
+        case OP_JUMP_IF_NOT_LT: return "JUMP_IF_NOT_LT";
+        case OP_JUMP_IF_NOT_GT: return "JUMP_IF_NOT_GT";
+        case OP_JUMP_IF_NOT_EQ: return "JUMP_IF_NOT_EQ";
+        case OP_JUMP_IF_NOT_GE: return "JUMP_IF_NOT_GE";
+        case OP_JUMP_IF_NOT_LE: return "JUMP_IF_NOT_LE";
+        case OP_JUMP_IF_NOT_NE: return "JUMP_IF_NOT_NE";
         default:
             throw std::runtime_error("Неизвестный байткод " + std::to_string(opcode));
     }
 }
+
+
+// Длина инструкции в байтах вместе с операндами
+inline size_t instructionLength(uint8_t opcode) {
+    switch (opcode) {
+        case OP_JUMP:
+        case OP_JUMP_IF_FALSE:
+        case OP_JUMP_IF_TRUE:
+        case OP_JUMP_IF_FALSE_OR_POP:
+        case OP_JUMP_IF_TRUE_OR_POP:
+        case OP_GET_GLOBAL_LONG:
+        case OP_SET_GLOBAL_LONG:
+        case OP_CONST_LONG:
+        case OP_ARRAY:
+        case OP_GET_LOCAL_LOCAL:
+        case OP_INC_LOCAL:
+        case OP_ARRAY_GET_LOCAL_LOCAL:
+        case OP_JUMP_IF_NOT_LT:
+        case OP_JUMP_IF_NOT_GT:
+        case OP_JUMP_IF_NOT_EQ:
+        case OP_JUMP_IF_NOT_GE:
+        case OP_JUMP_IF_NOT_LE:
+        case OP_JUMP_IF_NOT_NE:
+            return 3;
+        case OP_CALL:
+            return 4;
+        case OP_CONST:
+        case OP_COMPARE:
+        case OP_GET_LOCAL:
+        case OP_SET_LOCAL:
+        case OP_GET_GLOBAL:
+        case OP_SET_GLOBAL:
+        case OP_ARRAY_LITERAL:
+        case OP_ADD_CONST:
+        case OP_SUB_CONST:
+            return 2;
+        case OP_HALT:
+        case OP_ADD:
+        case OP_SUB:
+        case OP_MUL:
+        case OP_DIV:
+        case OP_LOGICAL_NOT:
+        case OP_DUP:
+        case OP_NIL:
+        case OP_RETURN:
+        case OP_ARRAY_GET:
+        case OP_ARRAY_SET:
+        case OP_POP:
+            return 1;
+        default:
+            throw std::runtime_error("Неизвестный байткод " + std::to_string(opcode));
+    }
+}
+
+// Изменение глубины стека операндов после выполнения инструкции.
+// instruction указывает на опкод, за которым идут его операнды.
+inline int stackEffect(const uint8_t *instruction) {
+    switch (instruction[0]) {
+        case OP_CONST:
+        case OP_CONST_LONG:
+        case OP_GET_LOCAL:
+        case OP_GET_GLOBAL:
+        case OP_GET_GLOBAL_LONG:
+        case OP_DUP:
+        case OP_NIL:
+        case OP_ARRAY:
+        case OP_ARRAY_GET_LOCAL_LOCAL:
+            return 1;
+        case OP_GET_LOCAL_LOCAL:
+            return 2;
+        case OP_LOGICAL_NOT:
+        case OP_JUMP:
+        case OP_HALT:
+        case OP_ADD_CONST:
+        case OP_SUB_CONST:
+        case OP_INC_LOCAL:
+            return 0;
+        case OP_ADD:
+        case OP_SUB:
+        case OP_MUL:
+        case OP_DIV:
+        case OP_COMPARE:
+        case OP_ARRAY_GET:
+        case OP_JUMP_IF_FALSE:
+        case OP_JUMP_IF_TRUE:
+        case OP_JUMP_IF_FALSE_OR_POP:
+        case OP_JUMP_IF_TRUE_OR_POP:
+        case OP_SET_LOCAL:
+        case OP_SET_GLOBAL:
+        case OP_SET_GLOBAL_LONG:
+        case OP_RETURN:
+        case OP_POP:
+            return -1;
+        case OP_JUMP_IF_NOT_LT:
+        case OP_JUMP_IF_NOT_GT:
+        case OP_JUMP_IF_NOT_EQ:
+        case OP_JUMP_IF_NOT_GE:
+        case OP_JUMP_IF_NOT_LE:
+        case OP_JUMP_IF_NOT_NE:
+            return -2;
+        case OP_ARRAY_SET:
+            return -3;
+        case OP_CALL:
+            // Снимаются функция и аргументы, кладётся результат
+            return -instruction[1];
+        case OP_ARRAY_LITERAL:
+            return 1 - instruction[1];
+        default:
+            throw std::runtime_error("Неизвестный байткод " + std::to_string(instruction[0]));
+    }
+}
+
+// Инструкции, после которых управление не переходит к следующей по порядку
+inline bool isTerminator(uint8_t opcode) {
+    return opcode == OP_JUMP || opcode == OP_RETURN || opcode == OP_HALT;
+}
+
+// Инструкции перехода с 16-битным адресом в операнде
+inline bool isJump(uint8_t opcode) {
+    return opcode == OP_JUMP || opcode == OP_JUMP_IF_FALSE || opcode == OP_JUMP_IF_TRUE ||
+           opcode == OP_JUMP_IF_FALSE_OR_POP || opcode == OP_JUMP_IF_TRUE_OR_POP ||
+           (opcode >= OP_JUMP_IF_NOT_LT && opcode <= OP_JUMP_IF_NOT_NE);
+}
@@ -0,0 +1,329 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "EvaluationValue.h"
+#include "OpCode.h"
+
+// Щелевая (peephole) оптимизация байткода, выполняется один раз при компиляции.
+//
+// Байткод разбирается в список инструкций, где переход хранит не смещение, а индекс
+// целевой инструкции (символическую метку). Удалённая инструкция остаётся в списке
+// с пометкой removed, поэтому индексы не сдвигаются: переход на удалённую инструкцию
+// ведёт к следующей оставшейся. После правок байткод кодируется заново с новыми адресами.
+//
+// Правила применяются, пока что-то меняется:
+// - недостижимые инструкции удаляются;
+// - переход на JUMP заменяется переходом сразу по его адресу, JUMP на следующую
+//   инструкцию удаляется, JUMP на RETURN или HALT заменяется самой этой инструкцией,
+//   JUMP_IF_FALSE на следующую инструкцию становится POP;
+// - загрузка значения, которое тут же снимает POP, удаляется вместе с POP;
+// - GET_LOCAL x; SET_LOCAL x (присваивание переменной самой себе) удаляется;
+// - SET_LOCAL x; GET_LOCAL x -> DUP; SET_LOCAL x;
+// - LOGICAL_NOT; JUMP_IF_FALSE -> JUMP_IF_TRUE.
+// Пара инструкций заменяется, только если на вторую из них нет перехода.
+//
+// Затем частые последовательности сливаются в суперинструкции (OP_INC_LOCAL и другие,
+// см. OpCode.h), если на инструкции внутри последовательности нет переходов. Правила
+// и слияние включаются независимо друг от друга.
+class PeepholeOptimizer {
+public:
+    explicit PeepholeOptimizer(bool rewrite = true, bool superinstructions = true)
+        : rewrite(rewrite), superinstructions(superinstructions) {
+    }
+
+    // Оптимизирует байткод на месте и возвращает число удалённых инструкций
+    // (без учёта слитых в суперинструкции)
+    size_t optimize(CodeObject *co) {
+        decode(co);
+
+        bool changed = rewrite;
+        while (changed) {
+            changed = removeUnreachable();
+            changed = threadJumps() || changed;
+            changed = rewritePairs() || changed;
+        }
+
+        size_t removed = 0;
+        for (const Instruction &instruction: instructions) {
+            removed += instruction.removed;
+        }
+        if (superinstructions) {
+            fuseSuperinstructions();
+        }
+        co->code = encode(co);
+        return removed;
+    }
+
+    // Число суперинструкций, созданных во всех вызовах optimize
+    size_t fusedCount() const {
+        return fused;
+    }
+
+private:
+    struct Instruction {
+        uint8_t opcode;
+        uint8_t operands[3];
+        // Индекс целевой инструкции для переходов
+        size_t target;
+        bool removed;
+    };
+
+    void decode(const CodeObject *co) {
+        const std::vector<uint8_t> &code = co->code;
+        instructions.clear();
+
+        std::vector<size_t> indexAt(code.size() + 1, SIZE_MAX);
+        for (size_t offset = 0; offset < code.size(); offset += instructionLength(code[offset])) {
+            indexAt[offset] = instructions.size();
+            Instruction instruction{code[offset], {0, 0, 0}, 0, false};
+            for (size_t i = 1; i < instructionLength(code[offset]); ++i) {
+                instruction.operands[i - 1] = code[offset + i];
+            }
+            instructions.push_back(instruction);
+        }
+        indexAt[code.size()] = instructions.size();
+
+        for (Instruction &instruction: instructions) {
+            if (isJump(instruction.opcode)) {
+                size_t address = (instruction.operands[0] << 8) | instruction.operands[1];
+                if (address > code.size() || indexAt[address] == SIZE_MAX) {
+                    throw std::runtime_error("Переход в середину инструкции в " + co->name);
+                }
+                instruction.target = indexAt[address];
+            }
+        }
+    }
+
+    std::vector<uint8_t> encode(const CodeObject *co) const {
+        // Смещение удалённой инструкции совпадает со смещением следующей оставшейся
+        std::vector<size_t> offsetOf(instructions.size() + 1);
+        size_t offset = 0;
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            offsetOf[i] = offset;
+            if (!instructions[i].removed) {
+                offset += instructionLength(instructions[i].opcode);
+            }
+        }
+        offsetOf[instructions.size()] = offset;
+
+        std::vector<uint8_t> code;
+        code.reserve(offset);
+        for (const Instruction &instruction: instructions) {
+            if (instruction.removed) {
+                continue;
+            }
+            code.push_back(instruction.opcode);
+            if (isJump(instruction.opcode)) {
+                size_t address = offsetOf[instruction.target];
+                if (address > UINT16_MAX) {
+                    throw std::runtime_error("Слишком длинный переход в " + co->name);
+                }
+                code.push_back((uint8_t) ((address >> 8) & 0xFF));
+                code.push_back((uint8_t) (address & 0xFF));
+            } else {
+                for (size_t i = 1; i < instructionLength(instruction.opcode); ++i) {
+                    code.push_back(instruction.operands[i - 1]);
+                }
+            }
+        }
+        return code;
+    }
+
+    // Первая оставшаяся инструкция, начиная с index
+    size_t resolve(size_t index) const {
+        while (index < instructions.size() && instructions[index].removed) {
+            index++;
+        }
+        return index;
+    }
+
+    size_t next(size_t index) const {
+        return resolve(index + 1);
+    }
+
+    bool removeUnreachable() {
+        std::vector<bool> reachable(instructions.size(), false);
+        std::vector<size_t> worklist = {resolve(0)};
+        while (!worklist.empty()) {
+            size_t index = worklist.back();
+            worklist.pop_back();
+            if (index >= instructions.size() || reachable[index]) {
+                continue;
+            }
+            reachable[index] = true;
+
+            const Instruction &instruction = instructions[index];
+            if (isJump(instruction.opcode)) {
+                worklist.push_back(resolve(instruction.target));
+            }
+            if (!isTerminator(instruction.opcode)) {
+                worklist.push_back(next(index));
+            }
+        }
+
+        bool changed = false;
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            if (!instructions[i].removed && !reachable[i]) {
+                instructions[i].removed = true;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    bool threadJumps() {
+        bool changed = false;
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            Instruction &instruction = instructions[i];
+            if (instruction.removed || !isJump(instruction.opcode)) {
+                continue;
+            }
+
+            // JUMP не меняет стек, поэтому любой переход на него можно направить дальше.
+            // Число шагов ограничено, чтобы не зациклиться на бесконечном цикле из JUMP.
+            size_t target = resolve(instruction.target);
+            for (size_t hops = 0; hops < instructions.size() && target < instructions.size() && target != i &&
+                                  instructions[target].opcode == OP_JUMP; ++hops) {
+                target = resolve(instructions[target].target);
+            }
+            if (target != instruction.target) {
+                instruction.target = target;
+                changed = true;
+            }
+
+            if (instruction.opcode == OP_JUMP && target < instructions.size() &&
+                (instructions[target].opcode == OP_RETURN || instructions[target].opcode == OP_HALT)) {
+                instruction.opcode = instructions[target].opcode;
+                changed = true;
+            } else if (target == next(i)) {
+                if (instruction.opcode == OP_JUMP) {
+                    instruction.removed = true;
+                    changed = true;
+                } else if (instruction.opcode == OP_JUMP_IF_FALSE) {
+                    instruction.opcode = OP_POP;
+                    changed = true;
+                }
+            }
+        }
+        return changed;
+    }
+
+    // Инструкции, которые только кладут значение на стек и не могут завершиться ошибкой
+    static bool isPurePush(uint8_t opcode) {
+        switch (opcode) {
+            case OP_CONST:
+            case OP_CONST_LONG:
+            case OP_GET_LOCAL:
+            case OP_GET_GLOBAL:
+            case OP_GET_GLOBAL_LONG:
+            case OP_DUP:
+            case OP_NIL:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Инструкции, на которые есть переход
+    std::vector<bool> jumpTargets() const {
+        std::vector<bool> isTarget(instructions.size() + 1, false);
+        for (const Instruction &instruction: instructions) {
+            if (!instruction.removed && isJump(instruction.opcode)) {
+                isTarget[resolve(instruction.target)] = true;
+            }
+        }
+        return isTarget;
+    }
+
+    bool rewritePairs() {
+        std::vector<bool> isTarget = jumpTargets();
+
+        bool changed = false;
+        for (size_t i = resolve(0); i < instructions.size(); i = next(i)) {
+            size_t j = next(i);
+            if (j >= instructions.size() || isTarget[j]) {
+                continue;
+            }
+            Instruction &first = instructions[i];
+            Instruction &second = instructions[j];
+
+            if (isPurePush(first.opcode) && second.opcode == OP_POP) {
+                first.removed = true;
+                second.removed = true;
+                changed = true;
+            } else if (first.opcode == OP_GET_LOCAL && second.opcode == OP_SET_LOCAL &&
+                       first.operands[0] == second.operands[0]) {
+                first.removed = true;
+                second.removed = true;
+                changed = true;
+            } else if (first.opcode == OP_SET_LOCAL && second.opcode == OP_GET_LOCAL &&
+                       first.operands[0] == second.operands[0]) {
+                first.opcode = OP_DUP;
+                second.opcode = OP_SET_LOCAL;
+                changed = true;
+            } else if (first.opcode == OP_LOGICAL_NOT && second.opcode == OP_JUMP_IF_FALSE) {
+                // JUMP_IF_FALSE после NOT переходит ровно тогда, когда исходное значение истинно
+                first.removed = true;
+                second.opcode = OP_JUMP_IF_TRUE;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    void fuseSuperinstructions() {
+        std::vector<bool> isTarget = jumpTargets();
+
+        for (size_t i = resolve(0); i < instructions.size(); i = next(i)) {
+            // Окно из следующих оставшихся инструкций
+            size_t window[4] = {i, next(i), SIZE_MAX, SIZE_MAX};
+            for (size_t k = 2; k < 4 && window[k - 1] < instructions.size(); ++k) {
+                window[k] = next(window[k - 1]);
+            }
+            auto matches = [&](std::initializer_list<uint8_t> opcodes) {
+                size_t k = 0;
+                for (uint8_t opcode: opcodes) {
+                    if (window[k] >= instructions.size() || instructions[window[k]].opcode != opcode ||
+                        (k > 0 && isTarget[window[k]])) {
+                        return false;
+                    }
+                    k++;
+                }
+                return true;
+            };
+            auto operand = [&](size_t k) { return instructions[window[k]].operands[0]; };
+            auto fuse = [&](size_t length, uint8_t opcode, uint8_t first, uint8_t second) {
+                instructions[i] = Instruction{opcode, {first, second, 0}, 0, false};
+                for (size_t k = 1; k < length; ++k) {
+                    instructions[window[k]].removed = true;
+                }
+                fused++;
+            };
+
+            // Длинные последовательности проверяются первыми
+            if (matches({OP_GET_LOCAL, OP_CONST, OP_ADD, OP_SET_LOCAL}) && operand(0) == operand(3)) {
+                fuse(4, OP_INC_LOCAL, operand(0), operand(1));
+            } else if (matches({OP_GET_LOCAL, OP_GET_LOCAL, OP_ARRAY_GET})) {
+                fuse(3, OP_ARRAY_GET_LOCAL_LOCAL, operand(0), operand(1));
+            } else if (matches({OP_GET_LOCAL, OP_GET_LOCAL})) {
+                fuse(2, OP_GET_LOCAL_LOCAL, operand(0), operand(1));
+            } else if (matches({OP_CONST, OP_ADD})) {
+                fuse(2, OP_ADD_CONST, operand(0), 0);
+            } else if (matches({OP_CONST, OP_SUB})) {
+                fuse(2, OP_SUB_CONST, operand(0), 0);
+            }
+        }
+    }
+
+    bool rewrite;
+
+    bool superinstructions;
+
+    std::vector<Instruction> instructions;
+
+    size_t fused = 0;
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+// Регистровый набор инструкций (CompilerOptions::backend = Backend::REGISTER).
+//
+// Регистры - слоты фрейма на стеке операндов: сначала параметры и локальные переменные,
+// затем временные значения выражений. Инструкция читает операнды прямо из регистров
+// и пишет результат в регистр назначения: ADD d a b вместо GET_LOCAL a; GET_LOCAL b; ADD; SET_LOCAL d.
+//
+// Номер регистра занимает байт, индексы констант и глобальных переменных и адреса
+// переходов - два байта (старший первым). Адрес перехода абсолютный, как в OpCode.h.
+
+constexpr auto ROP_HALT = 0x00;            // HALT a - результат программы из регистра a
+constexpr auto ROP_LOAD_CONST = 0x01;      // d k16
+constexpr auto ROP_LOAD_NIL = 0x02;        // d
+constexpr auto ROP_MOVE = 0x03;            // d s
+constexpr auto ROP_GET_GLOBAL = 0x04;      // d g16
+constexpr auto ROP_SET_GLOBAL = 0x05;      // g16 s
+
+constexpr auto ROP_ADD = 0x06;             // d a b
+constexpr auto ROP_SUB = 0x07;
+constexpr auto ROP_MUL = 0x08;
+constexpr auto ROP_DIV = 0x09;
+constexpr auto ROP_ADD_CONST = 0x0A;       // d a k16
+constexpr auto ROP_SUB_CONST = 0x0B;       // d a k16
+constexpr auto ROP_COMPARE = 0x0C;         // d a b, код сравнения как у OP_COMPARE
+constexpr auto ROP_NOT = 0x0D;             // d a
+
+constexpr auto ROP_JUMP = 0x0E;            // addr16
+// Переход, только если в регистре логическое false (как OP_JUMP_IF_FALSE)
+constexpr auto ROP_JUMP_IF_FALSE = 0x0F;   // a addr16
+// Переходы по истинности значения (vm::isTruth) для &&, || и отрицаний в условиях
+constexpr auto ROP_JUMP_IF_FALSY = 0x10;   // a addr16
+constexpr auto ROP_JUMP_IF_TRUTHY = 0x11;  // a addr16
+
+// Переход, если сравнение a и b ложно: ROP_JUMP_IF_NOT_LT + код сравнения
+constexpr auto ROP_JUMP_IF_NOT_LT = 0x12;  // a b addr16
+constexpr auto ROP_JUMP_IF_NOT_GT = 0x13;
+constexpr auto ROP_JUMP_IF_NOT_EQ = 0x14;
+constexpr auto ROP_JUMP_IF_NOT_GE = 0x15;
+constexpr auto ROP_JUMP_IF_NOT_LE = 0x16;
+constexpr auto ROP_JUMP_IF_NOT_NE = 0x17;
+
+constexpr auto ROP_ARRAY = 0x18;           // d capacity16
+constexpr auto ROP_ARRAY_LITERAL = 0x19;   // d first count - массив из регистров first..first+count-1
+constexpr auto ROP_ARRAY_GET = 0x1A;       // d array index
+constexpr auto ROP_ARRAY_SET = 0x1B;       // array index value
+
+// Вызов: функция в регистре f, аргументы в f+1..f+argc; результат записывается в f.
+// Регистры вызванной функции начинаются с f+1, поэтому аргументы не копируются.
+constexpr auto ROP_CALL = 0x1C;            // f argc
+constexpr auto ROP_RETURN = 0x1D;          // a
+
+
+// Операнды инструкции по порядку: r - регистр, b - байт (код сравнения, число значений),
+// k - индекс константы, g - индекс глобальной переменной, n - ёмкость, a - адрес перехода.
+// k, g, n и a занимают два байта, остальные - один.
+inline const char *registerOperands(uint8_t opcode) {
+    switch (opcode) {
+        case ROP_HALT: return "r";
+        case ROP_LOAD_CONST: return "rk";
+        case ROP_LOAD_NIL: return "r";
+        case ROP_MOVE: return "rr";
+        case ROP_GET_GLOBAL: return "rg";
+        case ROP_SET_GLOBAL: return "gr";
+        case ROP_ADD:
+        case ROP_SUB:
+        case ROP_MUL:
+        case ROP_DIV:
+            return "rrr";
+        case ROP_ADD_CONST:
+        case ROP_SUB_CONST:
+            return "rrk";
+        case ROP_COMPARE: return "rrrb";
+        case ROP_NOT: return "rr";
+        case ROP_JUMP: return "a";
+        case ROP_JUMP_IF_FALSE:
+        case ROP_JUMP_IF_FALSY:
+        case ROP_JUMP_IF_TRUTHY:
+            return "ra";
+        case ROP_JUMP_IF_NOT_LT:
+        case ROP_JUMP_IF_NOT_GT:
+        case ROP_JUMP_IF_NOT_EQ:
+        case ROP_JUMP_IF_NOT_GE:
+        case ROP_JUMP_IF_NOT_LE:
+        case ROP_JUMP_IF_NOT_NE:
+            return "rra";
+        case ROP_ARRAY: return "rn";
+        case ROP_ARRAY_LITERAL: return "rrb";
+        case ROP_ARRAY_GET: return "rrr";
+        case ROP_ARRAY_SET: return "rrr";
+        case ROP_CALL: return "rb";
+        case ROP_RETURN: return "r";
+        default:
+            throw std::runtime_error("Неизвестная регистровая инструкция " + std::to_string(opcode));
+    }
+}
+
+inline std::string registerOpcodeToString(uint8_t opcode) {
+    switch (opcode) {
+        case ROP_HALT: return "HALT";
+        case ROP_LOAD_CONST: return "LOAD_CONST";
+        case ROP_LOAD_NIL: return "LOAD_NIL";
+        case ROP_MOVE: return "MOVE";
+        case ROP_GET_GLOBAL: return "GET_GLOBAL";
+        case ROP_SET_GLOBAL: return "SET_GLOBAL";
+        case ROP_ADD: return "ADD";
+        case ROP_SUB: return "SUB";
+        case ROP_MUL: return "MUL";
+        case ROP_DIV: return "DIV";
+        case ROP_ADD_CONST: return "ADD_CONST";
+        case ROP_SUB_CONST: return "SUB_CONST";
+        case ROP_COMPARE: return "COMPARE";
+        case ROP_NOT: return "NOT";
+        case ROP_JUMP: return "JUMP";
+        case ROP_JUMP_IF_FALSE: return "JUMP_IF_FALSE";
+        case ROP_JUMP_IF_FALSY: return "JUMP_IF_FALSY";
+        case ROP_JUMP_IF_TRUTHY: return "JUMP_IF_TRUTHY";
+        case ROP_JUMP_IF_NOT_LT: return "JUMP_IF_NOT_LT";
+        case ROP_JUMP_IF_NOT_GT: return "JUMP_IF_NOT_GT";
+        case ROP_JUMP_IF_NOT_EQ: return "JUMP_IF_NOT_EQ";
+        case ROP_JUMP_IF_NOT_GE: return "JUMP_IF_NOT_GE";
+        case ROP_JUMP_IF_NOT_LE: return "JUMP_IF_NOT_LE";
+        case ROP_JUMP_IF_NOT_NE: return "JUMP_IF_NOT_NE";
+        case ROP_ARRAY: return "ARRAY";
+        case ROP_ARRAY_LITERAL: return "ARRAY_LITERAL";
+        case ROP_ARRAY_GET: return "ARRAY_GET";
+        case ROP_ARRAY_SET: return "ARRAY_SET";
+        case ROP_CALL: return "CALL";
+        case ROP_RETURN: return "RETURN";
+        default:
+            throw std::runtime_error("Неизвестная регистровая инструкция " + std::to_string(opcode));
+    }
+}
+
+inline bool isWideRegisterOperand(char operand) {
+    return operand == 'k' || operand == 'g' || operand == 'n' || operand == 'a';
+}
+
+// Длина инструкции в байтах вместе с операндами
+inline size_t registerInstructionLength(uint8_t opcode) {
+    size_t length = 1;
+    for (const char *operand = registerOperands(opcode); *operand != '\0'; ++operand) {
+        length += isWideRegisterOperand(*operand) ? 2 : 1;
+    }
+    return length;
+}
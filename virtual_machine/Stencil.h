@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Трафарет (stencil) для JIT-компилятора копированием и заплатками (CopyPatchJit.h):
+// машинный код одной инструкции байткода, скомпилированный при сборке из stencils/stencils.cpp,
+// с дырами под операнды и адреса продолжения. Трафареты извлекает из объектного файла
+// stencils/extractStencils.cpp и записывает в сгенерированный Stencils.h.
+
+// Что записывается в дыру (64-битный абсолютный адрес или значение)
+enum class StencilHole : uint8_t {
+    // Машинный код следующей инструкции
+    CONTINUE,
+    // Машинный код цели перехода
+    TARGET,
+    // Адрес инструкции байткода, которую выполнит интерпретатор
+    EXIT,
+    // Операнды, которые подставляет компилятор (значение, номер слота, адрес)
+    OPERAND0,
+    OPERAND1,
+    OPERAND2,
+};
+
+struct StencilPatch {
+    uint16_t offset;
+    StencilHole hole;
+    int64_t addend;
+};
+
+struct Stencil {
+    const uint8_t *code;
+    uint16_t size;
+
+    const StencilPatch *patches;
+    uint8_t patchCount;
+
+    // Начало завершающего перехода на CONTINUE (movabs + jmp) или size, если его нет.
+    // Когда следующая инструкция лежит сразу за трафаретом, код копируется только до него.
+    uint16_t tailJump;
+};
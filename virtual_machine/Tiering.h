@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "EvaluationValue.h"
+
+// Уровни исполнения стекового кода и правила перехода между ними.
+//
+// Байткод оптимизируется один раз при компиляции (ConstantFolder, PeepholeOptimizer), поэтому
+// каждый объект кода начинает исполняться в интерпретаторе уже на оптимизированном байткоде.
+// Горячие циклы интерпретатор записывает в трассы (TraceJit.h), а горячие объекты кода
+// компилирует в машинный код (Jit.h, CopyPatchJit.h). Объект кода считает вызовы
+// и обратные переходы раздельно:
+// - на пороге вызовов он компилируется при очередном вызове и исполняется с первой инструкции;
+// - на пороге обратных переходов он компилируется посреди исполнения, и фрейм продолжается
+//   в машинном коде с заголовка цикла (on-stack replacement). Так переходит на машинный код
+//   долгий цикл main, который вызывается один раз.
+// Машинный код может начать исполнение с любой инструкции (NativeCode::run), поэтому
+// переход не требует отдельной точки входа; фреймы, уже стоящие в стеке вызовов, переходят
+// на машинный код при возврате в них.
+
+enum class Tier : uint8_t {
+    // Байткод в интерпретаторе, горячие циклы - в трассах
+    INTERPRETER,
+    // Машинный код
+    NATIVE,
+};
+
+inline Tier tierOf(const CodeObject *codeObject) {
+    return codeObject->native != nullptr ? Tier::NATIVE : Tier::INTERPRETER;
+}
+
+// Число объектов кода, переведённых на машинный код
+struct TieringStats {
+    // При вызове
+    size_t promotedOnCall = 0;
+
+    // Посреди исполнения, на обратном переходе (on-stack replacement)
+    size_t promotedInLoop = 0;
+};
+
+class TieringPolicy {
+public:
+    TieringPolicy(uint32_t callThreshold, uint32_t backEdgeThreshold)
+        : callThreshold(callThreshold), backEdgeThreshold(backEdgeThreshold) {
+    }
+
+    // Вызов объекта кода; true, если он достиг порога вызовов
+    bool hotCall(CodeObject *codeObject) const {
+        return ++codeObject->invocations >= callThreshold;
+    }
+
+    // Обратный переход в объекте кода; true, если он достиг порога обратных переходов
+    bool hotBackEdge(CodeObject *codeObject) const {
+        return ++codeObject->backEdges >= backEdgeThreshold;
+    }
+
+    uint32_t callThreshold;
+
+    uint32_t backEdgeThreshold;
+};
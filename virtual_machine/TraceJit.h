@@ -0,0 +1,992 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "EvaluationValue.h"
+#include "Global.h"
+#include "Jit.h"
+#include "OpCode.h"
+
+// Трассирующий JIT для горячих циклов стекового байткода (x86-64 Linux, как и Jit.h).
+//
+// vm считает обратные переходы на каждый заголовок цикла. Когда заголовок становится
+// горячим, одна итерация цикла исполняется обработчиками с записью: TraceRecorder переводит
+// каждую инструкцию в линейный промежуточный код (операнд - номер инструкции, вычислившей
+// значение) и ставит охранные проверки на то, что видел при записи: типы значений (малое
+// целое, массив чисел) и направление условных переходов. Запись заканчивается, когда
+// исполнение вернулось в заголовок; вызовы, создание объектов и значения других типов
+// прерывают её.
+//
+// TraceOptimizer упрощает трассу: повторные чтения локальных и глобальных переменных
+// заменяются уже известными значениями, константы распространяются и сворачиваются,
+// проверки типа значения, тип которого уже известен, удаляются, неиспользуемые значения
+// выбрасываются.
+//
+// TraceCache переводит трассу в машинный код. Значения живут в слотах на машинном стеке,
+// стек операндов vm внутри трассы не используется. Неудачная проверка ведёт в боковой
+// выход: значения, которые в этой точке лежали бы на стеке операндов, записываются на стек
+// vm, и трасса возвращает адрес инструкции, с которой продолжает vm::evalExp (или базовый
+// машинный код). Все проверки инструкции выходят на саму эту инструкцию, до её эффектов,
+// поэтому интерпретатор выполняет её заново со всеми медленными путями и ошибками.
+
+enum class TraceOp : uint8_t {
+    CONST,              // значение immediate
+    LOAD_LOCAL,         // локальная переменная immediate
+    LOAD_GLOBAL,        // глобальная переменная immediate
+    STORE_LOCAL,        // локальная переменная immediate = a
+    GUARD_SMALL_NUMBER, // a - малое целое
+    GUARD_NUMBER_ARRAY, // a - массив чисел (ArrayObject::Kind::INT64)
+    GUARD_EQUAL,        // (a == immediate) == expected
+    GUARD_COMPARE,      // (a condition b) == expected для малых целых
+    ADD,                // a + b, выход при переполнении малого целого
+    SUB,
+    MUL,
+    COMPARE,            // логическое значение a condition b
+    ARRAY_GET,          // a[b]; выход, если индекс вне границ или элемент не малое целое
+    ARRAY_SET,          // a[b] = c
+    LOOP,               // переход в начало трассы
+    NOP,                // удалено оптимизатором
+};
+
+struct TraceInstruction {
+    TraceOp op;
+    uint16_t a = 0;
+    uint16_t b = 0;
+    uint16_t c = 0;
+
+    // Код сравнения OP_COMPARE
+    uint8_t condition = 0;
+
+    bool expected = false;
+
+    uint64_t immediate = 0;
+
+    // Состояние для бокового выхода (индекс в TraceIr::snapshots) или -1
+    int32_t snapshot = -1;
+};
+
+// Состояние бокового выхода: смещение инструкции байткода, с которой продолжает
+// интерпретатор, и значения на стеке операндов над его высотой при входе в трассу
+struct TraceSnapshot {
+    uint32_t resume;
+    std::vector<uint16_t> stack;
+};
+
+struct TraceIr {
+    std::vector<TraceInstruction> instructions;
+    std::vector<TraceSnapshot> snapshots;
+};
+
+struct TraceStats {
+    // Инструкций промежуточного кода после записи и после оптимизации
+    size_t recorded = 0;
+    size_t optimized = 0;
+
+    // Чтений переменных, замененных известным значением
+    size_t loadsForwarded = 0;
+
+    // Вычислений, свёрнутых в константу
+    size_t constantsFolded = 0;
+
+    // Удалённых охранных проверок
+    size_t guardsRemoved = 0;
+
+    TraceStats &operator+=(const TraceStats &other) {
+        recorded += other.recorded;
+        optimized += other.optimized;
+        loadsForwarded += other.loadsForwarded;
+        constantsFolded += other.constantsFolded;
+        guardsRemoved += other.guardsRemoved;
+        return *this;
+    }
+};
+
+// Запись одной итерации цикла, начиная с заголовка
+class TraceRecorder {
+public:
+    // Длинные тела циклов (и циклы с вложенными циклами, которые разворачиваются в трассе)
+    // не записываются
+    static constexpr size_t MAX_INSTRUCTIONS = 1000;
+
+    // directAccess - машинный код может читать глобальные переменные и буферы массивов (JitLayout)
+    TraceRecorder(const CodeObject *codeObject, const uint8_t *header, bool directAccess)
+        : codeObject(codeObject), header(header), directAccess(directAccess) {
+    }
+
+    // Записывает инструкцию ip перед её исполнением; по стеку vm (sp) и локальным переменным
+    // видны типы операндов. Возвращает false, если инструкцию нельзя включить в трассу.
+    bool record(const uint8_t *ip, const EvaluationValue *sp, const EvaluationValue *locals) {
+        const uint8_t *operands = ip + 1;
+        uint8_t opcode = *ip;
+        offset = static_cast<uint32_t>(ip - codeObject->code.data());
+        stackBefore = stack;
+        snapshot = -1;
+        next = ip + instructionLength(opcode);
+        auto target = [&]() {
+            return &codeObject->code[(operands[0] << 8) | operands[1]];
+        };
+
+        switch (opcode) {
+            case OP_CONST:
+                push(constant(codeObject->constants[operands[0]]));
+                break;
+            case OP_CONST_LONG:
+                push(constant(codeObject->constants[(operands[0] << 8) | operands[1]]));
+                break;
+            case OP_NIL:
+                push(constant(NIL()));
+                break;
+            case OP_GET_LOCAL:
+                push(load(TraceOp::LOAD_LOCAL, operands[0]));
+                break;
+            case OP_GET_LOCAL_LOCAL:
+                push(load(TraceOp::LOAD_LOCAL, operands[0]));
+                push(load(TraceOp::LOAD_LOCAL, operands[1]));
+                break;
+            case OP_SET_LOCAL: {
+                if (stack.empty()) {
+                    return false;
+                }
+                store(operands[0], pop());
+                break;
+            }
+            case OP_DUP:
+                if (stack.empty()) {
+                    return false;
+                }
+                push(stack.back());
+                break;
+            case OP_POP:
+                if (stack.empty()) {
+                    return false;
+                }
+                pop();
+                break;
+            case OP_GET_GLOBAL:
+            case OP_GET_GLOBAL_LONG:
+                if (!directAccess) {
+                    return false;
+                }
+                push(load(TraceOp::LOAD_GLOBAL, opcode == OP_GET_GLOBAL ? operands[0] : (operands[0] << 8) | operands[1]));
+                break;
+            case OP_ADD:
+            case OP_SUB:
+            case OP_MUL: {
+                TraceOp op = opcode == OP_ADD ? TraceOp::ADD : opcode == OP_SUB ? TraceOp::SUB : TraceOp::MUL;
+                if (stack.size() < 2 || !fitsSmallNumber(op, sp[-2], sp[-1])) {
+                    return false;
+                }
+                uint16_t right = pop();
+                uint16_t left = pop();
+                push(arithmetic(op, left, right));
+                break;
+            }
+            case OP_ADD_CONST:
+            case OP_SUB_CONST: {
+                TraceOp op = opcode == OP_ADD_CONST ? TraceOp::ADD : TraceOp::SUB;
+                EvaluationValue right = codeObject->constants[operands[0]];
+                if (stack.empty() || !fitsSmallNumber(op, sp[-1], right)) {
+                    return false;
+                }
+                uint16_t left = pop();
+                push(arithmetic(op, left, constant(right)));
+                break;
+            }
+            case OP_INC_LOCAL: {
+                EvaluationValue right = codeObject->constants[operands[1]];
+                if (!fitsSmallNumber(TraceOp::ADD, locals[operands[0]], right)) {
+                    return false;
+                }
+                uint16_t left = load(TraceOp::LOAD_LOCAL, operands[0]);
+                store(operands[0], arithmetic(TraceOp::ADD, left, constant(right)));
+                break;
+            }
+            case OP_COMPARE: {
+                if (stack.size() < 2 || !sp[-2].isSmallNumber() || !sp[-1].isSmallNumber() || operands[0] > 5) {
+                    return false;
+                }
+                uint16_t right = guardSmallNumber(pop());
+                uint16_t left = guardSmallNumber(pop());
+                TraceInstruction instruction{TraceOp::COMPARE, left, right};
+                instruction.condition = operands[0];
+                push(emit(instruction));
+                break;
+            }
+            case OP_JUMP_IF_NOT_LT:
+            case OP_JUMP_IF_NOT_GT:
+            case OP_JUMP_IF_NOT_EQ:
+            case OP_JUMP_IF_NOT_GE:
+            case OP_JUMP_IF_NOT_LE:
+            case OP_JUMP_IF_NOT_NE: {
+                if (stack.size() < 2 || !sp[-2].isSmallNumber() || !sp[-1].isSmallNumber()) {
+                    return false;
+                }
+                uint8_t condition = opcode - OP_JUMP_IF_NOT_LT;
+                bool holds = compareWords(condition, sp[-2], sp[-1]);
+                uint16_t right = guardSmallNumber(pop());
+                uint16_t left = guardSmallNumber(pop());
+                TraceInstruction guard{TraceOp::GUARD_COMPARE, left, right};
+                guard.condition = condition;
+                guard.expected = holds;
+                guard.snapshot = exitSnapshot();
+                emit(guard);
+                if (!holds) {
+                    next = target();
+                }
+                break;
+            }
+            case OP_JUMP_IF_FALSE: {
+                if (stack.empty()) {
+                    return false;
+                }
+                // Переход только на false; любое другое значение, в том числе не логическое, - нет
+                bool jumps = sp[-1].bits == EvaluationValue::FALSE_BITS;
+                guardEqual(pop(), EvaluationValue::FALSE_BITS, jumps);
+                if (jumps) {
+                    next = target();
+                }
+                break;
+            }
+            case OP_JUMP_IF_TRUE: {
+                if (stack.empty() || !IS_BOOL(sp[-1])) {
+                    return false;
+                }
+                bool jumps = sp[-1].bits == EvaluationValue::TRUE_BITS;
+                guardEqual(pop(), sp[-1].bits, true);
+                if (jumps) {
+                    next = target();
+                }
+                break;
+            }
+            case OP_JUMP:
+                next = target();
+                break;
+            case OP_ARRAY_GET:
+            case OP_ARRAY_GET_LOCAL_LOCAL: {
+                bool fromLocals = opcode == OP_ARRAY_GET_LOCAL_LOCAL;
+                if (!fromLocals && stack.size() < 2) {
+                    return false;
+                }
+                EvaluationValue arrayVal = fromLocals ? locals[operands[0]] : sp[-2];
+                EvaluationValue indexVal = fromLocals ? locals[operands[1]] : sp[-1];
+                if (!directAccess || !isNumberArray(arrayVal) || !inBounds(arrayVal, indexVal) ||
+                    !fitsSmallNumber(AS_ARRAY(arrayVal)->numbers[indexVal.number()])) {
+                    return false;
+                }
+                uint16_t index = fromLocals ? load(TraceOp::LOAD_LOCAL, operands[1]) : pop();
+                uint16_t array = fromLocals ? load(TraceOp::LOAD_LOCAL, operands[0]) : pop();
+                TraceInstruction get{TraceOp::ARRAY_GET, guardNumberArray(array), guardSmallNumber(index)};
+                get.snapshot = exitSnapshot();
+                push(emit(get));
+                break;
+            }
+            case OP_ARRAY_SET: {
+                if (stack.size() < 3 || !directAccess || !isNumberArray(sp[-3]) || !inBounds(sp[-3], sp[-2]) ||
+                    !sp[-1].isSmallNumber()) {
+                    return false;
+                }
+                uint16_t value = guardSmallNumber(pop());
+                uint16_t index = guardSmallNumber(pop());
+                uint16_t array = guardNumberArray(pop());
+                TraceInstruction set{TraceOp::ARRAY_SET, array, index, value};
+                set.snapshot = exitSnapshot();
+                emit(set);
+                break;
+            }
+            default:
+                // Вызовы, возвраты, создание объектов, запись глобальных переменных с барьером,
+                // деление и логические операции над значениями любых типов трасса не содержит
+                return false;
+        }
+
+        if (next == header) {
+            // Высота стека в заголовке цикла одна и та же на каждой итерации
+            if (!stack.empty()) {
+                return false;
+            }
+            emit(TraceInstruction{TraceOp::LOOP});
+            loopClosed = true;
+        }
+        return trace.instructions.size() <= MAX_INSTRUCTIONS;
+    }
+
+    // Адрес инструкции, которая по записи исполняется следующей
+    const uint8_t *expectedNext() const {
+        return next;
+    }
+
+    // Исполнение вернулось в заголовок цикла: трасса готова
+    bool closed() const {
+        return loopClosed;
+    }
+
+    TraceIr &ir() {
+        return trace;
+    }
+
+private:
+    static bool isNumberArray(const EvaluationValue &value) {
+        return IS_ARRAY(value) && AS_ARRAY(value)->kind == ArrayObject::Kind::INT64;
+    }
+
+    static bool inBounds(const EvaluationValue &arrayVal, const EvaluationValue &indexVal) {
+        return indexVal.isSmallNumber() && static_cast<uint64_t>(indexVal.number()) < AS_ARRAY(arrayVal)->size();
+    }
+
+    static bool fitsSmallNumber(int64_t number) {
+        return number >= EvaluationValue::SMALL_NUMBER_MIN && number <= EvaluationValue::SMALL_NUMBER_MAX;
+    }
+
+    // Операция над малыми целыми, результат которой - тоже малое целое
+    static bool fitsSmallNumber(TraceOp op, const EvaluationValue &left, const EvaluationValue &right) {
+        if (!left.isSmallNumber() || !right.isSmallNumber()) {
+            return false;
+        }
+        int64_t result;
+        bool overflow = op == TraceOp::ADD ? __builtin_add_overflow(left.number(), right.number(), &result)
+                      : op == TraceOp::SUB ? __builtin_sub_overflow(left.number(), right.number(), &result)
+                      : __builtin_mul_overflow(left.number(), right.number(), &result);
+        return !overflow && fitsSmallNumber(result);
+    }
+
+    // Слова малых целых упорядочены так же, как числа
+    static bool compareWords(uint8_t condition, const EvaluationValue &left, const EvaluationValue &right) {
+        auto l = static_cast<int64_t>(left.bits);
+        auto r = static_cast<int64_t>(right.bits);
+        switch (condition) {
+            case 0: return l < r;
+            case 1: return l > r;
+            case 2: return l == r;
+            case 3: return l >= r;
+            case 4: return l <= r;
+            default: return l != r;
+        }
+    }
+
+    uint16_t emit(const TraceInstruction &instruction) {
+        trace.instructions.push_back(instruction);
+        return static_cast<uint16_t>(trace.instructions.size() - 1);
+    }
+
+    void push(uint16_t value) {
+        stack.push_back(value);
+    }
+
+    uint16_t pop() {
+        uint16_t value = stack.back();
+        stack.pop_back();
+        return value;
+    }
+
+    uint16_t constant(const EvaluationValue &value) {
+        TraceInstruction instruction{TraceOp::CONST};
+        instruction.immediate = value.bits;
+        return emit(instruction);
+    }
+
+    uint16_t load(TraceOp op, size_t index) {
+        TraceInstruction instruction{op};
+        instruction.immediate = index;
+        return emit(instruction);
+    }
+
+    void store(uint8_t slot, uint16_t value) {
+        TraceInstruction instruction{TraceOp::STORE_LOCAL, value};
+        instruction.immediate = slot;
+        emit(instruction);
+    }
+
+    // Выход на текущую инструкцию со стеком до неё; один на все проверки инструкции
+    int32_t exitSnapshot() {
+        if (snapshot < 0) {
+            snapshot = static_cast<int32_t>(trace.snapshots.size());
+            trace.snapshots.push_back(TraceSnapshot{offset, stackBefore});
+        }
+        return snapshot;
+    }
+
+    uint16_t guardSmallNumber(uint16_t value) {
+        TraceInstruction guard{TraceOp::GUARD_SMALL_NUMBER, value};
+        guard.snapshot = exitSnapshot();
+        emit(guard);
+        return value;
+    }
+
+    uint16_t guardNumberArray(uint16_t value) {
+        TraceInstruction guard{TraceOp::GUARD_NUMBER_ARRAY, value};
+        guard.snapshot = exitSnapshot();
+        emit(guard);
+        return value;
+    }
+
+    void guardEqual(uint16_t value, uint64_t word, bool expected) {
+        TraceInstruction guard{TraceOp::GUARD_EQUAL, value};
+        guard.immediate = word;
+        guard.expected = expected;
+        guard.snapshot = exitSnapshot();
+        emit(guard);
+    }
+
+    uint16_t arithmetic(TraceOp op, uint16_t left, uint16_t right) {
+        TraceInstruction instruction{op, guardSmallNumber(left), guardSmallNumber(right)};
+        instruction.snapshot = exitSnapshot();
+        return emit(instruction);
+    }
+
+    const CodeObject *codeObject;
+    const uint8_t *header;
+    bool directAccess;
+
+    TraceIr trace;
+
+    // Значения на стеке операндов над его высотой при входе в трассу
+    std::vector<uint16_t> stack;
+
+    // Состояние перед записываемой инструкцией
+    uint32_t offset = 0;
+    std::vector<uint16_t> stackBefore;
+    int32_t snapshot = -1;
+
+    const uint8_t *next = nullptr;
+    bool loopClosed = false;
+};
+
+// Оптимизация записанной трассы за один проход вперёд и один назад
+class TraceOptimizer {
+public:
+    void optimize(TraceIr &trace, TraceStats &stats) {
+        std::vector<TraceInstruction> &instructions = trace.instructions;
+        stats.recorded = instructions.size();
+
+        // Замена значения равным ему более ранним и известные типы значений
+        std::vector<uint16_t> replacement(instructions.size());
+        std::vector<Known> known(instructions.size(), Known::UNKNOWN);
+        std::unordered_map<uint64_t, uint16_t> localValues;
+        std::unordered_map<uint64_t, uint16_t> globalValues;
+
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            replacement[i] = static_cast<uint16_t>(i);
+            TraceInstruction &instruction = instructions[i];
+            size_t operandCount = operands(instruction.op);
+            if (operandCount > 0) instruction.a = replacement[instruction.a];
+            if (operandCount > 1) instruction.b = replacement[instruction.b];
+            if (operandCount > 2) instruction.c = replacement[instruction.c];
+
+            switch (instruction.op) {
+                case TraceOp::CONST: {
+                    EvaluationValue value{instruction.immediate};
+                    known[i] = value.isSmallNumber() ? Known::SMALL_NUMBER : Known::UNKNOWN;
+                    break;
+                }
+                case TraceOp::LOAD_LOCAL:
+                case TraceOp::LOAD_GLOBAL: {
+                    // Глобальные переменные трасса не пишет, локальные - только через STORE_LOCAL
+                    auto &values = instruction.op == TraceOp::LOAD_LOCAL ? localValues : globalValues;
+                    auto found = values.find(instruction.immediate);
+                    if (found != values.end()) {
+                        replacement[i] = found->second;
+                        instruction.op = TraceOp::NOP;
+                        stats.loadsForwarded++;
+                    } else {
+                        values[instruction.immediate] = static_cast<uint16_t>(i);
+                    }
+                    break;
+                }
+                case TraceOp::STORE_LOCAL:
+                    localValues[instruction.immediate] = instruction.a;
+                    break;
+                case TraceOp::GUARD_SMALL_NUMBER:
+                case TraceOp::GUARD_NUMBER_ARRAY: {
+                    Known type = instruction.op == TraceOp::GUARD_SMALL_NUMBER ? Known::SMALL_NUMBER
+                                                                               : Known::NUMBER_ARRAY;
+                    if (known[instruction.a] == type) {
+                        instruction.op = TraceOp::NOP;
+                        stats.guardsRemoved++;
+                    } else {
+                        known[instruction.a] = type;
+                    }
+                    break;
+                }
+                case TraceOp::GUARD_EQUAL:
+                case TraceOp::GUARD_COMPARE:
+                    // Проверка константы выполнялась при записи и всегда даёт тот же результат
+                    if (isConstant(instructions, instruction.a) &&
+                        (instruction.op == TraceOp::GUARD_EQUAL || isConstant(instructions, instruction.b))) {
+                        instruction.op = TraceOp::NOP;
+                        stats.guardsRemoved++;
+                    }
+                    break;
+                case TraceOp::ADD:
+                case TraceOp::SUB:
+                case TraceOp::MUL:
+                case TraceOp::COMPARE:
+                    known[i] = instruction.op == TraceOp::COMPARE ? Known::UNKNOWN : Known::SMALL_NUMBER;
+                    if (isConstant(instructions, instruction.a) && isConstant(instructions, instruction.b)) {
+                        fold(instruction, instructions[instruction.a].immediate, instructions[instruction.b].immediate);
+                        stats.constantsFolded++;
+                    }
+                    break;
+                case TraceOp::ARRAY_GET:
+                    known[i] = Known::SMALL_NUMBER;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        for (TraceSnapshot &snapshot: trace.snapshots) {
+            for (uint16_t &value: snapshot.stack) {
+                value = replacement[value];
+            }
+        }
+
+        // Удаление неиспользуемых значений: операнды всегда раньше инструкции
+        std::vector<bool> used(instructions.size(), false);
+        for (size_t i = instructions.size(); i-- > 0;) {
+            TraceInstruction &instruction = instructions[i];
+            if (instruction.op == TraceOp::NOP) {
+                continue;
+            }
+            if (!used[i] && !hasEffect(instruction.op)) {
+                instruction.op = TraceOp::NOP;
+                continue;
+            }
+            size_t operandCount = operands(instruction.op);
+            if (operandCount > 0) used[instruction.a] = true;
+            if (operandCount > 1) used[instruction.b] = true;
+            if (operandCount > 2) used[instruction.c] = true;
+            if (instruction.snapshot >= 0) {
+                for (uint16_t value: trace.snapshots[instruction.snapshot].stack) {
+                    used[value] = true;
+                }
+            }
+        }
+
+        stats.optimized = 0;
+        for (const TraceInstruction &instruction: instructions) {
+            stats.optimized += instruction.op != TraceOp::NOP;
+        }
+    }
+
+private:
+    enum class Known : uint8_t {
+        UNKNOWN,
+        SMALL_NUMBER,
+        NUMBER_ARRAY,
+    };
+
+    static size_t operands(TraceOp op) {
+        switch (op) {
+            case TraceOp::STORE_LOCAL:
+            case TraceOp::GUARD_SMALL_NUMBER:
+            case TraceOp::GUARD_NUMBER_ARRAY:
+            case TraceOp::GUARD_EQUAL:
+                return 1;
+            case TraceOp::GUARD_COMPARE:
+            case TraceOp::ADD:
+            case TraceOp::SUB:
+            case TraceOp::MUL:
+            case TraceOp::COMPARE:
+            case TraceOp::ARRAY_GET:
+                return 2;
+            case TraceOp::ARRAY_SET:
+                return 3;
+            default:
+                return 0;
+        }
+    }
+
+    // Инструкции, которые нужны, даже если их значение не используется: запись, проверки
+    // и чтение массива, которое при записи не могло выйти за границы
+    static bool hasEffect(TraceOp op) {
+        switch (op) {
+            case TraceOp::CONST:
+            case TraceOp::LOAD_LOCAL:
+            case TraceOp::LOAD_GLOBAL:
+            case TraceOp::ADD:
+            case TraceOp::SUB:
+            case TraceOp::MUL:
+            case TraceOp::COMPARE:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    static bool isConstant(const std::vector<TraceInstruction> &instructions, uint16_t value) {
+        return instructions[value].op == TraceOp::CONST;
+    }
+
+    // Константы в операндах - малые целые: их проверили охранные проверки при записи
+    static void fold(TraceInstruction &instruction, uint64_t leftWord, uint64_t rightWord) {
+        int64_t left = EvaluationValue{leftWord}.number();
+        int64_t right = EvaluationValue{rightWord}.number();
+        EvaluationValue result;
+        switch (instruction.op) {
+            case TraceOp::ADD: result = NUMBER(left + right); break;
+            case TraceOp::SUB: result = NUMBER(left - right); break;
+            case TraceOp::MUL: result = NUMBER(left * right); break;
+            default: {
+                const bool results[] = {left < right, left > right, left == right,
+                                        left >= right, left <= right, left != right};
+                result = BOOLEAN(results[instruction.condition]);
+                break;
+            }
+        }
+        instruction = TraceInstruction{TraceOp::CONST};
+        instruction.immediate = result.bits;
+    }
+};
+
+// Машинный код трассы
+class Trace {
+public:
+    // Аргументы: адрес ячейки vm::sp и локальные переменные фрейма. Возвращает адрес
+    // инструкции байткода, с которой продолжается исполнение после бокового выхода.
+    typedef uint8_t *(*Entry)(EvaluationValue **sp, EvaluationValue *locals);
+
+    Trace(std::unique_ptr<ExecutableMemory> memory, const TraceStats &stats)
+        : memory(std::move(memory)), traceStats(stats) {
+    }
+
+    uint8_t *run(EvaluationValue **sp, EvaluationValue *locals) const {
+        return reinterpret_cast<Entry>(memory->data())(sp, locals);
+    }
+
+    const TraceStats &stats() const {
+        return traceStats;
+    }
+
+    size_t size() const {
+        return memory->size();
+    }
+
+private:
+    std::unique_ptr<ExecutableMemory> memory;
+
+    TraceStats traceStats;
+};
+
+// Счётчик и трасса заголовка цикла
+struct LoopHeader {
+    const Trace *trace = nullptr;
+
+    // Обратных переходов на заголовок с последней попытки записи
+    uint32_t hotness = 0;
+
+    // Прерванных записей; после TraceCache::MAX_ABORTS цикл больше не записывается
+    uint32_t aborts = 0;
+
+    // Входов в трассу и итераций, пройденных в ней целиком
+    uint64_t entries = 0;
+    uint64_t iterations = 0;
+};
+
+// Заголовки циклов одного объекта кода по смещению в байткоде. Размер таблицы не меняется,
+// поэтому базовый машинный код читает ячейку трассы заголовка напрямую (Jit.h).
+class LoopTable {
+public:
+    explicit LoopTable(size_t codeSize) : headers(codeSize) {
+    }
+
+    LoopHeader &at(size_t offset) {
+        return headers[offset];
+    }
+
+    const LoopHeader &at(size_t offset) const {
+        return headers[offset];
+    }
+
+private:
+    std::vector<LoopHeader> headers;
+};
+
+// Трассы и таблицы заголовков циклов виртуальной машины; память освобождается вместе с vm
+class TraceCache {
+public:
+    static constexpr uint32_t MAX_ABORTS = 3;
+
+    // Трасса, которая в среднем проходит меньше MIN_ITERATIONS итераций за вход (цикл часто
+    // уходит в другую ветку), снимается после PROBATION входов, если у объекта кода есть
+    // базовый машинный код: боковой выход в интерпретатор стоит дороже, чем базовый код
+    static constexpr uint64_t PROBATION = 64;
+    static constexpr uint64_t MIN_ITERATIONS = 4;
+
+    explicit TraceCache(std::shared_ptr<Global> global) : global(std::move(global)) {
+    }
+
+    // Машинный код может читать глобальные переменные и буферы массивов напрямую
+    bool directAccess() const {
+        return layout.vectorLayoutKnown();
+    }
+
+    // Таблица заголовков циклов объекта кода, создаётся при первом обращении
+    LoopTable &loops(CodeObject *codeObject) {
+        if (codeObject->loops == nullptr) {
+            tables.push_back(std::make_unique<LoopTable>(codeObject->code.size()));
+            codeObject->loops = tables.back().get();
+        }
+        return *codeObject->loops;
+    }
+
+    // Оптимизирует и компилирует замкнутую трассу; nullptr, если исполняемую память получить не удалось
+    const Trace *compile(CodeObject *codeObject, LoopHeader &loop, TraceRecorder &recorder) {
+        TraceIr &trace = recorder.ir();
+        TraceStats stats;
+        TraceOptimizer().optimize(trace, stats);
+
+        X86Emitter emitter;
+        emit(codeObject, loop, trace, emitter);
+        std::unique_ptr<ExecutableMemory> memory = ExecutableMemory::create(emitter.bytes());
+        if (memory == nullptr) {
+            return nullptr;
+        }
+        totalStats += stats;
+        compiled.push_back(std::make_unique<Trace>(std::move(memory), stats));
+        return compiled.back().get();
+    }
+
+    // Снимает трассу цикла; цикл больше не записывается
+    void retire(LoopHeader &loop) {
+        loop.trace = nullptr;
+        loop.aborts = MAX_ABORTS;
+        retired++;
+    }
+
+    // Число скомпилированных трасс
+    size_t traceCount() const {
+        return compiled.size();
+    }
+
+    // Число снятых трасс
+    size_t retiredCount() const {
+        return retired;
+    }
+
+    // Статистика оптимизации по всем трассам
+    const TraceStats &stats() const {
+        return totalStats;
+    }
+
+private:
+    using Register = X86Emitter::Register;
+
+    // Вершина стека операндов vm при входе, локальные переменные фрейма и адрес ячейки vm::sp
+    static constexpr Register SP = X86Emitter::R14;
+    static constexpr Register LOCALS = X86Emitter::R15;
+    static constexpr Register SP_SLOT = X86Emitter::R12;
+
+    static constexpr Register RAX = X86Emitter::RAX;
+    static constexpr Register RCX = X86Emitter::RCX;
+    static constexpr Register RDX = X86Emitter::RDX;
+    static constexpr Register RSI = X86Emitter::RSI;
+    static constexpr Register RDI = X86Emitter::RDI;
+    static constexpr Register RSP = X86Emitter::RSP;
+
+    static constexpr int32_t SLOT = sizeof(EvaluationValue);
+
+    static X86Emitter::Condition compareCondition(uint8_t compareOp) {
+        static const X86Emitter::Condition conditions[] = {
+            X86Emitter::LESS, X86Emitter::GREATER, X86Emitter::EQUAL,
+            X86Emitter::GREATER_OR_EQUAL, X86Emitter::LESS_OR_EQUAL, X86Emitter::NOT_EQUAL,
+        };
+        return conditions[compareOp];
+    }
+
+    static bool fitsImmediate(uint64_t word) {
+        return static_cast<int64_t>(word) == static_cast<int32_t>(word);
+    }
+
+    // Значение i живёт в слоте [rsp + 8 * i]; константы подставляются в код
+    void emit(CodeObject *codeObject, LoopHeader &loop, const TraceIr &trace, X86Emitter &emitter) {
+        const std::vector<TraceInstruction> &instructions = trace.instructions;
+        auto frameSize = static_cast<int32_t>((instructions.size() * SLOT + 15) / 16 * 16);
+
+        auto loadValue = [&](Register dst, uint16_t value) {
+            if (instructions[value].op == TraceOp::CONST) {
+                emitter.moveImmediate(dst, instructions[value].immediate);
+            } else {
+                emitter.load(dst, RSP, value * SLOT);
+            }
+        };
+        // rcx - второй операнд; сравнение с небольшой константой без загрузки
+        auto compareWith = [&](uint16_t value) {
+            const TraceInstruction &operand = instructions[value];
+            if (operand.op == TraceOp::CONST && fitsImmediate(operand.immediate)) {
+                emitter.compareImmediate(RAX, static_cast<int32_t>(operand.immediate));
+            } else {
+                loadValue(RCX, value);
+                emitter.compare(RAX, RCX);
+            }
+        };
+
+        emitter.push(SP_SLOT);
+        emitter.push(SP);
+        emitter.push(LOCALS);
+        emitter.subtractImmediate(RSP, frameSize);
+        emitter.move(SP_SLOT, RDI);
+        emitter.load(SP, SP_SLOT, 0);
+        emitter.move(LOCALS, RSI);
+        size_t loopStart = emitter.size();
+
+        // Переходы на боковые выходы: позиция смещения и номер состояния
+        std::vector<std::pair<size_t, int32_t>> exits;
+        size_t i = 0;
+        auto exitIf = [&](X86Emitter::Condition condition) {
+            exits.emplace_back(emitter.jumpIf(condition), instructions[i].snapshot);
+        };
+
+        for (; i < instructions.size(); ++i) {
+            const TraceInstruction &instruction = instructions[i];
+            auto result = static_cast<int32_t>(i * SLOT);
+            switch (instruction.op) {
+                case TraceOp::NOP:
+                case TraceOp::CONST:
+                    break;
+                case TraceOp::LOAD_LOCAL:
+                    emitter.load(RAX, LOCALS, static_cast<int32_t>(instruction.immediate * SLOT));
+                    emitter.store(RSP, result, RAX);
+                    break;
+                case TraceOp::LOAD_GLOBAL:
+                    layout.emitLoadGlobal(emitter, RAX, *global, instruction.immediate);
+                    emitter.store(RSP, result, RAX);
+                    break;
+                case TraceOp::STORE_LOCAL:
+                    loadValue(RAX, instruction.a);
+                    emitter.store(LOCALS, static_cast<int32_t>(instruction.immediate * SLOT), RAX);
+                    break;
+                case TraceOp::GUARD_SMALL_NUMBER:
+                    loadValue(RAX, instruction.a);
+                    emitter.testImmediate(RAX, EvaluationValue::INT_TAG);
+                    exitIf(X86Emitter::EQUAL);
+                    break;
+                case TraceOp::GUARD_NUMBER_ARRAY:
+                    loadValue(RAX, instruction.a);
+                    layout.emitNumberArrayGuard(emitter, exitIf);
+                    break;
+                case TraceOp::GUARD_EQUAL:
+                    loadValue(RAX, instruction.a);
+                    if (fitsImmediate(instruction.immediate)) {
+                        emitter.compareImmediate(RAX, static_cast<int32_t>(instruction.immediate));
+                    } else {
+                        emitter.moveImmediate(RCX, instruction.immediate);
+                        emitter.compare(RAX, RCX);
+                    }
+                    exitIf(instruction.expected ? X86Emitter::NOT_EQUAL : X86Emitter::EQUAL);
+                    break;
+                case TraceOp::GUARD_COMPARE: {
+                    loadValue(RAX, instruction.a);
+                    compareWith(instruction.b);
+                    X86Emitter::Condition holds = compareCondition(instruction.condition);
+                    exitIf(instruction.expected ? X86Emitter::inverse(holds) : holds);
+                    break;
+                }
+                case TraceOp::ADD:
+                    // (2a + 1) + (2b + 1) - 1 = 2(a + b) + 1
+                    loadValue(RAX, instruction.a);
+                    loadValue(RCX, instruction.b);
+                    emitter.subtractImmediate(RCX, 1);
+                    emitter.add(RAX, RCX);
+                    exitIf(X86Emitter::OVERFLOW);
+                    emitter.store(RSP, result, RAX);
+                    break;
+                case TraceOp::SUB:
+                    // (2a + 1) - (2b + 1) = 2(a - b)
+                    loadValue(RAX, instruction.a);
+                    loadValue(RCX, instruction.b);
+                    emitter.subtract(RAX, RCX);
+                    exitIf(X86Emitter::OVERFLOW);
+                    emitter.orImmediate(RAX, EvaluationValue::INT_TAG);
+                    emitter.store(RSP, result, RAX);
+                    break;
+                case TraceOp::MUL:
+                    // 2a * b + 1
+                    loadValue(RAX, instruction.a);
+                    loadValue(RCX, instruction.b);
+                    emitter.subtractImmediate(RAX, 1);
+                    emitter.shiftRight(RCX, 1);
+                    emitter.multiply(RAX, RCX);
+                    exitIf(X86Emitter::OVERFLOW);
+                    emitter.orImmediate(RAX, EvaluationValue::INT_TAG);
+                    emitter.store(RSP, result, RAX);
+                    break;
+                case TraceOp::COMPARE:
+                    loadValue(RAX, instruction.a);
+                    compareWith(instruction.b);
+                    emitter.setIf(compareCondition(instruction.condition), RDX);
+                    emitter.shiftLeft(RDX, 3);
+                    emitter.orImmediate(RDX, EvaluationValue::FALSE_BITS);
+                    emitter.store(RSP, result, RDX);
+                    break;
+                case TraceOp::ARRAY_GET:
+                    loadValue(RAX, instruction.a);
+                    loadValue(RCX, instruction.b);
+                    layout.emitBoundsCheck(emitter, exitIf);
+                    emitter.loadIndexed(RAX, RDX, RCX);
+                    emitter.add(RAX, RAX);
+                    exitIf(X86Emitter::OVERFLOW);
+                    emitter.orImmediate(RAX, EvaluationValue::INT_TAG);
+                    emitter.store(RSP, result, RAX);
+                    break;
+                case TraceOp::ARRAY_SET:
+                    loadValue(RAX, instruction.a);
+                    loadValue(RCX, instruction.b);
+                    layout.emitBoundsCheck(emitter, exitIf);
+                    loadValue(RSI, instruction.c);
+                    emitter.shiftRight(RSI, 1);
+                    emitter.storeIndexed(RDX, RCX, RSI);
+                    break;
+                case TraceOp::LOOP:
+                    emitter.moveImmediate(RDX, reinterpret_cast<uint64_t>(&loop.iterations));
+                    emitter.load(RAX, RDX, 0);
+                    emitter.addImmediate(RAX, 1);
+                    emitter.store(RDX, 0, RAX);
+                    emitter.patch(emitter.jump(), loopStart);
+                    break;
+            }
+        }
+
+        // Эпилог: адрес инструкции для интерпретатора уже в rax
+        size_t epilogue = emitter.size();
+        emitter.store(SP_SLOT, 0, SP);
+        emitter.addImmediate(RSP, frameSize);
+        emitter.pop(LOCALS);
+        emitter.pop(SP);
+        emitter.pop(SP_SLOT);
+        emitter.ret();
+
+        // Боковые выходы: стек операндов восстанавливается по состоянию
+        std::vector<size_t> stubs(trace.snapshots.size(), SIZE_MAX);
+        for (const auto &[at, snapshotIndex]: exits) {
+            if (stubs[snapshotIndex] == SIZE_MAX) {
+                stubs[snapshotIndex] = emitter.size();
+                const TraceSnapshot &snapshot = trace.snapshots[snapshotIndex];
+                for (size_t k = 0; k < snapshot.stack.size(); ++k) {
+                    loadValue(RAX, snapshot.stack[k]);
+                    emitter.store(SP, static_cast<int32_t>(k * SLOT), RAX);
+                }
+                if (!snapshot.stack.empty()) {
+                    emitter.addImmediate(SP, static_cast<int32_t>(snapshot.stack.size() * SLOT));
+                }
+                emitter.moveImmediate(RAX, reinterpret_cast<uint64_t>(&codeObject->code[snapshot.resume]));
+                emitter.patch(emitter.jump(), epilogue);
+            }
+            emitter.patch(at, stubs[snapshotIndex]);
+        }
+    }
+
+    std::shared_ptr<Global> global;
+
+    JitLayout layout;
+
+    std::vector<std::unique_ptr<Trace>> compiled;
+
+    std::vector<std::unique_ptr<LoopTable>> tables;
+
+    TraceStats totalStats;
+
+    size_t retired = 0;
+};
@@ -1,28 +1,130 @@
 #pragma once
 
+#include <algorithm>
 #include <unordered_map>
 #include "parser.h"
+#include "ConstantFolder.h"
+#include "PeepholeOptimizer.h"
 #include "EvaluationValue.h"
 #include "OpCode.h"
 #include "Global.h"
 #include "disassembler/Disassembler.h"
 
+// Набор инструкций, в который компилируется программа
+enum class Backend {
+    // Стековый байткод (OpCode.h), bytecodeGenerator и vm::evalExp
+    STACK,
+    // Трёхадресный регистровый код (RegisterOpCode.h), registerGenerator и vm::evalRegisters
+    REGISTER,
+};
+
+// Способ компиляции горячего стекового кода в машинный
+enum class JitCompiler {
+    // Шаблоны инструкций, собранные X86Emitter (Jit.h)
+    TEMPLATES,
+    // Копирование трафаретов, скомпилированных при сборке из stencils/stencils.cpp (CopyPatchJit.h);
+    // без сгенерированных трафаретов (VM_HAVE_STENCILS) используются шаблоны
+    STENCILS,
+};
+
+// Параметры компиляции
+struct CompilerOptions {
+    // Свёртка констант и упрощение выражений в AST перед генерацией кода (ConstantFolder)
+    bool foldConstants = true;
+
+    // Щелевая оптимизация сгенерированного байткода (PeepholeOptimizer)
+    bool peephole = true;
+
+    // Слияние частых последовательностей в суперинструкции (PeepholeOptimizer);
+    // выполняется и без остальных правил щелевой оптимизации
+    bool superinstructions = true;
+
+    // Набор инструкций; щелевая оптимизация и суперинструкции есть только у стекового байткода
+    Backend backend = Backend::STACK;
+
+    // Компиляция горячего стекового кода в машинный код x86-64 (Jit.h); на других платформах
+    // и в сборке с подсчётом инструкций (VM_PROFILE_OPCODES) не действует. Выключена по
+    // умолчанию: исполняемая память нужна не каждому встраиванию vm, машинный код включается явно
+    bool jit = false;
+
+    // Число вызовов объекта кода до компиляции в машинный код
+    uint32_t jitThreshold = 1000;
+
+    // Число обратных переходов объекта кода до компиляции в машинный код посреди исполнения:
+    // фрейм продолжается в нём с заголовка цикла (Tiering.h)
+    uint32_t osrThreshold = 1000;
+
+    // Компилятор машинного кода (шаблоны или трафареты)
+    JitCompiler jitCompiler = JitCompiler::TEMPLATES;
+
+    // Запись и компиляция трасс горячих циклов (TraceJit.h); условия и значение по умолчанию
+    // те же, что у jit
+    bool traces = false;
+
+    // Число обратных переходов на заголовок цикла до записи трассы
+    uint32_t traceThreshold = 50;
+};
+
+// Статистика последней компиляции
+struct CompileStats {
+    // Инструкций во всех объектах кода программы
+    size_t instructions = 0;
+
+    // Выражений, свёрнутых или упрощённых до генерации кода
+    size_t foldedExpressions = 0;
+
+    // Инструкций, удалённых щелевой оптимизацией
+    size_t peepholeRemoved = 0;
+
+    // Созданных суперинструкций
+    size_t superinstructions = 0;
+};
+
 class bytecodeGenerator {
 public :
-    explicit bytecodeGenerator(const std::shared_ptr<Global> &global)
-            : global(global), disassembler(std::make_unique<Disassembler>(global)), co(nullptr) {
+    explicit bytecodeGenerator(const std::shared_ptr<Global> &global, CompilerOptions options = {})
+            : global(global), disassembler(std::make_unique<Disassembler>(global)), co(nullptr), options(options) {
     }
 
-    CodeObject *compile(const Exp &exp) {
+    // AST может быть изменено свёрткой констант; новые строки размещаются в arena
+    CodeObject *compile(Exp &exp, AstArena &arena) {
+        stats = {};
+        if (options.foldConstants) {
+            ConstantFolder folder(arena);
+            folder.fold(exp);
+            stats.foldedExpressions = folder.foldedCount();
+        }
+
         co = AS_CODE(ALLOC_CODE("main"));
+        codeObjects = {co};
 
 
         localCount = 0;
+        functionScopeBase = 0;
+        scopeStack.clear();
 
         generate(exp);
 
-
+        // Результат программы - значение последнего выражения, иначе nil
+        if (!producesValue(exp)) {
+            emit(OP_NIL);
+        }
         emit(OP_HALT);
+        co->localCount = localCount;
+
+        PeepholeOptimizer optimizer(options.peephole, options.superinstructions);
+        for (CodeObject *compiled: codeObjects) {
+            if (options.peephole || options.superinstructions) {
+                stats.peepholeRemoved += optimizer.optimize(compiled);
+            }
+            compiled->maxStackDepth = computeMaxStackDepth(compiled);
+            for (size_t offset = 0; offset < compiled->code.size();
+                 offset += instructionLength(compiled->code[offset])) {
+                stats.instructions++;
+            }
+        }
+        stats.superinstructions = optimizer.fusedCount();
+        constantIndex.clear();
 
         return co;
     }
@@ -30,54 +132,24 @@ public :
     void generate(const Exp &exp) {
         switch (exp.type) {
             case ExpType::NUMBER: {
-                emit(OP_CONST);
-                emit(numericConstIdx(exp.number));
+                emitConst(numericConstIdx(exp.number));
                 break;
             }
 
             case ExpType::STRING: {
-                emit(OP_CONST);
-                emit(stringConstIdx(exp.string));
+                emitConst(stringConstIdx(exp.string));
                 break;
             }
 
             case ExpType::SYMBOL: {
-
-                if (exp.string == "true" || exp.string == "false") {
-                    emit(OP_CONST);
-                    emit(booleanConstIdx(exp.string == "true"));
-                    break;
-                }
-
-                int slot = -1;
-
-                // Поиск переменной во внутренних областях видимости (от внутренней к внешней)
-                for (auto scopeIt = scopeStack.rbegin(); scopeIt != scopeStack.rend(); ++scopeIt) {
-                    auto &scope = *scopeIt;
-                    if (scope.find(exp.string) != scope.end()) {
-                        slot = scope[exp.string];
-                        emit(OP_GET_LOCAL);
-                        emit(slot);
-                        break;
-                    }
-                }
-
-                if (slot == -1) {
-                    if (global->exists(exp.string)) {
-                        emit(OP_GET_GLOBAL);
-                        emit(global->getGlobalIndex(exp.string));
-                    } else {
-                        throw std::runtime_error("Undefined variable: " + exp.string);
-                    }
-                }
-
+                generateSymbol(exp.string);
                 break;
             }
 
             case ExpType::UNARY_EXP: {
-                generate(*exp.operand);
+                generate(*exp.unary.operand);
 
-                if (exp.unaryOp == "!") {
+                if (exp.unary.op == "!") {
                     emit(OP_LOGICAL_NOT);
                 } else {
                     throw std::runtime_error("Неизвестный оператор в бинарном выражении");
@@ -86,51 +158,55 @@ public :
             }
 
             case ExpType::BINARY_EXP: {
+                const BinaryNode &binary = exp.binary;
                 // Логические операции && и || с коротким замыканием
-                if (exp.op == "&&") {
+                if (binary.op == "&&") {
                     // Для &&: если левая часть ложна, правая не вычисляется
-                    generate(*exp.left);
+                    generate(*binary.left);
 
                     emit(OP_DUP);
                     emit(OP_JUMP_IF_FALSE_OR_POP);
                     size_t jumpAddr = co->code.size();
                     emit16(0); // Заглушка адреса
 
-                    generate(*exp.right);
+                    // Левое значение нужно только при коротком замыкании
+                    emit(OP_POP);
+                    generate(*binary.right);
 
 
                     size_t afterRight = co->code.size();
                     patchAddress(jumpAddr, afterRight);
-                } else if (exp.op == "||") {
+                } else if (binary.op == "||") {
                     // Для ||: если левая часть истинна, правая не вычисляется
-                    generate(*exp.left);
+                    generate(*binary.left);
 
                     emit(OP_DUP);
                     emit(OP_JUMP_IF_TRUE_OR_POP);
                     size_t jumpAddr = co->code.size();
                     emit16(0);
 
-                    generate(*exp.right);
+                    emit(OP_POP);
+                    generate(*binary.right);
 
 
                     size_t afterRight = co->code.size();
                     patchAddress(jumpAddr, afterRight);
                 } else {
 
-                    generate(*exp.left);
-                    generate(*exp.right);
+                    generate(*binary.left);
+                    generate(*binary.right);
 
-                    if (exp.op == "+") {
+                    if (binary.op == "+") {
                         emit(OP_ADD);
-                    } else if (exp.op == "-") {
+                    } else if (binary.op == "-") {
                         emit(OP_SUB);
-                    } else if (exp.op == "*") {
+                    } else if (binary.op == "*") {
                         emit(OP_MUL);
-                    } else if (exp.op == "/") {
+                    } else if (binary.op == "/") {
                         emit(OP_DIV);
-                    } else if (compareOperator.count(exp.op) != 0) {
+                    } else if (auto compare = compareOperator.find(binary.op); compare != compareOperator.end()) {
                         emit(OP_COMPARE);
-                        emit(compareOperator[exp.op]);
+                        emit(compare->second);
                     } else {
                         throw std::runtime_error("Неизвестный оператор в бинарном выражении");
                     }
@@ -139,17 +215,20 @@ public :
             }
 
             case ExpType::IF_EXP: {
+                const IfNode &ifExp = exp.ifExp;
+                // Если хотя бы одна ветка даёт значение, обе ветки должны оставить ровно одно
+                bool thenValue = producesValue(*ifExp.thenBranch);
+                bool elseValue = ifExp.elseBranch != nullptr && producesValue(*ifExp.elseBranch);
+                bool resultValue = thenValue || elseValue;
 
-                generate(*exp.condition);
-
+                size_t jumpIfFalseAddr = emitJumpIfFalse(*ifExp.condition);
 
-                emit(OP_JUMP_IF_FALSE);
-                size_t jumpIfFalseAddr = co->code.size();
-                emit16(0);
-
-                generate(*exp.thenBranch);
+                generate(*ifExp.thenBranch);
+                if (resultValue && !thenValue) {
+                    emit(OP_NIL);
+                }
 
-                if (exp.elseBranch != nullptr) {
+                if (ifExp.elseBranch != nullptr) {
                     // Если есть else-ветка, вставляем OP_JUMP для пропуска else при истинном условии
                     emit(OP_JUMP);
                     size_t jumpAddr = co->code.size();
@@ -159,12 +238,15 @@ public :
                     uint16_t elseBranchAddr = co->code.size();
                     patchAddress(jumpIfFalseAddr, elseBranchAddr);
 
-                    generate(*exp.elseBranch);
+                    generate(*ifExp.elseBranch);
+                    if (resultValue && !elseValue) {
+                        emit(OP_NIL);
+                    }
 
                     // Обратная замена адреса после else
                     uint16_t afterElseAddr = co->code.size();
                     patchAddress(jumpAddr, afterElseAddr);
-                } else {
+                } else if (resultValue) {
                     // Если нет else-ветки, пропускаем место для nil
                     emit(OP_JUMP);
                     size_t jumpOverNilAddr = co->code.size();
@@ -180,6 +262,9 @@ public :
                     // Обратная замена адреса прыжка, чтобы пропустить NIL при истинном условии
                     uint16_t afterNilAddr = co->code.size();
                     patchAddress(jumpOverNilAddr, afterNilAddr);
+                } else {
+                    // Ветка ничего не оставляет на стеке - nil не нужен
+                    patchAddress(jumpIfFalseAddr, co->code.size());
                 }
 
                 break;
@@ -187,20 +272,21 @@ public :
 
             case ExpType::VAR_DECLARATION: {
 
-                generate(*exp.varValue);
+                generate(*exp.variable.value);
 
                 auto &currentScope = scopeStack.back();
+                std::string_view name = exp.variable.name;
 
-                if (currentScope.find(exp.varName) != currentScope.end()) {
-                    throw std::runtime_error("Variable " + exp.varName + " already exists.");
+                if (currentScope.find(name) != currentScope.end()) {
+                    throw std::runtime_error("Variable " + std::string(name) + " already exists.");
                 }
 
-                currentScope[exp.varName] = localCount;
-                co->localNames[localCount] = exp.varName;
+                currentScope[name] = localCount;
+                co->localNames[localCount] = std::string(name);
                 localCount++;
 
                 emit(OP_SET_LOCAL);
-                emit(currentScope[exp.varName]);
+                emit(currentScope[name]);
                 break;
             }
 
@@ -208,8 +294,13 @@ public :
 
                 scopeStack.emplace_back();
 
-                for (const auto &stmt: exp.statements) {
-                    generate(*stmt);
+                // Значение блока - значение последней инструкции, остальные снимаются со стека
+                for (size_t i = 0; i < exp.list.size(); ++i) {
+                    if (i + 1 < exp.list.size()) {
+                        generateDiscarded(*exp.list[i]);
+                    } else {
+                        generate(*exp.list[i]);
+                    }
                 }
 
 
@@ -218,39 +309,30 @@ public :
             }
 
             case ExpType::ASSIGNMENT: {
+                const AssignmentNode &assignment = exp.assignment;
 
-                if (exp.arrayValue != nullptr) {
+                if (assignment.index != nullptr) {
                     // Присваивание элементу массива: arr[j] = arr[j+1]
-                    Exp arrayNameExp(exp.varName);
-                    generate(arrayNameExp);
+                    generateSymbol(assignment.name);
 
-                    generate(*exp.varValue);
-                    generate(*exp.arrayValue);
+                    generate(*assignment.index);
+                    generate(*assignment.value);
 
                     emit(OP_ARRAY_SET);
                 } else {
-                    generate(*exp.varValue);
-
-                    int slot = -1;
-                    // Поиск переменной в областях видимости
-                    for (auto scopeIt = scopeStack.rbegin(); scopeIt != scopeStack.rend(); ++scopeIt) {
-                        auto &scope = *scopeIt;
-                        if (scope.find(exp.varName) != scope.end()) {
-                            slot = scope[exp.varName];
-                            emit(OP_SET_LOCAL);
-                            emit(slot);
-                            break;
-                        }
-                    }
+                    generate(*assignment.value);
 
-                    if (slot == -1) {
+                    int slot = findLocal(assignment.name);
+                    if (slot != -1) {
+                        emit(OP_SET_LOCAL);
+                        emit(slot);
+                    } else {
                         // Проверка глобальных
-                        if (global->exists(exp.varName)) {
-                            emit(OP_SET_GLOBAL);
-                            emit(global->getGlobalIndex(exp.varName));
-                        } else {
-                            throw std::runtime_error("Неизвестная переменная " + exp.varName);
+                        int globalIdx = global->getGlobalIndex(std::string(assignment.name));
+                        if (globalIdx == -1) {
+                            throw std::runtime_error("Неизвестная переменная " + std::string(assignment.name));
                         }
+                        emitGlobal(OP_SET_GLOBAL, OP_SET_GLOBAL_LONG, globalIdx);
                     }
                 }
 
@@ -261,15 +343,11 @@ public :
                 size_t loopStart = co->code.size();
 
 
-                generate(*exp.condition);
+                // Выход из цикла при ложном условии
+                size_t exitJumpAddr = emitJumpIfFalse(*exp.whileExp.condition);
 
-                // Вставка OP_JUMP_IF_FALSE для выхода из цикла
-                emit(OP_JUMP_IF_FALSE);
-                size_t exitJumpAddr = co->code.size();
-                emit16(0);
 
-
-                generate(*exp.whileBody);
+                generateDiscarded(*exp.whileExp.body);
 
                 // Прыжок в начало цикла
                 emit(OP_JUMP);
@@ -283,28 +361,25 @@ public :
             }
 
             case ExpType::FOR_EXP : {
+                const ForNode &forExp = exp.forExp;
                 // Инициализация (если есть)
-                if (exp.forInit != nullptr) {
-                    generate(*exp.forInit);
+                if (forExp.init != nullptr) {
+                    generateDiscarded(*forExp.init);
                 }
 
                 size_t loopStart = co->code.size();
 
                 // Условие (если есть)
-                if (exp.forCondition != nullptr) {
-                    generate(*exp.forCondition);
-
+                if (forExp.condition != nullptr) {
                     // Если условие ложно - выход
-                    emit(OP_JUMP_IF_FALSE);
-                    size_t exitJumpAddr = co->code.size();
-                    emit16(0);
+                    size_t exitJumpAddr = emitJumpIfFalse(*forExp.condition);
 
                     // Тело цикла
-                    generate(*exp.forBody);
+                    generateDiscarded(*forExp.body);
 
                     // Обновление (если есть)
-                    if (exp.forUpdate != nullptr) {
-                        generate(*exp.forUpdate);
+                    if (forExp.update != nullptr) {
+                        generateDiscarded(*forExp.update);
                     }
 
                     // Прыжок в начало
@@ -316,10 +391,10 @@ public :
                     patchAddress(exitJumpAddr, loopEnd);
                 } else {
                     // Бесконечный цикл (нет условия)
-                    generate(*exp.forBody);
+                    generateDiscarded(*forExp.body);
 
-                    if (exp.forUpdate != nullptr) {
-                        generate(*exp.forUpdate);
+                    if (forExp.update != nullptr) {
+                        generateDiscarded(*forExp.update);
                     }
 
                     emit(OP_JUMP);
@@ -331,53 +406,59 @@ public :
             case ExpType::FUNCTION_DECLARATION: {
 
                 // Создание нового CodeObject для функции
-                std::string functionName = exp.funcName;
-                std::vector<std::string> params = exp.funcParams;
-                std::shared_ptr<Exp> body = exp.funcBody;
+                std::string functionName(exp.function.name);
+                const NameList &params = exp.function.params;
+                const Exp *body = exp.function.body;
 
                 CodeObject *functionCo = AS_CODE(ALLOC_CODE(functionName));
+                codeObjects.push_back(functionCo);
 
 
                 size_t functionConstIdx = co->constants.size();
                 co->constants.emplace_back(ALLOC_CODE_OBJECT(functionCo));
 
                 // Вставка OP_CONST с индексом функции
-                emit(OP_CONST);
-                emit((uint8_t) functionConstIdx);
+                emitConst(functionConstIdx);
 
 
-                if (!global->exists(functionName)) {
-                    global->define(functionName);
-                }
-                int globalIdx = global->getGlobalIndex(functionName);
+                int globalIdx = global->define(functionName);
 
                 // OP_SET_GLOBAL для присвоения имени функции
-                emit(OP_SET_GLOBAL);
-                emit((uint8_t) globalIdx);
+                emitGlobal(OP_SET_GLOBAL, OP_SET_GLOBAL_LONG, globalIdx);
 
                 // Переключение на functionCo
                 CodeObject *previousCo = co;
                 co = functionCo;
 
-                // Новая область видимости для функции
+                // Новая область видимости для функции; нумерация слотов у функции своя
+                int previousLocalCount = localCount;
+                size_t previousScopeBase = functionScopeBase;
+                functionScopeBase = scopeStack.size();
                 scopeStack.emplace_back();
                 localCount = 0;
 
                 // Параметры как локальные переменные
                 for (const auto &param: params) {
                     scopeStack.back()[param] = localCount;
-                    co->localNames[localCount] = param;
+                    co->localNames[localCount] = std::string(param);
                     localCount++;
                 }
+                functionCo->arity = params.size();
 
                 // Генерация тела функции
                 generate(*body);
 
-                // Убедиться, что функция заканчивается return
+                // Убедиться, что функция заканчивается return; без значения возвращается nil
+                if (!producesValue(*body)) {
+                    emit(OP_NIL);
+                }
                 emit(OP_RETURN);
+                functionCo->localCount = localCount;
 
                 // Восстановление предыдущего CodeObject и области
                 co = previousCo;
+                localCount = previousLocalCount;
+                functionScopeBase = previousScopeBase;
                 scopeStack.pop_back();
 
                 break;
@@ -385,24 +466,29 @@ public :
 
             case ExpType::FUNCTION_CALL: {
 
-                std::string functionName = exp.funcName;
+                std::string functionName(exp.call.name);
                 int functionIdx = global->getGlobalIndex(functionName);
                 if (functionIdx == -1) {
                     throw std::runtime_error("Undefined function: " + functionName);
                 }
 
                 // Загрузка функции
-                emit(OP_GET_GLOBAL);
-                emit((uint8_t) functionIdx);
+                emitGlobal(OP_GET_GLOBAL, OP_GET_GLOBAL_LONG, functionIdx);
 
                 // Генерация аргументов
-                for (const auto &arg: exp.callArguments) {
+                for (const Exp *arg: exp.call.arguments) {
                     generate(*arg);
                 }
 
 
+                // Место вызова получает свой кэш; функция всегда загружается из слота functionIdx
+                if (co->callCaches.size() > UINT16_MAX) {
+                    throw std::runtime_error("Слишком много вызовов в " + co->name);
+                }
                 emit(OP_CALL);
-                emit((uint8_t) exp.callArguments.size());
+                emit((uint8_t) exp.call.arguments.size());
+                emit16((uint16_t) co->callCaches.size());
+                co->callCaches.push_back(CallCache{0, 0, static_cast<uint32_t>(functionIdx), false});
 
                 break;
             }
@@ -420,17 +506,26 @@ public :
             }
 
             case ExpType::ARRAY_LITERAL: {
+                // До 255 элементов массив собирается одной инструкцией из значений на стеке
+                if (exp.list.size() <= UINT8_MAX) {
+                    for (Exp *element: exp.list) {
+                        generate(*element);
+                    }
+                    emit(OP_ARRAY_LITERAL);
+                    emit((uint8_t) exp.list.size());
+                    break;
+                }
 
+                // Большой литерал заполняется поэлементно в массив нужной ёмкости
                 emit(OP_ARRAY);
+                emit16((uint16_t) std::min<size_t>(exp.list.size(), UINT16_MAX));
 
-
-                for (size_t i = 0; i < exp.callArguments.size(); ++i) {
+                for (size_t i = 0; i < exp.list.size(); ++i) {
                     emit(OP_DUP);
 
-                    emit(OP_CONST);
-                    emit(numericConstIdx((double) i));
+                    emitConst(numericConstIdx((int64_t) i));
 
-                    generate(*exp.callArguments[i]);
+                    generate(*exp.list[i]);
 
                     emit(OP_ARRAY_SET);
                 }
@@ -439,17 +534,64 @@ public :
 
             case ExpType::ARRAY_ACCESS: {
                 // Доступ к элементу массива: arr[i]
-                Exp arrayNameExp(exp.varName);
-                generate(arrayNameExp);
-                generate(*exp.varValue);
+                generateSymbol(exp.arrayAccess.name);
+                generate(*exp.arrayAccess.index);
                 emit(OP_ARRAY_GET);
                 break;
             }
+
+            // Списки параметров и аргументов разбирают узлы FUNCTION_DECLARATION и FUNCTION_CALL
+            case ExpType::PARAM_LIST:
+            case ExpType::ARG_LIST:
+                throw std::runtime_error("Список параметров или аргументов вне объявления или вызова функции");
+        }
+    }
+
+    // Чтение переменной или логической константы по имени
+    void generateSymbol(std::string_view name) {
+        if (name == "true" || name == "false") {
+            emitConst(booleanConstIdx(name == "true"));
+            return;
+        }
+
+        int slot = findLocal(name);
+        if (slot != -1) {
+            emit(OP_GET_LOCAL);
+            emit(slot);
+            return;
+        }
+
+        int globalIdx = global->getGlobalIndex(std::string(name));
+        if (globalIdx == -1) {
+            throw std::runtime_error("Undefined variable: " + std::string(name));
+        }
+        emitGlobal(OP_GET_GLOBAL, OP_GET_GLOBAL_LONG, globalIdx);
+    }
+
+    // Слот локальной переменной или -1. Поиск идёт от внутренней области к внешней;
+    // локальные переменные объемлющей функции лежат в чужом фрейме и здесь не видны.
+    int findLocal(std::string_view name) {
+        for (auto scopeIt = scopeStack.rbegin(); scopeIt != scopeStack.rend() - functionScopeBase; ++scopeIt) {
+            auto found = scopeIt->find(name);
+            if (found != scopeIt->end()) {
+                return found->second;
+            }
+        }
+        return -1;
+    }
+
+    // Генерация инструкции, значение которой не используется
+    void generateDiscarded(const Exp &exp) {
+        generate(exp);
+        if (producesValue(exp)) {
+            emit(OP_POP);
         }
     }
 
     void disassembleBytecode() { disassembler->disassemble(co); }
 
+    const CompileStats &compileStats() const { return stats; }
+
 
 private:
     std::shared_ptr<Global> global;
@@ -458,39 +600,69 @@ private:
 
     CodeObject *co;
 
-    std::vector<std::unordered_map<std::string, int> > scopeStack;
+    CompilerOptions options;
+
+    CompileStats stats;
+
+    // Имена ссылаются на память AST, которое живёт до конца компиляции
+    std::vector<std::unordered_map<std::string_view, int> > scopeStack;
     int localCount = 0;
 
+    // Индекс первой области видимости текущей функции в scopeStack
+    size_t functionScopeBase = 0;
+
+    // Все объекты кода, созданные при текущей компиляции
+    std::vector<CodeObject *> codeObjects;
+
+    // Индексы уже добавленных констант объекта кода, чтобы не искать их перебором
+    struct ConstantIndex {
+        std::unordered_map<int64_t, size_t> numbers;
+        std::unordered_map<std::string_view, size_t> strings;
+        size_t booleans[2] = {SIZE_MAX, SIZE_MAX};
+    };
+
+    // Живёт только во время компиляции
+    std::unordered_map<const CodeObject *, ConstantIndex> constantIndex;
+
     size_t getOffset() { return co->code.size(); }
 
-    size_t numericConstIdx(double value) {
-        for (size_t i = 0; i < co->constants.size(); ++i) {
-            if (IS_NUMBER(co->constants[i]) && AS_NUMBER(co->constants[i]) == value) {
-                return i;
-            }
+    size_t numericConstIdx(int64_t value) {
+        auto [it, inserted] = constantIndex[co].numbers.emplace(value, co->constants.size());
+        if (inserted) {
+            co->constants.emplace_back(NUMBER(value));
         }
-        co->constants.emplace_back(NUMBER(value));
-        return co->constants.size() - 1;
+        return it->second;
     }
 
     size_t booleanConstIdx(bool value) {
-        for (size_t i = 0; i < co->constants.size(); ++i) {
-            if (IS_BOOL(co->constants[i]) && AS_BOOL(co->constants[i]) == value) {
-                return i;
-            }
+        size_t &index = constantIndex[co].booleans[value];
+        if (index == SIZE_MAX) {
+            index = co->constants.size();
+            co->constants.emplace_back(BOOLEAN(value));
         }
-        co->constants.emplace_back(BOOLEAN(value));
-        return co->constants.size() - 1;
+        return index;
     }
 
-    size_t stringConstIdx(const std::string &value) {
-        for (size_t i = 0; i < co->constants.size(); ++i) {
-            if (IS_STRING(co->constants[i]) && AS_CPP_STRING(co->constants[i]) == value) {
-                return i;
-            }
+    size_t stringConstIdx(std::string_view value) {
+        auto [it, inserted] = constantIndex[co].strings.emplace(value, co->constants.size());
+        if (inserted) {
+            co->constants.emplace_back(ALLOC_STRING(std::string(value)));
+        }
+        return it->second;
+    }
+
+    // Загрузка константы: короткая форма для первых 256 констант, иначе 16-битный индекс
+    void emitConst(size_t constIdx) {
+        if (constIdx > UINT16_MAX) {
+            throw std::runtime_error("Слишком много констант в " + co->name);
+        }
+        if (constIdx <= UINT8_MAX) {
+            emit(OP_CONST);
+            emit((uint8_t) constIdx);
+        } else {
+            emit(OP_CONST_LONG);
+            emit16((uint16_t) constIdx);
         }
-        co->constants.emplace_back(ALLOC_STRING(value));
-        return co->constants.size() - 1;
     }
 
     void emit(uint8_t code) {
@@ -502,33 +674,101 @@ private:
         emit((uint8_t) (value & 0xFF));
     }
 
+    // Обращение к глобальной переменной: короткая форма для первых 256 слотов, иначе 16-битный индекс
+    void emitGlobal(uint8_t shortOpcode, uint8_t longOpcode, int globalIdx) {
+        if (globalIdx > UINT16_MAX) {
+            throw std::runtime_error("Слишком много глобальных переменных.");
+        }
+        if (globalIdx <= UINT8_MAX) {
+            emit(shortOpcode);
+            emit((uint8_t) globalIdx);
+        } else {
+            emit(longOpcode);
+            emit16((uint16_t) globalIdx);
+        }
+    }
+
+    // Переход, если условие ложно; возвращает позицию адреса для patchAddress.
+    // Сравнение в условии сливается с переходом (OP_JUMP_IF_NOT_LT и другие),
+    // и логическое значение не кладётся на стек.
+    size_t emitJumpIfFalse(const Exp &condition) {
+        if (condition.type == ExpType::BINARY_EXP) {
+            if (auto compare = compareOperator.find(condition.binary.op); compare != compareOperator.end()) {
+                generate(*condition.binary.left);
+                generate(*condition.binary.right);
+                emit(OP_JUMP_IF_NOT_LT + compare->second);
+                size_t addrPos = co->code.size();
+                emit16(0);
+                return addrPos;
+            }
+        }
+        generate(condition);
+        emit(OP_JUMP_IF_FALSE);
+        size_t addrPos = co->code.size();
+        emit16(0);
+        return addrPos;
+    }
+
     void patchAddress(size_t addrPos, uint16_t value) {
         co->code[addrPos] = (uint8_t) ((value >> 8) & 0xFF);
         co->code[addrPos + 1] = (uint8_t) (value & 0xFF);
     }
 
-    inline EvaluationValue ALLOC_CODE_OBJECT(CodeObject *codeObject) {
-        EvaluationValue val;
-        val.type = EvaluationValueType::OBJECT;
-        val.value = (Object *) codeObject;
-        return val;
-    }
+    // Максимальная глубина стека операндов для объекта кода: обход всех путей исполнения
+    // с проверкой, что в каждую точку байткода управление приходит с одной и той же глубиной.
+    static size_t computeMaxStackDepth(CodeObject *codeObject) {
+        const std::vector<uint8_t> &code = codeObject->code;
+        std::vector<int> depthAt(code.size(), -1);
+        std::vector<size_t> worklist = {0};
+        depthAt[0] = 0;
+        int maxDepth = 0;
+
+        auto reach = [&](size_t offset, int depth) {
+            if (offset >= code.size()) {
+                throw std::runtime_error("Переход за пределы байткода в " + codeObject->name);
+            }
+            if (depthAt[offset] == -1) {
+                depthAt[offset] = depth;
+                worklist.push_back(offset);
+            } else if (depthAt[offset] != depth) {
+                throw std::runtime_error("Несогласованная глубина стека в " + codeObject->name +
+                                         " на смещении " + std::to_string(offset));
+            }
+        };
 
+        while (!worklist.empty()) {
+            size_t offset = worklist.back();
+            worklist.pop_back();
 
-    size_t numericConstIdxInFunction(CodeObject *co, double value) {
-        for (size_t i = 0; i < co->constants.size(); ++i) {
-            if (IS_NUMBER(co->constants[i]) && AS_NUMBER(co->constants[i]) == value) {
-                return i;
+            uint8_t opcode = code[offset];
+            int depth = depthAt[offset] + stackEffect(&code[offset]);
+            if (depth < 0) {
+                throw std::runtime_error("Опустошение стека в " + codeObject->name +
+                                         " на смещении " + std::to_string(offset));
+            }
+            maxDepth = std::max(maxDepth, depth);
+
+            if (isJump(opcode)) {
+                reach((code[offset + 1] << 8) | code[offset + 2], depth);
+            }
+            if (!isTerminator(opcode)) {
+                reach(offset + instructionLength(opcode), depth);
             }
         }
-        co->constants.push_back(NUMBER(value));
-        return co->constants.size() - 1;
+
+        return maxDepth;
+    }
+
+    inline EvaluationValue ALLOC_CODE_OBJECT(CodeObject *codeObject) {
+        return OBJECT(codeObject);
     }
 
-    static std::map<std::string, uint8_t> compareOperator;
+public:
+    // Коды сравнения - операнд OP_COMPARE и смещение от OP_JUMP_IF_NOT_LT (общие с registerGenerator)
+    static std::map<std::string_view, uint8_t> compareOperator;
 };
 
-std::map<std::string, uint8_t> bytecodeGenerator::compareOperator = {
+std::map<std::string_view, uint8_t> bytecodeGenerator::compareOperator = {
         {"<",  0},
         {">",  1},
         {"==", 2},
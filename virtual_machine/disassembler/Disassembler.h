@@ -3,6 +3,7 @@
 #include <iostream>
 #include "EvaluationValue.h"
 #include "OpCode.h"
+#include "RegisterOpCode.h"
 
 // Disassembler - дизассемблер байткода для отладки и отображения
 class Disassembler {
@@ -13,11 +14,58 @@ public:
         std::cout << "== Disassembly of " << co->name << " ==" << std::endl;
         size_t offset = 0;
         while (offset < co->code.size()) {
-            offset = disassembleInstruction(co, offset);
+            offset = co->registerBased ? disassembleRegisterInstruction(co, offset)
+                                       : disassembleInstruction(co, offset);
         }
     }
 
 private:
+    // Регистровая инструкция: операнды печатаются по описанию из registerOperands
+    size_t disassembleRegisterInstruction(CodeObject* co, size_t offset) {
+        uint8_t opcode = co->code[offset];
+        printf("%04zu %-16s", offset, ("ROP_" + registerOpcodeToString(opcode)).c_str());
+        size_t position = offset + 1;
+        std::string comment;
+        for (const char* operand = registerOperands(opcode); *operand != '\0'; ++operand) {
+            if (!isWideRegisterOperand(*operand)) {
+                uint8_t value = co->code[position++];
+                if (*operand == 'r') {
+                    printf(" r%d", value);
+                    auto local = co->localNames.find(value);
+                    if (local != co->localNames.end()) {
+                        comment += " " + local->second;
+                    }
+                } else {
+                    printf(" %d", value);
+                }
+                continue;
+            }
+            uint16_t value = (co->code[position] << 8) | co->code[position + 1];
+            position += 2;
+            switch (*operand) {
+                case 'k':
+                    printf(" k%d", value);
+                    comment += " " + evaluationValueToConstantString(co->constants[value]);
+                    break;
+                case 'g':
+                    printf(" g%d", value);
+                    comment += " " + global->globals[value].name;
+                    break;
+                case 'a':
+                    printf(" -> %d", value);
+                    break;
+                default:
+                    printf(" %d", value);
+                    break;
+            }
+        }
+        if (!comment.empty()) {
+            std::cout << " ;" << comment;
+        }
+        std::cout << std::endl;
+        return position;
+    }
+
     size_t disassembleInstruction(CodeObject* co, size_t offset) {
         printf("%04zu ", offset);
         uint8_t opcode = co->code[offset];
@@ -37,9 +85,11 @@ private:
             case OP_COMPARE:
                 return byteInstruction("OP_COMPARE", co, offset);
             case OP_JUMP_IF_FALSE:
-                return jumpInstruction("OP_JUMP_IF_FALSE", 1, co, offset);
+                return jumpInstruction("OP_JUMP_IF_FALSE", co, offset);
+            case OP_JUMP_IF_TRUE:
+                return jumpInstruction("OP_JUMP_IF_TRUE", co, offset);
             case OP_JUMP:
-                return jumpInstruction("OP_JUMP", 1, co, offset);
+                return jumpInstruction("OP_JUMP", co, offset);
             case OP_GET_GLOBAL:
                 return globalInstruction("OP_GET_GLOBAL", co, offset);
             case OP_SET_GLOBAL:
@@ -53,9 +103,9 @@ private:
             case OP_LOGICAL_NOT:
                 return simpleInstruction("OP_LOGICAL_NOT", offset);
             case OP_JUMP_IF_FALSE_OR_POP:
-                return jumpInstruction("OP_JUMP_IF_FALSE_OR_POP", 1, co, offset);
+                return jumpInstruction("OP_JUMP_IF_FALSE_OR_POP", co, offset);
             case OP_JUMP_IF_TRUE_OR_POP:
-                return jumpInstruction("OP_JUMP_IF_TRUE_OR_POP", 1, co, offset);
+                return jumpInstruction("OP_JUMP_IF_TRUE_OR_POP", co, offset);
             case OP_DUP:
                 return simpleInstruction("OP_DUP", offset);
             case OP_CALL:
@@ -63,11 +113,43 @@ private:
             case OP_RETURN:
                 return simpleInstruction("OP_RETURN", offset);
             case OP_ARRAY:
-                return simpleInstruction("OP_ARRAY", offset);
+                return capacityInstruction("OP_ARRAY", co, offset);
             case OP_ARRAY_GET:
                 return simpleInstruction("OP_ARRAY_GET", offset);
             case OP_ARRAY_SET:
                 return simpleInstruction("OP_ARRAY_SET", offset);
+            case OP_POP:
+                return simpleInstruction("OP_POP", offset);
+            case OP_GET_GLOBAL_LONG:
+                return globalLongInstruction("OP_GET_GLOBAL_LONG", co, offset);
+            case OP_SET_GLOBAL_LONG:
+                return globalLongInstruction("OP_SET_GLOBAL_LONG", co, offset);
+            case OP_CONST_LONG:
+                return constantLongInstruction("OP_CONST_LONG", co, offset);
+            case OP_ARRAY_LITERAL:
+                return countInstruction("OP_ARRAY_LITERAL", co, offset);
+            case OP_GET_LOCAL_LOCAL:
+                return twoSlotInstruction("OP_GET_LOCAL_LOCAL", co, offset);
+            case OP_ADD_CONST:
+                return constantInstruction("OP_ADD_CONST", co, offset);
+            case OP_SUB_CONST:
+                return constantInstruction("OP_SUB_CONST", co, offset);
+            case OP_INC_LOCAL:
+                return slotConstantInstruction("OP_INC_LOCAL", co, offset);
+            case OP_ARRAY_GET_LOCAL_LOCAL:
+                return twoSlotInstruction("OP_ARRAY_GET_LOCAL_LOCAL", co, offset);
+            case OP_JUMP_IF_NOT_LT:
+                return jumpInstruction("OP_JUMP_IF_NOT_LT", co, offset);
+            case OP_JUMP_IF_NOT_GT:
+                return jumpInstruction("OP_JUMP_IF_NOT_GT", co, offset);
+            case OP_JUMP_IF_NOT_EQ:
+                return jumpInstruction("OP_JUMP_IF_NOT_EQ", co, offset);
+            case OP_JUMP_IF_NOT_GE:
+                return jumpInstruction("OP_JUMP_IF_NOT_GE", co, offset);
+            case OP_JUMP_IF_NOT_LE:
+                return jumpInstruction("OP_JUMP_IF_NOT_LE", co, offset);
+            case OP_JUMP_IF_NOT_NE:
+                return jumpInstruction("OP_JUMP_IF_NOT_NE", co, offset);
             default:
                 throw std::runtime_error("Unknown opcode: " + std::to_string(opcode));
         }
@@ -87,6 +169,14 @@ private:
         return offset + 2;
     }
 
+    size_t constantLongInstruction(const std::string& name, CodeObject* co, size_t offset) {
+        // Индекс константы в двух байтах
+        uint16_t constantIndex = (co->code[offset + 1] << 8) | co->code[offset + 2];
+        printf("%-16s %4d ", name.c_str(), constantIndex);
+        std::cout << "; " << evaluationValueToConstantString(co->constants[constantIndex]) << std::endl;
+        return offset + 3;
+    }
+
     size_t byteInstruction(const std::string& name, CodeObject* co, size_t offset) {
         // Инструкция с одним байтовым аргументом (например локальный индекс)
         uint8_t slot = co->code[offset + 1];
@@ -98,9 +188,33 @@ private:
         return offset + 2;
     }
 
-    size_t jumpInstruction(const std::string& name, int sign, CodeObject* co, size_t offset) {
-        uint16_t jump = (co->code[offset + 1] << 8) | co->code[offset + 2];
-        printf("%-16s %4zu -> %zu\n", name.c_str(), offset, offset + 3 + sign * jump);
+    std::string localName(CodeObject* co, uint8_t slot) {
+        auto found = co->localNames.find(slot);
+        return found != co->localNames.end() ? found->second : "<unknown>";
+    }
+
+    size_t twoSlotInstruction(const std::string& name, CodeObject* co, size_t offset) {
+        // Суперинструкция над двумя локальными переменными
+        uint8_t first = co->code[offset + 1];
+        uint8_t second = co->code[offset + 2];
+        printf("%-16s %4d %4d (%s, %s)\n", name.c_str(), first, second, localName(co, first).c_str(),
+               localName(co, second).c_str());
+        return offset + 3;
+    }
+
+    size_t slotConstantInstruction(const std::string& name, CodeObject* co, size_t offset) {
+        // Локальная переменная и индекс константы
+        uint8_t slot = co->code[offset + 1];
+        uint8_t constantIndex = co->code[offset + 2];
+        printf("%-16s %4d %4d (%s) ", name.c_str(), slot, constantIndex, localName(co, slot).c_str());
+        std::cout << "; " << evaluationValueToConstantString(co->constants[constantIndex]) << std::endl;
+        return offset + 3;
+    }
+
+    size_t jumpInstruction(const std::string& name, CodeObject* co, size_t offset) {
+        // Адрес перехода абсолютный: смещение от начала байткода
+        uint16_t address = (co->code[offset + 1] << 8) | co->code[offset + 2];
+        printf("%-16s %4zu -> %d\n", name.c_str(), offset, address);
         return offset + 3;
     }
 
@@ -112,10 +226,33 @@ private:
         return offset + 2;
     }
 
+    size_t globalLongInstruction(const std::string& name, CodeObject* co, size_t offset) {
+        // Глобальная переменная по 16-битному индексу
+        uint16_t globalIndex = (co->code[offset + 1] << 8) | co->code[offset + 2];
+        const std::string& globalName = global->globals[globalIndex].name;
+        printf("%-16s %4d (%s)\n", name.c_str(), globalIndex, globalName.c_str());
+        return offset + 3;
+    }
+
     size_t callInstruction(const std::string& name, CodeObject* co, size_t offset) {
-        // Вызов функции с числом аргументов
+        // Вызов функции с числом аргументов и номером места вызова
         uint8_t argCount = co->code[offset + 1];
-        printf("%-16s %4d args\n", name.c_str(), argCount);
+        uint16_t site = (co->code[offset + 2] << 8) | co->code[offset + 3];
+        printf("%-16s %4d args, site %d\n", name.c_str(), argCount, site);
+        return offset + 4;
+    }
+
+    size_t capacityInstruction(const std::string& name, CodeObject* co, size_t offset) {
+        // Создание массива с заранее выделенной ёмкостью (два байта)
+        uint16_t capacity = (co->code[offset + 1] << 8) | co->code[offset + 2];
+        printf("%-16s %4d capacity\n", name.c_str(), capacity);
+        return offset + 3;
+    }
+
+    size_t countInstruction(const std::string& name, CodeObject* co, size_t offset) {
+        // Инструкция с числом значений, снимаемых со стека
+        uint8_t count = co->code[offset + 1];
+        printf("%-16s %4d values\n", name.c_str(), count);
         return offset + 2;
     }
 
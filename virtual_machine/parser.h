@@ -25,7 +25,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
-#include <regex>
+#include <string_view>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -50,143 +50,17 @@
 //   }
 //
 // clang-format off
-#include <string>
-#include <vector>
-#include <memory>
-
-enum class ExpType {
-    NUMBER,
-    STRING,
-    SYMBOL,
-    BINARY_EXP,
-    UNARY_EXP,
-    IF_EXP,
-    WHILE_EXP,
-    FOR_EXP,
-    VAR_DECLARATION,
-    BLOCK,
-    ASSIGNMENT,
-    FUNCTION_DECLARATION,
-    FUNCTION_CALL,
-    PARAM_LIST,
-    ARG_LIST,
-    RETURN_STATEMENT,
-    ARRAY_LITERAL,
-    ARRAY_ACCESS  ,
-    /* PRINT_STATEMENT*/
-};
-
-struct Exp {
-    ExpType type;
-
-    int number;
-    std::string string;
-
-    std::string op;
-    std::shared_ptr<Exp> left;
-    std::shared_ptr<Exp> right;
-
-    std::shared_ptr<Exp> condition;
-    std::shared_ptr<Exp> thenBranch;
-    std::shared_ptr<Exp> elseBranch;
-
-    std::string varName;
-    std::shared_ptr<Exp> varValue;
-
-    std::vector<std::shared_ptr<Exp>> statements;
-
-    std::string unaryOp;
-    std::shared_ptr<Exp> operand;
-
-    std::shared_ptr<Exp> whileBody;
-
-    std::shared_ptr<Exp> forInit;
-    std::shared_ptr<Exp> forCondition;
-    std::shared_ptr<Exp> forUpdate;
-    std::shared_ptr<Exp> forBody;
-
-    std::string funcName;
-    std::vector<std::string> funcParams;
-    std::shared_ptr<Exp> funcBody;
-
-    std::vector<std::shared_ptr<Exp>> callArguments;
-
-    std::shared_ptr<Exp> returnValue;
-
-     std::shared_ptr<Exp> arrayValue;
-
-    // Constructors
-
-    Exp(ExpType type, const std::vector<std::string> &params)
-        : type(type), funcParams(params) {}
-
-    Exp(ExpType type, const std::vector<std::shared_ptr<Exp>> &args)
-        : type(type), callArguments(args) {}
-
-    Exp(ExpType type, const std::string &name, const std::vector<std::string> &params, std::shared_ptr<Exp> body)
-        : type(type), funcName(name), funcParams(params), funcBody(body) {}
-
-    Exp(ExpType type, const std::string &name, const std::vector<std::shared_ptr<Exp>> &args)
-        : type(type), funcName(name), callArguments(args) {}
-
-    Exp(int number) : type(ExpType::NUMBER), number(number) {}
-
-    Exp(const std::string& strVal) {
-        if (strVal[0] == '"') {
-            type = ExpType::STRING;
-            string = strVal.substr(1, strVal.size() - 2);
-        } else {
-            type = ExpType::SYMBOL;
-            string = strVal;
-        }
-    }
+#include "Ast.h"
 
-    Exp(const std::string& unaryOp, std::shared_ptr<Exp> operand)
-        : type(ExpType::UNARY_EXP), unaryOp(unaryOp), operand(operand) {}
-
-    Exp(ExpType expType, const std::string& varName, std::shared_ptr<Exp> varValue)
-        : type(expType), varName(varName), varValue(varValue) {}
-
-    Exp(const std::string& op, std::shared_ptr<Exp> left, std::shared_ptr<Exp> right)
-        : type(ExpType::BINARY_EXP), op(op), left(left), right(right) {}
-
-    Exp(ExpType expType, std::shared_ptr<Exp> condition, std::shared_ptr<Exp> thenBranch, std::shared_ptr<Exp> elseBranch)
-        : type(expType), condition(condition), thenBranch(thenBranch), elseBranch(elseBranch) {}
-
-    Exp(const std::vector<std::shared_ptr<Exp>>& statements)
-        : type(ExpType::BLOCK), statements(statements) {}
-
-    Exp(ExpType expType, std::shared_ptr<Exp> condition, std::shared_ptr<Exp> whileBody)
-        : type(expType), condition(condition), whileBody(whileBody) {}
-
-    Exp(ExpType expType, std::shared_ptr<Exp> forInit, std::shared_ptr<Exp> forCondition, std::shared_ptr<Exp> forUpdate, std::shared_ptr<Exp> forBody)
-        : type(expType), forInit(forInit), forCondition(forCondition), forUpdate(forUpdate), forBody(forBody) {}
-
-
-Exp(ExpType type, std::shared_ptr<Exp> singleValue)
-    : type(type)
-{
-    switch(type) {
-        case ExpType::RETURN_STATEMENT:
-            returnValue = singleValue;
-            break;
-      /*  case ExpType::PRINT_STATEMENT:
-            varValue = singleValue;
-            break;
-
-        default:
-            varValue = singleValue;
-            break;*/
+// Строковый литерал (в кавычках) или имя
+inline Exp *makeStringOrSymbol(AstArena &arena, std::string_view token) {
+    if (!token.empty() && token[0] == '"') {
+        return arena.make<Exp>(ExpType::STRING, arena.copyString(token.substr(1, token.size() - 2)));
     }
+    return arena.make<Exp>(ExpType::SYMBOL, arena.copyString(token));
 }
 
-
-    Exp(ExpType type, const std::string &varName, std::shared_ptr<Exp> varValue, std::shared_ptr<Exp> arrayValue)
-            : type(type), varName(varName), varValue(varValue), arrayValue(arrayValue) {}
-
-};
-
-using Value = std::shared_ptr<Exp>;  // clang-format on
+using Value = Exp*;  // clang-format on
 
 namespace syntax {
 
@@ -252,7 +126,7 @@ enum class TokenType {
 
 struct Token {
   TokenType type;
-  std::string value;
+  std::string_view value;  // Points into the source string
 
   int startOffset;
   int endOffset;
@@ -262,18 +136,6 @@ struct Token {
   int endColumn;
 };
 
-using SharedToken = std::shared_ptr<Token>;
-
-typedef TokenType (*LexRuleHandler)(const Tokenizer&, const std::string&);
-
-// ------------------------------------------------------------------
-// Lex rule: [regex, handler]
-
-struct LexRule {
-  std::regex regex;
-  LexRuleHandler handler;
-};
-
 // ------------------------------------------------------------------
 // Token.
 
@@ -285,11 +147,16 @@ enum TokenizerState {
 
 // ------------------------------------------------------------------
 // Tokenizer.
+//
+// Hand-written single-pass scanner over a std::string_view of the source
+// (replaces the generated std::regex rules). Each token is recognized by its
+// first character; identifiers are scanned whole and only then compared with
+// keywords, so `format` or `iffy` are symbols, not `for`/`if` + rest.
 
 class Tokenizer {
  public:
   /**
-   * Initializes a parsing string.
+   * Initializes a parsing string. The string must outlive the tokenizer.
    */
   void initString(const std::string& str) {
     str_ = str;
@@ -314,7 +181,7 @@ class Tokenizer {
   /**
    * Whether there are still tokens in the stream.
    */
-  inline bool hasMoreTokens() { return cursor_ <= str_.length(); }
+  inline bool hasMoreTokens() { return cursor_ <= (int)str_.length(); }
 
   /**
    * Returns current tokenizing state.
@@ -343,59 +210,43 @@ class Tokenizer {
   /**
    * Returns next token.
    */
-  SharedToken getNextToken() {
-    if (!hasMoreTokens()) {
-      yytext = __EOF;
-      return toToken(TokenType::__EOF);
-    }
-
-    auto strSlice = str_.substr(cursor_);
-
-    auto lexRulesForState = lexRulesByStartConditions_.at(getCurrentState());
-
-    for (const auto& ruleIndex : lexRulesForState) {
-      auto rule = lexRules_[ruleIndex];
-      std::smatch sm;
-
-      if (std::regex_search(strSlice, sm, rule.regex)) {
-        yytext = sm[0];
-
-        captureLocations_(yytext);
-        cursor_ += yytext.length();
+  Token getNextToken() {
+    for (;;) {
+      if (!hasMoreTokens()) {
+        yytext = __EOF;
+        return toToken(TokenType::__EOF);
+      }
 
-        // Manual handling of EOF token (the end of string). Return it
-        // as `EOF` symbol.
-        if (yytext.length() == 0) {
-          cursor_++;
-        }
+      if (isEOF()) {
+        cursor_++;
+        yytext = __EOF;
+        return toToken(TokenType::__EOF);
+      }
 
-        auto tokenType = rule.handler(*this, yytext);
+      size_t length = 0;
+      auto tokenType = scanToken_(length);
 
-        if (tokenType == TokenType::__EMPTY) {
-          return getNextToken();
-        }
+      auto matched = str_.substr(cursor_, length);
+      captureLocations_(matched);
+      cursor_ += length;
 
-        return toToken(tokenType);
+      // Whitespace and comments.
+      if (tokenType == TokenType::__EMPTY) {
+        continue;
       }
-    }
 
-    if (isEOF()) {
-      cursor_++;
-      yytext = __EOF;
-      return toToken(TokenType::__EOF);
+      yytext = matched;
+      return toToken(tokenType);
     }
-
-    throwUnexpectedToken(std::string(1, strSlice[0]), currentLine_,
-                         currentColumn_);
   }
 
   /**
    * Whether the cursor is at the EOF.
    */
-  inline bool isEOF() { return cursor_ == str_.length(); }
+  inline bool isEOF() { return cursor_ == (int)str_.length(); }
 
-  SharedToken toToken(TokenType tokenType) {
-    return std::shared_ptr<Token>(new Token{
+  Token toToken(TokenType tokenType) {
+    return Token{
         .type = tokenType,
         .value = yytext,
         .startOffset = tokenStartOffset_,
@@ -404,7 +255,7 @@ class Tokenizer {
         .endLine = tokenEndLine_,
         .startColumn = tokenStartColumn_,
         .endColumn = tokenEndColumn_,
-    });
+    };
   }
 
   /**
@@ -414,7 +265,7 @@ class Tokenizer {
    */
   [[noreturn]] void throwUnexpectedToken(const std::string& symbol, int line,
                                          int column) {
-    std::stringstream ss{str_};
+    std::stringstream ss{std::string(str_)};
     std::string lineStr;
     int currentLine = 1;
 
@@ -436,16 +287,151 @@ class Tokenizer {
   }
 
   /**
-   * Matched text.
+   * Matched text (a view into the source string).
    */
-  std::string yytext;
+  std::string_view yytext;
 
  private:
+  static bool isDigit_(char c) { return c >= '0' && c <= '9'; }
+
+  static bool isWordChar_(char c) {
+    return isDigit_(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           c == '_';
+  }
+
+  static bool isSpace_(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' ||
+           c == '\f';
+  }
+
+  static TokenType keywordOrSymbol_(std::string_view word) {
+    switch (word.size()) {
+      case 2:
+        if (word == "if") return TokenType::IF;
+        break;
+      case 3:
+        if (word == "for") return TokenType::FOR;
+        if (word == "var") return TokenType::VAR;
+        break;
+      case 4:
+        if (word == "func") return TokenType::FUNC;
+        if (word == "else") return TokenType::ELSE;
+        break;
+      case 5:
+        if (word == "while") return TokenType::WHILE;
+        break;
+      case 6:
+        if (word == "return") return TokenType::RETURN;
+        break;
+    }
+    return TokenType::SYMBOL;
+  }
+
+  /**
+   * Recognizes the token at the cursor: returns its type (__EMPTY for
+   * whitespace and comments) and stores its length.
+   */
+  TokenType scanToken_(size_t& length) {
+    const char* begin = str_.data() + cursor_;
+    const char* end = str_.data() + str_.size();
+    const char* p = begin;
+
+    auto single = [&](TokenType type) {
+      length = 1;
+      return type;
+    };
+    auto pair = [&](char second, TokenType both, TokenType one) {
+      if (p + 1 < end && p[1] == second) {
+        length = 2;
+        return both;
+      }
+      length = 1;
+      return one;
+    };
+
+    switch (*p) {
+      case ' ': case '\t': case '\n': case '\r': case '\v': case '\f':
+        while (p < end && isSpace_(*p)) p++;
+        length = p - begin;
+        return TokenType::__EMPTY;
+
+      case '/':
+        if (p + 1 < end && p[1] == '/') {
+          while (p < end && *p != '\n') p++;
+          length = p - begin;
+          return TokenType::__EMPTY;
+        }
+        if (p + 1 < end && p[1] == '*') {
+          auto close = str_.find("*/", cursor_ + 2);
+          // An unterminated comment is just a division sign.
+          if (close != std::string_view::npos) {
+            length = close + 2 - cursor_;
+            return TokenType::__EMPTY;
+          }
+        }
+        return single(TokenType::DIVIDE);
+
+      case '=': return pair('=', TokenType::EQUALS, TokenType::ASSIGN);
+      case '!': return pair('=', TokenType::NOT_EQUALS, TokenType::LOGICAL_NOT);
+      case '<': return pair('=', TokenType::LESS_EQUAL, TokenType::LESS);
+      case '>': return pair('=', TokenType::GREATER_EQUAL, TokenType::GREATER);
+      case ';': return single(TokenType::SEMICOLON);
+      case '(': return single(TokenType::L_PAREN);
+      case ')': return single(TokenType::R_PAREN);
+      case '{': return single(TokenType::L_BRACE);
+      case '}': return single(TokenType::R_BRACE);
+      case '[': return single(TokenType::L_BRACKET);
+      case ']': return single(TokenType::R_BRACKET);
+      case ',': return single(TokenType::COMMA);
+      case '+': return single(TokenType::PLUS);
+      case '-': return single(TokenType::MINUS);
+      case '*': return single(TokenType::MULTIPLY);
+
+      case '&':
+        if (p + 1 < end && p[1] == '&') {
+          length = 2;
+          return TokenType::LOGICAL_AND;
+        }
+        break;
+
+      case '|':
+        if (p + 1 < end && p[1] == '|') {
+          length = 2;
+          return TokenType::LOGICAL_OR;
+        }
+        break;
+
+      case '"': {
+        auto close = str_.find('"', cursor_ + 1);
+        if (close != std::string_view::npos) {
+          length = close + 1 - cursor_;
+          return TokenType::STRING;
+        }
+        break;
+      }
+
+      default:
+        if (isDigit_(*p)) {
+          while (p < end && isDigit_(*p)) p++;
+          length = p - begin;
+          return TokenType::NUMBER;
+        }
+        if (isWordChar_(*p)) {
+          while (p < end && isWordChar_(*p)) p++;
+          length = p - begin;
+          return keywordOrSymbol_(std::string_view(begin, length));
+        }
+        break;
+    }
+
+    throwUnexpectedToken(std::string(1, *p), currentLine_, currentColumn_);
+  }
+
   /**
    * Captures token locations.
    */
-  void captureLocations_(const std::string& matched) {
-    auto len = matched.length();
+  void captureLocations_(std::string_view matched) {
+    auto len = (int)matched.length();
 
     // Absolute offsets.
     tokenStartOffset_ = cursor_;
@@ -455,13 +441,11 @@ class Tokenizer {
     tokenStartColumn_ = tokenStartOffset_ - currentLineBeginOffset_;
 
     // Extract `\n` in the matched token.
-    std::stringstream ss{matched};
-    std::string lineStr;
-    std::getline(ss, lineStr, '\n');
-    while (ss.tellg() > 0 && ss.tellg() <= len) {
-      currentLine_++;
-      currentLineBeginOffset_ = tokenStartOffset_ + ss.tellg();
-      std::getline(ss, lineStr, '\n');
+    for (int i = 0; i < len; i++) {
+      if (matched[i] == '\n') {
+        currentLine_++;
+        currentLineBeginOffset_ = tokenStartOffset_ + i + 1;
+      }
     }
 
     tokenEndOffset_ = cursor_ + len;
@@ -472,24 +456,15 @@ class Tokenizer {
     currentColumn_ = tokenEndColumn_;
   }
 
-  /**
-   * Lexical rules.
-   */
-  // clang-format off
-  static constexpr size_t LEX_RULES_COUNT = 35;
-  static std::array<LexRule, LEX_RULES_COUNT> lexRules_;
-  static std::map<TokenizerState, std::vector<size_t>> lexRulesByStartConditions_;
-  // clang-format on
-
   /**
    * Special EOF token.
    */
-  static std::string __EOF;
+  static constexpr std::string_view __EOF = "$";
 
   /**
    * Tokenizing string.
    */
-  std::string str_;
+  std::string_view str_;
 
   /**
    * Cursor for current symbol.
@@ -519,196 +494,6 @@ class Tokenizer {
   int tokenEndColumn_;
 };
 
-// ------------------------------------------------------------------
-// Lexical rule handlers.
-
-std::string Tokenizer::__EOF("$");
-
-// clang-format off
-inline TokenType _lexRule1(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::__EMPTY;
-}
-
-inline TokenType _lexRule2(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::__EMPTY;
-}
-
-inline TokenType _lexRule3(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::__EMPTY;
-}
-
-inline TokenType _lexRule4(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::RETURN;
-}
-
-inline TokenType _lexRule5(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::FUNC;
-}
-
-inline TokenType _lexRule6(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::IF;
-}
-
-inline TokenType _lexRule7(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::ELSE;
-}
-
-inline TokenType _lexRule8(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::WHILE;
-}
-
-inline TokenType _lexRule9(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::FOR;
-}
-
-inline TokenType _lexRule10(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::VAR;
-}
-
-inline TokenType _lexRule11(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::EQUALS;
-}
-
-inline TokenType _lexRule12(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::NOT_EQUALS;
-}
-
-inline TokenType _lexRule13(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::LESS_EQUAL;
-}
-
-inline TokenType _lexRule14(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::GREATER_EQUAL;
-}
-
-inline TokenType _lexRule15(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::LESS;
-}
-
-inline TokenType _lexRule16(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::GREATER;
-}
-
-inline TokenType _lexRule17(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::ASSIGN;
-}
-
-inline TokenType _lexRule18(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::SEMICOLON;
-}
-
-inline TokenType _lexRule19(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::L_PAREN;
-}
-
-inline TokenType _lexRule20(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::R_PAREN;
-}
-
-inline TokenType _lexRule21(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::L_BRACE;
-}
-
-inline TokenType _lexRule22(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::R_BRACE;
-}
-
-inline TokenType _lexRule23(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::L_BRACKET        /* Added for arrays */;
-}
-
-inline TokenType _lexRule24(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::R_BRACKET        /* Added for arrays */;
-}
-
-inline TokenType _lexRule25(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::COMMA            /* Added for arrays */;
-}
-
-inline TokenType _lexRule26(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::LOGICAL_AND;
-}
-
-inline TokenType _lexRule27(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::LOGICAL_OR;
-}
-
-inline TokenType _lexRule28(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::LOGICAL_NOT;
-}
-
-inline TokenType _lexRule29(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::PLUS;
-}
-
-inline TokenType _lexRule30(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::MINUS;
-}
-
-inline TokenType _lexRule31(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::MULTIPLY;
-}
-
-inline TokenType _lexRule32(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::DIVIDE;
-}
-
-inline TokenType _lexRule33(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::STRING;
-}
-
-inline TokenType _lexRule34(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::NUMBER;
-}
-
-inline TokenType _lexRule35(const Tokenizer& tokenizer, const std::string& yytext) {
-return TokenType::SYMBOL;
-}
-// clang-format on
-
-// ------------------------------------------------------------------
-// Lexical rules.
-
-// clang-format off
-std::array<LexRule, Tokenizer::LEX_RULES_COUNT> Tokenizer::lexRules_ = {{
-  {std::regex(R"(^\/\/.*)"), &_lexRule1},
-  {std::regex(R"(^\/\*[\s\S]*?\*\/)"), &_lexRule2},
-  {std::regex(R"(^\s+)"), &_lexRule3},
-  {std::regex(R"(^return)"), &_lexRule4},
-  {std::regex(R"(^func)"), &_lexRule5},
-  {std::regex(R"(^if)"), &_lexRule6},
-  {std::regex(R"(^else)"), &_lexRule7},
-  {std::regex(R"(^while)"), &_lexRule8},
-  {std::regex(R"(^for)"), &_lexRule9},
-  {std::regex(R"(^var)"), &_lexRule10},
-  {std::regex(R"(^==)"), &_lexRule11},
-  {std::regex(R"(^!=)"), &_lexRule12},
-  {std::regex(R"(^<=)"), &_lexRule13},
-  {std::regex(R"(^>=)"), &_lexRule14},
-  {std::regex(R"(^<)"), &_lexRule15},
-  {std::regex(R"(^>)"), &_lexRule16},
-  {std::regex(R"(^=)"), &_lexRule17},
-  {std::regex(R"(^;)"), &_lexRule18},
-  {std::regex(R"(^\()"), &_lexRule19},
-  {std::regex(R"(^\))"), &_lexRule20},
-  {std::regex(R"(^\{)"), &_lexRule21},
-  {std::regex(R"(^\})"), &_lexRule22},
-  {std::regex(R"(^\[)"), &_lexRule23},
-  {std::regex(R"(^\])"), &_lexRule24},
-  {std::regex(R"(^,)"), &_lexRule25},
-  {std::regex(R"(^&&)"), &_lexRule26},
-  {std::regex(R"(^\|\|)"), &_lexRule27},
-  {std::regex(R"(^!)"), &_lexRule28},
-  {std::regex(R"(^\+)"), &_lexRule29},
-  {std::regex(R"(^-)"), &_lexRule30},
-  {std::regex(R"(^\*)"), &_lexRule31},
-  {std::regex(R"(^\/)"), &_lexRule32},
-  {std::regex(R"(^"[^\"]*")"), &_lexRule33},
-  {std::regex(R"(^\d+)"), &_lexRule34},
-  {std::regex(R"(^[\w]+)"), &_lexRule35}
-}};
-std::map<TokenizerState, std::vector<size_t>> Tokenizer::lexRulesByStartConditions_ =  {{TokenizerState::INITIAL, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34}}};
-// clang-format on
 
 #endif
 // clang-format on
@@ -717,17 +502,18 @@ std::map<TokenizerState, std::vector<size_t>> Tokenizer::lexRulesByStartConditio
   parser.valuesStack.back(); \
   parser.valuesStack.pop_back()
 
-#define POP_T()              \
-  parser.tokensStack.back(); \
+#define POP_T()                           \
+  std::string(parser.tokensStack.back()); \
   parser.tokensStack.pop_back()
 
 #define PUSH_VR() parser.valuesStack.push_back(__)
 #define PUSH_TR() parser.tokensStack.push_back(__)
 
 /**
- * Parsing table type.
+ * Parsing table type. Error marks an empty cell of the dense table.
  */
-enum class TE {
+enum class TE : uint8_t {
+  Error,
   Accept,
   Shift,
   Reduce,
@@ -735,13 +521,189 @@ enum class TE {
 };
 
 /**
- * Parsing table entry.
+ * Parsing table entry: a state number (Shift, Transit) or a production
+ * number (Reduce), both below 256.
  */
 struct TableEntry {
+  TE type;
+  uint8_t value;
+};
+
+/**
+ * Parsing table entry in the sparse form the grammar tool emits.
+ */
+struct SparseTableEntry {
+  int state;
+  int column;
   TE type;
   int value;
 };
 
+static constexpr size_t ROWS_COUNT = 134;
+
+// Columns: encoded symbols, non-terminals first, then TokenType values up to __EOF.
+static constexpr size_t COLUMNS_COUNT = (size_t)TokenType::__EOF + 1;
+
+/**
+ * Dense parsing table: one flat row of entries per state, indexed
+ * directly by the encoded symbol.
+ */
+using ParseTable = std::array<std::array<TableEntry, COLUMNS_COUNT>, ROWS_COUNT>;
+
+template <size_t N>
+constexpr ParseTable buildParseTable(const SparseTableEntry (&entries)[N]) {
+  ParseTable table{};
+  for (const auto& entry : entries) {
+    table[entry.state][entry.column] = {entry.type, (uint8_t)entry.value};
+  }
+  return table;
+}
+
+// ------------------------------------------------------------------
+// Parsing table.
+
+// clang-format off
+constexpr SparseTableEntry sparseTable_[] = {
+    {0, 0, TE::Transit, 1}, {0, 1, TE::Transit, 2}, {0, 2, TE::Transit, 3}, {0, 3, TE::Transit, 4}, {0, 4, TE::Transit, 5}, {0, 5, TE::Transit, 7}, {0, 6, TE::Transit, 37}, {0, 7, TE::Transit, 8}, {0, 8, TE::Transit, 9}, {0, 12, TE::Transit, 11}, {0, 13, TE::Transit, 10}, {0, 14, TE::Transit, 18}, {0, 15, TE::Transit, 16}, {0, 16, TE::Transit, 6}, {0, 17, TE::Transit, 17}, {0, 18, TE::Transit, 20}, {0, 19, TE::Transit, 21}, {0, 20, TE::Transit, 24}, {0, 21, TE::Transit, 25}, {0, 22, TE::Transit, 26}, {0, 23, TE::Transit, 27}, {0, 24, TE::Transit, 28}, {0, 25, TE::Transit, 29}, {0, 26, TE::Transit, 31}, {0, 27, TE::Transit, 23}, {0, 32, TE::Shift, 12}, {0, 33, TE::Shift, 32}, {0, 36, TE::Shift, 13}, {0, 37, TE::Shift, 14}, {0, 39, TE::Shift, 15}, {0, 40, TE::Shift, 22}, {0, 41, TE::Shift, 36}, {0, 43, TE::Shift, 19}, {0, 45, TE::Shift, 38}, {0, 58, TE::Shift, 30}, {0, 59, TE::Shift, 33}, {0, 60, TE::Shift, 34}, {0, 61, TE::Shift, 35},
+    {1, 64, TE::Accept, 0},
+    {2, 2, TE::Transit, 39}, {2, 3, TE::Transit, 4}, {2, 4, TE::Transit, 5}, {2, 5, TE::Transit, 7}, {2, 6, TE::Transit, 37}, {2, 7, TE::Transit, 8}, {2, 8, TE::Transit, 9}, {2, 12, TE::Transit, 11}, {2, 13, TE::Transit, 10}, {2, 14, TE::Transit, 18}, {2, 15, TE::Transit, 16}, {2, 16, TE::Transit, 6}, {2, 17, TE::Transit, 17}, {2, 18, TE::Transit, 20}, {2, 19, TE::Transit, 21}, {2, 20, TE::Transit, 24}, {2, 21, TE::Transit, 25}, {2, 22, TE::Transit, 26}, {2, 23, TE::Transit, 27}, {2, 24, TE::Transit, 28}, {2, 25, TE::Transit, 29}, {2, 26, TE::Transit, 31}, {2, 27, TE::Transit, 23}, {2, 32, TE::Shift, 12}, {2, 33, TE::Shift, 32}, {2, 36, TE::Shift, 13}, {2, 37, TE::Shift, 14}, {2, 39, TE::Shift, 15}, {2, 40, TE::Shift, 22}, {2, 41, TE::Shift, 36}, {2, 43, TE::Shift, 19}, {2, 45, TE::Shift, 38}, {2, 58, TE::Shift, 30}, {2, 59, TE::Shift, 33}, {2, 60, TE::Shift, 34}, {2, 61, TE::Shift, 35}, {2, 64, TE::Reduce, 1},
+    {3, 32, TE::Reduce, 2}, {3, 33, TE::Reduce, 2}, {3, 36, TE::Reduce, 2}, {3, 37, TE::Reduce, 2}, {3, 39, TE::Reduce, 2}, {3, 40, TE::Reduce, 2}, {3, 41, TE::Reduce, 2}, {3, 42, TE::Reduce, 2}, {3, 43, TE::Reduce, 2}, {3, 45, TE::Reduce, 2}, {3, 58, TE::Reduce, 2}, {3, 59, TE::Reduce, 2}, {3, 60, TE::Reduce, 2}, {3, 61, TE::Reduce, 2}, {3, 64, TE::Reduce, 2},
+    {4, 32, TE::Reduce, 4}, {4, 33, TE::Reduce, 4}, {4, 36, TE::Reduce, 4}, {4, 37, TE::Reduce, 4}, {4, 39, TE::Reduce, 4}, {4, 40, TE::Reduce, 4}, {4, 41, TE::Reduce, 4}, {4, 42, TE::Reduce, 4}, {4, 43, TE::Reduce, 4}, {4, 45, TE::Reduce, 4}, {4, 58, TE::Reduce, 4}, {4, 59, TE::Reduce, 4}, {4, 60, TE::Reduce, 4}, {4, 61, TE::Reduce, 4}, {4, 64, TE::Reduce, 4},
+    {5, 32, TE::Reduce, 5}, {5, 33, TE::Reduce, 5}, {5, 36, TE::Reduce, 5}, {5, 37, TE::Reduce, 5}, {5, 39, TE::Reduce, 5}, {5, 40, TE::Reduce, 5}, {5, 41, TE::Reduce, 5}, {5, 42, TE::Reduce, 5}, {5, 43, TE::Reduce, 5}, {5, 45, TE::Reduce, 5}, {5, 58, TE::Reduce, 5}, {5, 59, TE::Reduce, 5}, {5, 60, TE::Reduce, 5}, {5, 61, TE::Reduce, 5}, {5, 64, TE::Reduce, 5},
+    {6, 32, TE::Reduce, 6}, {6, 33, TE::Reduce, 6}, {6, 36, TE::Reduce, 6}, {6, 37, TE::Reduce, 6}, {6, 39, TE::Reduce, 6}, {6, 40, TE::Reduce, 6}, {6, 41, TE::Reduce, 6}, {6, 42, TE::Reduce, 6}, {6, 43, TE::Reduce, 6}, {6, 45, TE::Reduce, 6}, {6, 58, TE::Reduce, 6}, {6, 59, TE::Reduce, 6}, {6, 60, TE::Reduce, 6}, {6, 61, TE::Reduce, 6}, {6, 64, TE::Reduce, 6},
+    {7, 32, TE::Reduce, 7}, {7, 33, TE::Reduce, 7}, {7, 35, TE::Reduce, 7}, {7, 36, TE::Reduce, 7}, {7, 37, TE::Reduce, 7}, {7, 39, TE::Reduce, 7}, {7, 40, TE::Reduce, 7}, {7, 41, TE::Reduce, 7}, {7, 42, TE::Reduce, 7}, {7, 43, TE::Reduce, 7}, {7, 45, TE::Reduce, 7}, {7, 58, TE::Reduce, 7}, {7, 59, TE::Reduce, 7}, {7, 60, TE::Reduce, 7}, {7, 61, TE::Reduce, 7}, {7, 64, TE::Reduce, 7},
+    {8, 32, TE::Reduce, 8}, {8, 33, TE::Reduce, 8}, {8, 35, TE::Reduce, 8}, {8, 36, TE::Reduce, 8}, {8, 37, TE::Reduce, 8}, {8, 39, TE::Reduce, 8}, {8, 40, TE::Reduce, 8}, {8, 41, TE::Reduce, 8}, {8, 42, TE::Reduce, 8}, {8, 43, TE::Reduce, 8}, {8, 45, TE::Reduce, 8}, {8, 58, TE::Reduce, 8}, {8, 59, TE::Reduce, 8}, {8, 60, TE::Reduce, 8}, {8, 61, TE::Reduce, 8}, {8, 64, TE::Reduce, 8},
+    {9, 32, TE::Reduce, 9}, {9, 33, TE::Reduce, 9}, {9, 35, TE::Reduce, 9}, {9, 36, TE::Reduce, 9}, {9, 37, TE::Reduce, 9}, {9, 39, TE::Reduce, 9}, {9, 40, TE::Reduce, 9}, {9, 41, TE::Reduce, 9}, {9, 42, TE::Reduce, 9}, {9, 43, TE::Reduce, 9}, {9, 45, TE::Reduce, 9}, {9, 58, TE::Reduce, 9}, {9, 59, TE::Reduce, 9}, {9, 60, TE::Reduce, 9}, {9, 61, TE::Reduce, 9}, {9, 64, TE::Reduce, 9},
+    {10, 32, TE::Reduce, 10}, {10, 33, TE::Reduce, 10}, {10, 35, TE::Reduce, 10}, {10, 36, TE::Reduce, 10}, {10, 37, TE::Reduce, 10}, {10, 39, TE::Reduce, 10}, {10, 40, TE::Reduce, 10}, {10, 41, TE::Reduce, 10}, {10, 42, TE::Reduce, 10}, {10, 43, TE::Reduce, 10}, {10, 45, TE::Reduce, 10}, {10, 58, TE::Reduce, 10}, {10, 59, TE::Reduce, 10}, {10, 60, TE::Reduce, 10}, {10, 61, TE::Reduce, 10}, {10, 64, TE::Reduce, 10},
+    {11, 32, TE::Reduce, 11}, {11, 33, TE::Reduce, 11}, {11, 35, TE::Reduce, 11}, {11, 36, TE::Reduce, 11}, {11, 37, TE::Reduce, 11}, {11, 39, TE::Reduce, 11}, {11, 40, TE::Reduce, 11}, {11, 41, TE::Reduce, 11}, {11, 42, TE::Reduce, 11}, {11, 43, TE::Reduce, 11}, {11, 45, TE::Reduce, 11}, {11, 58, TE::Reduce, 11}, {11, 59, TE::Reduce, 11}, {11, 60, TE::Reduce, 11}, {11, 61, TE::Reduce, 11}, {11, 64, TE::Reduce, 11},
+    {12, 33, TE::Shift, 40},
+    {13, 33, TE::Shift, 52},
+    {14, 33, TE::Shift, 56},
+    {15, 40, TE::Shift, 68},
+    {16, 38, TE::Shift, 77},
+    {17, 38, TE::Shift, 78},
+    {18, 32, TE::Reduce, 26}, {18, 33, TE::Reduce, 26}, {18, 35, TE::Reduce, 26}, {18, 36, TE::Reduce, 26}, {18, 37, TE::Reduce, 26}, {18, 39, TE::Reduce, 26}, {18, 40, TE::Reduce, 26}, {18, 41, TE::Reduce, 26}, {18, 42, TE::Reduce, 26}, {18, 43, TE::Reduce, 26}, {18, 45, TE::Reduce, 26}, {18, 58, TE::Reduce, 26}, {18, 59, TE::Reduce, 26}, {18, 60, TE::Reduce, 26}, {18, 61, TE::Reduce, 26}, {18, 64, TE::Reduce, 26},
+    {19, 40, TE::Shift, 79},
+    {20, 34, TE::Reduce, 31}, {20, 38, TE::Reduce, 31}, {20, 62, TE::Reduce, 31}, {20, 63, TE::Reduce, 31},
+    {21, 34, TE::Reduce, 32}, {21, 38, TE::Reduce, 32}, {21, 46, TE::Shift, 82}, {21, 62, TE::Reduce, 32}, {21, 63, TE::Reduce, 32},
+    {22, 33, TE::Shift, 106}, {22, 34, TE::Reduce, 62}, {22, 38, TE::Reduce, 62}, {22, 44, TE::Shift, 104}, {22, 46, TE::Reduce, 62}, {22, 47, TE::Reduce, 62}, {22, 48, TE::Reduce, 62}, {22, 49, TE::Reduce, 62}, {22, 50, TE::Reduce, 62}, {22, 51, TE::Reduce, 62}, {22, 52, TE::Reduce, 62}, {22, 53, TE::Reduce, 62}, {22, 54, TE::Reduce, 62}, {22, 55, TE::Reduce, 62}, {22, 56, TE::Reduce, 62}, {22, 57, TE::Reduce, 62}, {22, 61, TE::Shift, 105}, {22, 62, TE::Reduce, 62}, {22, 63, TE::Reduce, 62},
+    {23, 44, TE::Shift, 108},
+    {24, 34, TE::Reduce, 36}, {24, 38, TE::Reduce, 36}, {24, 46, TE::Reduce, 36}, {24, 47, TE::Shift, 85}, {24, 62, TE::Reduce, 36}, {24, 63, TE::Reduce, 36},
+    {25, 34, TE::Reduce, 38}, {25, 38, TE::Reduce, 38}, {25, 46, TE::Reduce, 38}, {25, 47, TE::Reduce, 38}, {25, 48, TE::Shift, 87}, {25, 49, TE::Shift, 88}, {25, 62, TE::Reduce, 38}, {25, 63, TE::Reduce, 38},
+    {26, 34, TE::Reduce, 41}, {26, 38, TE::Reduce, 41}, {26, 46, TE::Reduce, 41}, {26, 47, TE::Reduce, 41}, {26, 48, TE::Reduce, 41}, {26, 49, TE::Reduce, 41}, {26, 50, TE::Shift, 90}, {26, 51, TE::Shift, 91}, {26, 52, TE::Shift, 92}, {26, 53, TE::Shift, 93}, {26, 62, TE::Reduce, 41}, {26, 63, TE::Reduce, 41},
+    {27, 34, TE::Reduce, 46}, {27, 38, TE::Reduce, 46}, {27, 46, TE::Reduce, 46}, {27, 47, TE::Reduce, 46}, {27, 48, TE::Reduce, 46}, {27, 49, TE::Reduce, 46}, {27, 50, TE::Reduce, 46}, {27, 51, TE::Reduce, 46}, {27, 52, TE::Reduce, 46}, {27, 53, TE::Reduce, 46}, {27, 54, TE::Shift, 95}, {27, 55, TE::Shift, 96}, {27, 62, TE::Reduce, 46}, {27, 63, TE::Reduce, 46},
+    {28, 34, TE::Reduce, 49}, {28, 38, TE::Reduce, 49}, {28, 46, TE::Reduce, 49}, {28, 47, TE::Reduce, 49}, {28, 48, TE::Reduce, 49}, {28, 49, TE::Reduce, 49}, {28, 50, TE::Reduce, 49}, {28, 51, TE::Reduce, 49}, {28, 52, TE::Reduce, 49}, {28, 53, TE::Reduce, 49}, {28, 54, TE::Reduce, 49}, {28, 55, TE::Reduce, 49}, {28, 56, TE::Shift, 98}, {28, 57, TE::Shift, 99}, {28, 62, TE::Reduce, 49}, {28, 63, TE::Reduce, 49},
+    {29, 34, TE::Reduce, 52}, {29, 38, TE::Reduce, 52}, {29, 46, TE::Reduce, 52}, {29, 47, TE::Reduce, 52}, {29, 48, TE::Reduce, 52}, {29, 49, TE::Reduce, 52}, {29, 50, TE::Reduce, 52}, {29, 51, TE::Reduce, 52}, {29, 52, TE::Reduce, 52}, {29, 53, TE::Reduce, 52}, {29, 54, TE::Reduce, 52}, {29, 55, TE::Reduce, 52}, {29, 56, TE::Reduce, 52}, {29, 57, TE::Reduce, 52}, {29, 62, TE::Reduce, 52}, {29, 63, TE::Reduce, 52},
+    {30, 25, TE::Transit, 101}, {30, 26, TE::Transit, 31}, {30, 33, TE::Shift, 32}, {30, 40, TE::Shift, 84}, {30, 58, TE::Shift, 30}, {30, 59, TE::Shift, 33}, {30, 60, TE::Shift, 34}, {30, 61, TE::Shift, 35},
+    {31, 34, TE::Reduce, 54}, {31, 38, TE::Reduce, 54}, {31, 46, TE::Reduce, 54}, {31, 47, TE::Reduce, 54}, {31, 48, TE::Reduce, 54}, {31, 49, TE::Reduce, 54}, {31, 50, TE::Reduce, 54}, {31, 51, TE::Reduce, 54}, {31, 52, TE::Reduce, 54}, {31, 53, TE::Reduce, 54}, {31, 54, TE::Reduce, 54}, {31, 55, TE::Reduce, 54}, {31, 56, TE::Reduce, 54}, {31, 57, TE::Reduce, 54}, {31, 62, TE::Reduce, 54}, {31, 63, TE::Reduce, 54},
+    {32, 17, TE::Transit, 102}, {32, 18, TE::Transit, 20}, {32, 19, TE::Transit, 21}, {32, 20, TE::Transit, 24}, {32, 21, TE::Transit, 25}, {32, 22, TE::Transit, 26}, {32, 23, TE::Transit, 27}, {32, 24, TE::Transit, 28}, {32, 25, TE::Transit, 29}, {32, 26, TE::Transit, 31}, {32, 27, TE::Transit, 23}, {32, 33, TE::Shift, 32}, {32, 40, TE::Shift, 22}, {32, 58, TE::Shift, 30}, {32, 59, TE::Shift, 33}, {32, 60, TE::Shift, 34}, {32, 61, TE::Shift, 35},
+    {33, 34, TE::Reduce, 56}, {33, 38, TE::Reduce, 56}, {33, 46, TE::Reduce, 56}, {33, 47, TE::Reduce, 56}, {33, 48, TE::Reduce, 56}, {33, 49, TE::Reduce, 56}, {33, 50, TE::Reduce, 56}, {33, 51, TE::Reduce, 56}, {33, 52, TE::Reduce, 56}, {33, 53, TE::Reduce, 56}, {33, 54, TE::Reduce, 56}, {33, 55, TE::Reduce, 56}, {33, 56, TE::Reduce, 56}, {33, 57, TE::Reduce, 56}, {33, 62, TE::Reduce, 56}, {33, 63, TE::Reduce, 56},
+    {34, 34, TE::Reduce, 57}, {34, 38, TE::Reduce, 57}, {34, 46, TE::Reduce, 57}, {34, 47, TE::Reduce, 57}, {34, 48, TE::Reduce, 57}, {34, 49, TE::Reduce, 57}, {34, 50, TE::Reduce, 57}, {34, 51, TE::Reduce, 57}, {34, 52, TE::Reduce, 57}, {34, 53, TE::Reduce, 57}, {34, 54, TE::Reduce, 57}, {34, 55, TE::Reduce, 57}, {34, 56, TE::Reduce, 57}, {34, 57, TE::Reduce, 57}, {34, 62, TE::Reduce, 57}, {34, 63, TE::Reduce, 57},
+    {35, 17, TE::Transit, 117}, {35, 18, TE::Transit, 20}, {35, 19, TE::Transit, 21}, {35, 20, TE::Transit, 24}, {35, 21, TE::Transit, 25}, {35, 22, TE::Transit, 26}, {35, 23, TE::Transit, 27}, {35, 24, TE::Transit, 28}, {35, 25, TE::Transit, 29}, {35, 26, TE::Transit, 31}, {35, 27, TE::Transit, 23}, {35, 31, TE::Transit, 122}, {35, 33, TE::Shift, 32}, {35, 40, TE::Shift, 22}, {35, 58, TE::Shift, 30}, {35, 59, TE::Shift, 33}, {35, 60, TE::Shift, 34}, {35, 61, TE::Shift, 35}, {35, 62, TE::Shift, 123},
+    {36, 1, TE::Transit, 75}, {36, 2, TE::Transit, 3}, {36, 3, TE::Transit, 4}, {36, 4, TE::Transit, 5}, {36, 5, TE::Transit, 7}, {36, 6, TE::Transit, 37}, {36, 7, TE::Transit, 8}, {36, 8, TE::Transit, 9}, {36, 12, TE::Transit, 11}, {36, 13, TE::Transit, 10}, {36, 14, TE::Transit, 18}, {36, 15, TE::Transit, 16}, {36, 16, TE::Transit, 6}, {36, 17, TE::Transit, 17}, {36, 18, TE::Transit, 20}, {36, 19, TE::Transit, 21}, {36, 20, TE::Transit, 24}, {36, 21, TE::Transit, 25}, {36, 22, TE::Transit, 26}, {36, 23, TE::Transit, 27}, {36, 24, TE::Transit, 28}, {36, 25, TE::Transit, 29}, {36, 26, TE::Transit, 31}, {36, 27, TE::Transit, 23}, {36, 32, TE::Shift, 12}, {36, 33, TE::Shift, 32}, {36, 36, TE::Shift, 13}, {36, 37, TE::Shift, 14}, {36, 39, TE::Shift, 15}, {36, 40, TE::Shift, 22}, {36, 41, TE::Shift, 36}, {36, 43, TE::Shift, 19}, {36, 45, TE::Shift, 38}, {36, 58, TE::Shift, 30}, {36, 59, TE::Shift, 33}, {36, 60, TE::Shift, 34}, {36, 61, TE::Shift, 35},
+    {37, 32, TE::Reduce, 12}, {37, 33, TE::Reduce, 12}, {37, 36, TE::Reduce, 12}, {37, 37, TE::Reduce, 12}, {37, 39, TE::Reduce, 12}, {37, 40, TE::Reduce, 12}, {37, 41, TE::Reduce, 12}, {37, 42, TE::Reduce, 12}, {37, 43, TE::Reduce, 12}, {37, 45, TE::Reduce, 12}, {37, 58, TE::Reduce, 12}, {37, 59, TE::Reduce, 12}, {37, 60, TE::Reduce, 12}, {37, 61, TE::Reduce, 12}, {37, 64, TE::Reduce, 12},
+    {38, 17, TE::Transit, 130}, {38, 18, TE::Transit, 20}, {38, 19, TE::Transit, 21}, {38, 20, TE::Transit, 24}, {38, 21, TE::Transit, 25}, {38, 22, TE::Transit, 26}, {38, 23, TE::Transit, 27}, {38, 24, TE::Transit, 28}, {38, 25, TE::Transit, 29}, {38, 26, TE::Transit, 31}, {38, 27, TE::Transit, 23}, {38, 33, TE::Shift, 32}, {38, 40, TE::Shift, 22}, {38, 58, TE::Shift, 30}, {38, 59, TE::Shift, 33}, {38, 60, TE::Shift, 34}, {38, 61, TE::Shift, 35},
+    {39, 32, TE::Reduce, 3}, {39, 33, TE::Reduce, 3}, {39, 36, TE::Reduce, 3}, {39, 37, TE::Reduce, 3}, {39, 39, TE::Reduce, 3}, {39, 40, TE::Reduce, 3}, {39, 41, TE::Reduce, 3}, {39, 42, TE::Reduce, 3}, {39, 43, TE::Reduce, 3}, {39, 45, TE::Reduce, 3}, {39, 58, TE::Reduce, 3}, {39, 59, TE::Reduce, 3}, {39, 60, TE::Reduce, 3}, {39, 61, TE::Reduce, 3}, {39, 64, TE::Reduce, 3},
+    {40, 17, TE::Transit, 41}, {40, 18, TE::Transit, 20}, {40, 19, TE::Transit, 21}, {40, 20, TE::Transit, 24}, {40, 21, TE::Transit, 25}, {40, 22, TE::Transit, 26}, {40, 23, TE::Transit, 27}, {40, 24, TE::Transit, 28}, {40, 25, TE::Transit, 29}, {40, 26, TE::Transit, 31}, {40, 27, TE::Transit, 23}, {40, 33, TE::Shift, 32}, {40, 40, TE::Shift, 22}, {40, 58, TE::Shift, 30}, {40, 59, TE::Shift, 33}, {40, 60, TE::Shift, 34}, {40, 61, TE::Shift, 35},
+    {41, 34, TE::Shift, 42},
+    {42, 2, TE::Transit, 44}, {42, 3, TE::Transit, 43}, {42, 4, TE::Transit, 5}, {42, 5, TE::Transit, 7}, {42, 6, TE::Transit, 37}, {42, 7, TE::Transit, 8}, {42, 8, TE::Transit, 9}, {42, 12, TE::Transit, 11}, {42, 13, TE::Transit, 10}, {42, 14, TE::Transit, 18}, {42, 15, TE::Transit, 16}, {42, 16, TE::Transit, 6}, {42, 17, TE::Transit, 17}, {42, 18, TE::Transit, 20}, {42, 19, TE::Transit, 21}, {42, 20, TE::Transit, 24}, {42, 21, TE::Transit, 25}, {42, 22, TE::Transit, 26}, {42, 23, TE::Transit, 27}, {42, 24, TE::Transit, 28}, {42, 25, TE::Transit, 29}, {42, 26, TE::Transit, 31}, {42, 27, TE::Transit, 23}, {42, 32, TE::Shift, 12}, {42, 33, TE::Shift, 32}, {42, 36, TE::Shift, 13}, {42, 37, TE::Shift, 14}, {42, 39, TE::Shift, 15}, {42, 40, TE::Shift, 22}, {42, 41, TE::Shift, 36}, {42, 43, TE::Shift, 19}, {42, 45, TE::Shift, 38}, {42, 58, TE::Shift, 30}, {42, 59, TE::Shift, 33}, {42, 60, TE::Shift, 34}, {42, 61, TE::Shift, 35},
+    {43, 32, TE::Reduce, 4}, {43, 33, TE::Reduce, 4}, {43, 35, TE::Shift, 45}, {43, 36, TE::Reduce, 4}, {43, 37, TE::Reduce, 4}, {43, 39, TE::Reduce, 4}, {43, 40, TE::Reduce, 4}, {43, 41, TE::Reduce, 4}, {43, 42, TE::Reduce, 4}, {43, 43, TE::Reduce, 4}, {43, 45, TE::Reduce, 4}, {43, 58, TE::Reduce, 4}, {43, 59, TE::Reduce, 4}, {43, 60, TE::Reduce, 4}, {43, 61, TE::Reduce, 4}, {43, 64, TE::Reduce, 4},
+    {44, 32, TE::Reduce, 14}, {44, 33, TE::Reduce, 14}, {44, 36, TE::Reduce, 14}, {44, 37, TE::Reduce, 14}, {44, 39, TE::Reduce, 14}, {44, 40, TE::Reduce, 14}, {44, 41, TE::Reduce, 14}, {44, 42, TE::Reduce, 14}, {44, 43, TE::Reduce, 14}, {44, 45, TE::Reduce, 14}, {44, 58, TE::Reduce, 14}, {44, 59, TE::Reduce, 14}, {44, 60, TE::Reduce, 14}, {44, 61, TE::Reduce, 14}, {44, 64, TE::Reduce, 14},
+    {45, 3, TE::Transit, 46}, {45, 5, TE::Transit, 7}, {45, 7, TE::Transit, 8}, {45, 8, TE::Transit, 9}, {45, 12, TE::Transit, 11}, {45, 13, TE::Transit, 10}, {45, 14, TE::Transit, 18}, {45, 15, TE::Transit, 16}, {45, 17, TE::Transit, 17}, {45, 18, TE::Transit, 20}, {45, 19, TE::Transit, 21}, {45, 20, TE::Transit, 24}, {45, 21, TE::Transit, 25}, {45, 22, TE::Transit, 26}, {45, 23, TE::Transit, 27}, {45, 24, TE::Transit, 28}, {45, 25, TE::Transit, 29}, {45, 26, TE::Transit, 31}, {45, 27, TE::Transit, 23}, {45, 32, TE::Shift, 47}, {45, 33, TE::Shift, 32}, {45, 36, TE::Shift, 13}, {45, 37, TE::Shift, 14}, {45, 39, TE::Shift, 15}, {45, 40, TE::Shift, 22}, {45, 41, TE::Shift, 36}, {45, 43, TE::Shift, 19}, {45, 58, TE::Shift, 30}, {45, 59, TE::Shift, 33}, {45, 60, TE::Shift, 34}, {45, 61, TE::Shift, 35},
+    {46, 32, TE::Reduce, 13}, {46, 33, TE::Reduce, 13}, {46, 35, TE::Reduce, 13}, {46, 36, TE::Reduce, 13}, {46, 37, TE::Reduce, 13}, {46, 39, TE::Reduce, 13}, {46, 40, TE::Reduce, 13}, {46, 41, TE::Reduce, 13}, {46, 42, TE::Reduce, 13}, {46, 43, TE::Reduce, 13}, {46, 45, TE::Reduce, 13}, {46, 58, TE::Reduce, 13}, {46, 59, TE::Reduce, 13}, {46, 60, TE::Reduce, 13}, {46, 61, TE::Reduce, 13}, {46, 64, TE::Reduce, 13},
+    {47, 33, TE::Shift, 48},
+    {48, 17, TE::Transit, 49}, {48, 18, TE::Transit, 20}, {48, 19, TE::Transit, 21}, {48, 20, TE::Transit, 24}, {48, 21, TE::Transit, 25}, {48, 22, TE::Transit, 26}, {48, 23, TE::Transit, 27}, {48, 24, TE::Transit, 28}, {48, 25, TE::Transit, 29}, {48, 26, TE::Transit, 31}, {48, 27, TE::Transit, 23}, {48, 33, TE::Shift, 32}, {48, 40, TE::Shift, 22}, {48, 58, TE::Shift, 30}, {48, 59, TE::Shift, 33}, {48, 60, TE::Shift, 34}, {48, 61, TE::Shift, 35},
+    {49, 34, TE::Shift, 50},
+    {50, 3, TE::Transit, 51}, {50, 5, TE::Transit, 7}, {50, 7, TE::Transit, 8}, {50, 8, TE::Transit, 9}, {50, 12, TE::Transit, 11}, {50, 13, TE::Transit, 10}, {50, 14, TE::Transit, 18}, {50, 15, TE::Transit, 16}, {50, 17, TE::Transit, 17}, {50, 18, TE::Transit, 20}, {50, 19, TE::Transit, 21}, {50, 20, TE::Transit, 24}, {50, 21, TE::Transit, 25}, {50, 22, TE::Transit, 26}, {50, 23, TE::Transit, 27}, {50, 24, TE::Transit, 28}, {50, 25, TE::Transit, 29}, {50, 26, TE::Transit, 31}, {50, 27, TE::Transit, 23}, {50, 32, TE::Shift, 47}, {50, 33, TE::Shift, 32}, {50, 36, TE::Shift, 13}, {50, 37, TE::Shift, 14}, {50, 39, TE::Shift, 15}, {50, 40, TE::Shift, 22}, {50, 41, TE::Shift, 36}, {50, 43, TE::Shift, 19}, {50, 58, TE::Shift, 30}, {50, 59, TE::Shift, 33}, {50, 60, TE::Shift, 34}, {50, 61, TE::Shift, 35},
+    {51, 35, TE::Shift, 45},
+    {52, 17, TE::Transit, 53}, {52, 18, TE::Transit, 20}, {52, 19, TE::Transit, 21}, {52, 20, TE::Transit, 24}, {52, 21, TE::Transit, 25}, {52, 22, TE::Transit, 26}, {52, 23, TE::Transit, 27}, {52, 24, TE::Transit, 28}, {52, 25, TE::Transit, 29}, {52, 26, TE::Transit, 31}, {52, 27, TE::Transit, 23}, {52, 33, TE::Shift, 32}, {52, 40, TE::Shift, 22}, {52, 58, TE::Shift, 30}, {52, 59, TE::Shift, 33}, {52, 60, TE::Shift, 34}, {52, 61, TE::Shift, 35},
+    {53, 34, TE::Shift, 54},
+    {54, 3, TE::Transit, 55}, {54, 5, TE::Transit, 7}, {54, 7, TE::Transit, 8}, {54, 8, TE::Transit, 9}, {54, 12, TE::Transit, 11}, {54, 13, TE::Transit, 10}, {54, 14, TE::Transit, 18}, {54, 15, TE::Transit, 16}, {54, 17, TE::Transit, 17}, {54, 18, TE::Transit, 20}, {54, 19, TE::Transit, 21}, {54, 20, TE::Transit, 24}, {54, 21, TE::Transit, 25}, {54, 22, TE::Transit, 26}, {54, 23, TE::Transit, 27}, {54, 24, TE::Transit, 28}, {54, 25, TE::Transit, 29}, {54, 26, TE::Transit, 31}, {54, 27, TE::Transit, 23}, {54, 32, TE::Shift, 47}, {54, 33, TE::Shift, 32}, {54, 36, TE::Shift, 13}, {54, 37, TE::Shift, 14}, {54, 39, TE::Shift, 15}, {54, 40, TE::Shift, 22}, {54, 41, TE::Shift, 36}, {54, 43, TE::Shift, 19}, {54, 58, TE::Shift, 30}, {54, 59, TE::Shift, 33}, {54, 60, TE::Shift, 34}, {54, 61, TE::Shift, 35},
+    {55, 32, TE::Reduce, 15}, {55, 33, TE::Reduce, 15}, {55, 35, TE::Reduce, 15}, {55, 36, TE::Reduce, 15}, {55, 37, TE::Reduce, 15}, {55, 39, TE::Reduce, 15}, {55, 40, TE::Reduce, 15}, {55, 41, TE::Reduce, 15}, {55, 42, TE::Reduce, 15}, {55, 43, TE::Reduce, 15}, {55, 45, TE::Reduce, 15}, {55, 58, TE::Reduce, 15}, {55, 59, TE::Reduce, 15}, {55, 60, TE::Reduce, 15}, {55, 61, TE::Reduce, 15}, {55, 64, TE::Reduce, 15},
+    {56, 9, TE::Transit, 57}, {56, 15, TE::Transit, 58}, {56, 17, TE::Transit, 59}, {56, 18, TE::Transit, 20}, {56, 19, TE::Transit, 21}, {56, 20, TE::Transit, 24}, {56, 21, TE::Transit, 25}, {56, 22, TE::Transit, 26}, {56, 23, TE::Transit, 27}, {56, 24, TE::Transit, 28}, {56, 25, TE::Transit, 29}, {56, 26, TE::Transit, 31}, {56, 27, TE::Transit, 23}, {56, 33, TE::Shift, 32}, {56, 38, TE::Reduce, 19}, {56, 40, TE::Shift, 22}, {56, 43, TE::Shift, 19}, {56, 58, TE::Shift, 30}, {56, 59, TE::Shift, 33}, {56, 60, TE::Shift, 34}, {56, 61, TE::Shift, 35},
+    {57, 38, TE::Shift, 60},
+    {58, 38, TE::Reduce, 17},
+    {59, 38, TE::Reduce, 18},
+    {60, 10, TE::Transit, 61}, {60, 17, TE::Transit, 62}, {60, 18, TE::Transit, 20}, {60, 19, TE::Transit, 21}, {60, 20, TE::Transit, 24}, {60, 21, TE::Transit, 25}, {60, 22, TE::Transit, 26}, {60, 23, TE::Transit, 27}, {60, 24, TE::Transit, 28}, {60, 25, TE::Transit, 29}, {60, 26, TE::Transit, 31}, {60, 27, TE::Transit, 23}, {60, 33, TE::Shift, 32}, {60, 38, TE::Reduce, 21}, {60, 40, TE::Shift, 22}, {60, 58, TE::Shift, 30}, {60, 59, TE::Shift, 33}, {60, 60, TE::Shift, 34}, {60, 61, TE::Shift, 35},
+    {61, 38, TE::Shift, 63},
+    {62, 38, TE::Reduce, 20},
+    {63, 11, TE::Transit, 64}, {63, 17, TE::Transit, 65}, {63, 18, TE::Transit, 20}, {63, 19, TE::Transit, 21}, {63, 20, TE::Transit, 24}, {63, 21, TE::Transit, 25}, {63, 22, TE::Transit, 26}, {63, 23, TE::Transit, 27}, {63, 24, TE::Transit, 28}, {63, 25, TE::Transit, 29}, {63, 26, TE::Transit, 31}, {63, 27, TE::Transit, 23}, {63, 33, TE::Shift, 32}, {63, 34, TE::Reduce, 23}, {63, 40, TE::Shift, 22}, {63, 58, TE::Shift, 30}, {63, 59, TE::Shift, 33}, {63, 60, TE::Shift, 34}, {63, 61, TE::Shift, 35},
+    {64, 34, TE::Shift, 66},
+    {65, 34, TE::Reduce, 22},
+    {66, 3, TE::Transit, 67}, {66, 5, TE::Transit, 7}, {66, 7, TE::Transit, 8}, {66, 8, TE::Transit, 9}, {66, 12, TE::Transit, 11}, {66, 13, TE::Transit, 10}, {66, 14, TE::Transit, 18}, {66, 15, TE::Transit, 16}, {66, 17, TE::Transit, 17}, {66, 18, TE::Transit, 20}, {66, 19, TE::Transit, 21}, {66, 20, TE::Transit, 24}, {66, 21, TE::Transit, 25}, {66, 22, TE::Transit, 26}, {66, 23, TE::Transit, 27}, {66, 24, TE::Transit, 28}, {66, 25, TE::Transit, 29}, {66, 26, TE::Transit, 31}, {66, 27, TE::Transit, 23}, {66, 32, TE::Shift, 47}, {66, 33, TE::Shift, 32}, {66, 36, TE::Shift, 13}, {66, 37, TE::Shift, 14}, {66, 39, TE::Shift, 15}, {66, 40, TE::Shift, 22}, {66, 41, TE::Shift, 36}, {66, 43, TE::Shift, 19}, {66, 58, TE::Shift, 30}, {66, 59, TE::Shift, 33}, {66, 60, TE::Shift, 34}, {66, 61, TE::Shift, 35},
+    {67, 32, TE::Reduce, 16}, {67, 33, TE::Reduce, 16}, {67, 35, TE::Reduce, 16}, {67, 36, TE::Reduce, 16}, {67, 37, TE::Reduce, 16}, {67, 39, TE::Reduce, 16}, {67, 40, TE::Reduce, 16}, {67, 41, TE::Reduce, 16}, {67, 42, TE::Reduce, 16}, {67, 43, TE::Reduce, 16}, {67, 45, TE::Reduce, 16}, {67, 58, TE::Reduce, 16}, {67, 59, TE::Reduce, 16}, {67, 60, TE::Reduce, 16}, {67, 61, TE::Reduce, 16}, {67, 64, TE::Reduce, 16},
+    {68, 33, TE::Shift, 69},
+    {69, 28, TE::Transit, 70}, {69, 29, TE::Transit, 71}, {69, 34, TE::Reduce, 64}, {69, 40, TE::Shift, 72},
+    {70, 34, TE::Shift, 73},
+    {71, 34, TE::Reduce, 65}, {71, 63, TE::Shift, 132},
+    {72, 34, TE::Reduce, 66}, {72, 63, TE::Reduce, 66},
+    {73, 14, TE::Transit, 74}, {73, 41, TE::Shift, 36},
+    {74, 32, TE::Reduce, 27}, {74, 33, TE::Reduce, 27}, {74, 35, TE::Reduce, 27}, {74, 36, TE::Reduce, 27}, {74, 37, TE::Reduce, 27}, {74, 39, TE::Reduce, 27}, {74, 40, TE::Reduce, 27}, {74, 41, TE::Reduce, 27}, {74, 42, TE::Reduce, 27}, {74, 43, TE::Reduce, 27}, {74, 45, TE::Reduce, 27}, {74, 58, TE::Reduce, 27}, {74, 59, TE::Reduce, 27}, {74, 60, TE::Reduce, 27}, {74, 61, TE::Reduce, 27}, {74, 64, TE::Reduce, 27},
+    {75, 2, TE::Transit, 39}, {75, 3, TE::Transit, 4}, {75, 4, TE::Transit, 5}, {75, 5, TE::Transit, 7}, {75, 6, TE::Transit, 37}, {75, 7, TE::Transit, 8}, {75, 8, TE::Transit, 9}, {75, 12, TE::Transit, 11}, {75, 13, TE::Transit, 10}, {75, 14, TE::Transit, 18}, {75, 15, TE::Transit, 16}, {75, 16, TE::Transit, 6}, {75, 17, TE::Transit, 17}, {75, 18, TE::Transit, 20}, {75, 19, TE::Transit, 21}, {75, 20, TE::Transit, 24}, {75, 21, TE::Transit, 25}, {75, 22, TE::Transit, 26}, {75, 23, TE::Transit, 27}, {75, 24, TE::Transit, 28}, {75, 25, TE::Transit, 29}, {75, 26, TE::Transit, 31}, {75, 27, TE::Transit, 23}, {75, 32, TE::Shift, 12}, {75, 33, TE::Shift, 32}, {75, 36, TE::Shift, 13}, {75, 37, TE::Shift, 14}, {75, 39, TE::Shift, 15}, {75, 40, TE::Shift, 22}, {75, 41, TE::Shift, 36}, {75, 42, TE::Shift, 76}, {75, 43, TE::Shift, 19}, {75, 45, TE::Shift, 38}, {75, 58, TE::Shift, 30}, {75, 59, TE::Shift, 33}, {75, 60, TE::Shift, 34}, {75, 61, TE::Shift, 35},
+    {76, 32, TE::Reduce, 28}, {76, 33, TE::Reduce, 28}, {76, 35, TE::Reduce, 28}, {76, 36, TE::Reduce, 28}, {76, 37, TE::Reduce, 28}, {76, 39, TE::Reduce, 28}, {76, 40, TE::Reduce, 28}, {76, 41, TE::Reduce, 28}, {76, 42, TE::Reduce, 28}, {76, 43, TE::Reduce, 28}, {76, 45, TE::Reduce, 28}, {76, 58, TE::Reduce, 28}, {76, 59, TE::Reduce, 28}, {76, 60, TE::Reduce, 28}, {76, 61, TE::Reduce, 28}, {76, 64, TE::Reduce, 28},
+    {77, 32, TE::Reduce, 24}, {77, 33, TE::Reduce, 24}, {77, 35, TE::Reduce, 24}, {77, 36, TE::Reduce, 24}, {77, 37, TE::Reduce, 24}, {77, 39, TE::Reduce, 24}, {77, 40, TE::Reduce, 24}, {77, 41, TE::Reduce, 24}, {77, 42, TE::Reduce, 24}, {77, 43, TE::Reduce, 24}, {77, 45, TE::Reduce, 24}, {77, 58, TE::Reduce, 24}, {77, 59, TE::Reduce, 24}, {77, 60, TE::Reduce, 24}, {77, 61, TE::Reduce, 24}, {77, 64, TE::Reduce, 24},
+    {78, 32, TE::Reduce, 25}, {78, 33, TE::Reduce, 25}, {78, 35, TE::Reduce, 25}, {78, 36, TE::Reduce, 25}, {78, 37, TE::Reduce, 25}, {78, 39, TE::Reduce, 25}, {78, 40, TE::Reduce, 25}, {78, 41, TE::Reduce, 25}, {78, 42, TE::Reduce, 25}, {78, 43, TE::Reduce, 25}, {78, 45, TE::Reduce, 25}, {78, 58, TE::Reduce, 25}, {78, 59, TE::Reduce, 25}, {78, 60, TE::Reduce, 25}, {78, 61, TE::Reduce, 25}, {78, 64, TE::Reduce, 25},
+    {79, 44, TE::Shift, 80},
+    {80, 17, TE::Transit, 81}, {80, 18, TE::Transit, 20}, {80, 19, TE::Transit, 21}, {80, 20, TE::Transit, 24}, {80, 21, TE::Transit, 25}, {80, 22, TE::Transit, 26}, {80, 23, TE::Transit, 27}, {80, 24, TE::Transit, 28}, {80, 25, TE::Transit, 29}, {80, 26, TE::Transit, 31}, {80, 27, TE::Transit, 23}, {80, 33, TE::Shift, 32}, {80, 40, TE::Shift, 22}, {80, 58, TE::Shift, 30}, {80, 59, TE::Shift, 33}, {80, 60, TE::Shift, 34}, {80, 61, TE::Shift, 35},
+    {81, 38, TE::Reduce, 29},
+    {82, 20, TE::Transit, 83}, {82, 21, TE::Transit, 25}, {82, 22, TE::Transit, 26}, {82, 23, TE::Transit, 27}, {82, 24, TE::Transit, 28}, {82, 25, TE::Transit, 29}, {82, 26, TE::Transit, 31}, {82, 33, TE::Shift, 32}, {82, 40, TE::Shift, 84}, {82, 58, TE::Shift, 30}, {82, 59, TE::Shift, 33}, {82, 60, TE::Shift, 34}, {82, 61, TE::Shift, 35},
+    {83, 34, TE::Reduce, 35}, {83, 38, TE::Reduce, 35}, {83, 46, TE::Reduce, 35}, {83, 47, TE::Shift, 85}, {83, 62, TE::Reduce, 35}, {83, 63, TE::Reduce, 35},
+    {84, 33, TE::Shift, 106}, {84, 34, TE::Reduce, 62}, {84, 38, TE::Reduce, 62}, {84, 46, TE::Reduce, 62}, {84, 47, TE::Reduce, 62}, {84, 48, TE::Reduce, 62}, {84, 49, TE::Reduce, 62}, {84, 50, TE::Reduce, 62}, {84, 51, TE::Reduce, 62}, {84, 52, TE::Reduce, 62}, {84, 53, TE::Reduce, 62}, {84, 54, TE::Reduce, 62}, {84, 55, TE::Reduce, 62}, {84, 56, TE::Reduce, 62}, {84, 57, TE::Reduce, 62}, {84, 61, TE::Shift, 114}, {84, 62, TE::Reduce, 62}, {84, 63, TE::Reduce, 62},
+    {85, 21, TE::Transit, 86}, {85, 22, TE::Transit, 26}, {85, 23, TE::Transit, 27}, {85, 24, TE::Transit, 28}, {85, 25, TE::Transit, 29}, {85, 26, TE::Transit, 31}, {85, 33, TE::Shift, 32}, {85, 40, TE::Shift, 84}, {85, 58, TE::Shift, 30}, {85, 59, TE::Shift, 33}, {85, 60, TE::Shift, 34}, {85, 61, TE::Shift, 35},
+    {86, 34, TE::Reduce, 37}, {86, 38, TE::Reduce, 37}, {86, 46, TE::Reduce, 37}, {86, 47, TE::Reduce, 37}, {86, 48, TE::Shift, 87}, {86, 49, TE::Shift, 88}, {86, 62, TE::Reduce, 37}, {86, 63, TE::Reduce, 37},
+    {87, 22, TE::Transit, 89}, {87, 23, TE::Transit, 27}, {87, 24, TE::Transit, 28}, {87, 25, TE::Transit, 29}, {87, 26, TE::Transit, 31}, {87, 33, TE::Shift, 32}, {87, 40, TE::Shift, 84}, {87, 58, TE::Shift, 30}, {87, 59, TE::Shift, 33}, {87, 60, TE::Shift, 34}, {87, 61, TE::Shift, 35},
+    {88, 22, TE::Transit, 110}, {88, 23, TE::Transit, 27}, {88, 24, TE::Transit, 28}, {88, 25, TE::Transit, 29}, {88, 26, TE::Transit, 31}, {88, 33, TE::Shift, 32}, {88, 40, TE::Shift, 84}, {88, 58, TE::Shift, 30}, {88, 59, TE::Shift, 33}, {88, 60, TE::Shift, 34}, {88, 61, TE::Shift, 35},
+    {89, 34, TE::Reduce, 39}, {89, 38, TE::Reduce, 39}, {89, 46, TE::Reduce, 39}, {89, 47, TE::Reduce, 39}, {89, 48, TE::Reduce, 39}, {89, 49, TE::Reduce, 39}, {89, 50, TE::Shift, 90}, {89, 51, TE::Shift, 91}, {89, 52, TE::Shift, 92}, {89, 53, TE::Shift, 93}, {89, 62, TE::Reduce, 39}, {89, 63, TE::Reduce, 39},
+    {90, 23, TE::Transit, 94}, {90, 24, TE::Transit, 28}, {90, 25, TE::Transit, 29}, {90, 26, TE::Transit, 31}, {90, 33, TE::Shift, 32}, {90, 40, TE::Shift, 84}, {90, 58, TE::Shift, 30}, {90, 59, TE::Shift, 33}, {90, 60, TE::Shift, 34}, {90, 61, TE::Shift, 35},
+    {91, 23, TE::Transit, 111}, {91, 24, TE::Transit, 28}, {91, 25, TE::Transit, 29}, {91, 26, TE::Transit, 31}, {91, 33, TE::Shift, 32}, {91, 40, TE::Shift, 84}, {91, 58, TE::Shift, 30}, {91, 59, TE::Shift, 33}, {91, 60, TE::Shift, 34}, {91, 61, TE::Shift, 35},
+    {92, 23, TE::Transit, 121}, {92, 24, TE::Transit, 28}, {92, 25, TE::Transit, 29}, {92, 26, TE::Transit, 31}, {92, 33, TE::Shift, 32}, {92, 40, TE::Shift, 84}, {92, 58, TE::Shift, 30}, {92, 59, TE::Shift, 33}, {92, 60, TE::Shift, 34}, {92, 61, TE::Shift, 35},
+    {93, 23, TE::Transit, 125}, {93, 24, TE::Transit, 28}, {93, 25, TE::Transit, 29}, {93, 26, TE::Transit, 31}, {93, 33, TE::Shift, 32}, {93, 40, TE::Shift, 84}, {93, 58, TE::Shift, 30}, {93, 59, TE::Shift, 33}, {93, 60, TE::Shift, 34}, {93, 61, TE::Shift, 35},
+    {94, 34, TE::Reduce, 42}, {94, 38, TE::Reduce, 42}, {94, 46, TE::Reduce, 42}, {94, 47, TE::Reduce, 42}, {94, 48, TE::Reduce, 42}, {94, 49, TE::Reduce, 42}, {94, 50, TE::Reduce, 42}, {94, 51, TE::Reduce, 42}, {94, 52, TE::Reduce, 42}, {94, 53, TE::Reduce, 42}, {94, 54, TE::Shift, 95}, {94, 55, TE::Shift, 96}, {94, 62, TE::Reduce, 42}, {94, 63, TE::Reduce, 42},
+    {95, 24, TE::Transit, 97}, {95, 25, TE::Transit, 29}, {95, 26, TE::Transit, 31}, {95, 33, TE::Shift, 32}, {95, 40, TE::Shift, 84}, {95, 58, TE::Shift, 30}, {95, 59, TE::Shift, 33}, {95, 60, TE::Shift, 34}, {95, 61, TE::Shift, 35},
+    {96, 24, TE::Transit, 112}, {96, 25, TE::Transit, 29}, {96, 26, TE::Transit, 31}, {96, 33, TE::Shift, 32}, {96, 40, TE::Shift, 84}, {96, 58, TE::Shift, 30}, {96, 59, TE::Shift, 33}, {96, 60, TE::Shift, 34}, {96, 61, TE::Shift, 35},
+    {97, 34, TE::Reduce, 47}, {97, 38, TE::Reduce, 47}, {97, 46, TE::Reduce, 47}, {97, 47, TE::Reduce, 47}, {97, 48, TE::Reduce, 47}, {97, 49, TE::Reduce, 47}, {97, 50, TE::Reduce, 47}, {97, 51, TE::Reduce, 47}, {97, 52, TE::Reduce, 47}, {97, 53, TE::Reduce, 47}, {97, 54, TE::Reduce, 47}, {97, 55, TE::Reduce, 47}, {97, 56, TE::Shift, 98}, {97, 57, TE::Shift, 99}, {97, 62, TE::Reduce, 47}, {97, 63, TE::Reduce, 47},
+    {98, 25, TE::Transit, 100}, {98, 26, TE::Transit, 31}, {98, 33, TE::Shift, 32}, {98, 40, TE::Shift, 84}, {98, 58, TE::Shift, 30}, {98, 59, TE::Shift, 33}, {98, 60, TE::Shift, 34}, {98, 61, TE::Shift, 35},
+    {99, 25, TE::Transit, 113}, {99, 26, TE::Transit, 31}, {99, 33, TE::Shift, 32}, {99, 40, TE::Shift, 84}, {99, 58, TE::Shift, 30}, {99, 59, TE::Shift, 33}, {99, 60, TE::Shift, 34}, {99, 61, TE::Shift, 35},
+    {100, 34, TE::Reduce, 50}, {100, 38, TE::Reduce, 50}, {100, 46, TE::Reduce, 50}, {100, 47, TE::Reduce, 50}, {100, 48, TE::Reduce, 50}, {100, 49, TE::Reduce, 50}, {100, 50, TE::Reduce, 50}, {100, 51, TE::Reduce, 50}, {100, 52, TE::Reduce, 50}, {100, 53, TE::Reduce, 50}, {100, 54, TE::Reduce, 50}, {100, 55, TE::Reduce, 50}, {100, 56, TE::Reduce, 50}, {100, 57, TE::Reduce, 50}, {100, 62, TE::Reduce, 50}, {100, 63, TE::Reduce, 50},
+    {101, 34, TE::Reduce, 53}, {101, 38, TE::Reduce, 53}, {101, 46, TE::Reduce, 53}, {101, 47, TE::Reduce, 53}, {101, 48, TE::Reduce, 53}, {101, 49, TE::Reduce, 53}, {101, 50, TE::Reduce, 53}, {101, 51, TE::Reduce, 53}, {101, 52, TE::Reduce, 53}, {101, 53, TE::Reduce, 53}, {101, 54, TE::Reduce, 53}, {101, 55, TE::Reduce, 53}, {101, 56, TE::Reduce, 53}, {101, 57, TE::Reduce, 53}, {101, 62, TE::Reduce, 53}, {101, 63, TE::Reduce, 53},
+    {102, 34, TE::Shift, 103},
+    {103, 34, TE::Reduce, 55}, {103, 38, TE::Reduce, 55}, {103, 46, TE::Reduce, 55}, {103, 47, TE::Reduce, 55}, {103, 48, TE::Reduce, 55}, {103, 49, TE::Reduce, 55}, {103, 50, TE::Reduce, 55}, {103, 51, TE::Reduce, 55}, {103, 52, TE::Reduce, 55}, {103, 53, TE::Reduce, 55}, {103, 54, TE::Reduce, 55}, {103, 55, TE::Reduce, 55}, {103, 56, TE::Reduce, 55}, {103, 57, TE::Reduce, 55}, {103, 62, TE::Reduce, 55}, {103, 63, TE::Reduce, 55},
+    {104, 17, TE::Transit, 107}, {104, 18, TE::Transit, 20}, {104, 19, TE::Transit, 21}, {104, 20, TE::Transit, 24}, {104, 21, TE::Transit, 25}, {104, 22, TE::Transit, 26}, {104, 23, TE::Transit, 27}, {104, 24, TE::Transit, 28}, {104, 25, TE::Transit, 29}, {104, 26, TE::Transit, 31}, {104, 27, TE::Transit, 23}, {104, 33, TE::Shift, 32}, {104, 40, TE::Shift, 22}, {104, 58, TE::Shift, 30}, {104, 59, TE::Shift, 33}, {104, 60, TE::Shift, 34}, {104, 61, TE::Shift, 35},
+    {105, 17, TE::Transit, 128}, {105, 18, TE::Transit, 20}, {105, 19, TE::Transit, 21}, {105, 20, TE::Transit, 24}, {105, 21, TE::Transit, 25}, {105, 22, TE::Transit, 26}, {105, 23, TE::Transit, 27}, {105, 24, TE::Transit, 28}, {105, 25, TE::Transit, 29}, {105, 26, TE::Transit, 31}, {105, 27, TE::Transit, 23}, {105, 33, TE::Shift, 32}, {105, 40, TE::Shift, 22}, {105, 58, TE::Shift, 30}, {105, 59, TE::Shift, 33}, {105, 60, TE::Shift, 34}, {105, 61, TE::Shift, 35},
+    {106, 17, TE::Transit, 117}, {106, 18, TE::Transit, 20}, {106, 19, TE::Transit, 21}, {106, 20, TE::Transit, 24}, {106, 21, TE::Transit, 25}, {106, 22, TE::Transit, 26}, {106, 23, TE::Transit, 27}, {106, 24, TE::Transit, 28}, {106, 25, TE::Transit, 29}, {106, 26, TE::Transit, 31}, {106, 27, TE::Transit, 23}, {106, 30, TE::Transit, 115}, {106, 31, TE::Transit, 116}, {106, 33, TE::Shift, 32}, {106, 34, TE::Reduce, 68}, {106, 40, TE::Shift, 22}, {106, 58, TE::Shift, 30}, {106, 59, TE::Shift, 33}, {106, 60, TE::Shift, 34}, {106, 61, TE::Shift, 35},
+    {107, 34, TE::Reduce, 33}, {107, 38, TE::Reduce, 33}, {107, 62, TE::Reduce, 33}, {107, 63, TE::Reduce, 33},
+    {108, 17, TE::Transit, 109}, {108, 18, TE::Transit, 20}, {108, 19, TE::Transit, 21}, {108, 20, TE::Transit, 24}, {108, 21, TE::Transit, 25}, {108, 22, TE::Transit, 26}, {108, 23, TE::Transit, 27}, {108, 24, TE::Transit, 28}, {108, 25, TE::Transit, 29}, {108, 26, TE::Transit, 31}, {108, 27, TE::Transit, 23}, {108, 33, TE::Shift, 32}, {108, 40, TE::Shift, 22}, {108, 58, TE::Shift, 30}, {108, 59, TE::Shift, 33}, {108, 60, TE::Shift, 34}, {108, 61, TE::Shift, 35},
+    {109, 34, TE::Reduce, 34}, {109, 38, TE::Reduce, 34}, {109, 62, TE::Reduce, 34}, {109, 63, TE::Reduce, 34},
+    {110, 34, TE::Reduce, 40}, {110, 38, TE::Reduce, 40}, {110, 46, TE::Reduce, 40}, {110, 47, TE::Reduce, 40}, {110, 48, TE::Reduce, 40}, {110, 49, TE::Reduce, 40}, {110, 50, TE::Shift, 90}, {110, 51, TE::Shift, 91}, {110, 52, TE::Shift, 92}, {110, 53, TE::Shift, 93}, {110, 62, TE::Reduce, 40}, {110, 63, TE::Reduce, 40},
+    {111, 34, TE::Reduce, 43}, {111, 38, TE::Reduce, 43}, {111, 46, TE::Reduce, 43}, {111, 47, TE::Reduce, 43}, {111, 48, TE::Reduce, 43}, {111, 49, TE::Reduce, 43}, {111, 50, TE::Reduce, 43}, {111, 51, TE::Reduce, 43}, {111, 52, TE::Reduce, 43}, {111, 53, TE::Reduce, 43}, {111, 54, TE::Shift, 95}, {111, 55, TE::Shift, 96}, {111, 62, TE::Reduce, 43}, {111, 63, TE::Reduce, 43},
+    {112, 34, TE::Reduce, 48}, {112, 38, TE::Reduce, 48}, {112, 46, TE::Reduce, 48}, {112, 47, TE::Reduce, 48}, {112, 48, TE::Reduce, 48}, {112, 49, TE::Reduce, 48}, {112, 50, TE::Reduce, 48}, {112, 51, TE::Reduce, 48}, {112, 52, TE::Reduce, 48}, {112, 53, TE::Reduce, 48}, {112, 54, TE::Reduce, 48}, {112, 55, TE::Reduce, 48}, {112, 56, TE::Shift, 98}, {112, 57, TE::Shift, 99}, {112, 62, TE::Reduce, 48}, {112, 63, TE::Reduce, 48},
+    {113, 34, TE::Reduce, 51}, {113, 38, TE::Reduce, 51}, {113, 46, TE::Reduce, 51}, {113, 47, TE::Reduce, 51}, {113, 48, TE::Reduce, 51}, {113, 49, TE::Reduce, 51}, {113, 50, TE::Reduce, 51}, {113, 51, TE::Reduce, 51}, {113, 52, TE::Reduce, 51}, {113, 53, TE::Reduce, 51}, {113, 54, TE::Reduce, 51}, {113, 55, TE::Reduce, 51}, {113, 56, TE::Reduce, 51}, {113, 57, TE::Reduce, 51}, {113, 62, TE::Reduce, 51}, {113, 63, TE::Reduce, 51},
+    {114, 17, TE::Transit, 126}, {114, 18, TE::Transit, 20}, {114, 19, TE::Transit, 21}, {114, 20, TE::Transit, 24}, {114, 21, TE::Transit, 25}, {114, 22, TE::Transit, 26}, {114, 23, TE::Transit, 27}, {114, 24, TE::Transit, 28}, {114, 25, TE::Transit, 29}, {114, 26, TE::Transit, 31}, {114, 27, TE::Transit, 23}, {114, 33, TE::Shift, 32}, {114, 40, TE::Shift, 22}, {114, 58, TE::Shift, 30}, {114, 59, TE::Shift, 33}, {114, 60, TE::Shift, 34}, {114, 61, TE::Shift, 35},
+    {115, 34, TE::Shift, 118},
+    {116, 34, TE::Reduce, 69}, {116, 63, TE::Shift, 119},
+    {117, 34, TE::Reduce, 70}, {117, 62, TE::Reduce, 70}, {117, 63, TE::Reduce, 70},
+    {118, 34, TE::Reduce, 58}, {118, 38, TE::Reduce, 58}, {118, 46, TE::Reduce, 58}, {118, 47, TE::Reduce, 58}, {118, 48, TE::Reduce, 58}, {118, 49, TE::Reduce, 58}, {118, 50, TE::Reduce, 58}, {118, 51, TE::Reduce, 58}, {118, 52, TE::Reduce, 58}, {118, 53, TE::Reduce, 58}, {118, 54, TE::Reduce, 58}, {118, 55, TE::Reduce, 58}, {118, 56, TE::Reduce, 58}, {118, 57, TE::Reduce, 58}, {118, 62, TE::Reduce, 58}, {118, 63, TE::Reduce, 58},
+    {119, 17, TE::Transit, 120}, {119, 18, TE::Transit, 20}, {119, 19, TE::Transit, 21}, {119, 20, TE::Transit, 24}, {119, 21, TE::Transit, 25}, {119, 22, TE::Transit, 26}, {119, 23, TE::Transit, 27}, {119, 24, TE::Transit, 28}, {119, 25, TE::Transit, 29}, {119, 26, TE::Transit, 31}, {119, 27, TE::Transit, 23}, {119, 33, TE::Shift, 32}, {119, 40, TE::Shift, 22}, {119, 58, TE::Shift, 30}, {119, 59, TE::Shift, 33}, {119, 60, TE::Shift, 34}, {119, 61, TE::Shift, 35},
+    {120, 34, TE::Reduce, 71}, {120, 62, TE::Reduce, 71}, {120, 63, TE::Reduce, 71},
+    {121, 34, TE::Reduce, 44}, {121, 38, TE::Reduce, 44}, {121, 46, TE::Reduce, 44}, {121, 47, TE::Reduce, 44}, {121, 48, TE::Reduce, 44}, {121, 49, TE::Reduce, 44}, {121, 50, TE::Reduce, 44}, {121, 51, TE::Reduce, 44}, {121, 52, TE::Reduce, 44}, {121, 53, TE::Reduce, 44}, {121, 54, TE::Shift, 95}, {121, 55, TE::Shift, 96}, {121, 62, TE::Reduce, 44}, {121, 63, TE::Reduce, 44},
+    {122, 62, TE::Shift, 124}, {122, 63, TE::Shift, 119},
+    {123, 34, TE::Reduce, 61}, {123, 38, TE::Reduce, 61}, {123, 46, TE::Reduce, 61}, {123, 47, TE::Reduce, 61}, {123, 48, TE::Reduce, 61}, {123, 49, TE::Reduce, 61}, {123, 50, TE::Reduce, 61}, {123, 51, TE::Reduce, 61}, {123, 52, TE::Reduce, 61}, {123, 53, TE::Reduce, 61}, {123, 54, TE::Reduce, 61}, {123, 55, TE::Reduce, 61}, {123, 56, TE::Reduce, 61}, {123, 57, TE::Reduce, 61}, {123, 62, TE::Reduce, 61}, {123, 63, TE::Reduce, 61},
+    {124, 34, TE::Reduce, 60}, {124, 38, TE::Reduce, 60}, {124, 46, TE::Reduce, 60}, {124, 47, TE::Reduce, 60}, {124, 48, TE::Reduce, 60}, {124, 49, TE::Reduce, 60}, {124, 50, TE::Reduce, 60}, {124, 51, TE::Reduce, 60}, {124, 52, TE::Reduce, 60}, {124, 53, TE::Reduce, 60}, {124, 54, TE::Reduce, 60}, {124, 55, TE::Reduce, 60}, {124, 56, TE::Reduce, 60}, {124, 57, TE::Reduce, 60}, {124, 62, TE::Reduce, 60}, {124, 63, TE::Reduce, 60},
+    {125, 34, TE::Reduce, 45}, {125, 38, TE::Reduce, 45}, {125, 46, TE::Reduce, 45}, {125, 47, TE::Reduce, 45}, {125, 48, TE::Reduce, 45}, {125, 49, TE::Reduce, 45}, {125, 50, TE::Reduce, 45}, {125, 51, TE::Reduce, 45}, {125, 52, TE::Reduce, 45}, {125, 53, TE::Reduce, 45}, {125, 54, TE::Shift, 95}, {125, 55, TE::Shift, 96}, {125, 62, TE::Reduce, 45}, {125, 63, TE::Reduce, 45},
+    {126, 62, TE::Shift, 127},
+    {127, 34, TE::Reduce, 59}, {127, 38, TE::Reduce, 59}, {127, 46, TE::Reduce, 59}, {127, 47, TE::Reduce, 59}, {127, 48, TE::Reduce, 59}, {127, 49, TE::Reduce, 59}, {127, 50, TE::Reduce, 59}, {127, 51, TE::Reduce, 59}, {127, 52, TE::Reduce, 59}, {127, 53, TE::Reduce, 59}, {127, 54, TE::Reduce, 59}, {127, 55, TE::Reduce, 59}, {127, 56, TE::Reduce, 59}, {127, 57, TE::Reduce, 59}, {127, 62, TE::Reduce, 59}, {127, 63, TE::Reduce, 59},
+    {128, 62, TE::Shift, 129},
+    {129, 34, TE::Reduce, 59}, {129, 38, TE::Reduce, 59}, {129, 44, TE::Reduce, 63}, {129, 46, TE::Reduce, 59}, {129, 47, TE::Reduce, 59}, {129, 48, TE::Reduce, 59}, {129, 49, TE::Reduce, 59}, {129, 50, TE::Reduce, 59}, {129, 51, TE::Reduce, 59}, {129, 52, TE::Reduce, 59}, {129, 53, TE::Reduce, 59}, {129, 54, TE::Reduce, 59}, {129, 55, TE::Reduce, 59}, {129, 56, TE::Reduce, 59}, {129, 57, TE::Reduce, 59}, {129, 62, TE::Reduce, 59}, {129, 63, TE::Reduce, 59},
+    {130, 38, TE::Shift, 131},
+    {131, 32, TE::Reduce, 30}, {131, 33, TE::Reduce, 30}, {131, 36, TE::Reduce, 30}, {131, 37, TE::Reduce, 30}, {131, 39, TE::Reduce, 30}, {131, 40, TE::Reduce, 30}, {131, 41, TE::Reduce, 30}, {131, 42, TE::Reduce, 30}, {131, 43, TE::Reduce, 30}, {131, 45, TE::Reduce, 30}, {131, 58, TE::Reduce, 30}, {131, 59, TE::Reduce, 30}, {131, 60, TE::Reduce, 30}, {131, 61, TE::Reduce, 30}, {131, 64, TE::Reduce, 30},
+    {132, 40, TE::Shift, 133},
+    {133, 34, TE::Reduce, 67}, {133, 63, TE::Reduce, 67}
+};
+// clang-format on
+
+constexpr ParseTable parseTable_ = buildParseTable(sparseTable_);
+
+
 // clang-format off
 class parser;
 // clang-format on
@@ -762,10 +724,6 @@ struct Production {
   ProductionHandler handler;
 };
 
-// Key: Encoded symbol (terminal or non-terminal) index
-// Value: TableEntry
-using Row = std::map<int, TableEntry>;
-
 /**
  * Parser class.
  */
@@ -779,9 +737,9 @@ class parser {
   std::vector<Value> valuesStack;
 
   /**
-   * Token values stack.
+   * Token values stack: views into the source string being parsed.
    */
-  std::vector<std::string> tokensStack;
+  std::vector<std::string_view> tokensStack;
 
   /**
    * Parsing states stack.
@@ -798,6 +756,12 @@ class parser {
    */
   int previousState;
 
+  /**
+   * Memory of the AST built by the last parse. Nodes stay valid until the next
+   * parse or releaseAst().
+   */
+  AstArena arena;
+
   /**
    * Parses a string.
    */
@@ -809,6 +773,9 @@ class parser {
     // Initialize the tokenizer and the string.
     tokenizer.initString(str);
 
+    // The previous AST is freed in one shot.
+    arena.reset();
+
     // Initialize the stacks.
     valuesStack.clear();
     tokensStack.clear();
@@ -823,18 +790,18 @@ class parser {
     // Main parsing loop.
     for (;;) {
       auto state = statesStack.back();
-      auto column = (int)token->type;
+      auto column = (int)token.type;
 
-      if (table_[state].count(column) == 0) {
+      const auto& entry = table_[state][column];
+
+      if (entry.type == TE::Error) {
         throwUnexpectedToken(token);
       }
 
-      auto entry = table_[state].at(column);
-
       // Shift a token, go to state.
       if (entry.type == TE::Shift) {
         // Push token.
-        tokensStack.push_back(token->value);
+        tokensStack.push_back(token.value);
 
         // Push next state number: "s5" -> 5
         statesStack.push_back(entry.value);
@@ -846,15 +813,11 @@ class parser {
       // Reduce by production.
       else if (entry.type == TE::Reduce) {
         auto productionNumber = entry.value;
-        auto production = productions_[productionNumber];
+        const auto& production = productions_[productionNumber];
 
-        tokenizer.yytext = shiftedToken->value;
+        tokenizer.yytext = shiftedToken.value;
 
-        auto rhsLength = production.rhsLength;
-        while (rhsLength > 0) {
-          statesStack.pop_back();
-          rhsLength--;
-        }
+        statesStack.resize(statesStack.size() - production.rhsLength);
 
         // Call the handler.
         production.handler(*this);
@@ -862,7 +825,7 @@ class parser {
         auto previousState = statesStack.back();
 
         auto symbolToReduceWith = production.opcode;
-        auto nextStateEntry = table_[previousState].at(symbolToReduceWith);
+        const auto& nextStateEntry = table_[previousState][symbolToReduceWith];
         assert(nextStateEntry.type == TE::Transit);
 
         statesStack.push_back(nextStateEntry.value);
@@ -894,26 +857,30 @@ class parser {
     }
   }
 
+  /**
+   * Frees the AST returned by the last parse.
+   */
+  void releaseAst() { arena.reset(); }
+
  private:
   /**
    * Throws parser error on unexpected token.
    */
-  [[noreturn]] void throwUnexpectedToken(SharedToken token) {
-    if (token->type == TokenType::__EOF && !tokenizer.hasMoreTokens()) {
+  [[noreturn]] void throwUnexpectedToken(const Token& token) {
+    if (token.type == TokenType::__EOF && !tokenizer.hasMoreTokens()) {
       std::string errMsg = "Unexpected end of input.\n";
       std::cerr << errMsg;
       throw std::runtime_error(errMsg.c_str());
     }
-    tokenizer.throwUnexpectedToken(token->value, token->startLine,
-                                   token->startColumn);
+    tokenizer.throwUnexpectedToken(std::string(token.value), token.startLine,
+                                   token.startColumn);
   }
 
   // clang-format off
   static constexpr size_t PRODUCTIONS_COUNT = 72;
   static std::array<Production, PRODUCTIONS_COUNT> productions_;
 
-  static constexpr size_t ROWS_COUNT = 134;
-  static std::array<Row, ROWS_COUNT> table_;
+  static constexpr const ParseTable& table_ = parseTable_;
   // clang-format on
 };
 
@@ -947,7 +914,7 @@ void _handler3(yyparse& parser) {
 // Semantic action prologue.
 auto _1 = POP_V();
 
-auto __ = std::make_shared<Exp>(std::vector<std::shared_ptr<Exp>>{ _1 });
+ExpList statements{}; statements.push_back(parser.arena, _1); auto __ = parser.arena.make<Exp>(ExpType::BLOCK, statements);
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -959,7 +926,7 @@ void _handler4(yyparse& parser) {
 auto _2 = POP_V();
 auto _1 = POP_V();
 
-_1->statements.push_back(_2); auto __ = _1;
+_1->list.push_back(parser.arena, _2); auto __ = _1;
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1075,7 +1042,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 parser.tokensStack.pop_back();
 
-auto __ = std::make_shared<Exp>(ExpType::IF_EXP, _3, _5, _7);
+auto __ = parser.arena.make<Exp>(IfNode{_3, _5, _7});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1090,7 +1057,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 parser.tokensStack.pop_back();
 
-auto __ = std::make_shared<Exp>(ExpType::IF_EXP, _3, _5, nullptr);
+auto __ = parser.arena.make<Exp>(IfNode{_3, _5, nullptr});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1105,7 +1072,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 parser.tokensStack.pop_back();
 
-auto __ = std::make_shared<Exp>(ExpType::WHILE_EXP, _3, _5);
+auto __ = parser.arena.make<Exp>(WhileNode{_3, _5});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1124,7 +1091,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 parser.tokensStack.pop_back();
 
-auto __ = std::make_shared<Exp>(ExpType::FOR_EXP, _3, _5, _7, _9);
+auto __ = parser.arena.make<Exp>(ForNode{_3, _5, _7, _9});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1252,12 +1219,11 @@ parser.tokensStack.pop_back();
 auto _2 = POP_T();
 parser.tokensStack.pop_back();
 
-auto __ = std::make_shared<Exp>(
-             ExpType::FUNCTION_DECLARATION,
-             _2,
-             _4->funcParams,
+auto __ = parser.arena.make<Exp>(FunctionNode{
+             parser.arena.copyString(_2),
+             _4->params,
              _6
-          );
+          });
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1270,7 +1236,7 @@ parser.tokensStack.pop_back();
 auto _2 = POP_V();
 parser.tokensStack.pop_back();
 
-auto __ = std::make_shared<Exp>(_2->statements);
+auto __ = _2;
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1284,7 +1250,7 @@ parser.tokensStack.pop_back();
 auto _2 = POP_T();
 parser.tokensStack.pop_back();
 
-auto __ = std::make_shared<Exp>(ExpType::VAR_DECLARATION, _2, _4);
+auto __ = parser.arena.make<Exp>(VariableNode{parser.arena.copyString(_2), _4});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1297,7 +1263,7 @@ parser.tokensStack.pop_back();
 auto _2 = POP_V();
 parser.tokensStack.pop_back();
 
-auto __ = std::make_shared<Exp>(ExpType::RETURN_STATEMENT, _2);
+auto __ = parser.arena.make<Exp>(_2);
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1332,7 +1298,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_T();
 
-auto __ = std::make_shared<Exp>(ExpType::ASSIGNMENT, _1, _3, nullptr);
+auto __ = parser.arena.make<Exp>(AssignmentNode{parser.arena.copyString(_1), nullptr, _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1345,7 +1311,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-auto __ = std::make_shared<Exp>(ExpType::ASSIGNMENT, _1->varName, _1->varValue, _3);
+auto __ = parser.arena.make<Exp>(AssignmentNode{_1->arrayAccess.name, _1->arrayAccess.index, _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1358,7 +1324,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-auto __ = std::make_shared<Exp>("||", _1, _3);
+auto __ = parser.arena.make<Exp>(BinaryNode{"||", _1, _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1382,7 +1348,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-auto __ = std::make_shared<Exp>("&&", _1, _3);
+auto __ = parser.arena.make<Exp>(BinaryNode{"&&", _1, _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1406,7 +1372,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-auto __ = std::make_shared<Exp>("==", _1, _3);
+auto __ = parser.arena.make<Exp>(BinaryNode{"==", _1, _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1419,7 +1385,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-auto __ = std::make_shared<Exp>("!=", _1, _3);
+auto __ = parser.arena.make<Exp>(BinaryNode{"!=", _1, _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1443,7 +1409,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-auto __ = std::make_shared<Exp>("<", _1, _3);
+auto __ = parser.arena.make<Exp>(BinaryNode{"<", _1, _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1456,7 +1422,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-auto __ = std::make_shared<Exp>(">", _1, _3);
+auto __ = parser.arena.make<Exp>(BinaryNode{">", _1, _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1469,7 +1435,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-auto __ = std::make_shared<Exp>("<=", _1, _3);
+auto __ = parser.arena.make<Exp>(BinaryNode{"<=", _1, _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1482,7 +1448,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-auto __ = std::make_shared<Exp>(">=", _1, _3);
+auto __ = parser.arena.make<Exp>(BinaryNode{">=", _1, _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1506,7 +1472,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-auto __ = std::make_shared<Exp>("+", _1, _3);
+auto __ = parser.arena.make<Exp>(BinaryNode{"+", _1, _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1519,7 +1485,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-auto __ = std::make_shared<Exp>("-", _1, _3);
+auto __ = parser.arena.make<Exp>(BinaryNode{"-", _1, _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1543,7 +1509,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-auto __ = std::make_shared<Exp>("*", _1, _3);
+auto __ = parser.arena.make<Exp>(BinaryNode{"*", _1, _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1556,7 +1522,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-auto __ = std::make_shared<Exp>("/", _1, _3);
+auto __ = parser.arena.make<Exp>(BinaryNode{"/", _1, _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1579,7 +1545,7 @@ void _handler54(yyparse& parser) {
 auto _2 = POP_V();
 parser.tokensStack.pop_back();
 
-auto __ = std::make_shared<Exp>("!", _2);
+auto __ = parser.arena.make<Exp>(UnaryNode{"!", _2});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1614,7 +1580,7 @@ void _handler57(yyparse& parser) {
 // Semantic action prologue.
 auto _1 = POP_T();
 
-auto __ = std::make_shared<Exp>(std::stoi(_1));
+auto __ = parser.arena.make<Exp>(int64_t(std::stoi(_1)));
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1625,7 +1591,7 @@ void _handler58(yyparse& parser) {
 // Semantic action prologue.
 auto _1 = POP_T();
 
-auto __ = std::make_shared<Exp>(_1);
+auto __ = makeStringOrSymbol(parser.arena, _1);
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1639,11 +1605,10 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_T();
 
-auto __ = std::make_shared<Exp>(
-                 ExpType::FUNCTION_CALL,
-                 _1,
-                 _3->callArguments
-               );
+auto __ = parser.arena.make<Exp>(CallNode{
+                 parser.arena.copyString(_1),
+                 _3->list
+               });
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1657,7 +1622,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_T();
 
-auto __ = std::make_shared<Exp>(ExpType::ARRAY_ACCESS, _1, _3);
+auto __ = parser.arena.make<Exp>(ArrayAccessNode{parser.arena.copyString(_1), _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1670,9 +1635,7 @@ parser.tokensStack.pop_back();
 auto _2 = POP_V();
 parser.tokensStack.pop_back();
 
-auto exp = std::make_shared<Exp>(ExpType::ARRAY_LITERAL, _2->callArguments);
-                 exp->statements = _2->callArguments;
-                 auto __ = exp;
+auto __ = parser.arena.make<Exp>(ExpType::ARRAY_LITERAL, _2->list);
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1684,8 +1647,7 @@ void _handler62(yyparse& parser) {
 parser.tokensStack.pop_back();
 parser.tokensStack.pop_back();
 
-auto exp = std::make_shared<Exp>(ExpType::ARRAY_LITERAL, std::vector<std::shared_ptr<Exp>>());
-            auto __ = exp;
+auto __ = parser.arena.make<Exp>(ExpType::ARRAY_LITERAL, ExpList{});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1696,7 +1658,7 @@ void _handler63(yyparse& parser) {
 // Semantic action prologue.
 auto _1 = POP_T();
 
-auto __ = std::make_shared<Exp>(_1);
+auto __ = makeStringOrSymbol(parser.arena, _1);
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1710,7 +1672,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_T();
 
-auto __ = std::make_shared<Exp>(ExpType::ARRAY_ACCESS, _1, _3);
+auto __ = parser.arena.make<Exp>(ArrayAccessNode{parser.arena.copyString(_1), _3});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1721,7 +1683,7 @@ void _handler65(yyparse& parser) {
 // Semantic action prologue.
 
 
-auto __ = std::make_shared<Exp>(ExpType::PARAM_LIST, std::vector<std::string>());
+auto __ = parser.arena.make<Exp>(NameList{});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1743,8 +1705,8 @@ void _handler67(yyparse& parser) {
 // Semantic action prologue.
 auto _1 = POP_T();
 
-std::vector<std::string> params = { _1 };
-          auto __ = std::make_shared<Exp>(ExpType::PARAM_LIST, params);
+NameList params{}; params.push_back(parser.arena, parser.arena.copyString(_1));
+          auto __ = parser.arena.make<Exp>(params);
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1757,7 +1719,7 @@ auto _3 = POP_T();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-_1->funcParams.push_back(_3);
+_1->params.push_back(parser.arena, parser.arena.copyString(_3));
           auto __ = _1;
 
  // Semantic action epilogue.
@@ -1769,7 +1731,7 @@ void _handler69(yyparse& parser) {
 // Semantic action prologue.
 
 
-auto __ = std::make_shared<Exp>(ExpType::ARG_LIST, std::vector<std::shared_ptr<Exp>>());
+auto __ = parser.arena.make<Exp>(ExpType::ARG_LIST, ExpList{});
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1791,8 +1753,8 @@ void _handler71(yyparse& parser) {
 // Semantic action prologue.
 auto _1 = POP_V();
 
-std::vector<std::shared_ptr<Exp>> args = { _1 };
-          auto __ = std::make_shared<Exp>(ExpType::ARG_LIST, args);
+ExpList args{}; args.push_back(parser.arena, _1);
+          auto __ = parser.arena.make<Exp>(ExpType::ARG_LIST, args);
 
  // Semantic action epilogue.
 PUSH_VR();
@@ -1805,7 +1767,7 @@ auto _3 = POP_V();
 parser.tokensStack.pop_back();
 auto _1 = POP_V();
 
-_1->callArguments.push_back(_3);
+_1->list.push_back(parser.arena, _3);
           auto __ = _1;
 
  // Semantic action epilogue.
@@ -1889,147 +1851,6 @@ std::array<Production, yyparse::PRODUCTIONS_COUNT> yyparse::productions_ = {{{-1
 {31, 3, &_handler72}}};
 // clang-format on
 
-// ------------------------------------------------------------------
-// Parsing table.
-
-// clang-format off
-std::array<Row, yyparse::ROWS_COUNT> yyparse::table_ = {
-    Row {{0, {TE::Transit, 1}}, {1, {TE::Transit, 2}}, {2, {TE::Transit, 3}}, {3, {TE::Transit, 4}}, {4, {TE::Transit, 5}}, {5, {TE::Transit, 7}}, {6, {TE::Transit, 37}}, {7, {TE::Transit, 8}}, {8, {TE::Transit, 9}}, {12, {TE::Transit, 11}}, {13, {TE::Transit, 10}}, {14, {TE::Transit, 18}}, {15, {TE::Transit, 16}}, {16, {TE::Transit, 6}}, {17, {TE::Transit, 17}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {32, {TE::Shift, 12}}, {33, {TE::Shift, 32}}, {36, {TE::Shift, 13}}, {37, {TE::Shift, 14}}, {39, {TE::Shift, 15}}, {40, {TE::Shift, 22}}, {41, {TE::Shift, 36}}, {43, {TE::Shift, 19}}, {45, {TE::Shift, 38}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{64, {TE::Accept, 0}}},
-    Row {{2, {TE::Transit, 39}}, {3, {TE::Transit, 4}}, {4, {TE::Transit, 5}}, {5, {TE::Transit, 7}}, {6, {TE::Transit, 37}}, {7, {TE::Transit, 8}}, {8, {TE::Transit, 9}}, {12, {TE::Transit, 11}}, {13, {TE::Transit, 10}}, {14, {TE::Transit, 18}}, {15, {TE::Transit, 16}}, {16, {TE::Transit, 6}}, {17, {TE::Transit, 17}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {32, {TE::Shift, 12}}, {33, {TE::Shift, 32}}, {36, {TE::Shift, 13}}, {37, {TE::Shift, 14}}, {39, {TE::Shift, 15}}, {40, {TE::Shift, 22}}, {41, {TE::Shift, 36}}, {43, {TE::Shift, 19}}, {45, {TE::Shift, 38}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}, {64, {TE::Reduce, 1}}},
-    Row {{32, {TE::Reduce, 2}}, {33, {TE::Reduce, 2}}, {36, {TE::Reduce, 2}}, {37, {TE::Reduce, 2}}, {39, {TE::Reduce, 2}}, {40, {TE::Reduce, 2}}, {41, {TE::Reduce, 2}}, {42, {TE::Reduce, 2}}, {43, {TE::Reduce, 2}}, {45, {TE::Reduce, 2}}, {58, {TE::Reduce, 2}}, {59, {TE::Reduce, 2}}, {60, {TE::Reduce, 2}}, {61, {TE::Reduce, 2}}, {64, {TE::Reduce, 2}}},
-    Row {{32, {TE::Reduce, 4}}, {33, {TE::Reduce, 4}}, {36, {TE::Reduce, 4}}, {37, {TE::Reduce, 4}}, {39, {TE::Reduce, 4}}, {40, {TE::Reduce, 4}}, {41, {TE::Reduce, 4}}, {42, {TE::Reduce, 4}}, {43, {TE::Reduce, 4}}, {45, {TE::Reduce, 4}}, {58, {TE::Reduce, 4}}, {59, {TE::Reduce, 4}}, {60, {TE::Reduce, 4}}, {61, {TE::Reduce, 4}}, {64, {TE::Reduce, 4}}},
-    Row {{32, {TE::Reduce, 5}}, {33, {TE::Reduce, 5}}, {36, {TE::Reduce, 5}}, {37, {TE::Reduce, 5}}, {39, {TE::Reduce, 5}}, {40, {TE::Reduce, 5}}, {41, {TE::Reduce, 5}}, {42, {TE::Reduce, 5}}, {43, {TE::Reduce, 5}}, {45, {TE::Reduce, 5}}, {58, {TE::Reduce, 5}}, {59, {TE::Reduce, 5}}, {60, {TE::Reduce, 5}}, {61, {TE::Reduce, 5}}, {64, {TE::Reduce, 5}}},
-    Row {{32, {TE::Reduce, 6}}, {33, {TE::Reduce, 6}}, {36, {TE::Reduce, 6}}, {37, {TE::Reduce, 6}}, {39, {TE::Reduce, 6}}, {40, {TE::Reduce, 6}}, {41, {TE::Reduce, 6}}, {42, {TE::Reduce, 6}}, {43, {TE::Reduce, 6}}, {45, {TE::Reduce, 6}}, {58, {TE::Reduce, 6}}, {59, {TE::Reduce, 6}}, {60, {TE::Reduce, 6}}, {61, {TE::Reduce, 6}}, {64, {TE::Reduce, 6}}},
-    Row {{32, {TE::Reduce, 7}}, {33, {TE::Reduce, 7}}, {35, {TE::Reduce, 7}}, {36, {TE::Reduce, 7}}, {37, {TE::Reduce, 7}}, {39, {TE::Reduce, 7}}, {40, {TE::Reduce, 7}}, {41, {TE::Reduce, 7}}, {42, {TE::Reduce, 7}}, {43, {TE::Reduce, 7}}, {45, {TE::Reduce, 7}}, {58, {TE::Reduce, 7}}, {59, {TE::Reduce, 7}}, {60, {TE::Reduce, 7}}, {61, {TE::Reduce, 7}}, {64, {TE::Reduce, 7}}},
-    Row {{32, {TE::Reduce, 8}}, {33, {TE::Reduce, 8}}, {35, {TE::Reduce, 8}}, {36, {TE::Reduce, 8}}, {37, {TE::Reduce, 8}}, {39, {TE::Reduce, 8}}, {40, {TE::Reduce, 8}}, {41, {TE::Reduce, 8}}, {42, {TE::Reduce, 8}}, {43, {TE::Reduce, 8}}, {45, {TE::Reduce, 8}}, {58, {TE::Reduce, 8}}, {59, {TE::Reduce, 8}}, {60, {TE::Reduce, 8}}, {61, {TE::Reduce, 8}}, {64, {TE::Reduce, 8}}},
-    Row {{32, {TE::Reduce, 9}}, {33, {TE::Reduce, 9}}, {35, {TE::Reduce, 9}}, {36, {TE::Reduce, 9}}, {37, {TE::Reduce, 9}}, {39, {TE::Reduce, 9}}, {40, {TE::Reduce, 9}}, {41, {TE::Reduce, 9}}, {42, {TE::Reduce, 9}}, {43, {TE::Reduce, 9}}, {45, {TE::Reduce, 9}}, {58, {TE::Reduce, 9}}, {59, {TE::Reduce, 9}}, {60, {TE::Reduce, 9}}, {61, {TE::Reduce, 9}}, {64, {TE::Reduce, 9}}},
-    Row {{32, {TE::Reduce, 10}}, {33, {TE::Reduce, 10}}, {35, {TE::Reduce, 10}}, {36, {TE::Reduce, 10}}, {37, {TE::Reduce, 10}}, {39, {TE::Reduce, 10}}, {40, {TE::Reduce, 10}}, {41, {TE::Reduce, 10}}, {42, {TE::Reduce, 10}}, {43, {TE::Reduce, 10}}, {45, {TE::Reduce, 10}}, {58, {TE::Reduce, 10}}, {59, {TE::Reduce, 10}}, {60, {TE::Reduce, 10}}, {61, {TE::Reduce, 10}}, {64, {TE::Reduce, 10}}},
-    Row {{32, {TE::Reduce, 11}}, {33, {TE::Reduce, 11}}, {35, {TE::Reduce, 11}}, {36, {TE::Reduce, 11}}, {37, {TE::Reduce, 11}}, {39, {TE::Reduce, 11}}, {40, {TE::Reduce, 11}}, {41, {TE::Reduce, 11}}, {42, {TE::Reduce, 11}}, {43, {TE::Reduce, 11}}, {45, {TE::Reduce, 11}}, {58, {TE::Reduce, 11}}, {59, {TE::Reduce, 11}}, {60, {TE::Reduce, 11}}, {61, {TE::Reduce, 11}}, {64, {TE::Reduce, 11}}},
-    Row {{33, {TE::Shift, 40}}},
-    Row {{33, {TE::Shift, 52}}},
-    Row {{33, {TE::Shift, 56}}},
-    Row {{40, {TE::Shift, 68}}},
-    Row {{38, {TE::Shift, 77}}},
-    Row {{38, {TE::Shift, 78}}},
-    Row {{32, {TE::Reduce, 26}}, {33, {TE::Reduce, 26}}, {35, {TE::Reduce, 26}}, {36, {TE::Reduce, 26}}, {37, {TE::Reduce, 26}}, {39, {TE::Reduce, 26}}, {40, {TE::Reduce, 26}}, {41, {TE::Reduce, 26}}, {42, {TE::Reduce, 26}}, {43, {TE::Reduce, 26}}, {45, {TE::Reduce, 26}}, {58, {TE::Reduce, 26}}, {59, {TE::Reduce, 26}}, {60, {TE::Reduce, 26}}, {61, {TE::Reduce, 26}}, {64, {TE::Reduce, 26}}},
-    Row {{40, {TE::Shift, 79}}},
-    Row {{34, {TE::Reduce, 31}}, {38, {TE::Reduce, 31}}, {62, {TE::Reduce, 31}}, {63, {TE::Reduce, 31}}},
-    Row {{34, {TE::Reduce, 32}}, {38, {TE::Reduce, 32}}, {46, {TE::Shift, 82}}, {62, {TE::Reduce, 32}}, {63, {TE::Reduce, 32}}},
-    Row {{33, {TE::Shift, 106}}, {34, {TE::Reduce, 62}}, {38, {TE::Reduce, 62}}, {44, {TE::Shift, 104}}, {46, {TE::Reduce, 62}}, {47, {TE::Reduce, 62}}, {48, {TE::Reduce, 62}}, {49, {TE::Reduce, 62}}, {50, {TE::Reduce, 62}}, {51, {TE::Reduce, 62}}, {52, {TE::Reduce, 62}}, {53, {TE::Reduce, 62}}, {54, {TE::Reduce, 62}}, {55, {TE::Reduce, 62}}, {56, {TE::Reduce, 62}}, {57, {TE::Reduce, 62}}, {61, {TE::Shift, 105}}, {62, {TE::Reduce, 62}}, {63, {TE::Reduce, 62}}},
-    Row {{44, {TE::Shift, 108}}},
-    Row {{34, {TE::Reduce, 36}}, {38, {TE::Reduce, 36}}, {46, {TE::Reduce, 36}}, {47, {TE::Shift, 85}}, {62, {TE::Reduce, 36}}, {63, {TE::Reduce, 36}}},
-    Row {{34, {TE::Reduce, 38}}, {38, {TE::Reduce, 38}}, {46, {TE::Reduce, 38}}, {47, {TE::Reduce, 38}}, {48, {TE::Shift, 87}}, {49, {TE::Shift, 88}}, {62, {TE::Reduce, 38}}, {63, {TE::Reduce, 38}}},
-    Row {{34, {TE::Reduce, 41}}, {38, {TE::Reduce, 41}}, {46, {TE::Reduce, 41}}, {47, {TE::Reduce, 41}}, {48, {TE::Reduce, 41}}, {49, {TE::Reduce, 41}}, {50, {TE::Shift, 90}}, {51, {TE::Shift, 91}}, {52, {TE::Shift, 92}}, {53, {TE::Shift, 93}}, {62, {TE::Reduce, 41}}, {63, {TE::Reduce, 41}}},
-    Row {{34, {TE::Reduce, 46}}, {38, {TE::Reduce, 46}}, {46, {TE::Reduce, 46}}, {47, {TE::Reduce, 46}}, {48, {TE::Reduce, 46}}, {49, {TE::Reduce, 46}}, {50, {TE::Reduce, 46}}, {51, {TE::Reduce, 46}}, {52, {TE::Reduce, 46}}, {53, {TE::Reduce, 46}}, {54, {TE::Shift, 95}}, {55, {TE::Shift, 96}}, {62, {TE::Reduce, 46}}, {63, {TE::Reduce, 46}}},
-    Row {{34, {TE::Reduce, 49}}, {38, {TE::Reduce, 49}}, {46, {TE::Reduce, 49}}, {47, {TE::Reduce, 49}}, {48, {TE::Reduce, 49}}, {49, {TE::Reduce, 49}}, {50, {TE::Reduce, 49}}, {51, {TE::Reduce, 49}}, {52, {TE::Reduce, 49}}, {53, {TE::Reduce, 49}}, {54, {TE::Reduce, 49}}, {55, {TE::Reduce, 49}}, {56, {TE::Shift, 98}}, {57, {TE::Shift, 99}}, {62, {TE::Reduce, 49}}, {63, {TE::Reduce, 49}}},
-    Row {{34, {TE::Reduce, 52}}, {38, {TE::Reduce, 52}}, {46, {TE::Reduce, 52}}, {47, {TE::Reduce, 52}}, {48, {TE::Reduce, 52}}, {49, {TE::Reduce, 52}}, {50, {TE::Reduce, 52}}, {51, {TE::Reduce, 52}}, {52, {TE::Reduce, 52}}, {53, {TE::Reduce, 52}}, {54, {TE::Reduce, 52}}, {55, {TE::Reduce, 52}}, {56, {TE::Reduce, 52}}, {57, {TE::Reduce, 52}}, {62, {TE::Reduce, 52}}, {63, {TE::Reduce, 52}}},
-    Row {{25, {TE::Transit, 101}}, {26, {TE::Transit, 31}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 84}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Reduce, 54}}, {38, {TE::Reduce, 54}}, {46, {TE::Reduce, 54}}, {47, {TE::Reduce, 54}}, {48, {TE::Reduce, 54}}, {49, {TE::Reduce, 54}}, {50, {TE::Reduce, 54}}, {51, {TE::Reduce, 54}}, {52, {TE::Reduce, 54}}, {53, {TE::Reduce, 54}}, {54, {TE::Reduce, 54}}, {55, {TE::Reduce, 54}}, {56, {TE::Reduce, 54}}, {57, {TE::Reduce, 54}}, {62, {TE::Reduce, 54}}, {63, {TE::Reduce, 54}}},
-    Row {{17, {TE::Transit, 102}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Reduce, 56}}, {38, {TE::Reduce, 56}}, {46, {TE::Reduce, 56}}, {47, {TE::Reduce, 56}}, {48, {TE::Reduce, 56}}, {49, {TE::Reduce, 56}}, {50, {TE::Reduce, 56}}, {51, {TE::Reduce, 56}}, {52, {TE::Reduce, 56}}, {53, {TE::Reduce, 56}}, {54, {TE::Reduce, 56}}, {55, {TE::Reduce, 56}}, {56, {TE::Reduce, 56}}, {57, {TE::Reduce, 56}}, {62, {TE::Reduce, 56}}, {63, {TE::Reduce, 56}}},
-    Row {{34, {TE::Reduce, 57}}, {38, {TE::Reduce, 57}}, {46, {TE::Reduce, 57}}, {47, {TE::Reduce, 57}}, {48, {TE::Reduce, 57}}, {49, {TE::Reduce, 57}}, {50, {TE::Reduce, 57}}, {51, {TE::Reduce, 57}}, {52, {TE::Reduce, 57}}, {53, {TE::Reduce, 57}}, {54, {TE::Reduce, 57}}, {55, {TE::Reduce, 57}}, {56, {TE::Reduce, 57}}, {57, {TE::Reduce, 57}}, {62, {TE::Reduce, 57}}, {63, {TE::Reduce, 57}}},
-    Row {{17, {TE::Transit, 117}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {31, {TE::Transit, 122}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}, {62, {TE::Shift, 123}}},
-    Row {{1, {TE::Transit, 75}}, {2, {TE::Transit, 3}}, {3, {TE::Transit, 4}}, {4, {TE::Transit, 5}}, {5, {TE::Transit, 7}}, {6, {TE::Transit, 37}}, {7, {TE::Transit, 8}}, {8, {TE::Transit, 9}}, {12, {TE::Transit, 11}}, {13, {TE::Transit, 10}}, {14, {TE::Transit, 18}}, {15, {TE::Transit, 16}}, {16, {TE::Transit, 6}}, {17, {TE::Transit, 17}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {32, {TE::Shift, 12}}, {33, {TE::Shift, 32}}, {36, {TE::Shift, 13}}, {37, {TE::Shift, 14}}, {39, {TE::Shift, 15}}, {40, {TE::Shift, 22}}, {41, {TE::Shift, 36}}, {43, {TE::Shift, 19}}, {45, {TE::Shift, 38}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{32, {TE::Reduce, 12}}, {33, {TE::Reduce, 12}}, {36, {TE::Reduce, 12}}, {37, {TE::Reduce, 12}}, {39, {TE::Reduce, 12}}, {40, {TE::Reduce, 12}}, {41, {TE::Reduce, 12}}, {42, {TE::Reduce, 12}}, {43, {TE::Reduce, 12}}, {45, {TE::Reduce, 12}}, {58, {TE::Reduce, 12}}, {59, {TE::Reduce, 12}}, {60, {TE::Reduce, 12}}, {61, {TE::Reduce, 12}}, {64, {TE::Reduce, 12}}},
-    Row {{17, {TE::Transit, 130}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{32, {TE::Reduce, 3}}, {33, {TE::Reduce, 3}}, {36, {TE::Reduce, 3}}, {37, {TE::Reduce, 3}}, {39, {TE::Reduce, 3}}, {40, {TE::Reduce, 3}}, {41, {TE::Reduce, 3}}, {42, {TE::Reduce, 3}}, {43, {TE::Reduce, 3}}, {45, {TE::Reduce, 3}}, {58, {TE::Reduce, 3}}, {59, {TE::Reduce, 3}}, {60, {TE::Reduce, 3}}, {61, {TE::Reduce, 3}}, {64, {TE::Reduce, 3}}},
-    Row {{17, {TE::Transit, 41}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Shift, 42}}},
-    Row {{2, {TE::Transit, 44}}, {3, {TE::Transit, 43}}, {4, {TE::Transit, 5}}, {5, {TE::Transit, 7}}, {6, {TE::Transit, 37}}, {7, {TE::Transit, 8}}, {8, {TE::Transit, 9}}, {12, {TE::Transit, 11}}, {13, {TE::Transit, 10}}, {14, {TE::Transit, 18}}, {15, {TE::Transit, 16}}, {16, {TE::Transit, 6}}, {17, {TE::Transit, 17}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {32, {TE::Shift, 12}}, {33, {TE::Shift, 32}}, {36, {TE::Shift, 13}}, {37, {TE::Shift, 14}}, {39, {TE::Shift, 15}}, {40, {TE::Shift, 22}}, {41, {TE::Shift, 36}}, {43, {TE::Shift, 19}}, {45, {TE::Shift, 38}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{32, {TE::Reduce, 4}}, {33, {TE::Reduce, 4}}, {35, {TE::Shift, 45}}, {36, {TE::Reduce, 4}}, {37, {TE::Reduce, 4}}, {39, {TE::Reduce, 4}}, {40, {TE::Reduce, 4}}, {41, {TE::Reduce, 4}}, {42, {TE::Reduce, 4}}, {43, {TE::Reduce, 4}}, {45, {TE::Reduce, 4}}, {58, {TE::Reduce, 4}}, {59, {TE::Reduce, 4}}, {60, {TE::Reduce, 4}}, {61, {TE::Reduce, 4}}, {64, {TE::Reduce, 4}}},
-    Row {{32, {TE::Reduce, 14}}, {33, {TE::Reduce, 14}}, {36, {TE::Reduce, 14}}, {37, {TE::Reduce, 14}}, {39, {TE::Reduce, 14}}, {40, {TE::Reduce, 14}}, {41, {TE::Reduce, 14}}, {42, {TE::Reduce, 14}}, {43, {TE::Reduce, 14}}, {45, {TE::Reduce, 14}}, {58, {TE::Reduce, 14}}, {59, {TE::Reduce, 14}}, {60, {TE::Reduce, 14}}, {61, {TE::Reduce, 14}}, {64, {TE::Reduce, 14}}},
-    Row {{3, {TE::Transit, 46}}, {5, {TE::Transit, 7}}, {7, {TE::Transit, 8}}, {8, {TE::Transit, 9}}, {12, {TE::Transit, 11}}, {13, {TE::Transit, 10}}, {14, {TE::Transit, 18}}, {15, {TE::Transit, 16}}, {17, {TE::Transit, 17}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {32, {TE::Shift, 47}}, {33, {TE::Shift, 32}}, {36, {TE::Shift, 13}}, {37, {TE::Shift, 14}}, {39, {TE::Shift, 15}}, {40, {TE::Shift, 22}}, {41, {TE::Shift, 36}}, {43, {TE::Shift, 19}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{32, {TE::Reduce, 13}}, {33, {TE::Reduce, 13}}, {35, {TE::Reduce, 13}}, {36, {TE::Reduce, 13}}, {37, {TE::Reduce, 13}}, {39, {TE::Reduce, 13}}, {40, {TE::Reduce, 13}}, {41, {TE::Reduce, 13}}, {42, {TE::Reduce, 13}}, {43, {TE::Reduce, 13}}, {45, {TE::Reduce, 13}}, {58, {TE::Reduce, 13}}, {59, {TE::Reduce, 13}}, {60, {TE::Reduce, 13}}, {61, {TE::Reduce, 13}}, {64, {TE::Reduce, 13}}},
-    Row {{33, {TE::Shift, 48}}},
-    Row {{17, {TE::Transit, 49}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Shift, 50}}},
-    Row {{3, {TE::Transit, 51}}, {5, {TE::Transit, 7}}, {7, {TE::Transit, 8}}, {8, {TE::Transit, 9}}, {12, {TE::Transit, 11}}, {13, {TE::Transit, 10}}, {14, {TE::Transit, 18}}, {15, {TE::Transit, 16}}, {17, {TE::Transit, 17}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {32, {TE::Shift, 47}}, {33, {TE::Shift, 32}}, {36, {TE::Shift, 13}}, {37, {TE::Shift, 14}}, {39, {TE::Shift, 15}}, {40, {TE::Shift, 22}}, {41, {TE::Shift, 36}}, {43, {TE::Shift, 19}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{35, {TE::Shift, 45}}},
-    Row {{17, {TE::Transit, 53}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Shift, 54}}},
-    Row {{3, {TE::Transit, 55}}, {5, {TE::Transit, 7}}, {7, {TE::Transit, 8}}, {8, {TE::Transit, 9}}, {12, {TE::Transit, 11}}, {13, {TE::Transit, 10}}, {14, {TE::Transit, 18}}, {15, {TE::Transit, 16}}, {17, {TE::Transit, 17}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {32, {TE::Shift, 47}}, {33, {TE::Shift, 32}}, {36, {TE::Shift, 13}}, {37, {TE::Shift, 14}}, {39, {TE::Shift, 15}}, {40, {TE::Shift, 22}}, {41, {TE::Shift, 36}}, {43, {TE::Shift, 19}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{32, {TE::Reduce, 15}}, {33, {TE::Reduce, 15}}, {35, {TE::Reduce, 15}}, {36, {TE::Reduce, 15}}, {37, {TE::Reduce, 15}}, {39, {TE::Reduce, 15}}, {40, {TE::Reduce, 15}}, {41, {TE::Reduce, 15}}, {42, {TE::Reduce, 15}}, {43, {TE::Reduce, 15}}, {45, {TE::Reduce, 15}}, {58, {TE::Reduce, 15}}, {59, {TE::Reduce, 15}}, {60, {TE::Reduce, 15}}, {61, {TE::Reduce, 15}}, {64, {TE::Reduce, 15}}},
-    Row {{9, {TE::Transit, 57}}, {15, {TE::Transit, 58}}, {17, {TE::Transit, 59}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {33, {TE::Shift, 32}}, {38, {TE::Reduce, 19}}, {40, {TE::Shift, 22}}, {43, {TE::Shift, 19}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{38, {TE::Shift, 60}}},
-    Row {{38, {TE::Reduce, 17}}},
-    Row {{38, {TE::Reduce, 18}}},
-    Row {{10, {TE::Transit, 61}}, {17, {TE::Transit, 62}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {33, {TE::Shift, 32}}, {38, {TE::Reduce, 21}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{38, {TE::Shift, 63}}},
-    Row {{38, {TE::Reduce, 20}}},
-    Row {{11, {TE::Transit, 64}}, {17, {TE::Transit, 65}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {33, {TE::Shift, 32}}, {34, {TE::Reduce, 23}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Shift, 66}}},
-    Row {{34, {TE::Reduce, 22}}},
-    Row {{3, {TE::Transit, 67}}, {5, {TE::Transit, 7}}, {7, {TE::Transit, 8}}, {8, {TE::Transit, 9}}, {12, {TE::Transit, 11}}, {13, {TE::Transit, 10}}, {14, {TE::Transit, 18}}, {15, {TE::Transit, 16}}, {17, {TE::Transit, 17}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {32, {TE::Shift, 47}}, {33, {TE::Shift, 32}}, {36, {TE::Shift, 13}}, {37, {TE::Shift, 14}}, {39, {TE::Shift, 15}}, {40, {TE::Shift, 22}}, {41, {TE::Shift, 36}}, {43, {TE::Shift, 19}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{32, {TE::Reduce, 16}}, {33, {TE::Reduce, 16}}, {35, {TE::Reduce, 16}}, {36, {TE::Reduce, 16}}, {37, {TE::Reduce, 16}}, {39, {TE::Reduce, 16}}, {40, {TE::Reduce, 16}}, {41, {TE::Reduce, 16}}, {42, {TE::Reduce, 16}}, {43, {TE::Reduce, 16}}, {45, {TE::Reduce, 16}}, {58, {TE::Reduce, 16}}, {59, {TE::Reduce, 16}}, {60, {TE::Reduce, 16}}, {61, {TE::Reduce, 16}}, {64, {TE::Reduce, 16}}},
-    Row {{33, {TE::Shift, 69}}},
-    Row {{28, {TE::Transit, 70}}, {29, {TE::Transit, 71}}, {34, {TE::Reduce, 64}}, {40, {TE::Shift, 72}}},
-    Row {{34, {TE::Shift, 73}}},
-    Row {{34, {TE::Reduce, 65}}, {63, {TE::Shift, 132}}},
-    Row {{34, {TE::Reduce, 66}}, {63, {TE::Reduce, 66}}},
-    Row {{14, {TE::Transit, 74}}, {41, {TE::Shift, 36}}},
-    Row {{32, {TE::Reduce, 27}}, {33, {TE::Reduce, 27}}, {35, {TE::Reduce, 27}}, {36, {TE::Reduce, 27}}, {37, {TE::Reduce, 27}}, {39, {TE::Reduce, 27}}, {40, {TE::Reduce, 27}}, {41, {TE::Reduce, 27}}, {42, {TE::Reduce, 27}}, {43, {TE::Reduce, 27}}, {45, {TE::Reduce, 27}}, {58, {TE::Reduce, 27}}, {59, {TE::Reduce, 27}}, {60, {TE::Reduce, 27}}, {61, {TE::Reduce, 27}}, {64, {TE::Reduce, 27}}},
-    Row {{2, {TE::Transit, 39}}, {3, {TE::Transit, 4}}, {4, {TE::Transit, 5}}, {5, {TE::Transit, 7}}, {6, {TE::Transit, 37}}, {7, {TE::Transit, 8}}, {8, {TE::Transit, 9}}, {12, {TE::Transit, 11}}, {13, {TE::Transit, 10}}, {14, {TE::Transit, 18}}, {15, {TE::Transit, 16}}, {16, {TE::Transit, 6}}, {17, {TE::Transit, 17}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {32, {TE::Shift, 12}}, {33, {TE::Shift, 32}}, {36, {TE::Shift, 13}}, {37, {TE::Shift, 14}}, {39, {TE::Shift, 15}}, {40, {TE::Shift, 22}}, {41, {TE::Shift, 36}}, {42, {TE::Shift, 76}}, {43, {TE::Shift, 19}}, {45, {TE::Shift, 38}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{32, {TE::Reduce, 28}}, {33, {TE::Reduce, 28}}, {35, {TE::Reduce, 28}}, {36, {TE::Reduce, 28}}, {37, {TE::Reduce, 28}}, {39, {TE::Reduce, 28}}, {40, {TE::Reduce, 28}}, {41, {TE::Reduce, 28}}, {42, {TE::Reduce, 28}}, {43, {TE::Reduce, 28}}, {45, {TE::Reduce, 28}}, {58, {TE::Reduce, 28}}, {59, {TE::Reduce, 28}}, {60, {TE::Reduce, 28}}, {61, {TE::Reduce, 28}}, {64, {TE::Reduce, 28}}},
-    Row {{32, {TE::Reduce, 24}}, {33, {TE::Reduce, 24}}, {35, {TE::Reduce, 24}}, {36, {TE::Reduce, 24}}, {37, {TE::Reduce, 24}}, {39, {TE::Reduce, 24}}, {40, {TE::Reduce, 24}}, {41, {TE::Reduce, 24}}, {42, {TE::Reduce, 24}}, {43, {TE::Reduce, 24}}, {45, {TE::Reduce, 24}}, {58, {TE::Reduce, 24}}, {59, {TE::Reduce, 24}}, {60, {TE::Reduce, 24}}, {61, {TE::Reduce, 24}}, {64, {TE::Reduce, 24}}},
-    Row {{32, {TE::Reduce, 25}}, {33, {TE::Reduce, 25}}, {35, {TE::Reduce, 25}}, {36, {TE::Reduce, 25}}, {37, {TE::Reduce, 25}}, {39, {TE::Reduce, 25}}, {40, {TE::Reduce, 25}}, {41, {TE::Reduce, 25}}, {42, {TE::Reduce, 25}}, {43, {TE::Reduce, 25}}, {45, {TE::Reduce, 25}}, {58, {TE::Reduce, 25}}, {59, {TE::Reduce, 25}}, {60, {TE::Reduce, 25}}, {61, {TE::Reduce, 25}}, {64, {TE::Reduce, 25}}},
-    Row {{44, {TE::Shift, 80}}},
-    Row {{17, {TE::Transit, 81}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{38, {TE::Reduce, 29}}},
-    Row {{20, {TE::Transit, 83}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 84}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Reduce, 35}}, {38, {TE::Reduce, 35}}, {46, {TE::Reduce, 35}}, {47, {TE::Shift, 85}}, {62, {TE::Reduce, 35}}, {63, {TE::Reduce, 35}}},
-    Row {{33, {TE::Shift, 106}}, {34, {TE::Reduce, 62}}, {38, {TE::Reduce, 62}}, {46, {TE::Reduce, 62}}, {47, {TE::Reduce, 62}}, {48, {TE::Reduce, 62}}, {49, {TE::Reduce, 62}}, {50, {TE::Reduce, 62}}, {51, {TE::Reduce, 62}}, {52, {TE::Reduce, 62}}, {53, {TE::Reduce, 62}}, {54, {TE::Reduce, 62}}, {55, {TE::Reduce, 62}}, {56, {TE::Reduce, 62}}, {57, {TE::Reduce, 62}}, {61, {TE::Shift, 114}}, {62, {TE::Reduce, 62}}, {63, {TE::Reduce, 62}}},
-    Row {{21, {TE::Transit, 86}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 84}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Reduce, 37}}, {38, {TE::Reduce, 37}}, {46, {TE::Reduce, 37}}, {47, {TE::Reduce, 37}}, {48, {TE::Shift, 87}}, {49, {TE::Shift, 88}}, {62, {TE::Reduce, 37}}, {63, {TE::Reduce, 37}}},
-    Row {{22, {TE::Transit, 89}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 84}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{22, {TE::Transit, 110}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 84}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Reduce, 39}}, {38, {TE::Reduce, 39}}, {46, {TE::Reduce, 39}}, {47, {TE::Reduce, 39}}, {48, {TE::Reduce, 39}}, {49, {TE::Reduce, 39}}, {50, {TE::Shift, 90}}, {51, {TE::Shift, 91}}, {52, {TE::Shift, 92}}, {53, {TE::Shift, 93}}, {62, {TE::Reduce, 39}}, {63, {TE::Reduce, 39}}},
-    Row {{23, {TE::Transit, 94}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 84}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{23, {TE::Transit, 111}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 84}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{23, {TE::Transit, 121}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 84}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{23, {TE::Transit, 125}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 84}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Reduce, 42}}, {38, {TE::Reduce, 42}}, {46, {TE::Reduce, 42}}, {47, {TE::Reduce, 42}}, {48, {TE::Reduce, 42}}, {49, {TE::Reduce, 42}}, {50, {TE::Reduce, 42}}, {51, {TE::Reduce, 42}}, {52, {TE::Reduce, 42}}, {53, {TE::Reduce, 42}}, {54, {TE::Shift, 95}}, {55, {TE::Shift, 96}}, {62, {TE::Reduce, 42}}, {63, {TE::Reduce, 42}}},
-    Row {{24, {TE::Transit, 97}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 84}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{24, {TE::Transit, 112}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 84}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Reduce, 47}}, {38, {TE::Reduce, 47}}, {46, {TE::Reduce, 47}}, {47, {TE::Reduce, 47}}, {48, {TE::Reduce, 47}}, {49, {TE::Reduce, 47}}, {50, {TE::Reduce, 47}}, {51, {TE::Reduce, 47}}, {52, {TE::Reduce, 47}}, {53, {TE::Reduce, 47}}, {54, {TE::Reduce, 47}}, {55, {TE::Reduce, 47}}, {56, {TE::Shift, 98}}, {57, {TE::Shift, 99}}, {62, {TE::Reduce, 47}}, {63, {TE::Reduce, 47}}},
-    Row {{25, {TE::Transit, 100}}, {26, {TE::Transit, 31}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 84}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{25, {TE::Transit, 113}}, {26, {TE::Transit, 31}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 84}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Reduce, 50}}, {38, {TE::Reduce, 50}}, {46, {TE::Reduce, 50}}, {47, {TE::Reduce, 50}}, {48, {TE::Reduce, 50}}, {49, {TE::Reduce, 50}}, {50, {TE::Reduce, 50}}, {51, {TE::Reduce, 50}}, {52, {TE::Reduce, 50}}, {53, {TE::Reduce, 50}}, {54, {TE::Reduce, 50}}, {55, {TE::Reduce, 50}}, {56, {TE::Reduce, 50}}, {57, {TE::Reduce, 50}}, {62, {TE::Reduce, 50}}, {63, {TE::Reduce, 50}}},
-    Row {{34, {TE::Reduce, 53}}, {38, {TE::Reduce, 53}}, {46, {TE::Reduce, 53}}, {47, {TE::Reduce, 53}}, {48, {TE::Reduce, 53}}, {49, {TE::Reduce, 53}}, {50, {TE::Reduce, 53}}, {51, {TE::Reduce, 53}}, {52, {TE::Reduce, 53}}, {53, {TE::Reduce, 53}}, {54, {TE::Reduce, 53}}, {55, {TE::Reduce, 53}}, {56, {TE::Reduce, 53}}, {57, {TE::Reduce, 53}}, {62, {TE::Reduce, 53}}, {63, {TE::Reduce, 53}}},
-    Row {{34, {TE::Shift, 103}}},
-    Row {{34, {TE::Reduce, 55}}, {38, {TE::Reduce, 55}}, {46, {TE::Reduce, 55}}, {47, {TE::Reduce, 55}}, {48, {TE::Reduce, 55}}, {49, {TE::Reduce, 55}}, {50, {TE::Reduce, 55}}, {51, {TE::Reduce, 55}}, {52, {TE::Reduce, 55}}, {53, {TE::Reduce, 55}}, {54, {TE::Reduce, 55}}, {55, {TE::Reduce, 55}}, {56, {TE::Reduce, 55}}, {57, {TE::Reduce, 55}}, {62, {TE::Reduce, 55}}, {63, {TE::Reduce, 55}}},
-    Row {{17, {TE::Transit, 107}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{17, {TE::Transit, 128}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{17, {TE::Transit, 117}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {30, {TE::Transit, 115}}, {31, {TE::Transit, 116}}, {33, {TE::Shift, 32}}, {34, {TE::Reduce, 68}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Reduce, 33}}, {38, {TE::Reduce, 33}}, {62, {TE::Reduce, 33}}, {63, {TE::Reduce, 33}}},
-    Row {{17, {TE::Transit, 109}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Reduce, 34}}, {38, {TE::Reduce, 34}}, {62, {TE::Reduce, 34}}, {63, {TE::Reduce, 34}}},
-    Row {{34, {TE::Reduce, 40}}, {38, {TE::Reduce, 40}}, {46, {TE::Reduce, 40}}, {47, {TE::Reduce, 40}}, {48, {TE::Reduce, 40}}, {49, {TE::Reduce, 40}}, {50, {TE::Shift, 90}}, {51, {TE::Shift, 91}}, {52, {TE::Shift, 92}}, {53, {TE::Shift, 93}}, {62, {TE::Reduce, 40}}, {63, {TE::Reduce, 40}}},
-    Row {{34, {TE::Reduce, 43}}, {38, {TE::Reduce, 43}}, {46, {TE::Reduce, 43}}, {47, {TE::Reduce, 43}}, {48, {TE::Reduce, 43}}, {49, {TE::Reduce, 43}}, {50, {TE::Reduce, 43}}, {51, {TE::Reduce, 43}}, {52, {TE::Reduce, 43}}, {53, {TE::Reduce, 43}}, {54, {TE::Shift, 95}}, {55, {TE::Shift, 96}}, {62, {TE::Reduce, 43}}, {63, {TE::Reduce, 43}}},
-    Row {{34, {TE::Reduce, 48}}, {38, {TE::Reduce, 48}}, {46, {TE::Reduce, 48}}, {47, {TE::Reduce, 48}}, {48, {TE::Reduce, 48}}, {49, {TE::Reduce, 48}}, {50, {TE::Reduce, 48}}, {51, {TE::Reduce, 48}}, {52, {TE::Reduce, 48}}, {53, {TE::Reduce, 48}}, {54, {TE::Reduce, 48}}, {55, {TE::Reduce, 48}}, {56, {TE::Shift, 98}}, {57, {TE::Shift, 99}}, {62, {TE::Reduce, 48}}, {63, {TE::Reduce, 48}}},
-    Row {{34, {TE::Reduce, 51}}, {38, {TE::Reduce, 51}}, {46, {TE::Reduce, 51}}, {47, {TE::Reduce, 51}}, {48, {TE::Reduce, 51}}, {49, {TE::Reduce, 51}}, {50, {TE::Reduce, 51}}, {51, {TE::Reduce, 51}}, {52, {TE::Reduce, 51}}, {53, {TE::Reduce, 51}}, {54, {TE::Reduce, 51}}, {55, {TE::Reduce, 51}}, {56, {TE::Reduce, 51}}, {57, {TE::Reduce, 51}}, {62, {TE::Reduce, 51}}, {63, {TE::Reduce, 51}}},
-    Row {{17, {TE::Transit, 126}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Shift, 118}}},
-    Row {{34, {TE::Reduce, 69}}, {63, {TE::Shift, 119}}},
-    Row {{34, {TE::Reduce, 70}}, {62, {TE::Reduce, 70}}, {63, {TE::Reduce, 70}}},
-    Row {{34, {TE::Reduce, 58}}, {38, {TE::Reduce, 58}}, {46, {TE::Reduce, 58}}, {47, {TE::Reduce, 58}}, {48, {TE::Reduce, 58}}, {49, {TE::Reduce, 58}}, {50, {TE::Reduce, 58}}, {51, {TE::Reduce, 58}}, {52, {TE::Reduce, 58}}, {53, {TE::Reduce, 58}}, {54, {TE::Reduce, 58}}, {55, {TE::Reduce, 58}}, {56, {TE::Reduce, 58}}, {57, {TE::Reduce, 58}}, {62, {TE::Reduce, 58}}, {63, {TE::Reduce, 58}}},
-    Row {{17, {TE::Transit, 120}}, {18, {TE::Transit, 20}}, {19, {TE::Transit, 21}}, {20, {TE::Transit, 24}}, {21, {TE::Transit, 25}}, {22, {TE::Transit, 26}}, {23, {TE::Transit, 27}}, {24, {TE::Transit, 28}}, {25, {TE::Transit, 29}}, {26, {TE::Transit, 31}}, {27, {TE::Transit, 23}}, {33, {TE::Shift, 32}}, {40, {TE::Shift, 22}}, {58, {TE::Shift, 30}}, {59, {TE::Shift, 33}}, {60, {TE::Shift, 34}}, {61, {TE::Shift, 35}}},
-    Row {{34, {TE::Reduce, 71}}, {62, {TE::Reduce, 71}}, {63, {TE::Reduce, 71}}},
-    Row {{34, {TE::Reduce, 44}}, {38, {TE::Reduce, 44}}, {46, {TE::Reduce, 44}}, {47, {TE::Reduce, 44}}, {48, {TE::Reduce, 44}}, {49, {TE::Reduce, 44}}, {50, {TE::Reduce, 44}}, {51, {TE::Reduce, 44}}, {52, {TE::Reduce, 44}}, {53, {TE::Reduce, 44}}, {54, {TE::Shift, 95}}, {55, {TE::Shift, 96}}, {62, {TE::Reduce, 44}}, {63, {TE::Reduce, 44}}},
-    Row {{62, {TE::Shift, 124}}, {63, {TE::Shift, 119}}},
-    Row {{34, {TE::Reduce, 61}}, {38, {TE::Reduce, 61}}, {46, {TE::Reduce, 61}}, {47, {TE::Reduce, 61}}, {48, {TE::Reduce, 61}}, {49, {TE::Reduce, 61}}, {50, {TE::Reduce, 61}}, {51, {TE::Reduce, 61}}, {52, {TE::Reduce, 61}}, {53, {TE::Reduce, 61}}, {54, {TE::Reduce, 61}}, {55, {TE::Reduce, 61}}, {56, {TE::Reduce, 61}}, {57, {TE::Reduce, 61}}, {62, {TE::Reduce, 61}}, {63, {TE::Reduce, 61}}},
-    Row {{34, {TE::Reduce, 60}}, {38, {TE::Reduce, 60}}, {46, {TE::Reduce, 60}}, {47, {TE::Reduce, 60}}, {48, {TE::Reduce, 60}}, {49, {TE::Reduce, 60}}, {50, {TE::Reduce, 60}}, {51, {TE::Reduce, 60}}, {52, {TE::Reduce, 60}}, {53, {TE::Reduce, 60}}, {54, {TE::Reduce, 60}}, {55, {TE::Reduce, 60}}, {56, {TE::Reduce, 60}}, {57, {TE::Reduce, 60}}, {62, {TE::Reduce, 60}}, {63, {TE::Reduce, 60}}},
-    Row {{34, {TE::Reduce, 45}}, {38, {TE::Reduce, 45}}, {46, {TE::Reduce, 45}}, {47, {TE::Reduce, 45}}, {48, {TE::Reduce, 45}}, {49, {TE::Reduce, 45}}, {50, {TE::Reduce, 45}}, {51, {TE::Reduce, 45}}, {52, {TE::Reduce, 45}}, {53, {TE::Reduce, 45}}, {54, {TE::Shift, 95}}, {55, {TE::Shift, 96}}, {62, {TE::Reduce, 45}}, {63, {TE::Reduce, 45}}},
-    Row {{62, {TE::Shift, 127}}},
-    Row {{34, {TE::Reduce, 59}}, {38, {TE::Reduce, 59}}, {46, {TE::Reduce, 59}}, {47, {TE::Reduce, 59}}, {48, {TE::Reduce, 59}}, {49, {TE::Reduce, 59}}, {50, {TE::Reduce, 59}}, {51, {TE::Reduce, 59}}, {52, {TE::Reduce, 59}}, {53, {TE::Reduce, 59}}, {54, {TE::Reduce, 59}}, {55, {TE::Reduce, 59}}, {56, {TE::Reduce, 59}}, {57, {TE::Reduce, 59}}, {62, {TE::Reduce, 59}}, {63, {TE::Reduce, 59}}},
-    Row {{62, {TE::Shift, 129}}},
-    Row {{34, {TE::Reduce, 59}}, {38, {TE::Reduce, 59}}, {44, {TE::Reduce, 63}}, {46, {TE::Reduce, 59}}, {47, {TE::Reduce, 59}}, {48, {TE::Reduce, 59}}, {49, {TE::Reduce, 59}}, {50, {TE::Reduce, 59}}, {51, {TE::Reduce, 59}}, {52, {TE::Reduce, 59}}, {53, {TE::Reduce, 59}}, {54, {TE::Reduce, 59}}, {55, {TE::Reduce, 59}}, {56, {TE::Reduce, 59}}, {57, {TE::Reduce, 59}}, {62, {TE::Reduce, 59}}, {63, {TE::Reduce, 59}}},
-    Row {{38, {TE::Shift, 131}}},
-    Row {{32, {TE::Reduce, 30}}, {33, {TE::Reduce, 30}}, {36, {TE::Reduce, 30}}, {37, {TE::Reduce, 30}}, {39, {TE::Reduce, 30}}, {40, {TE::Reduce, 30}}, {41, {TE::Reduce, 30}}, {42, {TE::Reduce, 30}}, {43, {TE::Reduce, 30}}, {45, {TE::Reduce, 30}}, {58, {TE::Reduce, 30}}, {59, {TE::Reduce, 30}}, {60, {TE::Reduce, 30}}, {61, {TE::Reduce, 30}}, {64, {TE::Reduce, 30}}},
-    Row {{40, {TE::Shift, 133}}},
-    Row {{34, {TE::Reduce, 67}}, {63, {TE::Reduce, 67}}}
-};
-// clang-format on
 
 }  // namespace syntax
 
@@ -0,0 +1,783 @@
+#pragma once
+
+#include <algorithm>
+#include <unordered_map>
+#include "parser.h"
+#include "ConstantFolder.h"
+#include "EvaluationValue.h"
+#include "RegisterOpCode.h"
+#include "Global.h"
+#include "bytecodeGenerator.h"
+
+// Генератор регистрового кода (Backend::REGISTER) по тому же AST, что и bytecodeGenerator.
+//
+// Регистры фрейма: параметры, затем все локальные переменные функции (их число известно
+// заранее из обхода тела), затем временные значения. Временные регистры выделяются
+// и освобождаются стопкой: после инструкции языка все они свободны. Результат выражения
+// вычисляется сразу в нужный регистр, а операнд, который уже лежит в локальной переменной,
+// читается из её регистра без копирования.
+class registerGenerator {
+public:
+    // Регистры над временными значениями фрейма: на них обработчики стековых инструкций,
+    // которые vm::evalRegisters вызывает на медленном пути, раскладывают операнды
+    static constexpr size_t SCRATCH_STACK_DEPTH = 3;
+
+    explicit registerGenerator(const std::shared_ptr<Global> &global, CompilerOptions options = {})
+        : global(global), options(options) {
+    }
+
+    // AST может быть изменено свёрткой констант; новые строки размещаются в arena
+    CodeObject *compile(Exp &exp, AstArena &arena) {
+        stats = {};
+        if (options.foldConstants) {
+            ConstantFolder folder(arena);
+            folder.fold(exp);
+            stats.foldedExpressions = folder.foldedCount();
+        }
+
+        co = newCodeObject("main");
+        scopeStack.clear();
+        functionScopeBase = 0;
+        beginFunction(0, countDeclarations(exp));
+
+        // Результат программы - значение последнего выражения, иначе nil
+        int result = generateResult(exp);
+        emit(ROP_HALT);
+        emit(result);
+        finishFunction();
+
+        constantIndex.clear();
+        return co;
+    }
+
+    const CompileStats &compileStats() const { return stats; }
+
+private:
+    // Значение выражения в регистре dest
+    void generateInto(const Exp &exp, int dest) {
+        switch (exp.type) {
+            case ExpType::NUMBER:
+                emitLoadConst(dest, numericConstIdx(exp.number));
+                break;
+
+            case ExpType::STRING:
+                emitLoadConst(dest, stringConstIdx(exp.string));
+                break;
+
+            case ExpType::SYMBOL:
+                generateSymbolInto(exp.string, dest);
+                break;
+
+            case ExpType::UNARY_EXP: {
+                if (exp.unary.op != "!") {
+                    throw std::runtime_error("Неизвестный оператор в бинарном выражении");
+                }
+                int mark = nextRegister;
+                int operand = generateOperand(*exp.unary.operand);
+                emit(ROP_NOT);
+                emit(dest);
+                emit(operand);
+                nextRegister = mark;
+                break;
+            }
+
+            case ExpType::BINARY_EXP:
+                generateBinaryInto(exp.binary, dest);
+                break;
+
+            case ExpType::IF_EXP: {
+                const IfNode &ifExp = exp.ifExp;
+                size_t jumpIfFalseAddr = emitJumpIfFalse(*ifExp.condition);
+                generateBranchInto(ifExp.thenBranch, dest);
+
+                emit(ROP_JUMP);
+                size_t jumpAddr = co->code.size();
+                emit16(0);
+
+                patchAddress(jumpIfFalseAddr, co->code.size());
+                generateBranchInto(ifExp.elseBranch, dest);
+                patchAddress(jumpAddr, co->code.size());
+                break;
+            }
+
+            case ExpType::BLOCK: {
+                scopeStack.emplace_back();
+                for (size_t i = 0; i + 1 < exp.list.size(); ++i) {
+                    generateStatement(*exp.list[i]);
+                }
+                generateInto(*exp.list.back(), dest);
+                scopeStack.pop_back();
+                break;
+            }
+
+            case ExpType::FUNCTION_CALL:
+                generateCallInto(exp.call, dest);
+                break;
+
+            case ExpType::ARRAY_LITERAL:
+                generateArrayInto(exp.list, dest);
+                break;
+
+            case ExpType::ARRAY_ACCESS: {
+                int mark = nextRegister;
+                int array = generateSymbolOperand(exp.arrayAccess.name);
+                int index = generateOperand(*exp.arrayAccess.index);
+                emit(ROP_ARRAY_GET);
+                emit(dest);
+                emit(array);
+                emit(index);
+                nextRegister = mark;
+                break;
+            }
+
+            default:
+                throw std::runtime_error("Инструкция не даёт значения");
+        }
+    }
+
+    // Инструкция, значение которой не используется
+    void generateStatement(const Exp &exp) {
+        switch (exp.type) {
+            case ExpType::NUMBER:
+            case ExpType::STRING:
+                break;
+
+            case ExpType::SYMBOL:
+                // Чтение переменной ничего не делает, но неизвестное имя - ошибка компиляции
+                if (exp.string != "true" && exp.string != "false" && findLocal(exp.string) == -1) {
+                    globalIndex(exp.string, "Undefined variable: ");
+                }
+                break;
+
+            case ExpType::IF_EXP: {
+                const IfNode &ifExp = exp.ifExp;
+                size_t jumpIfFalseAddr = emitJumpIfFalse(*ifExp.condition);
+                generateStatement(*ifExp.thenBranch);
+
+                if (ifExp.elseBranch != nullptr) {
+                    emit(ROP_JUMP);
+                    size_t jumpAddr = co->code.size();
+                    emit16(0);
+
+                    patchAddress(jumpIfFalseAddr, co->code.size());
+                    generateStatement(*ifExp.elseBranch);
+                    patchAddress(jumpAddr, co->code.size());
+                } else {
+                    patchAddress(jumpIfFalseAddr, co->code.size());
+                }
+                break;
+            }
+
+            case ExpType::BLOCK: {
+                scopeStack.emplace_back();
+                for (const Exp *item: exp.list) {
+                    generateStatement(*item);
+                }
+                scopeStack.pop_back();
+                break;
+            }
+
+            case ExpType::VAR_DECLARATION: {
+                // Переменная ещё не видна в своём инициализаторе, поэтому значение
+                // вычисляется прямо в её регистр
+                int slot = localCount++;
+                generateInto(*exp.variable.value, slot);
+
+                auto &currentScope = scopeStack.back();
+                std::string_view name = exp.variable.name;
+                if (currentScope.find(name) != currentScope.end()) {
+                    throw std::runtime_error("Variable " + std::string(name) + " already exists.");
+                }
+                currentScope[name] = slot;
+                co->localNames[slot] = std::string(name);
+                break;
+            }
+
+            case ExpType::ASSIGNMENT:
+                generateAssignment(exp.assignment);
+                break;
+
+            case ExpType::WHILE_EXP: {
+                size_t loopStart = co->code.size();
+                size_t exitJumpAddr = emitJumpIfFalse(*exp.whileExp.condition);
+
+                generateStatement(*exp.whileExp.body);
+
+                emit(ROP_JUMP);
+                emit16((uint16_t) loopStart);
+                patchAddress(exitJumpAddr, co->code.size());
+                break;
+            }
+
+            case ExpType::FOR_EXP: {
+                const ForNode &forExp = exp.forExp;
+                if (forExp.init != nullptr) {
+                    generateStatement(*forExp.init);
+                }
+
+                size_t loopStart = co->code.size();
+                size_t exitJumpAddr = SIZE_MAX;
+                if (forExp.condition != nullptr) {
+                    exitJumpAddr = emitJumpIfFalse(*forExp.condition);
+                }
+
+                generateStatement(*forExp.body);
+                if (forExp.update != nullptr) {
+                    generateStatement(*forExp.update);
+                }
+
+                emit(ROP_JUMP);
+                emit16((uint16_t) loopStart);
+                if (exitJumpAddr != SIZE_MAX) {
+                    patchAddress(exitJumpAddr, co->code.size());
+                }
+                break;
+            }
+
+            case ExpType::FUNCTION_DECLARATION:
+                generateFunction(exp.function);
+                break;
+
+            case ExpType::RETURN_STATEMENT: {
+                int mark = nextRegister;
+                int value = exp.returnValue != nullptr ? generateOperand(*exp.returnValue) : loadNil();
+                emit(ROP_RETURN);
+                emit(value);
+                nextRegister = mark;
+                break;
+            }
+
+            default: {
+                int mark = nextRegister;
+                generateInto(exp, allocateRegister());
+                nextRegister = mark;
+                break;
+            }
+        }
+    }
+
+    // Регистр со значением выражения: регистр локальной переменной или новый временный.
+    // Временный регистр освобождает вызывающий, восстанавливая nextRegister.
+    int generateOperand(const Exp &exp) {
+        if (exp.type == ExpType::SYMBOL) {
+            return generateSymbolOperand(exp.string);
+        }
+        int reg = allocateRegister();
+        generateInto(exp, reg);
+        return reg;
+    }
+
+    int generateSymbolOperand(std::string_view name) {
+        int slot = findLocal(name);
+        if (slot != -1) {
+            return slot;
+        }
+        int reg = allocateRegister();
+        generateSymbolInto(name, reg);
+        return reg;
+    }
+
+    // Чтение переменной или логической константы по имени
+    void generateSymbolInto(std::string_view name, int dest) {
+        if (name == "true" || name == "false") {
+            emitLoadConst(dest, booleanConstIdx(name == "true"));
+            return;
+        }
+
+        int slot = findLocal(name);
+        if (slot != -1) {
+            if (slot != dest) {
+                emit(ROP_MOVE);
+                emit(dest);
+                emit(slot);
+            }
+            return;
+        }
+
+        emit(ROP_GET_GLOBAL);
+        emit(dest);
+        emit16(globalIndex(name, "Undefined variable: "));
+    }
+
+    void generateBinaryInto(const BinaryNode &binary, int dest) {
+        // Короткое замыкание: левое значение остаётся результатом, если правое не нужно
+        if (binary.op == "&&" || binary.op == "||") {
+            generateInto(*binary.left, dest);
+            emit(binary.op == "&&" ? ROP_JUMP_IF_FALSY : ROP_JUMP_IF_TRUTHY);
+            emit(dest);
+            size_t jumpAddr = co->code.size();
+            emit16(0);
+            generateInto(*binary.right, dest);
+            patchAddress(jumpAddr, co->code.size());
+            return;
+        }
+
+        int mark = nextRegister;
+        int left = generateOperand(*binary.left);
+
+        // Прибавление и вычитание числовой константы не занимают регистр под неё
+        if ((binary.op == "+" || binary.op == "-") && binary.right->type == ExpType::NUMBER) {
+            emit(binary.op == "+" ? ROP_ADD_CONST : ROP_SUB_CONST);
+            emit(dest);
+            emit(left);
+            emit16(numericConstIdx(binary.right->number));
+            nextRegister = mark;
+            return;
+        }
+
+        int right = generateOperand(*binary.right);
+        if (binary.op == "+") {
+            emit(ROP_ADD);
+        } else if (binary.op == "-") {
+            emit(ROP_SUB);
+        } else if (binary.op == "*") {
+            emit(ROP_MUL);
+        } else if (binary.op == "/") {
+            emit(ROP_DIV);
+        } else if (auto compare = bytecodeGenerator::compareOperator.find(binary.op);
+            compare != bytecodeGenerator::compareOperator.end()) {
+            emit(ROP_COMPARE);
+            emit(dest);
+            emit(left);
+            emit(right);
+            emit(compare->second);
+            nextRegister = mark;
+            return;
+        } else {
+            throw std::runtime_error("Неизвестный оператор в бинарном выражении");
+        }
+        emit(dest);
+        emit(left);
+        emit(right);
+        nextRegister = mark;
+    }
+
+    // Ветка if, значение которой нужно; ветка без значения даёт nil
+    void generateBranchInto(const Exp *branch, int dest) {
+        if (branch != nullptr && producesValue(*branch)) {
+            generateInto(*branch, dest);
+            return;
+        }
+        if (branch != nullptr) {
+            generateStatement(*branch);
+        }
+        emit(ROP_LOAD_NIL);
+        emit(dest);
+    }
+
+    void generateAssignment(const AssignmentNode &assignment) {
+        int mark = nextRegister;
+
+        if (assignment.index != nullptr) {
+            // Присваивание элементу массива: arr[j] = arr[j+1]
+            int array = generateSymbolOperand(assignment.name);
+            int index = generateOperand(*assignment.index);
+            int value = generateOperand(*assignment.value);
+            emit(ROP_ARRAY_SET);
+            emit(array);
+            emit(index);
+            emit(value);
+            nextRegister = mark;
+            return;
+        }
+
+        int slot = findLocal(assignment.name);
+        if (slot != -1) {
+            if (writesOnce(*assignment.value)) {
+                generateInto(*assignment.value, slot);
+            } else {
+                // Значение может читать переменную после первой записи в регистр назначения
+                int value = allocateRegister();
+                generateInto(*assignment.value, value);
+                emit(ROP_MOVE);
+                emit(slot);
+                emit(value);
+            }
+            nextRegister = mark;
+            return;
+        }
+
+        uint16_t globalIdx = globalIndex(assignment.name, "Неизвестная переменная ");
+        int value = generateOperand(*assignment.value);
+        emit(ROP_SET_GLOBAL);
+        emit16(globalIdx);
+        emit(value);
+        nextRegister = mark;
+    }
+
+    // Пишет ли generateInto в регистр назначения только последней инструкцией
+    static bool writesOnce(const Exp &exp) {
+        switch (exp.type) {
+            case ExpType::BINARY_EXP:
+                return exp.binary.op != "&&" && exp.binary.op != "||";
+            case ExpType::ARRAY_LITERAL:
+                return exp.list.size() <= UINT8_MAX;
+            case ExpType::IF_EXP:
+            case ExpType::BLOCK:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    // Функция в регистре f, аргументы в следующих за ним; результат вызова остаётся в f
+    void generateCallInto(const CallNode &call, int dest) {
+        int mark = nextRegister;
+        // Регистр назначения подходит под функцию, только если над ним нет занятых регистров
+        int function = dest >= firstTemporary && dest == nextRegister - 1 ? dest : allocateRegister();
+
+        emit(ROP_GET_GLOBAL);
+        emit(function);
+        emit16(globalIndex(call.name, "Undefined function: "));
+
+        for (const Exp *argument: call.arguments) {
+            generateInto(*argument, allocateRegister());
+        }
+
+        emit(ROP_CALL);
+        emit(function);
+        emit((uint8_t) call.arguments.size());
+
+        if (function != dest) {
+            emit(ROP_MOVE);
+            emit(dest);
+            emit(function);
+        }
+        nextRegister = mark;
+    }
+
+    void generateArrayInto(const ExpList &elements, int dest) {
+        int mark = nextRegister;
+
+        // До 255 элементов массив собирается одной инструкцией из подряд идущих регистров
+        if (elements.size() <= UINT8_MAX) {
+            int first = nextRegister;
+            for (const Exp *element: elements) {
+                generateInto(*element, allocateRegister());
+            }
+            emit(ROP_ARRAY_LITERAL);
+            emit(dest);
+            emit(first);
+            emit((uint8_t) elements.size());
+            // Обработчик OP_ARRAY_LITERAL собирает массив из значений на стеке над регистрами
+            scratchDepth = std::max(scratchDepth, elements.size());
+            nextRegister = mark;
+            return;
+        }
+
+        // Большой литерал заполняется поэлементно в массив нужной ёмкости
+        emit(ROP_ARRAY);
+        emit(dest);
+        emit16((uint16_t) std::min<size_t>(elements.size(), UINT16_MAX));
+        for (size_t i = 0; i < elements.size(); ++i) {
+            int index = allocateRegister();
+            emitLoadConst(index, numericConstIdx((int64_t) i));
+            int value = generateOperand(*elements[i]);
+            emit(ROP_ARRAY_SET);
+            emit(dest);
+            emit(index);
+            emit(value);
+            nextRegister = mark;
+        }
+    }
+
+    void generateFunction(const FunctionNode &function) {
+        std::string functionName(function.name);
+        CodeObject *functionCo = newCodeObject(functionName);
+
+        size_t functionConstIdx = co->constants.size();
+        co->constants.emplace_back(OBJECT(functionCo));
+
+        int reg = allocateRegister();
+        emitLoadConst(reg, functionConstIdx);
+        emit(ROP_SET_GLOBAL);
+        emit16(checkedGlobalIndex(global->define(functionName)));
+        emit(reg);
+        nextRegister = reg;
+
+        // Состояние объемлющей функции восстанавливается после генерации тела
+        CodeObject *previousCo = co;
+        int previousLocalCount = localCount;
+        int previousFirstTemporary = firstTemporary;
+        int previousNextRegister = nextRegister;
+        int previousRegisterCount = registerCount;
+        size_t previousScratchDepth = scratchDepth;
+        size_t previousScopeBase = functionScopeBase;
+
+        co = functionCo;
+        functionScopeBase = scopeStack.size();
+        scopeStack.emplace_back();
+        beginFunction(function.params.size(), countDeclarations(*function.body));
+
+        // Параметры - первые регистры, в них вызывающий кладёт аргументы
+        for (const auto &param: function.params) {
+            scopeStack.back()[param] = localCount;
+            co->localNames[localCount] = std::string(param);
+            localCount++;
+        }
+        functionCo->arity = function.params.size();
+
+        // Без значения функция возвращает nil
+        int result = generateResult(*function.body);
+        emit(ROP_RETURN);
+        emit(result);
+        finishFunction();
+
+        co = previousCo;
+        localCount = previousLocalCount;
+        firstTemporary = previousFirstTemporary;
+        nextRegister = previousNextRegister;
+        registerCount = previousRegisterCount;
+        scratchDepth = previousScratchDepth;
+        functionScopeBase = previousScopeBase;
+        scopeStack.pop_back();
+    }
+
+    // Регистр со значением тела программы или функции; тело без значения даёт nil
+    int generateResult(const Exp &body) {
+        if (producesValue(body)) {
+            return generateOperand(body);
+        }
+        generateStatement(body);
+        return loadNil();
+    }
+
+    // Переход, если условие ложно; возвращает позицию адреса для patchAddress.
+    // Сравнение сливается с переходом, отрицание меняет его направление.
+    size_t emitJumpIfFalse(const Exp &condition) {
+        int mark = nextRegister;
+        if (condition.type == ExpType::BINARY_EXP) {
+            if (auto compare = bytecodeGenerator::compareOperator.find(condition.binary.op);
+                compare != bytecodeGenerator::compareOperator.end()) {
+                int left = generateOperand(*condition.binary.left);
+                int right = generateOperand(*condition.binary.right);
+                emit(ROP_JUMP_IF_NOT_LT + compare->second);
+                emit(left);
+                emit(right);
+                return emitJumpAddress(mark);
+            }
+        }
+        if (condition.type == ExpType::UNARY_EXP && condition.unary.op == "!") {
+            // JUMP_IF_FALSE после NOT переходит ровно тогда, когда исходное значение истинно
+            int operand = generateOperand(*condition.unary.operand);
+            emit(ROP_JUMP_IF_TRUTHY);
+            emit(operand);
+            return emitJumpAddress(mark);
+        }
+        int value = generateOperand(condition);
+        emit(ROP_JUMP_IF_FALSE);
+        emit(value);
+        return emitJumpAddress(mark);
+    }
+
+    size_t emitJumpAddress(int mark) {
+        size_t addrPos = co->code.size();
+        emit16(0);
+        nextRegister = mark;
+        return addrPos;
+    }
+
+    // Слот локальной переменной или -1. Поиск идёт от внутренней области к внешней;
+    // локальные переменные объемлющей функции лежат в чужом фрейме и здесь не видны.
+    int findLocal(std::string_view name) {
+        for (auto scopeIt = scopeStack.rbegin(); scopeIt != scopeStack.rend() - functionScopeBase; ++scopeIt) {
+            auto found = scopeIt->find(name);
+            if (found != scopeIt->end()) {
+                return found->second;
+            }
+        }
+        return -1;
+    }
+
+    // Число объявлений переменных в теле функции без вложенных функций: столько регистров
+    // под локальные переменные идёт сразу за параметрами
+    static size_t countDeclarations(const Exp &exp) {
+        auto count = [](const Exp *part) { return part != nullptr ? countDeclarations(*part) : 0; };
+        switch (exp.type) {
+            case ExpType::VAR_DECLARATION:
+                return 1 + count(exp.variable.value);
+            case ExpType::UNARY_EXP:
+                return count(exp.unary.operand);
+            case ExpType::BINARY_EXP:
+                return count(exp.binary.left) + count(exp.binary.right);
+            case ExpType::IF_EXP:
+                return count(exp.ifExp.condition) + count(exp.ifExp.thenBranch) + count(exp.ifExp.elseBranch);
+            case ExpType::WHILE_EXP:
+                return count(exp.whileExp.condition) + count(exp.whileExp.body);
+            case ExpType::FOR_EXP:
+                return count(exp.forExp.init) + count(exp.forExp.condition) + count(exp.forExp.update) +
+                       count(exp.forExp.body);
+            case ExpType::ASSIGNMENT:
+                return count(exp.assignment.index) + count(exp.assignment.value);
+            case ExpType::BLOCK:
+            case ExpType::ARG_LIST:
+            case ExpType::ARRAY_LITERAL: {
+                size_t total = 0;
+                for (const Exp *item: exp.list) {
+                    total += count(item);
+                }
+                return total;
+            }
+            case ExpType::FUNCTION_CALL: {
+                size_t total = 0;
+                for (const Exp *argument: exp.call.arguments) {
+                    total += count(argument);
+                }
+                return total;
+            }
+            case ExpType::RETURN_STATEMENT:
+                return count(exp.returnValue);
+            case ExpType::ARRAY_ACCESS:
+                return count(exp.arrayAccess.index);
+            default:
+                return 0;
+        }
+    }
+
+    void beginFunction(size_t paramCount, size_t declarationCount) {
+        localCount = 0;
+        firstTemporary = (int) (paramCount + declarationCount);
+        if (firstTemporary > UINT8_MAX + 1) {
+            throw std::runtime_error("Слишком много локальных переменных в " + co->name);
+        }
+        nextRegister = firstTemporary;
+        registerCount = firstTemporary;
+        scratchDepth = SCRATCH_STACK_DEPTH;
+    }
+
+    void finishFunction() {
+        co->localCount = registerCount;
+        co->maxStackDepth = scratchDepth;
+        for (size_t offset = 0; offset < co->code.size(); offset += registerInstructionLength(co->code[offset])) {
+            stats.instructions++;
+        }
+    }
+
+    int allocateRegister() {
+        if (nextRegister > UINT8_MAX) {
+            throw std::runtime_error("Слишком много регистров в " + co->name);
+        }
+        int reg = nextRegister++;
+        registerCount = std::max(registerCount, nextRegister);
+        return reg;
+    }
+
+    // Временный регистр со значением nil
+    int loadNil() {
+        int reg = allocateRegister();
+        emit(ROP_LOAD_NIL);
+        emit(reg);
+        return reg;
+    }
+
+    CodeObject *newCodeObject(const std::string &name) {
+        CodeObject *codeObject = AS_CODE(ALLOC_CODE(name));
+        codeObject->registerBased = true;
+        return codeObject;
+    }
+
+    uint16_t globalIndex(std::string_view name, const char *undefinedMessage) {
+        int index = global->getGlobalIndex(std::string(name));
+        if (index == -1) {
+            throw std::runtime_error(undefinedMessage + std::string(name));
+        }
+        return checkedGlobalIndex(index);
+    }
+
+    static uint16_t checkedGlobalIndex(int index) {
+        if (index > UINT16_MAX) {
+            throw std::runtime_error("Слишком много глобальных переменных.");
+        }
+        return (uint16_t) index;
+    }
+
+    size_t numericConstIdx(int64_t value) {
+        auto [it, inserted] = constantIndex[co].numbers.emplace(value, co->constants.size());
+        if (inserted) {
+            co->constants.emplace_back(NUMBER(value));
+        }
+        return it->second;
+    }
+
+    size_t booleanConstIdx(bool value) {
+        size_t &index = constantIndex[co].booleans[value];
+        if (index == SIZE_MAX) {
+            index = co->constants.size();
+            co->constants.emplace_back(BOOLEAN(value));
+        }
+        return index;
+    }
+
+    size_t stringConstIdx(std::string_view value) {
+        auto [it, inserted] = constantIndex[co].strings.emplace(value, co->constants.size());
+        if (inserted) {
+            co->constants.emplace_back(ALLOC_STRING(std::string(value)));
+        }
+        return it->second;
+    }
+
+    void emitLoadConst(int dest, size_t constIdx) {
+        emit(ROP_LOAD_CONST);
+        emit(dest);
+        emit16(constIdx);
+    }
+
+    void emit(int code) {
+        co->code.emplace_back((uint8_t) code);
+    }
+
+    void emit16(size_t value) {
+        if (value > UINT16_MAX) {
+            throw std::runtime_error("Слишком много констант в " + co->name);
+        }
+        emit((uint8_t) ((value >> 8) & 0xFF));
+        emit((uint8_t) (value & 0xFF));
+    }
+
+    void patchAddress(size_t addrPos, size_t value) {
+        if (value > UINT16_MAX) {
+            throw std::runtime_error("Слишком длинный переход в " + co->name);
+        }
+        co->code[addrPos] = (uint8_t) ((value >> 8) & 0xFF);
+        co->code[addrPos + 1] = (uint8_t) (value & 0xFF);
+    }
+
+    std::shared_ptr<Global> global;
+
+    CompilerOptions options;
+
+    CompileStats stats;
+
+    CodeObject *co = nullptr;
+
+    // Имена ссылаются на память AST, которое живёт до конца компиляции
+    std::vector<std::unordered_map<std::string_view, int> > scopeStack;
+
+    // Индекс первой области видимости текущей функции в scopeStack
+    size_t functionScopeBase = 0;
+
+    // Следующий регистр локальной переменной
+    int localCount = 0;
+
+    // Первый временный регистр (за параметрами и локальными переменными)
+    int firstTemporary = 0;
+
+    // Следующий свободный временный регистр
+    int nextRegister = 0;
+
+    // Число регистров фрейма: наибольшее значение nextRegister
+    int registerCount = 0;
+
+    // Глубина стека над регистрами, нужная медленным путям vm::evalRegisters
+    size_t scratchDepth = SCRATCH_STACK_DEPTH;
+
+    // Индексы уже добавленных констант объекта кода
+    struct ConstantIndex {
+        std::unordered_map<int64_t, size_t> numbers;
+        std::unordered_map<std::string_view, size_t> strings;
+        size_t booleans[2] = {SIZE_MAX, SIZE_MAX};
+    };
+
+    // Живёт только во время компиляции
+    std::unordered_map<const CodeObject *, ConstantIndex> constantIndex;
+};
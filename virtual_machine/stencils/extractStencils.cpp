@@ -0,0 +1,232 @@
+// Извлечение трафаретов из объектного файла stencils.cpp (ELF64, x86-64) в заголовок Stencils.h.
+//
+// Трафарет - секция .text.stencil_<имя> (stencils.cpp компилируется с -ffunction-sections).
+// Каждое её перемещение должно быть 64-битным абсолютным (R_X86_64_64) и ссылаться на один
+// из символов HOLE_*: тогда код можно скопировать куда угодно и заполнить дыры.
+// Продолжение (CONTINUE, TARGET) - переход по регистру, а не call, иначе цепочка трафаретов
+// росла бы на машинном стеке. Любое нарушение - ошибка сборки.
+//
+// Использование: extractStencils <stencils.o> <Stencils.h>
+
+#include <elf.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    const char SECTION_PREFIX[] = ".text.stencil_";
+
+    const std::map<std::string, std::string> HOLES = {
+        {"HOLE_CONTINUE", "CONTINUE"},
+        {"HOLE_TARGET", "TARGET"},
+        {"HOLE_EXIT", "EXIT"},
+        {"HOLE_OPERAND0", "OPERAND0"},
+        {"HOLE_OPERAND1", "OPERAND1"},
+        {"HOLE_OPERAND2", "OPERAND2"},
+    };
+
+    struct Patch {
+        uint64_t offset;
+        std::string hole;
+        int64_t addend;
+    };
+
+    struct ExtractedStencil {
+        std::vector<uint8_t> code;
+        std::vector<Patch> patches;
+        size_t tailJump;
+    };
+
+    class ObjectFile {
+    public:
+        explicit ObjectFile(const std::string &path) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("cannot open " + path);
+            }
+            bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+            const auto &header = at<Elf64_Ehdr>(0);
+            if (bytes.size() < sizeof(Elf64_Ehdr) || std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 ||
+                header.e_ident[EI_CLASS] != ELFCLASS64 || header.e_machine != EM_X86_64) {
+                throw std::runtime_error(path + " is not an x86-64 ELF64 object file");
+            }
+            for (size_t i = 0; i < header.e_shnum; ++i) {
+                sections.push_back(at<Elf64_Shdr>(header.e_shoff + i * header.e_shentsize));
+            }
+            sectionNames = sections.at(header.e_shstrndx).sh_offset;
+        }
+
+        std::string sectionName(const Elf64_Shdr &section) const {
+            return string(sectionNames + section.sh_name);
+        }
+
+        // Имя символа index из таблицы символов symbolTable
+        std::string symbolName(const Elf64_Shdr &symbolTable, size_t index) const {
+            const auto &symbol = at<Elf64_Sym>(symbolTable.sh_offset + index * sizeof(Elf64_Sym));
+            if (ELF64_ST_TYPE(symbol.st_info) == STT_SECTION) {
+                return sectionName(sections.at(symbol.st_shndx));
+            }
+            return string(sections.at(symbolTable.sh_link).sh_offset + symbol.st_name);
+        }
+
+        template<typename T>
+        const T &at(size_t offset) const {
+            if (offset + sizeof(T) > bytes.size()) {
+                throw std::runtime_error("truncated object file");
+            }
+            return *reinterpret_cast<const T *>(bytes.data() + offset);
+        }
+
+        std::vector<uint8_t> contents(const Elf64_Shdr &section) const {
+            return {bytes.begin() + section.sh_offset, bytes.begin() + section.sh_offset + section.sh_size};
+        }
+
+        std::vector<Elf64_Shdr> sections;
+
+    private:
+        std::string string(size_t offset) const {
+            return reinterpret_cast<const char *>(bytes.data() + offset);
+        }
+
+        std::vector<uint8_t> bytes;
+        size_t sectionNames = 0;
+    };
+
+    // jmp по регистру (ff e0+r, с REX.B - 41 ff e0+r) в позиции at; длина инструкции или 0
+    size_t registerJumpLength(const std::vector<uint8_t> &code, size_t at) {
+        if (at + 2 <= code.size() && code[at] == 0xFF && (code[at + 1] & 0xF8) == 0xE0) {
+            return 2;
+        }
+        if (at + 3 <= code.size() && code[at] == 0x41 && code[at + 1] == 0xFF && (code[at + 2] & 0xF8) == 0xE0) {
+            return 3;
+        }
+        return 0;
+    }
+
+    ExtractedStencil extract(const ObjectFile &object, const std::string &name, const Elf64_Shdr &text,
+                             const Elf64_Shdr *relocations) {
+        ExtractedStencil stencil{object.contents(text), {}, 0};
+        stencil.tailJump = stencil.code.size();
+        if (relocations == nullptr) {
+            return stencil;
+        }
+
+        const Elf64_Shdr &symbolTable = object.sections.at(relocations->sh_link);
+        for (size_t i = 0; i < relocations->sh_size / sizeof(Elf64_Rela); ++i) {
+            const auto &relocation = object.at<Elf64_Rela>(relocations->sh_offset + i * sizeof(Elf64_Rela));
+            std::string symbol = object.symbolName(symbolTable, ELF64_R_SYM(relocation.r_info));
+            auto hole = HOLES.find(symbol);
+            if (ELF64_R_TYPE(relocation.r_info) != R_X86_64_64 || hole == HOLES.end()) {
+                throw std::runtime_error("stencil " + name + " refers to " + symbol +
+                                         " with relocation type " + std::to_string(ELF64_R_TYPE(relocation.r_info)) +
+                                         "; stencils may only use HOLE_* symbols as 64-bit constants");
+            }
+            stencil.patches.push_back({relocation.r_offset, hole->second, relocation.r_addend});
+        }
+
+        // Продолжения вызываются хвостовым переходом: call по регистру (ff d0+r) запрещён
+        for (size_t at = 0; at + 1 < stencil.code.size(); ++at) {
+            if (stencil.code[at] == 0xFF && (stencil.code[at + 1] & 0xF8) == 0xD0) {
+                throw std::runtime_error("stencil " + name + " calls through a register; compile stencils.cpp "
+                                         "with sibling call optimization");
+            }
+        }
+
+        // Завершающие movabs r64, CONTINUE; jmp r64 не нужны, если следующий трафарет лежит сразу за ним
+        for (const Patch &patch: stencil.patches) {
+            size_t jumpLength = registerJumpLength(stencil.code, patch.offset + 8);
+            bool movabs = patch.offset >= 2 && (stencil.code[patch.offset - 2] & 0xFE) == 0x48 &&
+                          (stencil.code[patch.offset - 1] & 0xF8) == 0xB8;
+            if (patch.hole == "CONTINUE" && movabs && jumpLength != 0 &&
+                patch.offset + 8 + jumpLength == stencil.code.size()) {
+                stencil.tailJump = patch.offset - 2;
+            }
+        }
+        return stencil;
+    }
+
+    void write(std::ostream &out, const std::map<std::string, ExtractedStencil> &stencils) {
+        out << "#pragma once\n\n"
+               "// Сгенерировано stencils/extractStencils.cpp из stencils/stencils.cpp; не редактировать.\n\n"
+               "#include \"Stencil.h\"\n\n"
+               "namespace stencils {\n";
+        for (const auto &[name, stencil]: stencils) {
+            out << "    inline const uint8_t " << name << "_CODE[] = {";
+            for (size_t i = 0; i < stencil.code.size(); ++i) {
+                out << (i % 16 == 0 ? "\n        " : " ");
+                char hex[8];
+                std::snprintf(hex, sizeof(hex), "0x%02x,", stencil.code[i]);
+                out << hex;
+            }
+            out << "\n    };\n";
+
+            std::string patches = "nullptr";
+            if (!stencil.patches.empty()) {
+                patches = name + "_PATCHES";
+                out << "    inline const StencilPatch " << patches << "[] = {\n";
+                for (const Patch &patch: stencil.patches) {
+                    out << "        {" << patch.offset << ", StencilHole::" << patch.hole << ", " << patch.addend
+                        << "},\n";
+                }
+                out << "    };\n";
+            }
+            out << "    inline const Stencil " << name << " = {" << name << "_CODE, " << stencil.code.size() << ", "
+                << patches << ", " << stencil.patches.size() << ", " << stencil.tailJump << "};\n\n";
+        }
+        out << "}\n";
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        std::cerr << "usage: extractStencils <stencils.o> <Stencils.h>\n";
+        return 2;
+    }
+    try {
+        ObjectFile object(argv[1]);
+
+        std::map<std::string, const Elf64_Shdr *> relocations;
+        for (const Elf64_Shdr &section: object.sections) {
+            std::string name = object.sectionName(section);
+            if (section.sh_type == SHT_RELA && name.rfind(".rela", 0) == 0) {
+                relocations[name.substr(5)] = &section;
+            }
+        }
+
+        std::map<std::string, ExtractedStencil> stencils;
+        for (const Elf64_Shdr &section: object.sections) {
+            std::string name = object.sectionName(section);
+            if (name.rfind(SECTION_PREFIX, 0) != 0) {
+                continue;
+            }
+            auto found = relocations.find(name);
+            std::string stencilName = name.substr(sizeof(SECTION_PREFIX) - 1);
+            stencils[stencilName] = extract(object, stencilName, section,
+                                            found == relocations.end() ? nullptr : found->second);
+        }
+        if (stencils.empty()) {
+            throw std::runtime_error(std::string("no ") + SECTION_PREFIX + "* sections; compile with -ffunction-sections");
+        }
+
+        std::ostringstream header;
+        write(header, stencils);
+        std::ofstream out(argv[2]);
+        out << header.str();
+        if (!out) {
+            throw std::runtime_error(std::string("cannot write ") + argv[2]);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "extractStencils: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,235 @@
+// Трафареты JIT-компилятора копированием и заплатками (CopyPatchJit.h).
+//
+// Каждая функция stencil_* - быстрый путь одной инструкции стекового байткода: те же функции
+// FastPath.h, что вызывают обработчики интерпретатора (vm.h), и выход в интерпретатор, если они
+// отказались. Файл компилируется при сборке с -mcmodel=large, поэтому каждое обращение
+// к внешнему символу HOLE_* становится 64-битной абсолютной константой с перемещением - дырой,
+// которую компилятор заполняет при копировании трафарета. Продолжение - хвостовой вызов
+// следующего трафарета с теми же аргументами, так что вершина стека, локальные переменные
+// и адрес ячейки vm::sp всё время остаются в регистрах аргументов. Медленный путь сохраняет
+// sp и возвращает адрес инструкции байткода: её выполняет обработчик интерпретатора.
+//
+// Трафарет не вызывает функций и не обращается к другим данным: extractStencils отказывается
+// от трафарета с любым другим перемещением или с вызовом продолжения вместо перехода.
+
+#include <cstdint>
+#include "EvaluationValue.h"
+#include "FastPath.h"
+#include "Global.h"
+
+#define STENCIL(name)                                                                  \
+    extern "C" uint8_t *stencil_##name(EvaluationValue *sp, [[maybe_unused]] EvaluationValue *locals, \
+                                       EvaluationValue **spSlot)
+
+extern "C" uint8_t *HOLE_CONTINUE(EvaluationValue *sp, EvaluationValue *locals, EvaluationValue **spSlot);
+extern "C" uint8_t *HOLE_TARGET(EvaluationValue *sp, EvaluationValue *locals, EvaluationValue **spSlot);
+extern "C" uint8_t HOLE_EXIT[];
+extern "C" uint8_t HOLE_OPERAND0[];
+extern "C" uint8_t HOLE_OPERAND1[];
+extern "C" uint8_t HOLE_OPERAND2[];
+
+namespace {
+    template<int n>
+    inline uint64_t operand() {
+        const uint8_t *hole = n == 0 ? HOLE_OPERAND0 : n == 1 ? HOLE_OPERAND1 : HOLE_OPERAND2;
+        return reinterpret_cast<uintptr_t>(hole);
+    }
+
+    // Значение-операнд (слово константы)
+    template<int n>
+    inline EvaluationValue value() {
+        EvaluationValue result;
+        result.bits = operand<n>();
+        return result;
+    }
+
+    // Выход в интерпретатор на текущую инструкцию; стек операндов не изменён
+    inline uint8_t *exit(EvaluationValue *sp, EvaluationValue **spSlot) {
+        *spSlot = sp;
+        return HOLE_EXIT;
+    }
+
+    template<uint8_t compareOp>
+    inline uint8_t *compare(EvaluationValue *sp, EvaluationValue *locals, EvaluationValue **spSlot) {
+        if (!smallNumbers(sp[-2], sp[-1])) {
+            return exit(sp, spSlot);
+        }
+        sp[-2].bits = compareSmall(compareOp, sp[-2], sp[-1]) ? EvaluationValue::TRUE_BITS
+                                                               : EvaluationValue::FALSE_BITS;
+        return HOLE_CONTINUE(sp - 1, locals, spSlot);
+    }
+
+    template<uint8_t compareOp>
+    inline uint8_t *jumpIfNot(EvaluationValue *sp, EvaluationValue *locals, EvaluationValue **spSlot) {
+        if (!smallNumbers(sp[-2], sp[-1])) {
+            return exit(sp, spSlot);
+        }
+        if (compareSmall(compareOp, sp[-2], sp[-1])) {
+            return HOLE_CONTINUE(sp - 2, locals, spSlot);
+        }
+        return HOLE_TARGET(sp - 2, locals, spSlot);
+    }
+}
+
+// Точка входа: vm передаёт адрес ячейки sp, локальные переменные и трафарет первой инструкции
+extern "C" uint8_t *stencil_ENTER(EvaluationValue **spSlot, EvaluationValue *locals, const void *start) {
+    auto first = reinterpret_cast<uint8_t *(*)(EvaluationValue *, EvaluationValue *, EvaluationValue **)>(
+        const_cast<void *>(start));
+    return first(*spSlot, locals, spSlot);
+}
+
+// Инструкция без быстрого пути
+STENCIL(EXIT) {
+    return exit(sp, spSlot);
+}
+
+// OPERAND0 - слово значения (OP_CONST, OP_CONST_LONG, OP_NIL)
+STENCIL(CONST) {
+    sp->bits = operand<0>();
+    return HOLE_CONTINUE(sp + 1, locals, spSlot);
+}
+
+// OPERAND0 - номер локальной переменной
+STENCIL(GET_LOCAL) {
+    *sp = locals[operand<0>()];
+    return HOLE_CONTINUE(sp + 1, locals, spSlot);
+}
+
+STENCIL(GET_LOCAL_LOCAL) {
+    sp[0] = locals[operand<0>()];
+    sp[1] = locals[operand<1>()];
+    return HOLE_CONTINUE(sp + 2, locals, spSlot);
+}
+
+STENCIL(SET_LOCAL) {
+    locals[operand<0>()] = sp[-1];
+    return HOLE_CONTINUE(sp - 1, locals, spSlot);
+}
+
+STENCIL(DUP) {
+    sp[0] = sp[-1];
+    return HOLE_CONTINUE(sp + 1, locals, spSlot);
+}
+
+STENCIL(POP) {
+    return HOLE_CONTINUE(sp - 1, locals, spSlot);
+}
+
+// OPERAND0 - адрес Global::globals (буфер может переехать), OPERAND1 - номер переменной
+STENCIL(GET_GLOBAL) {
+    const auto *globals = reinterpret_cast<const std::vector<GlobalVar> *>(operand<0>());
+    *sp = (*globals)[operand<1>()].value;
+    return HOLE_CONTINUE(sp + 1, locals, spSlot);
+}
+
+STENCIL(JUMP) {
+    return HOLE_TARGET(sp, locals, spSlot);
+}
+
+// Обратный переход; OPERAND0 - адрес ячейки трассы цикла (TraceJit.h). Цикл с трассой
+// продолжается в интерпретаторе, который её исполнит.
+STENCIL(LOOP_JUMP) {
+    if (*reinterpret_cast<const void *const *>(operand<0>()) != nullptr) {
+        return exit(sp, spSlot);
+    }
+    return HOLE_TARGET(sp, locals, spSlot);
+}
+
+STENCIL(JUMP_IF_FALSE) {
+    if (sp[-1].bits == EvaluationValue::FALSE_BITS) {
+        return HOLE_TARGET(sp - 1, locals, spSlot);
+    }
+    return HOLE_CONTINUE(sp - 1, locals, spSlot);
+}
+
+// Быстрый путь только для логических значений
+STENCIL(JUMP_IF_TRUE) {
+    if (sp[-1].bits == EvaluationValue::TRUE_BITS) {
+        return HOLE_TARGET(sp - 1, locals, spSlot);
+    }
+    if (sp[-1].bits == EvaluationValue::FALSE_BITS) {
+        return HOLE_CONTINUE(sp - 1, locals, spSlot);
+    }
+    return exit(sp, spSlot);
+}
+
+STENCIL(ADD) {
+    if (!addSmall(sp[-2], sp[-1], sp[-2])) {
+        return exit(sp, spSlot);
+    }
+    return HOLE_CONTINUE(sp - 1, locals, spSlot);
+}
+
+STENCIL(SUB) {
+    if (!subSmall(sp[-2], sp[-1], sp[-2])) {
+        return exit(sp, spSlot);
+    }
+    return HOLE_CONTINUE(sp - 1, locals, spSlot);
+}
+
+STENCIL(MUL) {
+    if (!mulSmall(sp[-2], sp[-1], sp[-2])) {
+        return exit(sp, spSlot);
+    }
+    return HOLE_CONTINUE(sp - 1, locals, spSlot);
+}
+
+// OPERAND0 - слово малого целого (константа OP_ADD_CONST, OP_SUB_CONST)
+STENCIL(ADD_CONST) {
+    if (!addSmall(sp[-1], value<0>(), sp[-1])) {
+        return exit(sp, spSlot);
+    }
+    return HOLE_CONTINUE(sp, locals, spSlot);
+}
+
+STENCIL(SUB_CONST) {
+    if (!subSmall(sp[-1], value<0>(), sp[-1])) {
+        return exit(sp, spSlot);
+    }
+    return HOLE_CONTINUE(sp, locals, spSlot);
+}
+
+// OPERAND0 - номер локальной переменной, OPERAND1 - слово малого целого
+STENCIL(INC_LOCAL) {
+    EvaluationValue &local = locals[operand<0>()];
+    if (!addSmall(local, value<1>(), local)) {
+        return exit(sp, spSlot);
+    }
+    return HOLE_CONTINUE(sp, locals, spSlot);
+}
+
+STENCIL(COMPARE_LT) { return compare<0>(sp, locals, spSlot); }
+STENCIL(COMPARE_GT) { return compare<1>(sp, locals, spSlot); }
+STENCIL(COMPARE_EQ) { return compare<2>(sp, locals, spSlot); }
+STENCIL(COMPARE_GE) { return compare<3>(sp, locals, spSlot); }
+STENCIL(COMPARE_LE) { return compare<4>(sp, locals, spSlot); }
+STENCIL(COMPARE_NE) { return compare<5>(sp, locals, spSlot); }
+
+STENCIL(JUMP_IF_NOT_LT) { return jumpIfNot<0>(sp, locals, spSlot); }
+STENCIL(JUMP_IF_NOT_GT) { return jumpIfNot<1>(sp, locals, spSlot); }
+STENCIL(JUMP_IF_NOT_EQ) { return jumpIfNot<2>(sp, locals, spSlot); }
+STENCIL(JUMP_IF_NOT_GE) { return jumpIfNot<3>(sp, locals, spSlot); }
+STENCIL(JUMP_IF_NOT_LE) { return jumpIfNot<4>(sp, locals, spSlot); }
+STENCIL(JUMP_IF_NOT_NE) { return jumpIfNot<5>(sp, locals, spSlot); }
+
+STENCIL(ARRAY_GET) {
+    if (!getNumberElement(sp[-2], sp[-1], sp[-2])) {
+        return exit(sp, spSlot);
+    }
+    return HOLE_CONTINUE(sp - 1, locals, spSlot);
+}
+
+// OPERAND0 и OPERAND1 - номера локальных переменных массива и индекса
+STENCIL(ARRAY_GET_LOCAL_LOCAL) {
+    if (!getNumberElement(locals[operand<0>()], locals[operand<1>()], *sp)) {
+        return exit(sp, spSlot);
+    }
+    return HOLE_CONTINUE(sp + 1, locals, spSlot);
+}
+
+STENCIL(ARRAY_SET) {
+    if (!setNumberElement(sp[-3], sp[-2], sp[-1])) {
+        return exit(sp, spSlot);
+    }
+    return HOLE_CONTINUE(sp - 3, locals, spSlot);
+}
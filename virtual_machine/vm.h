@@ -1,12 +1,35 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <vector>
 #include <string>
 #include <memory>
 #include "parser.h"
 #include "EvaluationValue.h"
 #include "bytecodeGenerator.h"
+#include "registerGenerator.h"
 #include "Global.h"
+#include "FastPath.h"
+#include "Jit.h"
+#include "TraceJit.h"
+#include "CopyPatchJit.h"
+#include "Tiering.h"
+
+// Способ диспетчеризации байткода выбирается при сборке (опция CMake VM_COMPUTED_GOTO).
+// По умолчанию на GCC/Clang используется шитый код через computed goto.
+#ifndef VM_USE_COMPUTED_GOTO
+#if defined(__GNUC__) || defined(__clang__)
+#define VM_USE_COMPUTED_GOTO 1
+#else
+#define VM_USE_COMPUTED_GOTO 0
+#endif
+#endif
+
+// Подсчёт выполненных инструкций по опкодам (для бенчмарков и профилирования).
+#ifndef VM_PROFILE_OPCODES
+#define VM_PROFILE_OPCODES 0
+#endif
 
 
 struct CallFrame;
@@ -64,6 +87,31 @@ static void handleArraySet(vm *machine, CallFrame &frame, uint8_t *&ip);
 
 static void handleNil(vm *machine, CallFrame &frame, uint8_t *&ip);
 
+static void handlePop(vm *machine, CallFrame &frame, uint8_t *&ip);
+
+static void handleGetGlobalLong(vm *machine, CallFrame &frame, uint8_t *&ip);
+
+static void handleSetGlobalLong(vm *machine, CallFrame &frame, uint8_t *&ip);
+
+static void handleConstLong(vm *machine, CallFrame &frame, uint8_t *&ip);
+
+static void handleArrayLiteral(vm *machine, CallFrame &frame, uint8_t *&ip);
+
+static void handleJumpIfTrue(vm *machine, CallFrame &frame, uint8_t *&ip);
+
+static void handleGetLocalLocal(vm *machine, CallFrame &frame, uint8_t *&ip);
+
+static void handleAddConst(vm *machine, CallFrame &frame, uint8_t *&ip);
+
+static void handleSubConst(vm *machine, CallFrame &frame, uint8_t *&ip);
+
+static void handleIncLocal(vm *machine, CallFrame &frame, uint8_t *&ip);
+
+static void handleArrayGetLocalLocal(vm *machine, CallFrame &frame, uint8_t *&ip);
+
+template<uint8_t opcode>
+static void handleJumpIfNot(vm *machine, CallFrame &frame, uint8_t *&ip);
+
 
 static InstructionHandler handlers[0xFF + 1] = {
     handleHalt,
@@ -89,62 +137,529 @@ static InstructionHandler handlers[0xFF + 1] = {
     handleArray,
     handleArrayGet,
     handleArraySet,
-
+    handlePop,
+    handleGetGlobalLong,
+    handleSetGlobalLong,
+    handleConstLong,
+    handleArrayLiteral,
+    handleJumpIfTrue,
+    handleGetLocalLocal,
+    handleAddConst,
+    handleSubConst,
+    handleIncLocal,
+    handleArrayGetLocalLocal,
+    handleJumpIfNot<OP_JUMP_IF_NOT_LT>,
+    handleJumpIfNot<OP_JUMP_IF_NOT_GT>,
+    handleJumpIfNot<OP_JUMP_IF_NOT_EQ>,
+    handleJumpIfNot<OP_JUMP_IF_NOT_GE>,
+    handleJumpIfNot<OP_JUMP_IF_NOT_LE>,
+    handleJumpIfNot<OP_JUMP_IF_NOT_NE>,
 };
 
 
 struct CallFrame {
     CodeObject *co; // Pointer to the function's CodeObject
     uint8_t *ip; // Instruction pointer within the function's bytecode
-    std::vector<EvaluationValue> locals; // Local variables for the function
-
-    CallFrame(CodeObject *codeObject)
-        : co(codeObject), ip(codeObject->code.data()) {
-        int maxSlot = -1;
-        for (const auto &pair: co->localNames) {
-            if (pair.first > maxSlot) {
-                maxSlot = pair.first;
-            }
-        }
+    EvaluationValue *locals; // Local variables: a window on the operand stack, arguments first
 
-        locals.resize(maxSlot + 1, NIL());
+    CallFrame(CodeObject *codeObject, EvaluationValue *locals)
+        : co(codeObject), ip(codeObject->code.data()), locals(locals) {
     }
 };
 
 class vm {
 public:
-    vm() : global(std::make_shared<Global>()),
-           _parser(std::make_unique<syntax::parser>()),
-           _bytecodeGenerator(std::make_unique<bytecodeGenerator>(global)), disassembler(std::make_unique<Disassembler>(global)) {
+    // Ёмкость стека операндов по умолчанию (в значениях)
+    static constexpr size_t DEFAULT_STACK_SIZE = 256 * 1024;
+
+    // Глубина вызовов, под которую callStack резервируется заранее
+    static constexpr size_t INITIAL_CALL_DEPTH = 1024;
+
+    explicit vm(size_t stackSize = DEFAULT_STACK_SIZE, CompilerOptions compilerOptions = {})
+        : global(std::make_shared<Global>()),
+          stack(stackSize),
+          _parser(std::make_unique<syntax::parser>()),
+          _bytecodeGenerator(std::make_unique<bytecodeGenerator>(global, compilerOptions)),
+          _registerGenerator(std::make_unique<registerGenerator>(global, compilerOptions)),
+          backend(compilerOptions.backend),
+          jitCache(global),
+          stencilJit(global),
+          useStencils(compilerOptions.jitCompiler == JitCompiler::STENCILS && StencilJit::available()),
+          jitEnabled(compilerOptions.jit && JitCache::available() && !VM_PROFILE_OPCODES),
+          tiering(compilerOptions.jitThreshold, compilerOptions.osrThreshold),
+          traceCache(global),
+          tracingEnabled(compilerOptions.traces && JitCache::available() && !VM_PROFILE_OPCODES),
+          traceThreshold(compilerOptions.traceThreshold),
+          disassembler(std::make_unique<Disassembler>(global)) {
+        sp = stack.data();
+        stackLimit = stack.data() + stack.size();
+        callStack.reserve(INITIAL_CALL_DEPTH);
+
+        Heap::Scope heapScope(heap);
         setGlobalVariables();
-        initializeBuiltins();
     }
 
+    // Результат остаётся действительным до конца следующего вызова exec: объекты,
+    // недостижимые из глобальных переменных, после этого может освободить сборщик мусора
     EvaluationValue exec(const std::string &program) {
-        stack.clear();
+        Heap::Scope heapScope(heap);
+        sp = stack.data();
+        callStack.clear();
+
+        {
+            // Константы сразу попадают в старое поколение кучи
+            Heap::TenuredScope tenured(heap);
+            Exp *ast = _parser->parse(program);
+            co = backend == Backend::REGISTER ? _registerGenerator->compile(*ast, _parser->arena)
+                                              : _bytecodeGenerator->compile(*ast, _parser->arena);
+            // После компиляции AST не нужен: память арены освобождается целиком
+            _parser->releaseAst();
+        }
+        checkStackSpace(co);
+
+        // Локальные переменные main лежат в самом низу стека операндов
+        EvaluationValue *locals = sp;
+        std::fill(sp, sp + co->localCount, NIL());
+        sp += co->localCount;
 
-        std::shared_ptr<Exp> ast = _parser->parse(program);
-        co = _bytecodeGenerator->compile(*ast);
+        callStack.emplace_back(co, locals);
 
 
-        for (const auto &builtin: global->builtinFunctions) {
-            defineBuiltin(builtin.first);
+        /*_bytecodeGenerator->disassembleBytecode();*/
+
+        lastResult = co->registerBased ? evalRegisters() : evalExp();
+        // Молодые объекты перемещаются при сборке, поэтому результат, который хранит
+        // вызывающий код, переносится в старое поколение заранее
+        if (heap.isYoung(lastResult)) {
+            collectYoung();
         }
+        return lastResult;
+    }
 
+    // Малая сборка: живые молодые объекты переносятся в старое поколение. Корни: стек
+    // операндов, результат последнего exec, глобальные переменные и старые объекты,
+    // отмеченные барьером записи. Объекты кода и константы всегда старые.
+    void collectYoung() {
+        heap.beginYoungCollection();
 
-        callStack.emplace_back(co);
+        for (EvaluationValue *slot = stack.data(); slot < sp; ++slot) {
+            heap.evacuate(*slot);
+        }
+        heap.evacuate(lastResult);
+        for (size_t index: rememberedGlobals) {
+            GlobalVar &globalVar = global->globals[index];
+            globalVar.remembered = false;
+            heap.evacuate(globalVar.value);
+        }
+        rememberedGlobals.clear();
 
+        heap.finishYoungCollection();
+    }
 
-        CallFrame &currentFrame = callStack.back();
-        currentFrame.ip = currentFrame.co->code.data();
+    // Полная сборка мусора за одну паузу; начатый инкрементальный цикл сначала
+    // доводится до конца, чтобы освободить и то, что стало мусором во время него
+    void collectGarbage() {
+        heap.beginPause();
+        completeCollection();
+        // Сначала молодое поколение: после этого все живые объекты - старые
+        collectYoung();
+        heap.startMarking();
+        finishMarking();
+        heap.sweepAll();
+        heap.endPause();
+    }
 
+    // Порция инкрементальной сборки: начало цикла, разметка или очистка
+    void collectIncrementally() {
+        if (heap.exceedsLimit()) {
+            completeCollection();
+            return;
+        }
+        switch (heap.phase()) {
+            case Heap::Phase::IDLE:
+                heap.startMarking();
+                markRoots();
+                break;
+            case Heap::Phase::MARKING:
+                if (heap.markSlice()) {
+                    collectYoung();
+                    finishMarking();
+                }
+                break;
+            case Heap::Phase::SWEEPING:
+                heap.sweepSlice();
+                break;
+        }
+    }
 
-        /*_bytecodeGenerator->disassembleBytecode();*/
+    // Безопасная точка сборки: вызывается в конце инструкций, создающих объекты,
+    // когда все живые значения уже лежат на стеке, во фреймах или в глобальных переменных
+    void collectIfNeeded() {
+        if (!heap.needsYoungCollection() && !heap.needsCollection()) {
+            return;
+        }
+        heap.beginPause();
+        if (heap.needsYoungCollection()) {
+            collectYoung();
+        }
+        if (heap.needsCollection()) {
+            if (heap.incremental()) {
+                collectIncrementally();
+            } else {
+                collectGarbage();
+            }
+        }
+        heap.endPause();
+    }
 
-        return evalExp();
+    // Запись глобальной переменной с барьером: слот со ссылкой на молодой объект
+    // становится корнем малой сборки
+    void setGlobal(size_t index, const EvaluationValue &value) {
+        GlobalVar &globalVar = global->globals[index];
+        globalVar.value = value;
+        // Функция в слоте могла смениться: кэши мест вызова этого слота больше не действительны
+        globalVar.version++;
+        if (heap.isYoung(value) && !globalVar.remembered) {
+            globalVar.remembered = true;
+            rememberedGlobals.push_back(index);
+        }
     }
 
+    // Промах кэша места вызова: проверяет, что funcVal можно вызвать с argCount аргументами,
+    // и запоминает её в кэше
+    void resolveCall(CallCache &cache, EvaluationValue funcVal, uint8_t argCount) {
+        if (!funcVal.isHeapReference() || funcVal.object() == nullptr) {
+            throw std::runtime_error("Attempting to call a non-function.");
+        }
+        switch (funcVal.object()->type) {
+            case ObjectType::CODE:
+                if (argCount > AS_CODE(funcVal)->arity) {
+                    throw std::runtime_error("Слишком много аргументов при вызове функции.");
+                }
+                break;
+            case ObjectType::NATIVE: {
+                NativeObject *native = AS_NATIVE(funcVal);
+                if (native->arity >= 0 && argCount != native->arity) {
+                    throw std::runtime_error("Функция " + native->name + " ожидает аргументов: " +
+                                             std::to_string(native->arity) + ".");
+                }
+                break;
+            }
+            default:
+                throw std::runtime_error("Attempting to call a non-function.");
+        }
+        callCacheMisses++;
+        cache.callee = funcVal.bits;
+        cache.version = global->globals[cache.slot].version;
+        cache.native = funcVal.object()->type == ObjectType::NATIVE;
+    }
+
+    // Учёт роста буфера массива; буфер молодого массива учитывается при переносе
+    // в старое поколение
+    void arrayGrown(ArrayObject *array, size_t sizeBefore) {
+        size_t sizeAfter = Heap::objectSize(array);
+        if (!heap.isYoung(array) && sizeAfter > sizeBefore) {
+            heap.account(sizeAfter - sizeBefore);
+        }
+        collectIfNeeded();
+    }
+
+    // Переводит массив чисел в общий вид; большие числа становятся объектами кучи
+    void generalizeArray(ArrayObject *array) {
+        size_t sizeBefore = Heap::objectSize(array);
+        array->elements.reserve(array->numbers.size());
+        for (int64_t number: array->numbers) {
+            EvaluationValue value = NUMBER(number);
+            heap.writeBarrier(array, value);
+            array->elements.push_back(value);
+        }
+        array->numbers = std::vector<int64_t>();
+        array->kind = ArrayObject::Kind::GENERIC;
+
+        size_t sizeAfter = Heap::objectSize(array);
+        if (!heap.isYoung(array) && sizeAfter > sizeBefore) {
+            heap.account(sizeAfter - sizeBefore);
+        }
+    }
+
+    // Кладёт на стек результат, который мог быть только что создан в куче
+    void pushNew(const EvaluationValue &value) {
+        push(value);
+        if (value.isHeapReference()) {
+            collectIfNeeded();
+        }
+    }
+
+    const GcStats &gcStats() const {
+        return heap.stats();
+    }
+
+    // Длительности всех остановок программы сборщиком
+    const PauseHistogram &gcPauseHistogram() const {
+        return heap.stats().pauseHistogram;
+    }
+
+    // Корни сборки старого поколения: стек операндов, объекты кода во фреймах, глобальные
+    // переменные, текущая программа и результат последнего exec. Константы достижимы
+    // через объекты кода.
+    void markRoots() {
+        for (EvaluationValue *slot = stack.data(); slot < sp; ++slot) {
+            heap.markValue(*slot);
+        }
+        for (const CallFrame &frame: callStack) {
+            heap.markObject(frame.co);
+        }
+        for (const GlobalVar &globalVar: global->globals) {
+            heap.markValue(globalVar.value);
+        }
+        if (co != nullptr) {
+            heap.markObject(co);
+        }
+        heap.markValue(lastResult);
+    }
+
+    // Конец разметки (молодое поколение пусто): корни просматриваются ещё раз, потому что
+    // стек и глобальные переменные меняются без барьера, затем начинается очистка
+    void finishMarking() {
+        markRoots();
+        heap.traceReferences();
+        heap.startSweeping();
+    }
 
+    // Завершает начатый инкрементальный цикл без ограничения по времени
+    void completeCollection() {
+        if (heap.phase() == Heap::Phase::MARKING) {
+            collectYoung();
+            finishMarking();
+        }
+        if (heap.phase() == Heap::Phase::SWEEPING) {
+            heap.sweepAll();
+        }
+    }
+
+
+#if VM_USE_COMPUTED_GOTO
+    // Прямой шитый код (labels-as-values GCC/Clang): ip и текущий фрейм живут в локальных
+    // переменных и перечитываются из callStack только на CALL/RETURN.
+    EvaluationValue evalExp() {
+        static void *dispatchTable[0xFF + 1] = {
+            &&op_halt,
+            &&op_const,
+            &&op_add,
+            &&op_sub,
+            &&op_mul,
+            &&op_div,
+            &&op_compare,
+            &&op_jump_if_false,
+            &&op_jump,
+            &&op_get_global,
+            &&op_set_global,
+            &&op_get_local,
+            &&op_set_local,
+            &&op_logical_not,
+            &&op_jump_if_false_or_pop,
+            &&op_jump_if_true_or_pop,
+            &&op_dup,
+            &&op_nil,
+            &&op_call,
+            &&op_return,
+            &&op_array,
+            &&op_array_get,
+            &&op_array_set,
+            &&op_pop,
+            &&op_get_global_long,
+            &&op_set_global_long,
+            &&op_const_long,
+            &&op_array_literal,
+            &&op_jump_if_true,
+            &&op_get_local_local,
+            &&op_add_const,
+            &&op_sub_const,
+            &&op_inc_local,
+            &&op_array_get_local_local,
+            &&op_jump_if_not_lt,
+            &&op_jump_if_not_gt,
+            &&op_jump_if_not_eq,
+            &&op_jump_if_not_ge,
+            &&op_jump_if_not_le,
+            &&op_jump_if_not_ne,
+        };
+
+        CallFrame *frame = &callStack.back();
+        uint8_t *ip = frame->ip;
+
+#if VM_PROFILE_OPCODES
+#define DISPATCH() do { countOpcode(*ip); goto *dispatchTable[*ip++]; } while (false)
+#else
+#define DISPATCH() goto *dispatchTable[*ip++]
+#endif
+
+        DISPATCH();
+
+    op_halt:
+        handleHalt(this, *frame, ip);
+        goto done;
+    op_const:
+        handleConst(this, *frame, ip);
+        DISPATCH();
+    op_add:
+        handleAdd(this, *frame, ip);
+        DISPATCH();
+    op_sub:
+        handleSub(this, *frame, ip);
+        DISPATCH();
+    op_mul:
+        handleMul(this, *frame, ip);
+        DISPATCH();
+    op_div:
+        handleDiv(this, *frame, ip);
+        DISPATCH();
+    op_compare:
+        handleCompare(this, *frame, ip);
+        DISPATCH();
+    op_jump_if_false:
+        handleJumpIfFalse(this, *frame, ip);
+        DISPATCH();
+    op_jump: {
+        uint8_t *from = ip;
+        handleJump(this, *frame, ip);
+        // Обратный переход ведёт в заголовок цикла: горячий цикл продолжается в трассе
+        // или в машинном коде
+        if (ip < from) {
+            ip = enterLoop(*frame, ip);
+            if (tierUpInLoop(frame->co)) {
+                goto run_native;
+            }
+        }
+        DISPATCH();
+    }
+    op_get_global:
+        handleGetGlobal(this, *frame, ip);
+        DISPATCH();
+    op_set_global:
+        handleSetGlobal(this, *frame, ip);
+        DISPATCH();
+    op_get_local:
+        handleGetLocal(this, *frame, ip);
+        DISPATCH();
+    op_set_local:
+        handleSetLocal(this, *frame, ip);
+        DISPATCH();
+    op_logical_not:
+        handleLogicalNot(this, *frame, ip);
+        DISPATCH();
+    op_jump_if_false_or_pop:
+        handleJumpIfFalseOrPop(this, *frame, ip);
+        DISPATCH();
+    op_jump_if_true_or_pop:
+        handleJumpIfTrueOrPop(this, *frame, ip);
+        DISPATCH();
+    op_dup:
+        handleDup(this, *frame, ip);
+        DISPATCH();
+    op_nil:
+        handleNil(this, *frame, ip);
+        DISPATCH();
+    op_call: {
+        // handleCall может добавить фрейм (и переразместить callStack), поэтому ip вызывающего
+        // сохраняем по индексу, а текущий фрейм перечитываем.
+        size_t callerDepth = callStack.size();
+        handleCall(this, *frame, ip);
+        callStack[callerDepth - 1].ip = ip;
+        frame = &callStack.back();
+        ip = frame->ip;
+        if (callStack.size() > callerDepth && tierUpOnCall(frame->co)) {
+            goto run_native;
+        }
+        DISPATCH();
+    }
+    op_return:
+        handleReturn(this, *frame, ip);
+        if (callStack.empty()) {
+            goto done;
+        }
+        frame = &callStack.back();
+        ip = frame->ip;
+        if (frame->co->native != nullptr) {
+            goto run_native;
+        }
+        DISPATCH();
+    op_array:
+        handleArray(this, *frame, ip);
+        DISPATCH();
+    op_array_get:
+        handleArrayGet(this, *frame, ip);
+        DISPATCH();
+    op_array_set:
+        handleArraySet(this, *frame, ip);
+        DISPATCH();
+    op_pop:
+        handlePop(this, *frame, ip);
+        DISPATCH();
+    op_get_global_long:
+        handleGetGlobalLong(this, *frame, ip);
+        DISPATCH();
+    op_set_global_long:
+        handleSetGlobalLong(this, *frame, ip);
+        DISPATCH();
+    op_const_long:
+        handleConstLong(this, *frame, ip);
+        DISPATCH();
+    op_array_literal:
+        handleArrayLiteral(this, *frame, ip);
+        DISPATCH();
+    op_jump_if_true:
+        handleJumpIfTrue(this, *frame, ip);
+        DISPATCH();
+    op_get_local_local:
+        handleGetLocalLocal(this, *frame, ip);
+        DISPATCH();
+    op_add_const:
+        handleAddConst(this, *frame, ip);
+        DISPATCH();
+    op_sub_const:
+        handleSubConst(this, *frame, ip);
+        DISPATCH();
+    op_inc_local:
+        handleIncLocal(this, *frame, ip);
+        DISPATCH();
+    op_array_get_local_local:
+        handleArrayGetLocalLocal(this, *frame, ip);
+        DISPATCH();
+    op_jump_if_not_lt:
+        handleJumpIfNot<OP_JUMP_IF_NOT_LT>(this, *frame, ip);
+        DISPATCH();
+    op_jump_if_not_gt:
+        handleJumpIfNot<OP_JUMP_IF_NOT_GT>(this, *frame, ip);
+        DISPATCH();
+    op_jump_if_not_eq:
+        handleJumpIfNot<OP_JUMP_IF_NOT_EQ>(this, *frame, ip);
+        DISPATCH();
+    op_jump_if_not_ge:
+        handleJumpIfNot<OP_JUMP_IF_NOT_GE>(this, *frame, ip);
+        DISPATCH();
+    op_jump_if_not_le:
+        handleJumpIfNot<OP_JUMP_IF_NOT_LE>(this, *frame, ip);
+        DISPATCH();
+    op_jump_if_not_ne:
+        handleJumpIfNot<OP_JUMP_IF_NOT_NE>(this, *frame, ip);
+        DISPATCH();
+
+    // Машинный код возвращает управление на CALL, RETURN или HALT текущего фрейма
+    run_native:
+        ip = runNative(*frame, ip);
+        DISPATCH();
+
+#undef DISPATCH
+
+    done:
+        if (sp == stack.data()) {
+            return NIL();
+        }
+        return pop();
+    }
+#else
+    // Переносимый вариант: диспетчеризация через таблицу handlers.
     EvaluationValue evalExp() {
         while (!callStack.empty()) {
             CallFrame &currentFrame = callStack.back();
@@ -152,21 +667,158 @@ public:
 
 
             uint8_t op_code = *ip++;
+#if VM_PROFILE_OPCODES
+            countOpcode(op_code);
+#endif
+            size_t depth = callStack.size();
+            uint8_t *from = ip;
             handlers[op_code](this, currentFrame, ip);
 
 
             if (callStack.empty()) {
                 break;
             }
+
+            // После вызова, возврата и обратного перехода фрейм может продолжиться в машинном коде
+            if (op_code == OP_CALL || op_code == OP_RETURN || op_code == OP_JUMP) {
+                CallFrame &frame = callStack.back();
+                if (op_code == OP_JUMP && frame.ip < from) {
+                    frame.ip = enterLoop(frame, frame.ip);
+                }
+                bool native = op_code == OP_CALL ? callStack.size() > depth && tierUpOnCall(frame.co)
+                            : op_code == OP_RETURN ? frame.co->native != nullptr
+                            : frame.ip < from && tierUpInLoop(frame.co);
+                if (native) {
+                    frame.ip = runNative(frame, frame.ip);
+                }
+            }
         }
 
 
-        if (stack.empty()) {
+        if (sp == stack.data()) {
             return NIL();
         }
         return pop();
     }
+#endif
+
+    // Цикл исполнения регистрового кода (Backend::REGISTER), определён в конце файла
+    EvaluationValue evalRegisters();
+
+    // Вызов объекта кода; на пороге вызовов он компилируется в машинный код (Tiering.h).
+    // Возвращает true, если у объекта кода есть машинный код.
+    bool tierUpOnCall(CodeObject *codeObject) {
+        if (codeObject->native != nullptr) {
+            return true;
+        }
+        if (!jitEnabled || !tiering.hotCall(codeObject) || !compileNative(codeObject)) {
+            return false;
+        }
+        tieringStats.promotedOnCall++;
+        return true;
+    }
 
+    // Обратный переход в объекте кода; на пороге обратных переходов он компилируется,
+    // и фрейм продолжается в машинном коде с заголовка цикла (on-stack replacement)
+    bool tierUpInLoop(CodeObject *codeObject) {
+        if (codeObject->native != nullptr) {
+            return true;
+        }
+        if (!jitEnabled || !tiering.hotBackEdge(codeObject) || !compileNative(codeObject)) {
+            return false;
+        }
+        tieringStats.promotedInLoop++;
+        return true;
+    }
+
+    // Компилирует объект кода выбранным компилятором; false, если памяти под код нет
+    bool compileNative(CodeObject *codeObject) {
+        JitCache::TraceSlot traceSlot;
+        if (tracingEnabled) {
+            LoopTable &loops = traceCache.loops(codeObject);
+            traceSlot = [&loops](size_t header) {
+                return static_cast<const void *>(&loops.at(header).trace);
+            };
+        }
+        codeObject->native = useStencils ? stencilJit.compile(codeObject, traceSlot)
+                                         : jitCache.compile(codeObject, traceSlot);
+        if (codeObject->native == nullptr) {
+            // Исполняемую память получить не удалось: дальше работает только интерпретатор
+            jitEnabled = false;
+            return false;
+        }
+        return true;
+    }
+
+    // Исполняет фрейм в машинном коде начиная с ip. Инструкции, для которых шаблон выбрал
+    // медленный путь, выполняет обработчик, после чего машинный код продолжается. Возвращает
+    // адрес CALL, RETURN или HALT: они меняют стек вызовов и выполняются в evalExp.
+    uint8_t *runNative(CallFrame &frame, uint8_t *ip) {
+        const NativeCode *native = frame.co->native;
+        for (;;) {
+            ip = native->run(&sp, frame.locals, ip);
+            uint8_t opcode = *ip;
+            if (opcode == OP_CALL || opcode == OP_RETURN || opcode == OP_HALT) {
+                return ip;
+            }
+            ip++;
+            uint8_t *from = ip;
+            handlers[opcode](this, frame, ip);
+            // Машинный код выходит на обратном переходе, если у цикла есть трасса
+            if (opcode == OP_JUMP && ip < from) {
+                ip = enterLoop(frame, ip);
+            }
+        }
+    }
+
+    // Обратный переход в заголовок цикла header. Если у цикла есть трасса, исполняет её;
+    // иначе считает переходы и на пороге traceThreshold записывает трассу. Возвращает адрес
+    // инструкции, с которой продолжается исполнение.
+    uint8_t *enterLoop(CallFrame &frame, uint8_t *header) {
+        if (!tracingEnabled) {
+            return header;
+        }
+        LoopHeader &loop = traceCache.loops(frame.co).at(header - frame.co->code.data());
+        if (loop.trace != nullptr) {
+            uint8_t *resume = loop.trace->run(&sp, frame.locals);
+            if (++loop.entries >= TraceCache::PROBATION && frame.co->native != nullptr &&
+                loop.iterations < loop.entries * TraceCache::MIN_ITERATIONS) {
+                // Цикл продолжается в базовом машинном коде
+                traceCache.retire(loop);
+            }
+            return resume;
+        }
+        if (loop.aborts >= TraceCache::MAX_ABORTS || ++loop.hotness < traceThreshold) {
+            return header;
+        }
+        loop.hotness = 0;
+        return recordTrace(frame, header, loop);
+    }
+
+    // Исполняет обработчиками одну итерацию цикла с записью. Если исполнение вернулось
+    // в заголовок, трасса компилируется и сразу продолжает цикл; иначе запись прерывается
+    // и интерпретатор продолжает с текущей инструкции.
+    uint8_t *recordTrace(CallFrame &frame, uint8_t *header, LoopHeader &loop) {
+        TraceRecorder recorder(frame.co, header, traceCache.directAccess());
+        uint8_t *ip = header;
+        while (recorder.record(ip, sp, frame.locals)) {
+            uint8_t opcode = *ip++;
+            handlers[opcode](this, frame, ip);
+            if (ip != recorder.expectedNext()) {
+                break;
+            }
+            if (recorder.closed()) {
+                loop.trace = traceCache.compile(frame.co, loop, recorder);
+                if (loop.trace == nullptr) {
+                    tracingEnabled = false;
+                    return ip;
+                }
+                return loop.trace->run(&sp, frame.locals);
+            }
+        }
+        loop.aborts++;
+        return ip;
+    }
 
     void setGlobalVariables() {
         global->setGlobalVariables();
@@ -193,8 +845,16 @@ public:
     }
 
 
+    // push/pop/peek не проверяют границы: число локальных переменных и глубина стека каждого
+    // объекта кода известны при компиляции и проверяются один раз при входе во фрейм (checkStackSpace).
     void push(const EvaluationValue &value) {
-        stack.push_back(value);
+        *sp++ = value;
+    }
+
+    void checkStackSpace(const CodeObject *codeObject) {
+        if (static_cast<size_t>(stackLimit - sp) < codeObject->localCount + codeObject->maxStackDepth) {
+            throw std::runtime_error("Stack overflow.");
+        }
     }
 
     uint16_t READ_SHORT(uint8_t *&ip) {
@@ -204,19 +864,11 @@ public:
     }
 
     EvaluationValue pop() {
-        if (stack.empty()) {
-            throw std::runtime_error("Stack empty.");
-        }
-        EvaluationValue val = stack.back();
-        stack.pop_back();
-        return val;
+        return *--sp;
     }
 
     EvaluationValue peek() {
-        if (stack.empty()) {
-            throw std::runtime_error("Stack empty.");
-        }
-        return stack.back();
+        return sp[-1];
     }
 
     uint8_t READ_BYTE(uint8_t *&ip) {
@@ -227,174 +879,89 @@ public:
         return co->constants[READ_BYTE(ip)];
     }
 
-    void initializeBuiltins() {
-        for (const auto &[name, func]: global->builtinFunctions) {
-            // Создание CodeObject для встроенной функции
-            CodeObject *codeObj = new CodeObject(name);
-            builtins[name] = codeObj;
+    // Объявлена первой, чтобы освобождаться последней
+    Heap heap;
 
-            // Добавление в глобальные переменные
-            int globalIdx = global->getGlobalIndex(name);
-            if (globalIdx == -1) {
-                global->define(name);
-                globalIdx = global->getGlobalIndex(name);
-            }
-            global->set(globalIdx, ALLOC_CODE(name));
-        }
-    }
-
-    void defineBuiltin(const std::string &name) {
-        int globalIdx = global->getGlobalIndex(name);
-        if (globalIdx == -1) {
-            throw std::runtime_error("Не удалось определить встроенную функцию: " + name);
-        }
-        // Привязка CodeObject к встроенной функции
-        CodeObject *codeObj = builtins[name];
-        global->globals[globalIdx].value = ALLOC_CODE(name);
-        AS_CODE(global->globals[globalIdx].value)->name = name;
-        AS_CODE(global->globals[globalIdx].value)->constants.push_back(NUMBER(0)); // Placeholder
-    }
-
-    CodeObject *optimizeBytecode(CodeObject *originalCo) {
-        CodeObject *optimizedCo = new CodeObject(originalCo->name + "_optimized");
-        optimizedCo->constants = originalCo->constants;
-        optimizedCo->code = originalCo->code;
-        optimizedCo->localNames = originalCo->localNames;
-
-        /*std::cout << "before optimization:\n";
-        disassembler->disassemble(originalCo);*/
-
-
-        eliminateUnreachableCode(optimizedCo);
-        eliminateRedundantLoadsAndStores(optimizedCo);
-
-        /*std::cout << "after optimization:\n";
-        disassembler->disassemble(optimizedCo);*/
-
-        return optimizedCo;
-    }
-
-    void eliminateUnreachableCode(CodeObject *co) {
-        std::vector<uint8_t> &code = co->code;
-        std::vector<uint8_t> optimizedCode;
-        size_t i = 0;
-
-        while (i < code.size()) {
-            uint8_t opcode = code[i];
-            optimizedCode.emplace_back(opcode);
-            size_t instrLen = 1;
-
-            // Определяем длину текущей инструкции
-            switch (opcode) {
-                case OP_JUMP:
-                case OP_JUMP_IF_FALSE:
-                case OP_JUMP_IF_FALSE_OR_POP:
-                case OP_JUMP_IF_TRUE_OR_POP:
-                    if (i + 2 >= code.size()) {
-                        throw std::runtime_error("Invalid jump instruction length in eliminateUnreachableCode.");
-                    }
-                    instrLen = 3;
-                    for (int j = 1; j < instrLen; ++j) {
-                        optimizedCode.emplace_back(code[i + j]);
-                    }
-                    break;
-                case OP_CONST:
-                case OP_GET_LOCAL:
-                case OP_SET_LOCAL:
-                case OP_GET_GLOBAL:
-                case OP_SET_GLOBAL:
-                case OP_LOGICAL_NOT:
-                case OP_DUP:
-                case OP_CALL:
-                    instrLen = 2;
-                    if (i + 1 >= code.size()) {
-                        throw std::runtime_error("Invalid instruction length in eliminateUnreachableCode.");
-                    }
-                    optimizedCode.emplace_back(code[i + 1]);
-                    break;
-                case OP_ADD:
-                case OP_SUB:
-                case OP_MUL:
-                case OP_DIV:
-                case OP_COMPARE:
-                case OP_ARRAY:
-                case OP_ARRAY_GET:
-                case OP_ARRAY_SET:
-                case OP_NIL:
-                case OP_HALT:
-                case OP_RETURN:
-                    instrLen = 1;
-                    break;
-                default:
-                    throw std::runtime_error(
-                        "Unknown opcode encountered in eliminateUnreachableCode: " + std::to_string(opcode));
-            }
+    std::shared_ptr<Global> global;
 
-            // Проверяем, является ли текущая инструкция завершением выполнения
-            if (opcode == OP_RETURN || opcode == OP_HALT) {
-                // Любой код после этой инструкции считается недостижимым
-                break;
-            }
+    // Число промахов кэшей мест вызова
+    size_t callCacheMisses = 0;
 
-            i += instrLen;
-        }
 
-        // Устанавливаем оптимизированный байткод
-        co->code = optimizedCode;
-    }
+    // Стек операндов фиксированной ёмкости; sp указывает на первую свободную ячейку.
+    // Локальные переменные каждого фрейма лежат в нём же, под временными значениями фрейма.
+    std::vector<EvaluationValue> stack;
 
+    EvaluationValue *sp;
 
-    void eliminateRedundantLoadsAndStores(CodeObject *co) {
-        // удаление избыточных загрузок/сохранений
-        std::vector<uint8_t> &code = co->code;
-        bool changed = true;
+    EvaluationValue *stackLimit;
 
-        while (changed) {
-            changed = false;
-            for (size_t i = 0; i + 2 < code.size(); i++) {
-                if (code[i] == OP_GET_LOCAL && code[i + 2] == OP_SET_LOCAL) {
-                    uint8_t local1 = code[i + 1];
-                    uint8_t local2 = code[i + 3];
-                    if (local1 == local2) {
-                        // Если сразу после GET_LOCAL x идёт SET_LOCAL x без использования значения,
-                        // убираем GET_LOCAL
-                        code.erase(code.begin() + i, code.begin() + i + 2);
-                        changed = true;
-                        break;
-                    }
-                }
-            }
-        }
-    }
+    std::unique_ptr<syntax::parser> _parser;
 
+    CodeObject *co = nullptr;
 
-    std::vector<EvaluationValue> locals;
+    EvaluationValue lastResult;
 
+    // Глобальные переменные, в которые после последней малой сборки записаны молодые объекты
+    std::vector<size_t> rememberedGlobals;
 
-    std::shared_ptr<Global> global;
+    std::vector<CallFrame> callStack;
+
+    std::unique_ptr<bytecodeGenerator> _bytecodeGenerator;
 
+    std::unique_ptr<registerGenerator> _registerGenerator;
 
-    std::vector<EvaluationValue> stack;
+    Backend backend;
 
-    std::unique_ptr<syntax::parser> _parser;
+    // Машинный код горячих объектов кода (Jit.h)
+    JitCache jitCache;
 
-    CodeObject *co;
+    // Машинный код копированием трафаретов (CopyPatchJit.h), если выбран JitCompiler::STENCILS
+    StencilJit stencilJit;
 
-    std::vector<CallFrame> callStack;
+    bool useStencils;
 
-    std::unique_ptr<bytecodeGenerator> _bytecodeGenerator;
+    bool jitEnabled;
+
+    // Пороги перехода на машинный код и число переходов
+    TieringPolicy tiering;
 
-    std::unordered_map<std::string, CodeObject *> builtins;
+    TieringStats tieringStats;
 
-    std::unordered_map<CodeObject *, CodeObject *> jitCache;
+    // Трассы горячих циклов (TraceJit.h)
+    TraceCache traceCache;
+
+    bool tracingEnabled;
+
+    uint32_t traceThreshold;
 
     std::unique_ptr<Disassembler> disassembler;
+
+#if VM_PROFILE_OPCODES
+    void countOpcode(uint8_t opcode) {
+        opcodeCounts[opcode]++;
+        opcodePairCounts[(previousOpcode << 8) | opcode]++;
+        previousOpcode = opcode;
+    }
+
+    std::array<uint64_t, 0xFF + 1> opcodeCounts{};
+
+    // Пары подряд выполненных инструкций: индекс (предыдущая << 8) | следующая.
+    // По ним выбираются последовательности для суперинструкций.
+    std::vector<uint64_t> opcodePairCounts = std::vector<uint64_t>(0x10000);
+
+    uint8_t previousOpcode = OP_HALT;
+
+    // Выполненные регистровые инструкции по опкодам (RegisterOpCode.h)
+    std::array<uint64_t, 0xFF + 1> registerOpcodeCounts{};
+#endif
 };
 
 
 static void handleHalt(vm *machine, CallFrame &frame, uint8_t *&ip) {
-    EvaluationValue result = IS_NIL(machine->peek()) ? NIL() : machine->pop();
+    EvaluationValue result = machine->pop();
 
+    machine->sp = machine->stack.data();
     machine->callStack.clear();
 
     machine->push(result);
@@ -405,13 +972,24 @@ static void handleConst(vm *machine, CallFrame &frame, uint8_t *&ip) {
     machine->push(frame.co->constants[constIndex]);
 }
 
+static void handleConstLong(vm *machine, CallFrame &frame, uint8_t *&ip) {
+    uint16_t constIndex = (ip[0] << 8) | ip[1];
+    ip += 2;
+    machine->push(frame.co->constants[constIndex]);
+}
+
+// Быстрые пути малых целых и массивов чисел - общие с JIT на трафаретах (FastPath.h)
+
 static void handleAdd(vm *machine, CallFrame &frame, uint8_t *&ip) {
     auto right = machine->pop();
     auto left = machine->pop();
-    if (IS_NUMBER(left) && IS_NUMBER(right)) {
-        machine->push(NUMBER(AS_NUMBER(left) + AS_NUMBER(right)));
+    EvaluationValue result;
+    if (addSmall(left, right, result)) {
+        machine->push(result);
+    } else if (IS_NUMBER(left) && IS_NUMBER(right)) {
+        machine->pushNew(NUMBER(AS_NUMBER(left) + AS_NUMBER(right)));
     } else if (IS_STRING(left) && IS_STRING(right)) {
-        machine->push(ALLOC_STRING(AS_CPP_STRING(left) + AS_CPP_STRING(right)));
+        machine->pushNew(ALLOC_STRING(AS_CPP_STRING(left) + AS_CPP_STRING(right)));
     } else {
         throw std::runtime_error("Type error in ADD operation.");
     }
@@ -420,58 +998,91 @@ static void handleAdd(vm *machine, CallFrame &frame, uint8_t *&ip) {
 static void handleSub(vm *machine, CallFrame &frame, uint8_t *&ip) {
     auto right = machine->pop();
     auto left = machine->pop();
-    machine->push(NUMBER(AS_NUMBER(left) - AS_NUMBER(right)));
+    EvaluationValue result;
+    if (subSmall(left, right, result)) {
+        machine->push(result);
+        return;
+    }
+    if (!IS_NUMBER(left) || !IS_NUMBER(right)) {
+        throw std::runtime_error("Type error in SUB operation.");
+    }
+    machine->pushNew(NUMBER(AS_NUMBER(left) - AS_NUMBER(right)));
 }
 
 static void handleMul(vm *machine, CallFrame &frame, uint8_t *&ip) {
     auto right = machine->pop();
     auto left = machine->pop();
-    machine->push(NUMBER(AS_NUMBER(left) * AS_NUMBER(right)));
+    EvaluationValue result;
+    if (mulSmall(left, right, result)) {
+        machine->push(result);
+        return;
+    }
+    if (!IS_NUMBER(left) || !IS_NUMBER(right)) {
+        throw std::runtime_error("Type error in MUL operation.");
+    }
+    machine->pushNew(NUMBER(AS_NUMBER(left) * AS_NUMBER(right)));
 }
 
 static void handleDiv(vm *machine, CallFrame &frame, uint8_t *&ip) {
     auto right = machine->pop();
     auto left = machine->pop();
-    double casted_left = AS_NUMBER(left);
-    double casted_right = AS_NUMBER(right);
+    if (!IS_NUMBER(left) || !IS_NUMBER(right)) {
+        throw std::runtime_error("Type error in DIV operation.");
+    }
+    int64_t casted_left = AS_NUMBER(left);
+    int64_t casted_right = AS_NUMBER(right);
     if (casted_right == 0) {
         throw std::runtime_error("Division by zero");
     }
-    machine->push(NUMBER(casted_left / casted_right));
+    machine->pushNew(NUMBER(casted_left / casted_right));
+}
+
+// Код сравнения - операнд OP_COMPARE (bytecodeGenerator::compareOperator)
+template<typename T>
+static bool compareWith(uint8_t compareOp, const T &left, const T &right) {
+    switch (compareOp) {
+        case 0: return left < right;
+        case 1: return left > right;
+        case 2: return left == right;
+        case 3: return left >= right;
+        case 4: return left <= right;
+        case 5: return left != right;
+        default:
+            throw std::runtime_error("Unknown compare operation.");
+    }
+}
+
+static bool compareValues(uint8_t compareOp, const EvaluationValue &left, const EvaluationValue &right) {
+    if (smallNumbers(left, right) && compareOp <= 5) {
+        return compareSmall(compareOp, left, right);
+    }
+    if (IS_NUMBER(left) && IS_NUMBER(right)) {
+        return compareWith(compareOp, AS_NUMBER(left), AS_NUMBER(right));
+    }
+    if (IS_STRING(left) && IS_STRING(right)) {
+        return compareWith(compareOp, AS_CPP_STRING(left), AS_CPP_STRING(right));
+    }
+    throw std::runtime_error("Type error in COMPARE operation.");
 }
 
 static void handleCompare(vm *machine, CallFrame &frame, uint8_t *&ip) {
     auto compareOp = *ip++;
     auto right = machine->pop();
     auto left = machine->pop();
+    machine->push(BOOLEAN(compareValues(compareOp, left, right)));
+}
 
-    auto compare_values = [&](auto casted_left, auto casted_right) {
-        bool res = false;
-        switch (compareOp) {
-            case 0: res = (casted_left < casted_right);
-                break;
-            case 1: res = (casted_left > casted_right);
-                break;
-            case 2: res = (casted_left == casted_right);
-                break;
-            case 3: res = (casted_left >= casted_right);
-                break;
-            case 4: res = (casted_left <= casted_right);
-                break;
-            case 5: res = (casted_left != casted_right);
-                break;
-            default:
-                throw std::runtime_error("Unknown compare operation.");
-        }
-        machine->push(BOOLEAN(res));
-    };
+// Сравнение и переход без промежуточного логического значения на стеке
+template<uint8_t opcode>
+static void handleJumpIfNot(vm *machine, CallFrame &frame, uint8_t *&ip) {
+    constexpr uint8_t compareOp = opcode - OP_JUMP_IF_NOT_LT;
+    uint16_t addr = (ip[0] << 8) | ip[1];
+    ip += 2;
+    EvaluationValue right = machine->pop();
+    EvaluationValue left = machine->pop();
 
-    if (IS_NUMBER(left) && IS_NUMBER(right)) {
-        compare_values(AS_NUMBER(left), AS_NUMBER(right));
-    } else if (IS_STRING(left) && IS_STRING(right)) {
-        compare_values(AS_CPP_STRING(left), AS_CPP_STRING(right));
-    } else {
-        throw std::runtime_error("Type error in COMPARE operation.");
+    if (!compareValues(compareOp, left, right)) {
+        ip = &frame.co->code[addr];
     }
 }
 
@@ -484,21 +1095,41 @@ static void handleJumpIfFalse(vm *machine, CallFrame &frame, uint8_t *&ip) {
     }
 }
 
+static void handleJumpIfTrue(vm *machine, CallFrame &frame, uint8_t *&ip) {
+    uint16_t addr = (ip[0] << 8) | ip[1];
+    ip += 2;
+    if (machine->isTruth(machine->pop())) {
+        ip = &frame.co->code[addr];
+    }
+}
+
 static void handleJump(vm *machine, CallFrame &frame, uint8_t *&ip) {
     uint16_t addr = (ip[0] << 8) | ip[1];
     ip += 2;
     ip = &frame.co->code[addr];
 }
 
+// Индекс глобальной переменной проверен при компиляции, а слоты никогда не удаляются
 static void handleGetGlobal(vm *machine, CallFrame &frame, uint8_t *&ip) {
     uint8_t globalIndex = *ip++;
-    machine->push(machine->global->get(globalIndex).value);
+    machine->push(machine->global->slot(globalIndex));
 }
 
 static void handleSetGlobal(vm *machine, CallFrame &frame, uint8_t *&ip) {
     uint8_t globalIndex = *ip++;
-    EvaluationValue val = machine->pop();
-    machine->global->set(globalIndex, val);
+    machine->setGlobal(globalIndex, machine->pop());
+}
+
+static void handleGetGlobalLong(vm *machine, CallFrame &frame, uint8_t *&ip) {
+    uint16_t globalIndex = (ip[0] << 8) | ip[1];
+    ip += 2;
+    machine->push(machine->global->slot(globalIndex));
+}
+
+static void handleSetGlobalLong(vm *machine, CallFrame &frame, uint8_t *&ip) {
+    uint16_t globalIndex = (ip[0] << 8) | ip[1];
+    ip += 2;
+    machine->setGlobal(globalIndex, machine->pop());
 }
 
 static void handleGetLocal(vm *machine, CallFrame &frame, uint8_t *&ip) {
@@ -548,91 +1179,106 @@ static void handleDup(vm *machine, CallFrame &frame, uint8_t *&ip) {
 }
 
 static void handleCall(vm *machine, CallFrame &frame, uint8_t *&ip) {
-    uint8_t argCount = *ip++;
+    uint8_t argCount = ip[0];
+    CallCache &cache = frame.co->callCaches[(ip[1] << 8) | ip[2]];
+    ip += 3;
 
-    // 1) Считываем аргументы со стека
-    std::vector<EvaluationValue> args(argCount);
-    for (int i = argCount - 1; i >= 0; --i) {
-        args[i] = machine->pop();
-    }
+    // 1) Аргументы лежат на стеке прямо над вызываемой функцией
+    EvaluationValue *args = machine->sp - argCount;
+    EvaluationValue funcVal = args[-1];
 
-    // 2) Снимаем со стека саму функцию
-    EvaluationValue funcVal = machine->pop();
-    if (!IS_OBJECT(funcVal) || !IS_CODE(funcVal)) {
-        throw std::runtime_error("Attempting to call a non-function.");
+    // 2) Та же функция, что и в прошлый раз, уже проверена: сравнение слова вместо проверок
+    if (cache.callee != funcVal.bits || cache.version != machine->global->globals[cache.slot].version) {
+        machine->resolveCall(cache, funcVal, argCount);
     }
-    CodeObject *originalFunctionCo = AS_CODE(funcVal);
 
-    // 3) Проверяем, не является ли это встроенной функцией
-    bool isBuiltin = false;
-    std::string builtinName;
-    for (const auto &[name, codeObj]: machine->builtins) {
-        if (name == originalFunctionCo->name) {
-            isBuiltin = true;
-            builtinName = name;
-            break;
-        }
+    // 3) Встроенная функция вызывается сразу, аргументы передаются прямо со стека
+    if (cache.native) {
+        EvaluationValue result = AS_NATIVE(funcVal)->function(*machine->global, args, argCount);
+        machine->sp = args - 1;
+        machine->pushNew(result);
+        return;
     }
+    // Байткод функции уже оптимизирован при компиляции
+    CodeObject *functionCo = AS_CODE(funcVal);
 
-    CodeObject *functionCo = originalFunctionCo;
+    // 4) Аргументы становятся первыми локальными переменными на месте, остальные слоты - nil
+    machine->checkStackSpace(functionCo);
+    EvaluationValue *localsEnd = args + functionCo->localCount;
+    std::fill(machine->sp, localsEnd, NIL());
+    machine->sp = localsEnd;
 
-    if (!isBuiltin) {
-        // 4b) Если НЕ встроенная функция, проверяем, оптимизировалась ли она ранее
-        auto it = machine->jitCache.find(originalFunctionCo);
-        if (it != machine->jitCache.end()) {
-            // Есть в кэше -> берем оптимизированный код
-            functionCo = it->second;
-        } else {
-            // Нет в кэше -> оптимизируем и добавляем в кэш
-            CodeObject *optimizedCo = machine->optimizeBytecode(originalFunctionCo);
-            machine->jitCache[originalFunctionCo] = optimizedCo;
-            functionCo = optimizedCo;
-        }
-    }
-
-    if (isBuiltin) {
-        // 4a) Если встроенная, вызываем её, никакой JIT-оптимизации не нужно
-        EvaluationValue result = machine->global->callBuiltin(builtinName, args);
-        machine->push(result);
-    } else {
-        // 5) Создаём фрейм вызова пользовательской функции
-        CallFrame newFrame(functionCo);
-
-        // 6) Установка локальных переменных (параметров)
-        for (size_t i = 0; i < args.size(); ++i) {
-            int slot = i;
-            if (slot >= functionCo->localNames.size()) {
-                throw std::runtime_error("Слишком много аргументов при вызове функции.");
-            }
-            newFrame.locals[slot] = args[i];
-        }
-
-        // 7) Добавляем фрейм в стек вызовов
-        machine->callStack.push_back(newFrame);
-    }
+    // 5) Добавляем фрейм в стек вызовов
+    machine->callStack.emplace_back(functionCo, args);
 }
 
 
 static void handleReturn(vm *machine, CallFrame &frame, uint8_t *&ip) {
     EvaluationValue returnValue = machine->pop();
-    machine->callStack.pop_back();
-
-    if (machine->callStack.empty()) {
-        machine->push(returnValue);
-        return;
-    }
 
+    // Снимаем локальные переменные фрейма вместе с вызванной функцией под ними
+    machine->sp = machine->callStack.size() > 1 ? frame.locals - 1 : machine->stack.data();
+    machine->callStack.pop_back();
 
     machine->push(returnValue);
 }
 
 static void handleArray(vm *machine, CallFrame &frame, uint8_t *&ip) {
-    machine->push(ALLOC_ARRAY());
+    uint16_t capacity = (ip[0] << 8) | ip[1];
+    ip += 2;
+
+    EvaluationValue arrayVal = ALLOC_ARRAY();
+    ArrayObject *array = AS_ARRAY(arrayVal);
+    size_t sizeBefore = Heap::objectSize(array);
+    array->numbers.reserve(capacity);
+    machine->push(arrayVal);
+    machine->arrayGrown(array, sizeBefore);
+}
+
+static void handleArrayLiteral(vm *machine, CallFrame &frame, uint8_t *&ip) {
+    uint8_t count = *ip++;
+    // Значения остаются на стеке, пока массив не заполнен: они корни сборки
+    EvaluationValue *values = machine->sp - count;
+
+    EvaluationValue arrayVal = ALLOC_ARRAY();
+    ArrayObject *array = AS_ARRAY(arrayVal);
+    size_t sizeBefore = Heap::objectSize(array);
+
+    bool allNumbers = true;
+    for (size_t i = 0; i < count && allNumbers; ++i) {
+        allNumbers = IS_NUMBER(values[i]);
+    }
+    if (allNumbers) {
+        array->numbers.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            array->numbers.push_back(AS_NUMBER(values[i]));
+        }
+    } else {
+        array->kind = ArrayObject::Kind::GENERIC;
+        array->elements.assign(values, values + count);
+        for (size_t i = 0; i < count; ++i) {
+            machine->heap.writeBarrier(array, values[i]);
+        }
+    }
+
+    machine->sp = values;
+    machine->push(arrayVal);
+    machine->arrayGrown(array, sizeBefore);
+}
+
+// Новая ёмкость буфера массива: не меньше нужной и не меньше удвоенной текущей
+static size_t grownCapacity(size_t capacity, size_t required) {
+    return std::max(required, std::max<size_t>(capacity * 2, 8));
 }
 
 static void handleArrayGet(vm *machine, CallFrame &frame, uint8_t *&ip) {
     EvaluationValue indexVal = machine->pop();
     EvaluationValue arrayVal = machine->pop();
+    EvaluationValue element;
+    if (getNumberElement(arrayVal, indexVal, element)) {
+        machine->push(element);
+        return;
+    }
 
     if (!IS_ARRAY(arrayVal)) {
         throw std::runtime_error("Attempting to index a non-array.");
@@ -644,10 +1290,15 @@ static void handleArrayGet(vm *machine, CallFrame &frame, uint8_t *&ip) {
     }
 
     size_t index = (size_t) AS_NUMBER(indexVal);
-    if (index >= array->elements.size()) {
+    if (index >= array->size()) {
         throw std::runtime_error("Array index out of bounds.");
     }
 
+    if (array->kind == ArrayObject::Kind::INT64) {
+        // Число вне диапазона малых целых создаётся в куче
+        machine->pushNew(NUMBER(array->numbers[index]));
+        return;
+    }
     machine->push(array->elements[index]);
 }
 
@@ -655,6 +1306,9 @@ static void handleArraySet(vm *machine, CallFrame &frame, uint8_t *&ip) {
     EvaluationValue value = machine->pop();
     EvaluationValue indexVal = machine->pop();
     EvaluationValue arrayVal = machine->pop();
+    if (setNumberElement(arrayVal, indexVal, value)) {
+        return;
+    }
 
     if (!IS_ARRAY(arrayVal)) {
         throw std::runtime_error("Attempting to index a non-array.");
@@ -666,12 +1320,448 @@ static void handleArraySet(vm *machine, CallFrame &frame, uint8_t *&ip) {
     }
 
     size_t index = (size_t) AS_NUMBER(indexVal);
-    if (index >= array->elements.size()) {
-        array->elements.resize(index + 1, NIL());
+
+    if (array->kind == ArrayObject::Kind::INT64) {
+        if (IS_NUMBER(value) && index < array->numbers.size()) {
+            array->numbers[index] = AS_NUMBER(value);
+            return;
+        }
+        if (IS_NUMBER(value) && index == array->numbers.size()) {
+            // Добавление в конец: буфер растёт вдвое, поэтому сборщик учитывает рост
+            // лишь при смене ёмкости
+            if (array->numbers.size() < array->numbers.capacity()) {
+                array->numbers.push_back(AS_NUMBER(value));
+                return;
+            }
+            size_t sizeBefore = Heap::objectSize(array);
+            array->numbers.reserve(grownCapacity(array->numbers.capacity(), index + 1));
+            array->numbers.push_back(AS_NUMBER(value));
+            machine->arrayGrown(array, sizeBefore);
+            return;
+        }
+        machine->generalizeArray(array);
     }
-    array->elements[index] = value;
+
+    machine->heap.writeBarrier(array, value);
+
+    std::vector<EvaluationValue> &elements = array->elements;
+    if (index < elements.size()) {
+        elements[index] = value;
+        return;
+    }
+    if (index == elements.size() && elements.size() < elements.capacity()) {
+        elements.push_back(value);
+        return;
+    }
+
+    // Рост буфера, в том числе с дырами, заполненными nil
+    size_t sizeBefore = Heap::objectSize(array);
+    elements.reserve(grownCapacity(elements.capacity(), index + 1));
+    elements.resize(index + 1, NIL());
+    elements[index] = value;
+    machine->arrayGrown(array, sizeBefore);
 }
 
 static void handleNil(vm *machine, CallFrame &frame, uint8_t *&ip) {
     machine->push(NIL());
 }
+
+static void handlePop(vm *machine, CallFrame &frame, uint8_t *&ip) {
+    machine->sp--;
+}
+
+// Суперинструкции выполняют ту же работу, что и заменённые ими последовательности,
+// за одну диспетчеризацию: операнды кладутся на стек и вызывается обработчик операции.
+
+static void handleGetLocalLocal(vm *machine, CallFrame &frame, uint8_t *&ip) {
+    machine->push(frame.locals[ip[0]]);
+    machine->push(frame.locals[ip[1]]);
+    ip += 2;
+}
+
+static void handleAddConst(vm *machine, CallFrame &frame, uint8_t *&ip) {
+    machine->push(frame.co->constants[*ip++]);
+    handleAdd(machine, frame, ip);
+}
+
+static void handleSubConst(vm *machine, CallFrame &frame, uint8_t *&ip) {
+    machine->push(frame.co->constants[*ip++]);
+    handleSub(machine, frame, ip);
+}
+
+static void handleIncLocal(vm *machine, CallFrame &frame, uint8_t *&ip) {
+    uint8_t slot = ip[0];
+    machine->push(frame.locals[slot]);
+    machine->push(frame.co->constants[ip[1]]);
+    ip += 2;
+    handleAdd(machine, frame, ip);
+    frame.locals[slot] = machine->pop();
+}
+
+static void handleArrayGetLocalLocal(vm *machine, CallFrame &frame, uint8_t *&ip) {
+    machine->push(frame.locals[ip[0]]);
+    machine->push(frame.locals[ip[1]]);
+    ip += 2;
+    handleArrayGet(machine, frame, ip);
+}
+
+// Регистровый код (RegisterOpCode.h). Регистры фрейма - окно стека операндов от frame.locals,
+// поэтому корни сборки мусора те же, что у стекового кода: всё, что лежит ниже sp.
+// Малые целые и массивы чисел обрабатываются на месте; в остальных случаях операнды
+// кладутся на стек над регистрами и вызывается обработчик стековой инструкции, так что
+// ошибки и работа с кучей у обоих наборов инструкций одинаковые.
+inline EvaluationValue vm::evalRegisters() {
+    CallFrame *frame = &callStack.back();
+    EvaluationValue *regs = frame->locals;
+    const EvaluationValue *constants = frame->co->constants.data();
+    uint8_t *code = frame->co->code.data();
+    uint8_t *ip = frame->ip;
+
+    // Значение, которое могло быть только что создано в куче: регистр уже корень сборки
+    auto storeNew = [&](uint8_t dest, EvaluationValue value) {
+        regs[dest] = value;
+        if (value.isHeapReference()) {
+            collectIfNeeded();
+        }
+    };
+
+    // Медленный путь: стековый обработчик над регистрами, результат - в регистр dest
+    auto delegate = [&](InstructionHandler handler, uint8_t dest, EvaluationValue left, EvaluationValue right) {
+        push(left);
+        push(right);
+        handler(this, *frame, ip);
+        regs[dest] = pop();
+    };
+
+    auto jumpIfNot = [&](uint8_t compareOp) {
+        if (!compareValues(compareOp, regs[ip[0]], regs[ip[1]])) {
+            ip = code + ((ip[2] << 8) | ip[3]);
+        } else {
+            ip += 4;
+        }
+    };
+
+#if VM_USE_COMPUTED_GOTO
+    static void *dispatchTable[0xFF + 1] = {
+        &&rop_halt,
+        &&rop_load_const,
+        &&rop_load_nil,
+        &&rop_move,
+        &&rop_get_global,
+        &&rop_set_global,
+        &&rop_add,
+        &&rop_sub,
+        &&rop_mul,
+        &&rop_div,
+        &&rop_add_const,
+        &&rop_sub_const,
+        &&rop_compare,
+        &&rop_not,
+        &&rop_jump,
+        &&rop_jump_if_false,
+        &&rop_jump_if_falsy,
+        &&rop_jump_if_truthy,
+        &&rop_jump_if_not_lt,
+        &&rop_jump_if_not_gt,
+        &&rop_jump_if_not_eq,
+        &&rop_jump_if_not_ge,
+        &&rop_jump_if_not_le,
+        &&rop_jump_if_not_ne,
+        &&rop_array,
+        &&rop_array_literal,
+        &&rop_array_get,
+        &&rop_array_set,
+        &&rop_call,
+        &&rop_return,
+    };
+
+#if VM_PROFILE_OPCODES
+#define REGISTER_DISPATCH() do { registerOpcodeCounts[*ip]++; goto *dispatchTable[*ip++]; } while (false)
+#else
+#define REGISTER_DISPATCH() goto *dispatchTable[*ip++]
+#endif
+#define REGISTER_CASE(label, opcode) label:
+
+    REGISTER_DISPATCH();
+#else
+#define REGISTER_DISPATCH() continue
+#define REGISTER_CASE(label, opcode) case opcode:
+
+    for (;;) {
+        uint8_t opcode = *ip++;
+#if VM_PROFILE_OPCODES
+        registerOpcodeCounts[opcode]++;
+#endif
+        switch (opcode) {
+#endif
+
+    REGISTER_CASE(rop_halt, ROP_HALT) {
+        EvaluationValue result = regs[ip[0]];
+        sp = stack.data();
+        callStack.clear();
+        return result;
+    }
+    REGISTER_CASE(rop_load_const, ROP_LOAD_CONST) {
+        regs[ip[0]] = constants[(ip[1] << 8) | ip[2]];
+        ip += 3;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_load_nil, ROP_LOAD_NIL) {
+        regs[ip[0]] = NIL();
+        ip += 1;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_move, ROP_MOVE) {
+        regs[ip[0]] = regs[ip[1]];
+        ip += 2;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_get_global, ROP_GET_GLOBAL) {
+        regs[ip[0]] = global->slot((ip[1] << 8) | ip[2]);
+        ip += 3;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_set_global, ROP_SET_GLOBAL) {
+        setGlobal((ip[0] << 8) | ip[1], regs[ip[2]]);
+        ip += 3;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_add, ROP_ADD) {
+        EvaluationValue left = regs[ip[1]];
+        EvaluationValue right = regs[ip[2]];
+        if (!addSmall(left, right, regs[ip[0]])) {
+            delegate(handleAdd, ip[0], left, right);
+        }
+        ip += 3;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_sub, ROP_SUB) {
+        EvaluationValue left = regs[ip[1]];
+        EvaluationValue right = regs[ip[2]];
+        if (!subSmall(left, right, regs[ip[0]])) {
+            delegate(handleSub, ip[0], left, right);
+        }
+        ip += 3;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_mul, ROP_MUL) {
+        EvaluationValue left = regs[ip[1]];
+        EvaluationValue right = regs[ip[2]];
+        if (!mulSmall(left, right, regs[ip[0]])) {
+            delegate(handleMul, ip[0], left, right);
+        }
+        ip += 3;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_div, ROP_DIV) {
+        delegate(handleDiv, ip[0], regs[ip[1]], regs[ip[2]]);
+        ip += 3;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_add_const, ROP_ADD_CONST) {
+        EvaluationValue left = regs[ip[1]];
+        EvaluationValue right = constants[(ip[2] << 8) | ip[3]];
+        if (!addSmall(left, right, regs[ip[0]])) {
+            delegate(handleAdd, ip[0], left, right);
+        }
+        ip += 4;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_sub_const, ROP_SUB_CONST) {
+        EvaluationValue left = regs[ip[1]];
+        EvaluationValue right = constants[(ip[2] << 8) | ip[3]];
+        if (!subSmall(left, right, regs[ip[0]])) {
+            delegate(handleSub, ip[0], left, right);
+        }
+        ip += 4;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_compare, ROP_COMPARE) {
+        regs[ip[0]] = BOOLEAN(compareValues(ip[3], regs[ip[1]], regs[ip[2]]));
+        ip += 4;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_not, ROP_NOT) {
+        regs[ip[0]] = BOOLEAN(!isTruth(regs[ip[1]]));
+        ip += 2;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_jump, ROP_JUMP) {
+        ip = code + ((ip[0] << 8) | ip[1]);
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_jump_if_false, ROP_JUMP_IF_FALSE) {
+        if (regs[ip[0]] == BOOLEAN(false)) {
+            ip = code + ((ip[1] << 8) | ip[2]);
+        } else {
+            ip += 3;
+        }
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_jump_if_falsy, ROP_JUMP_IF_FALSY) {
+        if (!isTruth(regs[ip[0]])) {
+            ip = code + ((ip[1] << 8) | ip[2]);
+        } else {
+            ip += 3;
+        }
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_jump_if_truthy, ROP_JUMP_IF_TRUTHY) {
+        if (isTruth(regs[ip[0]])) {
+            ip = code + ((ip[1] << 8) | ip[2]);
+        } else {
+            ip += 3;
+        }
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_jump_if_not_lt, ROP_JUMP_IF_NOT_LT) {
+        jumpIfNot(0);
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_jump_if_not_gt, ROP_JUMP_IF_NOT_GT) {
+        jumpIfNot(1);
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_jump_if_not_eq, ROP_JUMP_IF_NOT_EQ) {
+        jumpIfNot(2);
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_jump_if_not_ge, ROP_JUMP_IF_NOT_GE) {
+        jumpIfNot(3);
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_jump_if_not_le, ROP_JUMP_IF_NOT_LE) {
+        jumpIfNot(4);
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_jump_if_not_ne, ROP_JUMP_IF_NOT_NE) {
+        jumpIfNot(5);
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_array, ROP_ARRAY) {
+        // Операнд ёмкости читается обработчиком OP_ARRAY
+        uint8_t *capacity = ip + 1;
+        handleArray(this, *frame, capacity);
+        regs[ip[0]] = pop();
+        ip += 3;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_array_literal, ROP_ARRAY_LITERAL) {
+        uint8_t *count = ip + 2;
+        for (uint8_t i = 0; i < *count; ++i) {
+            push(regs[ip[1] + i]);
+        }
+        handleArrayLiteral(this, *frame, count);
+        regs[ip[0]] = pop();
+        ip += 3;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_array_get, ROP_ARRAY_GET) {
+        EvaluationValue arrayVal = regs[ip[1]];
+        EvaluationValue indexVal = regs[ip[2]];
+        bool generic = IS_ARRAY(arrayVal) && AS_ARRAY(arrayVal)->kind != ArrayObject::Kind::INT64 &&
+                       indexVal.isSmallNumber() &&
+                       static_cast<uint64_t>(indexVal.number()) < AS_ARRAY(arrayVal)->size();
+        if (generic) {
+            regs[ip[0]] = AS_ARRAY(arrayVal)->elements[indexVal.number()];
+        } else if (!getNumberElement(arrayVal, indexVal, regs[ip[0]])) {
+            delegate(handleArrayGet, ip[0], arrayVal, indexVal);
+        }
+        ip += 3;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_array_set, ROP_ARRAY_SET) {
+        EvaluationValue arrayVal = regs[ip[0]];
+        EvaluationValue indexVal = regs[ip[1]];
+        EvaluationValue value = regs[ip[2]];
+        if (!setNumberElement(arrayVal, indexVal, value)) {
+            push(arrayVal);
+            push(indexVal);
+            push(value);
+            handleArraySet(this, *frame, ip);
+        }
+        ip += 3;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_call, ROP_CALL) {
+        uint8_t function = ip[0];
+        uint8_t argCount = ip[1];
+        ip += 2;
+
+        EvaluationValue funcVal = regs[function];
+        if (!funcVal.isHeapReference() || funcVal.object() == nullptr) {
+            throw std::runtime_error("Attempting to call a non-function.");
+        }
+        switch (funcVal.object()->type) {
+            case ObjectType::CODE:
+                break;
+            case ObjectType::NATIVE: {
+                // Аргументы передаются прямо из регистров
+                NativeObject *native = AS_NATIVE(funcVal);
+                if (native->arity >= 0 && argCount != native->arity) {
+                    throw std::runtime_error("Функция " + native->name + " ожидает аргументов: " +
+                                             std::to_string(native->arity) + ".");
+                }
+                storeNew(function, native->function(*global, &regs[function + 1], argCount));
+                REGISTER_DISPATCH();
+            }
+            default:
+                throw std::runtime_error("Attempting to call a non-function.");
+        }
+        CodeObject *functionCo = AS_CODE(funcVal);
+
+        if (argCount > functionCo->arity) {
+            throw std::runtime_error("Слишком много аргументов при вызове функции.");
+        }
+
+        // Регистры вызванной функции начинаются с первого аргумента. Регистры вызывающего
+        // выше функции свободны, но остаются под sp, чтобы не пропасть из корней сборки.
+        // Поэтому место под временные значения вызванной функции отсчитывается от нового sp:
+        // у широкого фрейма вызывающего он выше конца регистров вызванной.
+        EvaluationValue *base = &regs[function + 1];
+        EvaluationValue *calleeSp = std::max(sp, base + functionCo->localCount);
+        if (calleeSp > stackLimit || static_cast<size_t>(stackLimit - calleeSp) < functionCo->maxStackDepth) {
+            throw std::runtime_error("Stack overflow.");
+        }
+        std::fill(base + argCount, base + functionCo->localCount, NIL());
+        sp = calleeSp;
+
+        frame->ip = ip;
+        callStack.emplace_back(functionCo, base);
+        frame = &callStack.back();
+        regs = base;
+        constants = functionCo->constants.data();
+        code = functionCo->code.data();
+        ip = code;
+        REGISTER_DISPATCH();
+    }
+    REGISTER_CASE(rop_return, ROP_RETURN) {
+        EvaluationValue result = regs[ip[0]];
+        if (callStack.size() == 1) {
+            sp = stack.data();
+            callStack.clear();
+            return result;
+        }
+
+        // Результат записывается в регистр, где лежала вызванная функция
+        regs[-1] = result;
+        callStack.pop_back();
+        frame = &callStack.back();
+        regs = frame->locals;
+        constants = frame->co->constants.data();
+        code = frame->co->code.data();
+        ip = frame->ip;
+        sp = regs + frame->co->localCount;
+        REGISTER_DISPATCH();
+    }
+
+#if !VM_USE_COMPUTED_GOTO
+            default:
+                throw std::runtime_error("Неизвестная регистровая инструкция " + std::to_string(opcode));
+        }
+    }
+#endif
+
+#undef REGISTER_CASE
+#undef REGISTER_DISPATCH
+}